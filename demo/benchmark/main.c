@@ -0,0 +1,307 @@
+/* nuklear - v1.00 - public domain */
+/* Headless frame benchmark. Runs the demo/common UIs plus a number of
+ * small filler windows against a null backend with scripted input and
+ * prints one JSON object per scenario to stdout:
+ *
+ *      bin/benchmark [frames]
+ *
+ * Times are nanoseconds per frame, split into building the UI (input and
+ * all nk_begin/nk_end calls), `nk_build`, `nk_convert` and `nk_clear`.
+ * Allocations go through a counting allocator, so every allocation made
+ * by the context, the font atlas and the vertex buffers is included.
+ * `frame_peak_bytes` is the highest amount of live memory reached within
+ * a single frame, taken as the maximum over all measured frames. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_UINT_DRAW_INDEX
+#define NK_IMPLEMENTATION
+#include "../../nuklear.h"
+
+#include "../../demo/common/calculator.c"
+#include "../../demo/common/overview.c"
+#include "../../demo/common/node_editor.c"
+#include "../../demo/common/canvas.c"
+
+#define WARMUP_FRAMES   20
+#define SCREEN_WIDTH    1280
+#define SCREEN_HEIGHT   800
+
+static const int window_counts[] = {0, 16, 64, 256};
+static const float font_sizes[] = {13.0f, 20.0f};
+
+/* ===============================================================
+ *
+ *                          MEMORY
+ *
+ * ===============================================================*/
+union bench_header {
+    nk_size size;
+    /* keeps the returned memory aligned like malloc */
+    double d;
+    void *p;
+    long l;
+};
+
+struct bench_memory {
+    unsigned long allocations;
+    nk_size allocated;
+    nk_size live;
+    nk_size peak;
+};
+
+static void*
+bench_alloc(nk_handle handle, void *old, nk_size size)
+{
+    struct bench_memory *mem = (struct bench_memory*)handle.ptr;
+    union bench_header *header;
+    NK_UNUSED(old);
+    header = (union bench_header*)malloc(sizeof(*header) + size);
+    if (!header) return 0;
+    header->size = size;
+    mem->allocations++;
+    mem->allocated += size;
+    mem->live += size;
+    if (mem->live > mem->peak)
+        mem->peak = mem->live;
+    return header + 1;
+}
+
+static void
+bench_free(nk_handle handle, void *ptr)
+{
+    struct bench_memory *mem = (struct bench_memory*)handle.ptr;
+    union bench_header *header;
+    if (!ptr) return;
+    header = (union bench_header*)ptr - 1;
+    mem->live -= header->size;
+    free(header);
+}
+
+/* ===============================================================
+ *
+ *                          TIMER
+ *
+ * ===============================================================*/
+static double
+bench_now(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+/* ===============================================================
+ *
+ *                          SCENARIO
+ *
+ * ===============================================================*/
+struct bench_vertex {
+    float position[2];
+    float uv[2];
+    nk_byte col[4];
+};
+
+struct bench_result {
+    double build, layout, convert, clear; /* summed nanoseconds */
+    unsigned long allocations;
+    nk_size allocated;
+    nk_size peak; /* largest per frame peak of live bytes */
+    nk_size commands;
+    unsigned int vertices;
+    unsigned int elements;
+};
+
+static void
+bench_input(struct nk_context *ctx, int frame)
+{
+    /* deterministic mouse path with a click and a key every few frames */
+    int x = (int)(SCREEN_WIDTH/2 + (SCREEN_WIDTH/2 - 20) * sin(frame * 0.05));
+    int y = (int)(SCREEN_HEIGHT/2 + (SCREEN_HEIGHT/2 - 20) * sin(frame * 0.07));
+    nk_input_begin(ctx);
+    nk_input_motion(ctx, x, y);
+    nk_input_button(ctx, NK_BUTTON_LEFT, x, y, (frame % 40) == 20);
+    if ((frame % 10) == 0)
+        nk_input_scroll(ctx, nk_vec2(0, (frame % 20) ? 1.0f: -1.0f));
+    if ((frame % 7) == 0)
+        nk_input_char(ctx, (char)('a' + frame % 26));
+    nk_input_end(ctx);
+}
+
+static void
+bench_windows(struct nk_context *ctx, int count)
+{
+    static float values[256];
+    static nk_bool checks[256];
+    int i;
+    for (i = 0; i < count; ++i) {
+        char name[32];
+        const float x = (float)(420 + (i % 16) * 50);
+        const float y = (float)(10 + (i / 16) * 40);
+        sprintf(name, "Window %d", i);
+        if (nk_begin(ctx, name, nk_rect(x, y, 200, 160),
+            NK_WINDOW_BORDER|NK_WINDOW_MOVABLE|NK_WINDOW_TITLE)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_label(ctx, "value", NK_TEXT_LEFT);
+            nk_slider_float(ctx, 0, &values[i], 1.0f, 0.01f);
+            nk_checkbox_label(ctx, "enabled", &checks[i]);
+            nk_button_label(ctx, "apply");
+        }
+        nk_end(ctx);
+    }
+}
+
+static int
+bench_run(struct bench_result *res, int window_count, float font_size, int frames)
+{
+    static const struct nk_draw_vertex_layout_element vertex_layout[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct bench_vertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct bench_vertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct bench_vertex, col)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    struct bench_memory mem;
+    struct nk_allocator alloc;
+    struct nk_font_atlas atlas;
+    struct nk_draw_null_texture null;
+    struct nk_convert_config config;
+    struct nk_buffer cmds, vertices, elements;
+    struct nk_context ctx;
+    struct nk_font *font;
+    int frame, w, h;
+
+    memset(&mem, 0, sizeof(mem));
+    memset(res, 0, sizeof(*res));
+    alloc.userdata = nk_handle_ptr(&mem);
+    alloc.alloc = bench_alloc;
+    alloc.free = bench_free;
+
+    nk_font_atlas_init(&atlas, &alloc);
+    nk_font_atlas_begin(&atlas);
+    font = nk_font_atlas_add_default(&atlas, font_size, 0);
+    if (!font || !nk_font_atlas_bake(&atlas, &w, &h, NK_FONT_ATLAS_ALPHA8))
+        return 0;
+    nk_font_atlas_end(&atlas, nk_handle_id(0), &null);
+    if (!nk_init(&ctx, &alloc, &font->handle))
+        return 0;
+    nk_buffer_init(&cmds, &alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&vertices, &alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&elements, &alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+
+    memset(&config, 0, sizeof(config));
+    config.vertex_layout = vertex_layout;
+    config.vertex_size = sizeof(struct bench_vertex);
+    config.vertex_alignment = NK_ALIGNOF(struct bench_vertex);
+    config.tex_null = null;
+    config.circle_segment_count = 22;
+    config.curve_segment_count = 22;
+    config.arc_segment_count = 22;
+    config.global_alpha = 1.0f;
+    config.shape_AA = NK_ANTI_ALIASING_ON;
+    config.line_AA = NK_ANTI_ALIASING_ON;
+
+    for (frame = 0; frame < WARMUP_FRAMES + frames; ++frame) {
+        const int measure = frame >= WARMUP_FRAMES;
+        double t0, t1, t2, t3, t4;
+        if (frame == WARMUP_FRAMES) {
+            /* only count what the measured frames allocate */
+            mem.allocations = 0;
+            mem.allocated = 0;
+        }
+        /* peak of this frame alone, starting from what outlives frames */
+        mem.peak = mem.live;
+        t0 = bench_now();
+        bench_input(&ctx, frame);
+        calculator(&ctx);
+        overview(&ctx);
+        node_editor(&ctx);
+        canvas(&ctx);
+        bench_windows(&ctx, window_count);
+        t1 = bench_now();
+        nk__begin(&ctx); /* links all window command buffers */
+        t2 = bench_now();
+        nk_buffer_clear(&cmds);
+        nk_buffer_clear(&vertices);
+        nk_buffer_clear(&elements);
+        nk_convert(&ctx, &cmds, &vertices, &elements, &config);
+        t3 = bench_now();
+        if (measure) {
+            res->commands = ctx.memory.allocated;
+            res->vertices = ctx.draw_list.vertex_count;
+            res->elements = ctx.draw_list.element_count;
+        }
+        nk_clear(&ctx);
+        t4 = bench_now();
+        if (measure) {
+            res->build += t1 - t0;
+            res->layout += t2 - t1;
+            res->convert += t3 - t2;
+            res->clear += t4 - t3;
+            res->peak = NK_MAX(res->peak, mem.peak);
+        }
+    }
+    res->allocations = mem.allocations;
+    res->allocated = mem.allocated;
+
+    nk_buffer_free(&cmds);
+    nk_buffer_free(&vertices);
+    nk_buffer_free(&elements);
+    nk_free(&ctx);
+    nk_font_atlas_clear(&atlas);
+    return 1;
+}
+
+int
+main(int argc, char **argv)
+{
+    int frames = 300;
+    unsigned int i, j;
+    if (argc > 1) frames = atoi(argv[1]);
+    if (frames <= 0) {
+        fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < NK_LEN(font_sizes); ++i) {
+        for (j = 0; j < NK_LEN(window_counts); ++j) {
+            struct bench_result res;
+            if (!bench_run(&res, window_counts[j], font_sizes[i], frames)) {
+                fprintf(stderr, "benchmark setup failed\n");
+                return EXIT_FAILURE;
+            }
+            printf("{\"windows\":%d,\"font_size\":%.0f,\"frames\":%d,"
+                "\"build_ns\":%.0f,\"nk_build_ns\":%.0f,\"convert_ns\":%.0f,\"clear_ns\":%.0f,"
+                "\"allocations_per_frame\":%.2f,\"allocated_bytes_per_frame\":%.0f,"
+                "\"frame_peak_bytes\":%lu,\"command_bytes\":%lu,\"vertices\":%u,\"elements\":%u}\n",
+                window_counts[j], font_sizes[i], frames,
+                res.build / frames, res.layout / frames, res.convert / frames, res.clear / frames,
+                (double)res.allocations / frames, (double)res.allocated / frames,
+                (unsigned long)res.peak, (unsigned long)res.commands,
+                res.vertices, res.elements);
+        }
+    }
+    return EXIT_SUCCESS;
+}
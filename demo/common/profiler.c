@@ -0,0 +1,112 @@
+/* nuklear - v1.00 - public domain */
+/* Records the scopes opened by NK_PROFILE_BEGIN/NK_PROFILE_END into a ring
+ * buffer and writes them as Chrome trace events, which can be opened with
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Include this file before the nuklear implementation:
+ *
+ *      #include "profiler.c"
+ *      #define NK_IMPLEMENTATION
+ *      #include "nuklear.h"
+ *
+ * and call `profiler_dump` whenever a trace is wanted. Only the newest
+ * PROFILER_CAPACITY scopes are kept. State is global and not thread safe,
+ * so do not combine it with a threaded `nk_convert_parallel` dispatch. */
+#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifndef PROFILER_CAPACITY
+#define PROFILER_CAPACITY 65536
+#endif
+#ifndef PROFILER_MAX_DEPTH
+#define PROFILER_MAX_DEPTH 32
+#endif
+
+#define NK_PROFILE_BEGIN(name) profiler_begin(name)
+#define NK_PROFILE_END profiler_end()
+
+struct profiler_event {
+    const char *name;
+    double begin; /* microseconds */
+    double duration;
+};
+
+static struct profiler {
+    struct profiler_event events[PROFILER_CAPACITY];
+    unsigned long count; /* events recorded so far, the ring keeps the newest */
+    struct profiler_event stack[PROFILER_MAX_DEPTH];
+    int depth;
+} profiler;
+
+static double
+profiler_now(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000000.0 / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+#else
+    return (double)clock() * 1000000.0 / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+profiler_begin(const char *name)
+{
+    /* scopes nested deeper than the stack are dropped but stay balanced */
+    if (profiler.depth < PROFILER_MAX_DEPTH) {
+        struct profiler_event *e = &profiler.stack[profiler.depth];
+        e->name = name;
+        e->begin = profiler_now();
+    }
+    profiler.depth++;
+}
+
+static void
+profiler_end(void)
+{
+    struct profiler_event *e;
+    if (!profiler.depth) return;
+    profiler.depth--;
+    if (profiler.depth >= PROFILER_MAX_DEPTH) return;
+
+    e = &profiler.stack[profiler.depth];
+    e->duration = profiler_now() - e->begin;
+    profiler.events[profiler.count % PROFILER_CAPACITY] = *e;
+    profiler.count++;
+}
+
+static void
+profiler_reset(void)
+{
+    profiler.count = 0;
+}
+
+static int
+profiler_dump(FILE *file)
+{
+    unsigned long i = 0;
+    unsigned long n = profiler.count;
+    if (n > PROFILER_CAPACITY) {
+        i = n - PROFILER_CAPACITY;
+    }
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (; i < n; ++i) {
+        const struct profiler_event *e = &profiler.events[i % PROFILER_CAPACITY];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0}%s\n",
+            e->name, e->begin, e->duration, (i + 1 < n) ? ",": "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ns\"}\n");
+    return ferror(file) ? 0: 1;
+}
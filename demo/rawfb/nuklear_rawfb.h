@@ -43,6 +43,7 @@ struct rawfb_pl {
 /* All functions are thread-safe */
 NK_API struct rawfb_context *nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int h, const unsigned int pitch, const struct rawfb_pl pl);
 NK_API void                  nk_rawfb_render(const struct rawfb_context *rawfb, const struct nk_color clear, const unsigned char enable_clear);
+NK_API int                   nk_rawfb_render_damage(struct rawfb_context *rawfb, const struct nk_color clear, const struct nk_rect **rects);
 NK_API void                  nk_rawfb_shutdown(struct rawfb_context *rawfb);
 NK_API void                  nk_rawfb_resize_fb(struct rawfb_context *rawfb, void *fb, const unsigned int w, const unsigned int h, const unsigned int pitch, const struct rawfb_pl pl);
 
@@ -67,6 +68,8 @@ struct rawfb_image {
 struct rawfb_context {
     struct nk_context ctx;
     struct nk_rect scissors;
+    struct nk_rect area;
+    struct nk_damage damage;
     struct rawfb_image fb;
     struct rawfb_image font_tex;
     struct nk_font_atlas atlas;
@@ -226,10 +229,11 @@ nk_rawfb_scissor(struct rawfb_context *rawfb,
                  const float w,
                  const float h)
 {
-    rawfb->scissors.x = MIN(MAX(x, 0), rawfb->fb.w);
-    rawfb->scissors.y = MIN(MAX(y, 0), rawfb->fb.h);
-    rawfb->scissors.w = MIN(MAX(w + x, 0), rawfb->fb.w);
-    rawfb->scissors.h = MIN(MAX(h + y, 0), rawfb->fb.h);
+    /* area is the part of the framebuffer being repainted */
+    rawfb->scissors.x = MIN(MAX(x, rawfb->area.x), rawfb->area.w);
+    rawfb->scissors.y = MIN(MAX(y, rawfb->area.y), rawfb->area.h);
+    rawfb->scissors.w = MIN(MAX(w + x, rawfb->area.x), rawfb->area.w);
+    rawfb->scissors.h = MIN(MAX(h + y, rawfb->area.y), rawfb->area.h);
 }
 
 static void
@@ -623,7 +627,11 @@ nk_rawfb_draw_rect_multi_color(const struct rawfb_context *rawfb,
     }
 
     for (i=0; i<h; i++) {
+        if (y+i < rawfb->scissors.y || y+i >= rawfb->scissors.h)
+            continue;
         for (j=0; j<w; j++) {
+            if (x+j < rawfb->scissors.x || x+j >= rawfb->scissors.w)
+                continue;
             if (i==0) {
                 nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, edge_t[j]);
             } else if (i==h-1) {
@@ -839,6 +847,7 @@ nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int
     rawfb->fb.h = h;
     rawfb->fb.pitch = pitch;
     rawfb->fb.pl = pl;
+    rawfb->area = nk_rect(0, 0, w, h);
 
     if (0 == nk_init_default(&rawfb->ctx, 0)) {
         free(rawfb);
@@ -860,6 +869,7 @@ nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int
         nk_style_set_font(&rawfb->ctx, &rawfb->atlas.default_font->handle);
     nk_style_load_all_cursors(&rawfb->ctx, rawfb->atlas.cursors);
     nk_rawfb_scissor(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h);
+    nk_damage_init_default(&rawfb->damage);
 
     return rawfb;
 }
@@ -879,7 +889,7 @@ nk_rawfb_stretch_image(const struct rawfb_image *dst,
     /* Simple nearest filtering rescaling */
     /* TODO: use bilinear filter */
     for (j = 0; j < (short)dst_rect->h; j++) {
-        for (i = 0; i < (short)dst_rect->w; i++) {
+        for (i = 0; i < (short)dst_rect->w; i++, xoff += xinc) {
             if (dst_scissors) {
                 if (i + (int)(dst_rect->x + 0.5f) < dst_scissors->x || i + (int)(dst_rect->x + 0.5f) >= dst_scissors->w)
                     continue;
@@ -894,7 +904,6 @@ nk_rawfb_stretch_image(const struct rawfb_image *dst,
                 col.b = fg->b;
             }
             nk_rawfb_img_blendpixel(dst, i + (int)(dst_rect->x + 0.5f), j + (int)(dst_rect->y + 0.5f), col);
-            xoff += xinc;
         }
         xoff = src_rect->x;
         yoff += yinc;
@@ -1006,6 +1015,7 @@ NK_API void
 nk_rawfb_shutdown(struct rawfb_context *rawfb)
 {
     if (rawfb) {
+        nk_damage_free(&rawfb->damage);
         nk_free(&rawfb->ctx);
         memset(rawfb, 0, sizeof(struct rawfb_context));
         free(rawfb);
@@ -1025,6 +1035,90 @@ nk_rawfb_resize_fb(struct rawfb_context *rawfb,
     rawfb->fb.pixels = fb;
     rawfb->fb.pitch = pitch;
     rawfb->fb.pl = pl;
+    rawfb->area = nk_rect(0, 0, w, h);
+    nk_damage_invalidate(&rawfb->damage);
+}
+
+static void
+nk_rawfb_draw_command(const struct rawfb_context *rawfb, const struct nk_command *cmd)
+{
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+        nk_rawfb_scissor((struct rawfb_context *)rawfb, s->x, s->y, s->w, s->h);
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+        nk_rawfb_stroke_line(rawfb, l->begin.x, l->begin.y, l->end.x,
+            l->end.y, l->line_thickness, l->color);
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+        nk_rawfb_stroke_rect(rawfb, r->x, r->y, r->w, r->h,
+            (unsigned short)r->rounding, r->line_thickness, r->color);
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+        nk_rawfb_fill_rect(rawfb, r->x, r->y, r->w, r->h,
+            (unsigned short)r->rounding, r->color);
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+        nk_rawfb_stroke_circle(rawfb, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        nk_rawfb_fill_circle(rawfb, c->x, c->y, c->w, c->h, c->color);
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
+        nk_rawfb_stroke_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->line_thickness, t->color);
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+        nk_rawfb_fill_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->color);
+    } break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+        nk_rawfb_stroke_polygon(rawfb, p->points, p->point_count, p->line_thickness,p->color);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
+        nk_rawfb_fill_polygon(rawfb, p->points, p->point_count, p->color);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+        nk_rawfb_stroke_polyline(rawfb, p->points, p->point_count, p->line_thickness, p->color);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        nk_rawfb_draw_text(rawfb, t->font, nk_rect(t->x, t->y, t->w, t->h),
+            t->string, t->length, t->height, t->foreground);
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+        nk_rawfb_stroke_curve(rawfb, q->begin, q->ctrl[0], q->ctrl[1],
+            q->end, 22, q->line_thickness, q->color);
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *q = (const struct nk_command_rect_multi_color *)cmd;
+        nk_rawfb_draw_rect_multi_color(rawfb, q->x, q->y, q->w, q->h, q->left, q->top, q->right, q->bottom);
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *q = (const struct nk_command_image *)cmd;
+        nk_rawfb_drawimage(rawfb, q->x, q->y, q->w, q->h, &q->img, &q->col);
+    } break;
+    case NK_COMMAND_ARC: {
+        assert(0 && "NK_COMMAND_ARC not implemented\n");
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        assert(0 && "NK_COMMAND_ARC_FILLED not implemented\n");
+    } break;
+    default: break;
+    }
 }
 
 NK_API void
@@ -1033,88 +1127,46 @@ nk_rawfb_render(const struct rawfb_context *rawfb,
                 const unsigned char enable_clear)
 {
     const struct nk_command *cmd;
+    nk_rawfb_scissor((struct rawfb_context *)rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h);
     if (enable_clear)
         nk_rawfb_clear(rawfb, clear);
 
-    nk_foreach(cmd, (struct nk_context*)&rawfb->ctx) {
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-            nk_rawfb_scissor((struct rawfb_context *)rawfb, s->x, s->y, s->w, s->h);
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-            nk_rawfb_stroke_line(rawfb, l->begin.x, l->begin.y, l->end.x,
-                l->end.y, l->line_thickness, l->color);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-            nk_rawfb_stroke_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->line_thickness, r->color);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-            nk_rawfb_fill_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->color);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-            nk_rawfb_stroke_circle(rawfb, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_rawfb_fill_circle(rawfb, c->x, c->y, c->w, c->h, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
-            nk_rawfb_stroke_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->line_thickness, t->color);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-            nk_rawfb_fill_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-            nk_rawfb_stroke_polygon(rawfb, p->points, p->point_count, p->line_thickness,p->color);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
-            nk_rawfb_fill_polygon(rawfb, p->points, p->point_count, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-            nk_rawfb_stroke_polyline(rawfb, p->points, p->point_count, p->line_thickness, p->color);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_rawfb_draw_text(rawfb, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-            nk_rawfb_stroke_curve(rawfb, q->begin, q->ctrl[0], q->ctrl[1],
-                q->end, 22, q->line_thickness, q->color);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR: {
-            const struct nk_command_rect_multi_color *q = (const struct nk_command_rect_multi_color *)cmd;
-            nk_rawfb_draw_rect_multi_color(rawfb, q->x, q->y, q->w, q->h, q->left, q->top, q->right, q->bottom);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *q = (const struct nk_command_image *)cmd;
-            nk_rawfb_drawimage(rawfb, q->x, q->y, q->w, q->h, &q->img, &q->col);
-        } break;
-        case NK_COMMAND_ARC: {
-            assert(0 && "NK_COMMAND_ARC not implemented\n");
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            assert(0 && "NK_COMMAND_ARC_FILLED not implemented\n");
-        } break;
-        default: break;
-        }
-    } nk_clear((struct nk_context*)&rawfb->ctx);
+    nk_foreach(cmd, (struct nk_context*)&rawfb->ctx)
+        nk_rawfb_draw_command(rawfb, cmd);
+    nk_clear((struct nk_context*)&rawfb->ctx);
+}
+
+NK_API int
+nk_rawfb_render_damage(struct rawfb_context *rawfb,
+                       const struct nk_color clear,
+                       const struct nk_rect **rects)
+{
+    /* Only clears and redraws the parts of the framebuffer that changed
+     * since the last frame. Returns the number of rectangles in `rects`
+     * that have to be presented. */
+    const struct nk_command *cmd;
+    int i, n;
+
+    n = nk_damage_update(&rawfb->damage, &rawfb->ctx);
+    for (i = 0; i < n; ++i) {
+        struct nk_rect *r = &rawfb->damage.rects[i];
+        const int x0 = MAX((int)r->x, 0);
+        const int y0 = MAX((int)r->y, 0);
+        const int x1 = MIN((int)(r->x + r->w), rawfb->fb.w);
+        const int y1 = MIN((int)(r->y + r->h), rawfb->fb.h);
+        *r = nk_rect(x0, y0, MAX(x1 - x0, 0), MAX(y1 - y0, 0));
+        if (r->w <= 0 || r->h <= 0) continue;
+
+        rawfb->area = nk_rect(x0, y0, x1, y1);
+        nk_rawfb_scissor(rawfb, x0, y0, x1 - x0, y1 - y0);
+        nk_rawfb_fill_rect(rawfb, x0, y0, x1 - x0, y1 - y0, 0, clear);
+        nk_foreach(cmd, &rawfb->ctx)
+            nk_rawfb_draw_command(rawfb, cmd);
+    }
+    rawfb->area = nk_rect(0, 0, rawfb->fb.w, rawfb->fb.h);
+    nk_clear(&rawfb->ctx);
+    *rects = rawfb->damage.rects;
+    return n;
 }
 #endif
 
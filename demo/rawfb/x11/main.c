@@ -158,6 +158,8 @@ main(void)
     void *fb = NULL;
     struct rawfb_pl pl;
     unsigned char tex_scratch[512 * 512];
+    const struct nk_rect *damage;
+    int n;
 
     /* X11 */
     memset(&xw, 0, sizeof xw);
@@ -240,11 +242,10 @@ main(void)
         /* ----------------------------------------- */
 
         /* Draw framebuffer */
-        nk_rawfb_render(rawfb, nk_rgb(30,30,30), 1);
+        n = nk_rawfb_render_damage(rawfb, nk_rgb(30,30,30), &damage);
 
         /* Emulate framebuffer */
-        XClearWindow(xw.dpy, xw.win);
-        nk_xlib_render(xw.win);
+        nk_xlib_render_rects(xw.win, damage, n);
         XFlush(xw.dpy);
 
         /* Timing */
@@ -38,6 +38,7 @@
 NK_API int  nk_xlib_init(Display *dpy, Visual *vis, int screen, Window root, unsigned int w, unsigned int h, void **fb, struct rawfb_pl *pl);
 NK_API int  nk_xlib_handle_event(Display *dpy, int screen, Window win, XEvent *evt, struct rawfb_context *rawfb);
 NK_API void nk_xlib_render(Drawable screen);
+NK_API void nk_xlib_render_rects(Drawable screen, const struct nk_rect *rects, int count);
 NK_API void nk_xlib_shutdown(void);
 
 #endif
@@ -295,5 +296,19 @@ nk_xlib_render(Drawable screen)
     else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg,
             0, 0, 0, 0, xlib.ximg->width, xlib.ximg->height, False);
 }
+
+NK_API void
+nk_xlib_render_rects(Drawable screen, const struct nk_rect *rects, int count)
+{
+    int i;
+    for (i = 0; i < count; ++i) {
+        const int x = (int)rects[i].x, y = (int)rects[i].y;
+        const unsigned int w = (unsigned int)rects[i].w, h = (unsigned int)rects[i].h;
+        if (!w || !h) continue;
+        if (xlib.fallback)
+            XPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h);
+        else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h, False);
+    }
+}
 #endif
 
@@ -203,8 +203,7 @@ main(void)
         /* ----------------------------------------- */
 
         /* Draw */
-        XClearWindow(xw.dpy, xw.win);
-        nk_xlib_render(xw.win, nk_rgb(30,30,30));
+        nk_xlib_render_damage(xw.win, nk_rgb(30,30,30));
         XFlush(xw.dpy);
 
         /* Timing */
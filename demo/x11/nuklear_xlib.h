@@ -19,6 +19,7 @@ typedef struct XFont XFont;
 NK_API struct nk_context*   nk_xlib_init(XFont*, Display*, int scrn, Window root, unsigned w, unsigned h);
 NK_API int                  nk_xlib_handle_event(Display*, int scrn, Window, XEvent*);
 NK_API void                 nk_xlib_render(Drawable screen, struct nk_color clear);
+NK_API void                 nk_xlib_render_damage(Drawable screen, struct nk_color clear);
 NK_API void                 nk_xlib_shutdown(void);
 NK_API void                 nk_xlib_set_font(XFont*);
 NK_API void                 nk_xlib_push_font(XFont*);
@@ -91,6 +92,8 @@ struct XSurface {
     Window root;
     Drawable drawable;
     unsigned int w, h;
+    XRectangle area;
+    XRectangle clip;
 };
 struct XImageWithAlpha {
     XImage* ximage;
@@ -108,6 +111,7 @@ static struct  {
     Atom xa_utf8_string;
 
     struct nk_context ctx;
+    struct nk_damage damage;
     struct XSurface *surf;
     Cursor cursor;
     Display *dpy;
@@ -146,6 +150,9 @@ nk_xsurf_create(int screen, unsigned int w, unsigned int h)
     XSetLineAttributes(xlib.dpy, surface->gc, 1, LineSolid, CapButt, JoinMiter);
     surface->drawable = XCreatePixmap(xlib.dpy, xlib.root, w, h,
         (unsigned int)DefaultDepth(xlib.dpy, screen));
+    surface->area.width = (unsigned short)w;
+    surface->area.height = (unsigned short)h;
+    surface->clip = surface->area;
     return surface;
 }
 
@@ -160,15 +167,30 @@ nk_xsurf_resize(XSurface *surf, unsigned int w, unsigned int h)
         (unsigned int)DefaultDepth(surf->dpy, surf->screen));
 }
 
+NK_INTERN void
+nk_xsurf_area(XSurface *surf, short x, short y, unsigned short w, unsigned short h)
+{
+    /* restricts all drawing to the part of the surface being repainted */
+    surf->area.x = x;
+    surf->area.y = y;
+    surf->area.width = w;
+    surf->area.height = h;
+    surf->clip = surf->area;
+    XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &surf->clip, 1, Unsorted);
+}
+
 NK_INTERN void
 nk_xsurf_scissor(XSurface *surf, float x, float y, float w, float h)
 {
-    XRectangle clip_rect;
-    clip_rect.x = (short)(x-1);
-    clip_rect.y = (short)(y-1);
-    clip_rect.width = (unsigned short)(w+2);
-    clip_rect.height = (unsigned short)(h+2);
-    XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &clip_rect, 1, Unsorted);
+    const int x0 = NK_MAX((short)(x-1), surf->area.x);
+    const int y0 = NK_MAX((short)(y-1), surf->area.y);
+    const int x1 = NK_MIN((short)(x-1) + (int)(w+2), surf->area.x + surf->area.width);
+    const int y1 = NK_MIN((short)(y-1) + (int)(h+2), surf->area.y + surf->area.height);
+    surf->clip.x = (short)x0;
+    surf->clip.y = (short)y0;
+    surf->clip.width = (unsigned short)NK_MAX(x1 - x0, 0);
+    surf->clip.height = (unsigned short)NK_MAX(y1 - y0, 0);
+    XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &surf->clip, 1, Unsorted);
 }
 
 NK_INTERN void
@@ -524,12 +546,19 @@ nk_xsurf_draw_image(XSurface *surf, short x, short y, unsigned short w, unsigned
     NK_UNUSED(col);
 
     if (aimage){
+        /* the clip mask replaces the scissor so only put the visible part */
+        const int x0 = NK_MAX(x, surf->clip.x);
+        const int y0 = NK_MAX(y, surf->clip.y);
+        const int x1 = NK_MIN(x + w, surf->clip.x + surf->clip.width);
+        const int y1 = NK_MIN(y + h, surf->clip.y + surf->clip.height);
+        if (x1 <= x0 || y1 <= y0) return;
         if (aimage->clipMask){
             XSetClipMask(surf->dpy, surf->gc, aimage->clipMask);
             XSetClipOrigin(surf->dpy, surf->gc, x, y);
         }
-        XPutImage(surf->dpy, surf->drawable, surf->gc, aimage->ximage, 0, 0, x, y, w, h);
-        XSetClipMask(surf->dpy, surf->gc, None);
+        XPutImage(surf->dpy, surf->drawable, surf->gc, aimage->ximage,
+            x0 - x, y0 - y, x0, y0, (unsigned)(x1 - x0), (unsigned)(y1 - y0));
+        XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &surf->clip, 1, Unsorted);
     }
 }
 
@@ -662,6 +691,7 @@ nk_xlib_init(XFont *xfont, Display *dpy, int screen, Window root,
 
     xlib.surf = nk_xsurf_create(screen, w, h);
     nk_init_default(&xlib.ctx, font);
+    nk_damage_init_default(&xlib.damage);
     return &xlib.ctx;
 }
 
@@ -827,6 +857,7 @@ nk_xlib_handle_event(Display *dpy, int screen, Window win, XEvent *evt)
         width = (unsigned int)attr.width;
         height = (unsigned int)attr.height;
         nk_xsurf_resize(xlib.surf, width, height);
+        nk_damage_invalidate(&xlib.damage);
         return 1;
     } else if (evt->type == KeymapNotify) {
         XRefreshKeyboardMapping(&evt->xmapping);
@@ -893,11 +924,95 @@ NK_API void
 nk_xlib_shutdown(void)
 {
     nk_xsurf_del(xlib.surf);
+    nk_damage_free(&xlib.damage);
     nk_free(&xlib.ctx);
     XFreeCursor(xlib.dpy, xlib.cursor);
     memset(&xlib, 0, sizeof(xlib));
 }
 
+NK_INTERN void
+nk_xlib_draw_command(XSurface *surf, const struct nk_command *cmd)
+{
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+        nk_xsurf_scissor(surf, s->x, s->y, s->w, s->h);
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+        nk_xsurf_stroke_line(surf, l->begin.x, l->begin.y, l->end.x,
+            l->end.y, l->line_thickness, l->color);
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+        nk_xsurf_stroke_rect(surf, r->x, r->y, NK_MAX(r->w -r->line_thickness, 0),
+            NK_MAX(r->h - r->line_thickness, 0), (unsigned short)r->rounding,
+            r->line_thickness, r->color);
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+        nk_xsurf_fill_rect(surf, r->x, r->y, r->w, r->h,
+            (unsigned short)r->rounding, r->color);
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+        nk_xsurf_stroke_circle(surf, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        nk_xsurf_fill_circle(surf, c->x, c->y, c->w, c->h, c->color);
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *a = (const struct nk_command_arc *)cmd;
+        nk_xsurf_stroke_arc(surf, a->cx, a->cy, a->r, a->a[0], a->a[1], a->line_thickness, a->color);
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
+        nk_xsurf_fill_arc(surf, a->cx, a->cy, a->r, a->a[0], a->a[1], a->color);
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
+        nk_xsurf_stroke_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->line_thickness, t->color);
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+        nk_xsurf_fill_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->color);
+    } break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+        nk_xsurf_stroke_polygon(surf, p->points, p->point_count, p->line_thickness,p->color);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
+        nk_xsurf_fill_polygon(surf, p->points, p->point_count, p->color);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+        nk_xsurf_stroke_polyline(surf, p->points, p->point_count, p->line_thickness, p->color);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        nk_xsurf_draw_text(surf, t->x, t->y, (const char*)t->string, t->length,
+            (XFont*)t->font->userdata.ptr, t->foreground);
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+        nk_xsurf_stroke_curve(surf, q->begin, q->ctrl[0], q->ctrl[1],
+            q->end, 22, q->line_thickness, q->color);
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image *)cmd;
+        nk_xsurf_draw_image(surf, i->x, i->y, i->w, i->h, i->img, i->col);
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR:
+    case NK_COMMAND_CUSTOM:
+    default: break;
+    }
+}
+
 NK_API void
 nk_xlib_render(Drawable screen, struct nk_color clear)
 {
@@ -905,89 +1020,43 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
     struct nk_context *ctx = &xlib.ctx;
     XSurface *surf = xlib.surf;
 
+    nk_xsurf_area(surf, 0, 0, (unsigned short)surf->w, (unsigned short)surf->h);
     nk_xsurf_clear(xlib.surf, nk_color_from_byte(&clear.r));
     nk_foreach(cmd, &xlib.ctx)
-    {
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-            nk_xsurf_scissor(surf, s->x, s->y, s->w, s->h);
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-            nk_xsurf_stroke_line(surf, l->begin.x, l->begin.y, l->end.x,
-                l->end.y, l->line_thickness, l->color);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-            nk_xsurf_stroke_rect(surf, r->x, r->y, NK_MAX(r->w -r->line_thickness, 0),
-                NK_MAX(r->h - r->line_thickness, 0), (unsigned short)r->rounding,
-                r->line_thickness, r->color);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-            nk_xsurf_fill_rect(surf, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->color);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-            nk_xsurf_stroke_circle(surf, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_xsurf_fill_circle(surf, c->x, c->y, c->w, c->h, c->color);
-        } break;
-        case NK_COMMAND_ARC: {
-            const struct nk_command_arc *a = (const struct nk_command_arc *)cmd;
-            nk_xsurf_stroke_arc(surf, a->cx, a->cy, a->r, a->a[0], a->a[1], a->line_thickness, a->color);
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
-            nk_xsurf_fill_arc(surf, a->cx, a->cy, a->r, a->a[0], a->a[1], a->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
-            nk_xsurf_stroke_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->line_thickness, t->color);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-            nk_xsurf_fill_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-            nk_xsurf_stroke_polygon(surf, p->points, p->point_count, p->line_thickness,p->color);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
-            nk_xsurf_fill_polygon(surf, p->points, p->point_count, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-            nk_xsurf_stroke_polyline(surf, p->points, p->point_count, p->line_thickness, p->color);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_xsurf_draw_text(surf, t->x, t->y, (const char*)t->string, t->length,
-                (XFont*)t->font->userdata.ptr, t->foreground);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-            nk_xsurf_stroke_curve(surf, q->begin, q->ctrl[0], q->ctrl[1],
-                q->end, 22, q->line_thickness, q->color);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *i = (const struct nk_command_image *)cmd;
-            nk_xsurf_draw_image(surf, i->x, i->y, i->w, i->h, i->img, i->col);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR:
-        case NK_COMMAND_CUSTOM:
-        default: break;
-        }
-    }
+        nk_xlib_draw_command(surf, cmd);
     nk_clear(ctx);
+    nk_xsurf_area(surf, 0, 0, (unsigned short)surf->w, (unsigned short)surf->h);
     nk_xsurf_blit(screen, surf, surf->w, surf->h);
 }
+
+NK_API void
+nk_xlib_render_damage(Drawable screen, struct nk_color clear)
+{
+    /* Only clears, redraws and copies the parts of the window that changed
+     * since the last frame. The window content has to be kept between
+     * frames, so do not clear the window before calling this. */
+    const struct nk_command *cmd;
+    struct nk_context *ctx = &xlib.ctx;
+    XSurface *surf = xlib.surf;
+    int i, n;
+
+    n = nk_damage_update(&xlib.damage, ctx);
+    for (i = 0; i < n; ++i) {
+        const struct nk_rect *r = &xlib.damage.rects[i];
+        const int x0 = NK_MAX((int)r->x, 0);
+        const int y0 = NK_MAX((int)r->y, 0);
+        const int x1 = NK_MIN((int)(r->x + r->w), (int)surf->w);
+        const int y1 = NK_MIN((int)(r->y + r->h), (int)surf->h);
+        if (x1 <= x0 || y1 <= y0) continue;
+
+        nk_xsurf_area(surf, (short)x0, (short)y0, (unsigned short)(x1 - x0), (unsigned short)(y1 - y0));
+        nk_xsurf_clear(surf, nk_color_from_byte(&clear.r));
+        nk_foreach(cmd, ctx)
+            nk_xlib_draw_command(surf, cmd);
+        nk_xsurf_area(surf, (short)x0, (short)y0, (unsigned short)(x1 - x0), (unsigned short)(y1 - y0));
+        XCopyArea(surf->dpy, surf->drawable, screen, surf->gc, x0, y0,
+            (unsigned)(x1 - x0), (unsigned)(y1 - y0), x0, y0);
+    }
+    nk_clear(ctx);
+}
 #endif
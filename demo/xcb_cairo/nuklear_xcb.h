@@ -117,9 +117,7 @@ struct nk_cairo_context {
     struct nk_user_font *font;
     struct nk_color *bg;
 
-    void *last_buffer;
-    nk_size buffer_size;
-    int repaint;
+    struct nk_damage damage;
 };
 
 struct nk_xcb_context {
@@ -491,9 +489,7 @@ NK_API struct nk_cairo_context *nk_cairo_init(struct nk_color *bg, const char *f
     cairo_ctx->cr = cr;
     cairo_ctx->font = font;
     cairo_ctx->bg = bg;
-    cairo_ctx->last_buffer = NULL;
-    cairo_ctx->buffer_size = 0;
-    cairo_ctx->repaint = nk_false;
+    nk_damage_init_default(&cairo_ctx->damage);
 
     return cairo_ctx;
 }
@@ -510,7 +506,7 @@ NK_API struct nk_user_font *nk_cairo_default_font(struct nk_cairo_context *cairo
 
 NK_API void nk_cairo_free(struct nk_cairo_context *cairo_ctx)
 {
-    free (cairo_ctx->last_buffer);
+    nk_damage_free(&cairo_ctx->damage);
     cairo_destroy(cairo_ctx->cr);
     cairo_surface_destroy(cairo_ctx->surface);
     free(cairo_ctx->font);
@@ -519,31 +515,32 @@ NK_API void nk_cairo_free(struct nk_cairo_context *cairo_ctx)
 
 NK_API void nk_cairo_damage(struct nk_cairo_context *cairo_ctx)
 {
-    cairo_ctx->repaint = nk_true;
+    nk_damage_invalidate(&cairo_ctx->damage);
+}
+
+static void nk_cairo_clip_damage(cairo_t *cr, const struct nk_damage *damage)
+{
+    int i;
+    for (i = 0; i < damage->count; ++i) {
+        const struct nk_rect *r = &damage->rects[i];
+        cairo_rectangle(cr, r->x, r->y, r->w, r->h);
+    }
+    cairo_clip(cr);
 }
 
 NK_API int nk_cairo_render(struct nk_cairo_context *cairo_ctx, struct nk_context *nk_ctx)
 {
     cairo_t *cr;
     const struct nk_command *cmd = NULL;
-    void *cmds = nk_buffer_memory(&nk_ctx->memory);
 
-    if (cairo_ctx->buffer_size != nk_ctx->memory.allocated) {
-        cairo_ctx->buffer_size = nk_ctx->memory.allocated;
-        cairo_ctx->last_buffer = realloc(cairo_ctx->last_buffer, cairo_ctx->buffer_size);
-        memcpy(cairo_ctx->last_buffer, cmds, cairo_ctx->buffer_size);
-    }
-    else if (!memcmp(cmds, cairo_ctx->last_buffer, cairo_ctx->buffer_size)) {
-        if (!cairo_ctx->repaint) {
-            return nk_false;
-        }
-        cairo_ctx->repaint = nk_false;
-    }
-    else {
-        memcpy(cairo_ctx->last_buffer, cmds, cairo_ctx->buffer_size);
+    /* only repaint the parts of the surface that changed */
+    if (!nk_damage_update(&cairo_ctx->damage, nk_ctx)) {
+        return nk_false;
     }
 
     cr = cairo_ctx->cr;
+    cairo_reset_clip(cr);
+    nk_cairo_clip_damage(cr, &cairo_ctx->damage);
     cairo_push_group(cr);
 
     cairo_set_source_rgb(cr, NK_TO_CAIRO(cairo_ctx->bg->r), NK_TO_CAIRO(cairo_ctx->bg->g), NK_TO_CAIRO(cairo_ctx->bg->b));
@@ -557,6 +554,7 @@ NK_API int nk_cairo_render(struct nk_cairo_context *cairo_ctx, struct nk_context
             {
                 const struct nk_command_scissor *s = (const struct nk_command_scissor *)cmd;
                 cairo_reset_clip(cr);
+                nk_cairo_clip_damage(cr, &cairo_ctx->damage);
                 if (s->x >= 0) {
                     cairo_rectangle(cr, s->x - 1, s->y - 1, s->w + 2, s->h + 2);
                     cairo_clip(cr);
@@ -828,6 +826,7 @@ NK_API int nk_cairo_render(struct nk_cairo_context *cairo_ctx, struct nk_context
 
     cairo_pop_group_to_source(cr);
     cairo_paint(cr);
+    cairo_reset_clip(cr);
     cairo_surface_flush(cairo_ctx->surface);
 
     return nk_true;
@@ -109,6 +109,11 @@
 /// NK_ZERO_COMMAND_MEMORY          | Defining this will zero out memory for each drawing command added to a drawing queue (inside nk_command_buffer_push). Zeroing command memory is very useful for fast checking (using memcmp) if command buffers are equal and avoid drawing frames when nothing on screen has changed since previous frame.
 /// NK_UINT_DRAW_INDEX              | Defining this will set the size of vertex index elements when using NK_VERTEX_BUFFER_OUTPUT to 32bit instead of the default of 16bit
 /// NK_KEYSTATE_BASED_INPUT         | Define this if your backend uses key state for each frame rather than key press/release events
+/// NK_INCLUDE_TEXT_WIDTH_CACHE     | Defining this adds a fixed size cache of measured text widths to each context. Labels, titles and property values measured every frame are then only passed to `nk_user_font.width` once. Mainly useful for fonts with expensive width callbacks.
+/// NK_LIGHTWEIGHT_CONTEXT          | Defining this replaces the text editor embedded in each `nk_context` (about 6.6KB, 6.4KB of it the undo arrays) with a pointer. The editor is then allocated the first time an edit or property widget runs, or taken from an `nk_shared_state` shared by all contexts on one thread. `nk_text_edit` no longer embeds the undo arrays either, so editors created by the application start with an empty history that grows from their string allocator and fixed size editors have no undo. Useful when running a large number of contexts. The `NK_*_STACK_SIZE` configuration stacks default to 4 or 8 entries instead of 8 to 32 (about 0.8KB instead of 2.8KB). On 64-bit targets with vertex output a context shrinks from about 20KB to 11.4KB. Most of what is left is `nk_style` (about 9KB), which stays per context because `nk_style_push_*` writes to it.
+/// NK_INCLUDE_VIRTUAL_BUFFER       | If defined it will include `<sys/mman.h>` and `<unistd.h>` (or `<windows.h>` on Windows) and provide `nk_buffer_init_virtual`, a buffer that reserves address space up front and commits pages on demand so it never has to be copied or moved while growing.
+/// NK_NO_SIMD                      | Defining this disables the SSE2 code that `nk_draw_list_stroke_poly_line` uses for normals and miter offsets on x86 targets with SSE2. That code is only used with the built-in `NK_INV_SQRT` and produces the same vertices as the scalar code.
+/// NK_INCLUDE_STATISTICS           | Defining this makes each context count draw commands, command memory per window, pool and frame arena usage, value lookups and `nk_convert` output per frame. Read them with `nk_statistics` or show them with `nk_statistics_window`.
 ///
 /// !!! WARNING
 ///     The following flags will pull in the standard C library:
@@ -117,6 +122,11 @@
 ///     - NK_INCLUDE_STANDARD_VARARGS
 ///
 /// !!! WARNING
+///     NK_INCLUDE_VIRTUAL_BUFFER pulls in operating system headers. On POSIX
+///     systems the implementation defines `_DEFAULT_SOURCE` for `MAP_ANONYMOUS`
+///     and maps `/dev/zero` if system headers included earlier did not provide it.
+///
+/// !!! WARNING
 ///     The following flags if defined need to be defined for both header and implementation:
 ///     - NK_INCLUDE_FIXED_TYPES
 ///     - NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -127,6 +137,10 @@
 ///     - NK_INCLUDE_DEFAULT_FONT
 ///     - NK_INCLUDE_STANDARD_VARARGS
 ///     - NK_INCLUDE_COMMAND_USERDATA
+///     - NK_INCLUDE_TEXT_WIDTH_CACHE
+///     - NK_INCLUDE_VIRTUAL_BUFFER
+///     - NK_LIGHTWEIGHT_CONTEXT
+///     - NK_INCLUDE_STATISTICS
 ///     - NK_UINT_DRAW_INDEX
 ///
 /// ### Constants
@@ -135,12 +149,21 @@
 /// NK_BUFFER_DEFAULT_INITIAL_SIZE  | Initial buffer size allocated by all buffers while using the default allocator functions included by defining NK_INCLUDE_DEFAULT_ALLOCATOR. If you don't want to allocate the default 4k memory then redefine it.
 /// NK_MAX_NUMBER_BUFFER            | Maximum buffer size for the conversion buffer between float and string Under normal circumstances this should be more than sufficient.
 /// NK_INPUT_MAX                    | Defines the max number of bytes which can be added as text input in one frame. Under normal circumstances this should be more than sufficient.
+/// NK_TEXT_WIDTH_CACHE_SIZE        | Number of entries of the text width cache added by NK_INCLUDE_TEXT_WIDTH_CACHE. Needs to be a power of two and at least 4.
+/// NK_FRAME_ARENA_BLOCK_SIZE       | Size of the first block allocated by the frame arena behind `nk_frame_alloc`. Later blocks grow as needed. Defaults to 4k.
+/// NK_BUFFER_VIRTUAL_COMMIT_SIZE   | Minimum number of bytes committed at once by buffers created with `nk_buffer_init_virtual`. Rounded up to the system page size. Defaults to 64k.
+/// NK_STR_GAP_SIZE                 | Minimum number of spare bytes `nk_str` reserves at the edit position when it grows. Defaults to 64.
+/// NK_STR_CHECKPOINT_STRIDE        | Number of runes between the rune offsets `nk_str` remembers to find runes in long text. Define as 0 to not keep them. Defaults to 256.
+/// NK_TEXTEDIT_UNDO_LIMIT          | Maximum number of bytes the undo history of a dynamic `nk_text_edit` allocates before it drops the oldest edits. Can be changed per editor with `undo.limit`. Defaults to 256k.
+/// NK_STATS_MAX_WINDOWS            | Number of windows NK_INCLUDE_STATISTICS keeps per frame counters for. Later windows only count towards the totals. Defaults to 16.
 ///
 /// !!! WARNING
 ///     The following constants if defined need to be defined for both header and implementation:
 ///     - NK_MAX_NUMBER_BUFFER
 ///     - NK_BUFFER_DEFAULT_INITIAL_SIZE
 ///     - NK_INPUT_MAX
+///     - NK_TEXT_WIDTH_CACHE_SIZE
+///     - NK_STATS_MAX_WINDOWS
 ///
 /// ### Dependencies
 /// Function    | Description
@@ -154,6 +177,8 @@
 /// NK_STRTOD   | You can define this to `strtod` or your own string to double conversion implementation replacement. If not defined nuklear will use its own imprecise and possibly unsafe version (does not handle nan or infinity!).
 /// NK_DTOA     | You can define this to `dtoa` or your own double to string conversion implementation replacement. If not defined nuklear will use its own imprecise and possibly unsafe version (does not handle nan or infinity!).
 /// NK_VSNPRINTF| If you define `NK_INCLUDE_STANDARD_VARARGS` as well as `NK_INCLUDE_STANDARD_IO` and want to be safe define this to `vsnprintf` on compilers supporting later versions of C or C++. By default nuklear will check for your stdlib version in C as well as compiler version in C++. if `vsnprintf` is available it will define it to `vsnprintf` directly. If not defined and if you have older versions of C or C++ it will be defined to `vsprintf` which is unsafe.
+/// NK_PROFILE_BEGIN | Opens a named profiling scope. Called with a string literal at the start of `nk_begin`, `nk_end`, `nk_panel_begin`, `nk_build`, `nk_clear`, `nk_convert` (and its cached and parallel variants), each command type converted by them, `nk_font_atlas_bake` and `nk_do_edit`. Scopes nest per thread. Jobs handed out by `nk_convert_parallel` convert commands from whatever thread the dispatcher runs them on, so with a threaded dispatcher both hooks are called concurrently and must be thread safe (e.g. keep the scope stack in thread-local storage). Defaults to nothing. See `demo/common/profiler.c` for an implementation writing Chrome trace files.
+/// NK_PROFILE_END | Closes the innermost scope opened by `NK_PROFILE_BEGIN`. Used as a statement without arguments. Defaults to nothing.
 ///
 /// !!! WARNING
 ///     The following dependencies will pull in the standard C library if not redefined:
@@ -245,6 +270,12 @@ extern "C" {
 #ifndef NK_SCROLLBAR_HIDING_TIMEOUT
   #define NK_SCROLLBAR_HIDING_TIMEOUT 4.0f
 #endif
+#ifndef NK_DAMAGE_MAX_RECTS
+  #define NK_DAMAGE_MAX_RECTS 16
+#endif
+#ifndef NK_TEXT_WIDTH_CACHE_SIZE
+  #define NK_TEXT_WIDTH_CACHE_SIZE 256
+#endif
 /*
  * ==============================================================
  *
@@ -451,12 +482,17 @@ struct nk_allocator;
 struct nk_command_buffer;
 struct nk_draw_command;
 struct nk_convert_config;
+struct nk_convert_cache;
+struct nk_convert_pool;
+struct nk_text_width_cache;
 struct nk_style_item;
 struct nk_text_edit;
 struct nk_draw_list;
 struct nk_user_font;
 struct nk_panel;
 struct nk_context;
+struct nk_shared_state;
+struct nk_stats;
 struct nk_draw_vertex_layout_element;
 struct nk_style_button;
 struct nk_style_toggle;
@@ -675,6 +711,116 @@ NK_API void nk_clear(struct nk_context*);
 /// __ctx__     | Must point to a previously initialized `nk_context` struct
 */
 NK_API void nk_free(struct nk_context*);
+/*/// #### nk_trim
+/// Returns memory pool pages without any live window, panel or table back
+/// to the allocator. Nuklear keeps freed pool elements around for reuse so
+/// a burst of windows or popups otherwise stays allocated until `nk_free`.
+/// Has no effect on contexts initialized with `nk_init_fixed` or a fixed
+/// size pool. Call it between frames, for example after `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_size nk_trim(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns the number of bytes given back to the allocator
+*/
+NK_API nk_size nk_trim(struct nk_context*);
+/*/// #### nk_frame_alloc
+/// Allocates scratch memory that stays valid until the `nk_clear` after
+/// the next one. In other words memory taken while building a frame can
+/// still be used while drawing it and during the following frame.
+/// Allocations are never freed individually. The arena reuses its memory
+/// every other frame and settles on a single block once the frame size
+/// stops growing. `nk_convert` and `nk_convert_cached` take the temporary
+/// normals of anti-aliased strokes and fills from the same arena instead of
+/// the vertex buffer. Returns 0 for contexts initialized with `nk_init_fixed`
+/// or with a fixed size pool.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void *nk_frame_alloc(struct nk_context *ctx, nk_size size, nk_size align);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __size__    | Number of bytes to allocate
+/// __align__   | Required alignment as power of two or 0 for none
+///
+/// Returns a pointer to the allocated memory or 0 on failure
+*/
+NK_API void *nk_frame_alloc(struct nk_context*, nk_size size, nk_size align);
+/*/// #### nk_frame_allocator
+/// Returns an allocator that hands out frame scratch memory from `nk_frame_alloc`.
+/// Its free callback does nothing. You can pass it anywhere nuklear takes an
+/// `nk_allocator`, for example to build a temporary `nk_buffer` or `nk_str`
+/// that is thrown away with the frame.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_allocator nk_frame_allocator(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns an allocator bound to the context's frame arena
+*/
+NK_API struct nk_allocator nk_frame_allocator(struct nk_context*);
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+/*/// #### nk_shared_state_init
+/// Initializes state that may be shared between all contexts used by the
+/// same thread. Only available with NK_LIGHTWEIGHT_CONTEXT. Right now this
+/// is the text editor that edit and property widgets need while they run.
+/// It is allocated on first use.
+///
+/// Most of the remaining per context memory is `nk_style` (about 9KB).
+/// Style stays per context because `nk_style_push_*` and cursor handling
+/// write to it. The configuration stacks use smaller `NK_*_STACK_SIZE`
+/// defaults in this mode.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_shared_state_init(struct nk_shared_state *shared, const struct nk_allocator *alloc);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __shared__  | Must point to an either stack or heap allocated `nk_shared_state` struct
+/// __alloc__   | Must point to a previously allocated memory allocator
+*/
+NK_API void nk_shared_state_init(struct nk_shared_state*, const struct nk_allocator*);
+/*/// #### nk_shared_state_free
+/// Frees memory held by shared state. All contexts using it must no longer
+/// be used afterwards.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_shared_state_free(struct nk_shared_state *shared);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __shared__  | Must point to a previously initialized `nk_shared_state` struct
+*/
+NK_API void nk_shared_state_free(struct nk_shared_state*);
+/*/// #### nk_use_shared_state
+/// Makes a context use shared state instead of allocating its own. Must be
+/// called directly after initializing the context. Contexts sharing state
+/// must not be used from different threads at the same time.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_use_shared_state(struct nk_context *ctx, struct nk_shared_state *shared);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __shared__  | Must point to a previously initialized `nk_shared_state` struct
+*/
+NK_API void nk_use_shared_state(struct nk_context*, struct nk_shared_state*);
+#endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
 /*/// #### nk_set_user_data
 /// Sets the currently passed userdata passed down into each draw command.
@@ -690,6 +836,62 @@ NK_API void nk_free(struct nk_context*);
 */
 NK_API void nk_set_user_data(struct nk_context*, nk_handle handle);
 #endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+/*/// #### nk_text_width_cache_clear
+/// Drops all cached text widths. Entries are keyed by font pointer, font
+/// height and string hash so switching fonts needs no call. Call this if
+/// the metrics behind an existing `nk_user_font` change, for example after
+/// rebaking a font atlas or pointing `userdata` to a different font.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_text_width_cache_clear(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API void nk_text_width_cache_clear(struct nk_context*);
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+/*/// #### nk_statistics
+/// Returns counters collected over the last finished frame. Only available
+/// with NK_INCLUDE_STATISTICS. A frame ends with `nk_clear`, so call this
+/// after `nk_clear` for the frame just drawn. Covers draw commands by type,
+/// command memory in total and per window, pool usage, the frame arena,
+/// persistent value lookups and the output of `nk_convert`. Peak values are
+/// kept across frames.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// const struct nk_stats *nk_statistics(const struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns a pointer to the statistics, valid until the next `nk_clear`
+*/
+NK_API const struct nk_stats *nk_statistics(const struct nk_context*);
+/*/// #### nk_statistics_window
+/// Draws a window showing the statistics of the last finished frame. The
+/// window itself shows up in the numbers like any other window.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_bool nk_statistics_window(struct nk_context *ctx, const char *title, struct nk_rect bounds, nk_flags flags);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __title__   | Window title and identifier
+/// __bounds__  | Initial position and window size
+/// __flags__   | Window flags defined in the nk_panel_flags section
+///
+/// Returns `true(1)` if the window is open and not minimized
+*/
+NK_API nk_bool nk_statistics_window(struct nk_context*, const char *title, struct nk_rect bounds, nk_flags flags);
+#endif
 /* =============================================================================
  *
  *                                  INPUT
@@ -1157,7 +1359,11 @@ NK_API void nk_input_end(struct nk_context*);
 /// __nk__begin__       | Returns the first draw command in the context draw command list to be drawn
 /// __nk__next__        | Increments the draw command iterator to the next command inside the context draw command list
 /// __nk_foreach__      | Iterates over each draw command inside the context draw command list
+/// __nk_frame_digest__ | Returns a hash over all draw commands of the current frame
+/// __nk_frame_dirty__  | Returns if the draw commands of the current frame differ from the last drawn frame
 /// __nk_convert__      | Converts from the abstract draw commands list into a hardware accessible vertex format
+/// __nk_convert_cached__| Same as `nk_convert` but reuses vertices of windows that did not change since the last call
+/// __nk_convert_parallel__| Same as `nk_convert` but tessellates each window as a separate job on a caller supplied worker pool
 /// __nk_draw_begin__   | Returns the first vertex command in the context vertex draw list to be executed
 /// __nk__draw_next__   | Increments the vertex command iterator to the next command inside the context vertex command list
 /// __nk__draw_end__    | Returns the end of the vertex draw list
@@ -1232,6 +1438,43 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// Iterates over each draw command inside the context draw command list
 */
 #define nk_foreach(c, ctx) for((c) = nk__begin(ctx); (c) != 0; (c) = nk__next(ctx,c))
+/*/// #### nk_frame_digest
+/// Returns a hash over all draw commands of the current frame in drawing order.
+/// The hash is accumulated while commands are pushed so calling this function
+/// only combines the hash of each window.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_hash nk_frame_digest(struct nk_context*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+///
+/// Returns the hash of all draw commands or 0 if nothing was drawn
+*/
+NK_API nk_hash nk_frame_digest(struct nk_context*);
+/*/// #### nk_frame_dirty
+/// Checks if the draw commands of the current frame differ from the last frame
+/// that was built with `nk__begin`, `nk_convert` or `nk_frame_digest` before `nk_clear`.
+/// Backends can skip converting, uploading and presenting a frame if it is not dirty.
+/// Frames are compared by the `nk_frame_digest` hash and the total byte size of
+/// all draw commands, so a 32-bit hash collision alone does not hide a change.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_bool nk_frame_dirty(struct nk_context*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+///
+/// Returns `true(1)` if the frame needs to be drawn and `false(0)` if it is equal to the last one
+///
+/// !!! Note
+///     Custom commands are only compared by callback and data pointer.
+*/
+NK_API nk_bool nk_frame_dirty(struct nk_context*);
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
 /*/// #### nk_convert
 /// Converts all internal draw commands into vertex draw commands and fills
@@ -1263,6 +1506,68 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// NK_CONVERT_ELEMENT_BUFFER_FULL  | The provided buffer for storing indices is full or failed to allocate more memory
 */
 NK_API nk_flags nk_convert(struct nk_context*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_cached
+/// Converts all internal draw commands into vertex draw commands like `nk_convert`,
+/// but hashes the draw commands of each window and copies the vertices and indices
+/// of every window whose commands did not change since the previous call out of `cache`
+/// instead of tessellating them again. Windows are compared by two independently
+/// seeded 32-bit hashes over their draw commands. Only windows that changed are converted.
+/// Output is equal to `nk_convert` except that every window starts a new vertex draw command.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_flags nk_convert_cached(struct nk_context *ctx, struct nk_convert_cache *cache, struct nk_buffer *cmds,
+///     struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __cache__   | Must point to a `nk_convert_cache` initialized with `nk_convert_cache_init` and only used with this context
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes
+///
+/// !!! Note
+///     Windows containing `nk_push_custom` commands are always converted. Changing
+///     the `nk_convert_config` between calls invalidates the whole cache.
+///     Text commands only store the `nk_user_font` pointer, so after rebaking a font
+///     atlas or changing glyph metrics behind the same font call
+///     `nk_convert_cache_invalidate` to convert every window on the next call.
+*/
+NK_API nk_flags nk_convert_cached(struct nk_context*, struct nk_convert_cache*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_parallel
+/// Converts all internal draw commands into vertex draw commands like `nk_convert`,
+/// but splits the draw command list on window boundaries into jobs which are
+/// tessellated into separate vertex and index buffers by `pool`. Afterwards the
+/// output of all jobs is appended in order into the given buffers.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_flags nk_convert_parallel(struct nk_context *ctx, struct nk_convert_pool *pool, struct nk_buffer *cmds,
+///     struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __pool__    | Must point to a `nk_convert_pool` initialized with `nk_convert_pool_init`
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes
+///
+/// !!! Note
+///     The dispatch callback of `pool` has to call `nk_convert_job_run` exactly once
+///     for every job it is handed and may only return after all of them finished.
+///     Jobs are independent of each other and can run on any thread, but font width
+///     and glyph queries, `nk_push_custom` callbacks and the `NK_PROFILE_BEGIN`/
+///     `NK_PROFILE_END` hooks will be called from these threads.
+*/
+NK_API nk_flags nk_convert_parallel(struct nk_context*, struct nk_convert_pool*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
 /*/// #### nk__draw_begin
 /// Returns a draw vertex command buffer iterator to iterate over the vertex draw command buffer
 ///
@@ -4101,6 +4406,9 @@ struct nk_font {
     nk_rune fallback_codepoint;
     nk_handle texture;
     struct nk_font_config *config;
+    const nk_ushort *glyph_pages; /* 256 basic plane pages: index into glyph_index + 1 or 0 */
+    const nk_uint *glyph_index; /* 256 entries per page: glyph index + 1 or 0 */
+    float ascii_advance[128]; /* unscaled advance of each ASCII codepoint */
 };
 
 enum nk_font_atlas_format {
@@ -4121,6 +4429,7 @@ struct nk_font_atlas {
 
     int glyph_count;
     struct nk_font_glyph *glyphs;
+    void *glyph_lookup;
     struct nk_font *default_font;
     struct nk_font *fonts;
     struct nk_font_config *config;
@@ -4191,6 +4500,12 @@ NK_API void nk_font_atlas_clear(struct nk_font_atlas*);
 /// NK_INCLUDE_DEFAULT_ALLOCATOR which uses the standard library memory
 /// allocation functions malloc and free and takes over complete control over
 /// memory in this library.
+///
+/// For very large command or vertex buffers NK_INCLUDE_VIRTUAL_BUFFER adds
+/// `nk_buffer_init_virtual`. It reserves address space for the largest size the
+/// buffer may ever reach and only commits pages once they are used. Growing
+/// such a buffer never copies memory and pointers into it stay valid until
+/// `nk_buffer_free`.
 */
 struct nk_memory_status {
     void *memory;
@@ -4203,7 +4518,8 @@ struct nk_memory_status {
 
 enum nk_allocation_type {
     NK_BUFFER_FIXED,
-    NK_BUFFER_DYNAMIC
+    NK_BUFFER_DYNAMIC,
+    NK_BUFFER_VIRTUAL
 };
 
 enum nk_buffer_allocation_type {
@@ -4237,11 +4553,16 @@ struct nk_buffer {
     /* number of allocation calls */
     nk_size size;
     /* current size of the buffer */
+    nk_size committed[NK_BUFFER_MAX];
+    /* bytes backed by pages at the front and back of a virtual buffer */
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_buffer_init_default(struct nk_buffer*);
 #endif
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+NK_API nk_bool nk_buffer_init_virtual(struct nk_buffer*, nk_size reserve);
+#endif
 NK_API void nk_buffer_init(struct nk_buffer*, const struct nk_allocator*, nk_size size);
 NK_API void nk_buffer_init_fixed(struct nk_buffer*, void *memory, nk_size size);
 NK_API void nk_buffer_info(struct nk_memory_status*, struct nk_buffer*);
@@ -4263,10 +4584,37 @@ NK_API nk_size nk_buffer_total(struct nk_buffer*);
  *  to manage and manipulate dynamic or fixed size string content. This is _NOT_
  *  the default string handling method. The only instance you should have any contact
  *  with this API is if you interact with an `nk_text_edit` object inside one of the
- *  copy and paste functions and even there only for more advanced cases. */
+ *  copy and paste functions and even there only for more advanced cases.
+ *
+ *  While the text editor applies the edits of one call it keeps a gap of
+ *  unused bytes at the edit position, so typing several runes, replacing a
+ *  selection or undoing an edit moves the rest of the text only once. Every
+ *  `nk_str_*` and `nk_textedit_*` function closes the gap before it returns,
+ *  so `buffer` always holds the contiguous text and `buffer.allocated` its size.
+ *
+ *  Strings with an allocator also remember the text offset of every
+ *  NK_STR_CHECKPOINT_STRIDE-th rune, so finding a rune only decodes the text
+ *  between the closest two checkpoints instead of the whole string. Only
+ *  inserts, deletes and `nk_str_at_rune` add checkpoints, the const lookups
+ *  `nk_str_at_const` and `nk_str_rune_at` use them but never allocate. */
+struct nk_str_checkpoint {
+    int rune;
+    nk_size offset;
+};
 struct nk_str {
     struct nk_buffer buffer;
     int len; /* in codepoints/runes/glyphs */
+    /* text is [0, gap_begin) followed by [gap_begin + gap_size, buffer.allocated) */
+    nk_size gap_begin;
+    nk_size gap_size;
+    int gap_rune; /* rune index of `gap_begin` while the gap is open */
+    /* sorted by rune, allocated from `buffer.pool` */
+    struct nk_str_checkpoint *checkpoints;
+    int checkpoint_count;
+    int checkpoint_capacity;
+    /* text range edited since the text editor last looked, empty if begin > end */
+    nk_size changed_begin;
+    nk_size changed_end;
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -4347,6 +4695,10 @@ NK_API int nk_str_len_char(struct nk_str*);
 #define NK_TEXTEDIT_UNDOCHARCOUNT      999
 #endif
 
+#ifndef NK_TEXTEDIT_UNDO_LIMIT
+#define NK_TEXTEDIT_UNDO_LIMIT         (256*1024)
+#endif
+
 struct nk_text_edit;
 struct nk_clipboard {
     nk_handle userdata;
@@ -4356,18 +4708,39 @@ struct nk_clipboard {
 
 struct nk_text_undo_record {
    int where;
-   short insert_length;
-   short delete_length;
-   short char_storage;
+   int insert_length; /* runes inserted by the edit */
+   int delete_length; /* runes removed by the edit */
+   nk_size char_storage; /* removed runes in the char ring */
 };
 
+/* The history is a ring of records with the oldest at `record_begin`.
+ * Records before `undo_point` can be undone, the ones after it redone.
+ * Runes removed by each edit are kept in a second ring in record order,
+ * followed by a stack with the inserted runes of undone edits. Both
+ * rings start out in the arrays below and move into memory from the
+ * string allocator once they fill up, until `limit` bytes are used.
+ * After that the oldest records are dropped. With NK_LIGHTWEIGHT_CONTEXT
+ * the arrays are not embedded. Only the context's own editor points them
+ * at memory behind itself, all other editors start out empty. */
 struct nk_text_undo_state {
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+   struct nk_text_undo_record *undo_rec;
+   nk_rune *undo_char;
+#else
    struct nk_text_undo_record undo_rec[NK_TEXTEDIT_UNDOSTATECOUNT];
    nk_rune undo_char[NK_TEXTEDIT_UNDOCHARCOUNT];
-   short undo_point;
-   short redo_point;
-   short undo_char_point;
-   short redo_char_point;
+#endif
+   struct nk_text_undo_record *records; /* 0 while `undo_rec` is used */
+   nk_rune *chars; /* 0 while `undo_char` is used */
+   nk_size record_capacity;
+   nk_size char_capacity;
+   nk_size record_begin;
+   nk_size record_end;
+   nk_size undo_point;
+   nk_size char_begin;
+   nk_size char_end;
+   nk_size limit; /* 0 uses NK_TEXTEDIT_UNDO_LIMIT */
+   nk_rune coalesce; /* last rune typed into the newest record or 0 */
 };
 
 enum nk_text_edit_type {
@@ -4381,6 +4754,23 @@ enum nk_text_edit_mode {
     NK_TEXT_EDIT_MODE_REPLACE
 };
 
+struct nk_text_edit_line {
+    nk_size offset; /* text offset of the first byte */
+    int rune; /* rune index of the first rune */
+    float width;
+};
+
+struct nk_text_edit_lines {
+    struct nk_text_edit_line *line; /* allocated from `string.buffer.pool` */
+    int count;
+    int capacity;
+    float width; /* of the widest line */
+    nk_size text_len; /* text the lines were measured for */
+    int rune_len;
+    const struct nk_user_font *font;
+    float font_height;
+};
+
 struct nk_text_edit {
     struct nk_clipboard clip;
     struct nk_str string;
@@ -4399,6 +4789,7 @@ struct nk_text_edit {
     unsigned char padding1;
     float preferred_x;
     struct nk_text_undo_state undo;
+    struct nk_text_edit_lines lines;
 };
 
 /* filter function */
@@ -4672,6 +5063,13 @@ struct nk_command_buffer {
     int use_clipping;
     nk_handle userdata;
     nk_size begin, end, last;
+    nk_hash digest;
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache *text_cache;
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+    struct nk_stats *stats; /* counts pushed commands by type */
+#endif
 };
 
 /* shape outlines */
@@ -4699,6 +5097,35 @@ NK_API void nk_draw_text(struct nk_command_buffer*, struct nk_rect, const char *
 NK_API void nk_push_scissor(struct nk_command_buffer*, struct nk_rect);
 NK_API void nk_push_custom(struct nk_command_buffer*, struct nk_rect, nk_command_custom_callback, nk_handle usr);
 
+/* damage tracking
+ *  Compares the hash and screen bounds of each draw command with the
+ *  previous frame and returns the screen areas which have to be repainted.
+ *  Software renderers can restrict clearing, drawing and presenting to
+ *  `rects` instead of redrawing the whole screen every frame. If `rects`
+ *  contains `nk_null_rect` everything has to be repainted, which happens
+ *  for the first frame and after `nk_damage_invalidate`. */
+struct nk_damage {
+    struct nk_buffer commands[2];
+    /* hash and screen bounds of each draw command of the last two frames */
+    unsigned int command_count[2];
+    /* number of draw commands inside each buffer */
+    struct nk_rect rects[NK_DAMAGE_MAX_RECTS];
+    /* screen areas that changed since the last update */
+    int count;
+    /* number of screen areas inside `rects` */
+    unsigned int seq;
+    /* number of updates done */
+    int invalid;
+    /* repaint everything on the next update */
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_damage_init_default(struct nk_damage*);
+#endif
+NK_API void nk_damage_init(struct nk_damage*, const struct nk_allocator*);
+NK_API void nk_damage_free(struct nk_damage*);
+NK_API void nk_damage_invalidate(struct nk_damage*);
+NK_API int nk_damage_update(struct nk_damage*, struct nk_context*);
+
 /* ===============================================================
  *
  *                          INPUT
@@ -4841,10 +5268,13 @@ struct nk_draw_command {
 #endif
 };
 
+typedef void*(*nk_draw_vertex_writer)(void *dst, const struct nk_draw_list*, struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color);
 struct nk_draw_list {
     struct nk_rect clip_rect;
     struct nk_vec2 circle_vtx[12];
     struct nk_convert_config config;
+    nk_draw_vertex_writer vertex_writer;
+    nk_size vertex_offsets[NK_VERTEX_ATTRIBUTE_COUNT];
 
     struct nk_buffer *buffer;
     struct nk_buffer *vertices;
@@ -4858,6 +5288,12 @@ struct nk_draw_list {
     unsigned int path_count;
     unsigned int path_offset;
 
+    /* temporary normals of anti-aliased strokes and fills. Taken from the
+     * frame arena when set, otherwise from the back of `vertices` */
+    struct nk_frame_arena *scratch_arena;
+    void *scratch;
+    nk_size scratch_size;
+
     enum nk_anti_aliasing line_AA;
     enum nk_anti_aliasing shape_AA;
 
@@ -4866,6 +5302,65 @@ struct nk_draw_list {
 #endif
 };
 
+struct nk_convert_cache {
+    struct nk_buffer memory[2];
+    /* vertices, indices and draw commands of the last two conversions */
+    struct nk_convert_config config;
+    /* configuration used by the last conversion */
+    unsigned int seq;
+    /* number of conversions done with this cache */
+    unsigned int reused;
+    /* number of windows copied from the cache by the last conversion */
+    unsigned int converted;
+    /* number of windows tessellated by the last conversion */
+    int invalid;
+    /* convert every window on the next conversion */
+};
+
+/* convert cache */
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_cache_init_default(struct nk_convert_cache*);
+#endif
+NK_API void nk_convert_cache_init(struct nk_convert_cache*, const struct nk_allocator*);
+NK_API void nk_convert_cache_free(struct nk_convert_cache*);
+NK_API void nk_convert_cache_invalidate(struct nk_convert_cache*);
+
+struct nk_convert_job {
+    struct nk_context *ctx;
+    const struct nk_command *begin;
+    const struct nk_command *end;
+    /* draw commands to convert excluding `end` */
+    struct nk_rect clip;
+    /* clip rect left by the draw commands before `begin` */
+    struct nk_draw_list list;
+    struct nk_buffer cmds;
+    struct nk_buffer vertices;
+    struct nk_buffer elements;
+    /* private output of the job */
+    nk_flags result;
+    /* enum nk_convert_result of the job */
+};
+
+typedef void(*nk_convert_dispatch)(nk_handle userdata, struct nk_convert_job *jobs, int count);
+struct nk_convert_pool {
+    nk_handle userdata;
+    nk_convert_dispatch dispatch;
+    /* runs `nk_convert_job_run` for all jobs and returns once all are done.
+     * Jobs are run one after another on the calling thread if null */
+    struct nk_allocator alloc;
+    struct nk_convert_job *jobs;
+    int count;
+    int capacity;
+};
+
+/* convert pool */
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_pool_init_default(struct nk_convert_pool*, nk_convert_dispatch, nk_handle userdata);
+#endif
+NK_API void nk_convert_pool_init(struct nk_convert_pool*, const struct nk_allocator*, nk_convert_dispatch, nk_handle userdata);
+NK_API void nk_convert_pool_free(struct nk_convert_pool*);
+NK_API void nk_convert_job_run(struct nk_convert_job*);
+
 /* draw list */
 NK_API void nk_draw_list_init(struct nk_draw_list*);
 NK_API void nk_draw_list_setup(struct nk_draw_list*, const struct nk_convert_config*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, enum nk_anti_aliasing line_aa,enum nk_anti_aliasing shape_aa);
@@ -5548,12 +6043,53 @@ struct nk_property_state {
     int state;
 };
 
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+struct nk_convert_cache_state {
+    nk_hash hash[2];
+    unsigned int seq;
+    struct nk_rect clip;
+    nk_size cmd_offset;
+    nk_size vertex_offset;
+    nk_size element_offset;
+    unsigned int cmd_count;
+    unsigned int vertex_count;
+    unsigned int element_count;
+};
+#endif
+
+struct nk_value_slot {
+    nk_hash key;
+    unsigned int index; /* value index inside `tbl` or 1 for deleted slots */
+    struct nk_table *tbl; /* table page holding the value or 0 if unused */
+};
+
+struct nk_value_index {
+    /* open addressing index over the window's table pages. Growing
+     * allocates a new slot array and moves `old` over incrementally */
+    struct nk_value_slot *slots;
+    struct nk_value_slot *old;
+    unsigned int size, used, live;
+    unsigned int old_size, migrated;
+    /* windows owning index memory, freed in `nk_free` */
+    struct nk_window *next, *prev;
+};
+
+struct nk_window_state {
+    struct nk_property_state property;
+    struct nk_edit_state edit;
+};
+
 struct nk_window {
+    /* fields touched by every window list walk come first */
     unsigned int seq;
     nk_hash name;
-    char name_string[NK_WINDOW_MAX_NAME];
     nk_flags flags;
 
+    /* window list hooks */
+    struct nk_window *next;
+    struct nk_window *prev;
+    struct nk_window *parent;
+
     struct nk_rect bounds;
     struct nk_scroll scrollbar;
     struct nk_command_buffer buffer;
@@ -5561,19 +6097,22 @@ struct nk_window {
     float scrollbar_hiding_timer;
 
     /* persistent widget state */
-    struct nk_property_state property;
     struct nk_popup_state popup;
-    struct nk_edit_state edit;
+    struct nk_window_state *state; /* allocated by the first edit or property */
     unsigned int scrolled;
     nk_bool widgets_disabled;
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    struct nk_convert_cache_state convert_cache;
+#endif
 
     struct nk_table *tables;
     unsigned int table_count;
-
-    /* window list hooks */
-    struct nk_window *next;
-    struct nk_window *prev;
-    struct nk_window *parent;
+    struct nk_value_index values;
+#ifdef NK_INCLUDE_STATISTICS
+    unsigned int value_lookups;
+    unsigned int value_probes;
+#endif
+    char name_string[NK_WINDOW_MAX_NAME];
 };
 
 /*==============================================================
@@ -5600,35 +6139,64 @@ struct nk_window {
 ///
 /// Nuklear has a stack for style_items, float properties, vector properties,
 /// flags, colors, fonts and for button_behavior. Each has it's own fixed size stack
-/// which can be changed at compile time.
+/// which can be changed at compile time. With NK_LIGHTWEIGHT_CONTEXT the stacks
+/// default to 4 or 8 entries instead of 8 to 32.
  */
 #ifndef NK_BUTTON_BEHAVIOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_BUTTON_BEHAVIOR_STACK_SIZE 4
+#else
 #define NK_BUTTON_BEHAVIOR_STACK_SIZE 8
 #endif
+#endif
 
 #ifndef NK_FONT_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FONT_STACK_SIZE 4
+#else
 #define NK_FONT_STACK_SIZE 8
 #endif
+#endif
 
 #ifndef NK_STYLE_ITEM_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_STYLE_ITEM_STACK_SIZE 4
+#else
 #define NK_STYLE_ITEM_STACK_SIZE 16
 #endif
+#endif
 
 #ifndef NK_FLOAT_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FLOAT_STACK_SIZE 8
+#else
 #define NK_FLOAT_STACK_SIZE 32
 #endif
+#endif
 
 #ifndef NK_VECTOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_VECTOR_STACK_SIZE 4
+#else
 #define NK_VECTOR_STACK_SIZE 16
 #endif
+#endif
 
 #ifndef NK_FLAGS_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FLAGS_STACK_SIZE 8
+#else
 #define NK_FLAGS_STACK_SIZE 32
 #endif
+#endif
 
 #ifndef NK_COLOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_COLOR_STACK_SIZE 8
+#else
 #define NK_COLOR_STACK_SIZE 32
 #endif
+#endif
 
 #define NK_CONFIGURATION_STACK_TYPE(prefix, name, type)\
     struct nk_config_stack_##name##_element {\
@@ -5686,16 +6254,27 @@ union nk_page_data {
     struct nk_table tbl;
     struct nk_panel pan;
     struct nk_window win;
+    struct nk_window_state state;
 };
 
+enum nk_page_element_type {
+    NK_PAGE_ELEMENT_WINDOW,
+    NK_PAGE_ELEMENT_WINDOW_STATE,
+    NK_PAGE_ELEMENT_PANEL,
+    NK_PAGE_ELEMENT_TABLE
+};
+
+/* pool slots are cut to the size of the stored type, so `data` must come last */
 struct nk_page_element {
-    union nk_page_data data;
     struct nk_page_element *next;
     struct nk_page_element *prev;
+    struct nk_page *page; /* owning pool page or 0 */
+    union nk_page_data data;
 };
 
 struct nk_page {
-    unsigned int size;
+    unsigned int size; /* elements handed out so far */
+    unsigned int used; /* elements currently alive */
     struct nk_page *next;
     struct nk_page_element win[1];
 };
@@ -5707,42 +6286,150 @@ struct nk_pool {
     struct nk_page *pages;
     struct nk_page_element *freelist;
     unsigned capacity;
+    nk_size element_size;
     nk_size size;
     nk_size cap;
+    /* element counters */
+    unsigned int live_count;
+    unsigned int free_count;
+    unsigned int peak_count;
 };
 
-struct nk_context {
-/* public: can be accessed freely */
-    struct nk_input input;
-    struct nk_style style;
-    struct nk_buffer memory;
-    struct nk_clipboard clip;
-    nk_flags last_widget_state;
-    enum nk_button_behavior button_behavior;
-    struct nk_configuration_stacks stacks;
-    float delta_time_seconds;
-
-/* private:
-    should only be accessed if you
-    know what you are doing */
-#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    struct nk_draw_list draw_list;
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+struct nk_shared_state {
+    struct nk_allocator alloc;
+    struct nk_text_edit *text_edit; /* allocated on first use */
+};
 #endif
-#ifdef NK_INCLUDE_COMMAND_USERDATA
+
+struct nk_frame_block {
+    struct nk_frame_block *next;
+    nk_size size; /* usable bytes following the header */
+    nk_size used;
+};
+
+struct nk_frame_arena {
+    struct nk_allocator alloc;
+    struct nk_frame_block *blocks[2]; /* newest block first */
+    unsigned int current; /* blocks of the frame being built */
+    nk_size used; /* bytes handed out this frame */
+    nk_size peak; /* largest frame so far */
+};
+
+#ifdef NK_INCLUDE_STATISTICS
+#ifndef NK_STATS_MAX_WINDOWS
+#define NK_STATS_MAX_WINDOWS 16
+#endif
+struct nk_window_stats {
+    char name[NK_WINDOW_MAX_NAME];
+    nk_hash hash;
+    nk_size command_bytes;
+    unsigned int vertices; /* written by nk_convert */
+    unsigned int elements;
+};
+
+struct nk_stats {
+    /* draw commands */
+    unsigned int commands[NK_COMMAND_CUSTOM+1]; /* indexed by nk_command_type */
+    unsigned int command_count;
+    nk_size command_memory;
+    nk_size command_needed;
+    nk_size command_capacity;
+    nk_size command_peak;
+    /* windows with commands, in draw order, until NK_STATS_MAX_WINDOWS */
+    struct nk_window_stats windows[NK_STATS_MAX_WINDOWS];
+    unsigned int window_count;
+    /* window, state, panel and table pools together */
+    unsigned int pool_pages;
+    unsigned int pool_live;
+    unsigned int pool_free;
+    unsigned int pool_peak;
+    nk_size pool_memory;
+    /* frame arena */
+    nk_size frame_memory;
+    nk_size frame_peak;
+    /* `nk_find_value` lookups and compared keys */
+    unsigned int value_lookups;
+    unsigned int value_probes;
+    /* nk_convert output */
+    unsigned int vertices;
+    unsigned int elements;
+    unsigned int draw_commands;
+    unsigned int vertex_peak;
+    unsigned int element_peak;
+};
+#endif
+
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+#define NK_TEXT_WIDTH_CACHE_WAYS 4
+struct nk_text_width_entry {
+    const struct nk_user_font *font;
+    nk_hash hash;
+    int len;
+    float height;
+    float width;
+    int referenced;
+};
+struct nk_text_width_cache {
+    /* set associative: each string hash maps to a set of
+     * NK_TEXT_WIDTH_CACHE_WAYS entries replaced in clock order */
+    struct nk_text_width_entry entries[NK_TEXT_WIDTH_CACHE_SIZE];
+    nk_byte hand[NK_TEXT_WIDTH_CACHE_SIZE / NK_TEXT_WIDTH_CACHE_WAYS];
+};
+#endif
+
+struct nk_context {
+/* public: can be accessed freely */
+    struct nk_input input;
+    struct nk_style style;
+    struct nk_buffer memory;
+    struct nk_clipboard clip;
+    nk_flags last_widget_state;
+    enum nk_button_behavior button_behavior;
+    struct nk_configuration_stacks stacks;
+    float delta_time_seconds;
+
+/* private:
+    should only be accessed if you
+    know what you are doing */
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    struct nk_draw_list draw_list;
+#endif
+#ifdef NK_INCLUDE_COMMAND_USERDATA
     nk_handle userdata;
+#endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache text_cache;
 #endif
     /* text editor objects are quite big because of an internal
      * undo/redo stack. Therefore it does not make sense to have one for
      * each window for temporary use cases, so I only provide *one* instance
      * for all windows. This works because the content is cleared anyway */
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    struct nk_text_edit *text_edit;
+    struct nk_shared_state *shared;
+#else
     struct nk_text_edit text_edit;
+#endif
     /* draw buffer used for overlay drawing operation like cursor */
     struct nk_command_buffer overlay;
 
+    /* hash and byte size of all draw commands of the current and last drawn
+     * frame. Together they form the 64-bit key `nk_frame_dirty` compares */
+    nk_hash digest;
+    nk_hash last_digest;
+    nk_size digest_size;
+    nk_size last_digest_size;
+    int has_last_digest;
+
     /* windows */
     int build;
     int use_pool;
-    struct nk_pool pool;
+    struct nk_pool pool; /* windows, or every element for a fixed pool */
+    struct nk_pool state_pool;
+    struct nk_pool panel_pool;
+    struct nk_pool table_pool;
+    struct nk_frame_arena frame;
     struct nk_window *begin;
     struct nk_window *end;
     struct nk_window *active;
@@ -5750,6 +6437,20 @@ struct nk_context {
     struct nk_page_element *freelist;
     unsigned int count;
     unsigned int seq;
+
+    /* open addressing index from window name hash to windows in the list */
+    struct nk_window **window_index;
+    unsigned int window_index_size;
+    unsigned int window_index_count;
+    struct nk_window *value_index_owners;
+
+#ifdef NK_INCLUDE_STATISTICS
+    struct nk_stats stats; /* last finished frame */
+    struct nk_stats stats_frame; /* frame being built */
+    struct nk_window *stats_owner; /* window receiving converted vertices */
+    unsigned int stats_vertex_begin;
+    unsigned int stats_element_begin;
+#endif
 };
 
 /* ==============================================================
@@ -5849,6 +6550,22 @@ template<typename T> struct nk_alignof{struct Big {T x; char c;}; enum {
 #define NK_BUFFER_DEFAULT_INITIAL_SIZE (4*1024)
 #endif
 
+#ifndef NK_FRAME_ARENA_BLOCK_SIZE
+#define NK_FRAME_ARENA_BLOCK_SIZE (4*1024)
+#endif
+
+#ifndef NK_BUFFER_VIRTUAL_COMMIT_SIZE
+#define NK_BUFFER_VIRTUAL_COMMIT_SIZE (64*1024)
+#endif
+
+#ifndef NK_STR_GAP_SIZE
+#define NK_STR_GAP_SIZE 64
+#endif
+
+#ifndef NK_STR_CHECKPOINT_STRIDE
+#define NK_STR_CHECKPOINT_STRIDE 256
+#endif
+
 /* standard library headers */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 #include <stdlib.h> /* malloc, free */
@@ -5859,11 +6576,44 @@ template<typename T> struct nk_alignof{struct Big {T x; char c;}; enum {
 #ifdef NK_INCLUDE_STANDARD_VARARGS
 #include <stdarg.h> /* valist, va_start, va_end, ... */
 #endif
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+#ifdef _WIN32
+#include <windows.h> /* VirtualAlloc, VirtualFree, GetSystemInfo */
+#else
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS on glibc with -std=c89 */
+#endif
+#include <sys/mman.h> /* mmap, mprotect, munmap */
+#include <unistd.h> /* sysconf, close */
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_ANONYMOUS
+#include <fcntl.h> /* open */
+#endif
+#endif
+#endif
 #ifndef NK_ASSERT
 #include <assert.h>
 #define NK_ASSERT(expr) assert(expr)
 #endif
 
+/* SSE2 paths reproduce the scalar results bit for bit, which includes the
+ * approximation of the built-in inverse square root */
+#if !defined(NK_NO_SIMD) && !defined(NK_INV_SQRT) &&\
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h> /* SSE2 intrinsics */
+#define NK_SIMD_SSE2
+#endif
+
+/* profiling hooks around expensive regions, no-ops unless defined */
+#ifndef NK_PROFILE_BEGIN
+#define NK_PROFILE_BEGIN(name)
+#endif
+#ifndef NK_PROFILE_END
+#define NK_PROFILE_END
+#endif
+
 #define NK_DEFAULT (-1)
 
 #ifndef NK_VSNPRINTF
@@ -5894,6 +6644,7 @@ template<typename T> struct nk_alignof{struct Big {T x; char c;}; enum {
 #define NK_SINT_MAX 2147483647
 #define NK_UINT_MIN 0
 #define NK_UINT_MAX 4294967295u
+#define NK_SIZE_MAX ((nk_size)-1)
 
 /* Make sure correct type size:
  * This will fire with a negative subscript error if the type sizes
@@ -5901,6 +6652,10 @@ template<typename T> struct nk_alignof{struct Big {T x; char c;}; enum {
 NK_STATIC_ASSERT(sizeof(nk_size) >= sizeof(void*));
 NK_STATIC_ASSERT(sizeof(nk_ptr) == sizeof(void*));
 NK_STATIC_ASSERT(sizeof(nk_flags) >= 4);
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+NK_STATIC_ASSERT(!(NK_TEXT_WIDTH_CACHE_SIZE & (NK_TEXT_WIDTH_CACHE_SIZE - 1)));
+NK_STATIC_ASSERT(NK_TEXT_WIDTH_CACHE_SIZE >= NK_TEXT_WIDTH_CACHE_WAYS);
+#endif
 NK_STATIC_ASSERT(sizeof(nk_rune) >= 4);
 NK_STATIC_ASSERT(sizeof(nk_ushort) == 2);
 NK_STATIC_ASSERT(sizeof(nk_short) == 2);
@@ -5962,6 +6717,7 @@ NK_LIB void* nk_memcopy(void *dst, const void *src, nk_size n);
 #ifndef NK_MEMSET
 NK_LIB void nk_memset(void *ptr, int c0, nk_size size);
 #endif
+NK_LIB void nk_memmove(void *dst, const void *src, nk_size n);
 NK_LIB void nk_zero(void *ptr, nk_size size);
 NK_LIB char *nk_itoa(char *s, long n);
 NK_LIB int nk_string_float_limit(char *string, int prec);
@@ -5986,10 +6742,26 @@ NK_LIB void* nk_buffer_align(void *unaligned, nk_size align, nk_size *alignment,
 NK_LIB void* nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type, nk_size size, nk_size align);
 NK_LIB void* nk_buffer_realloc(struct nk_buffer *b, nk_size capacity, nk_size *size);
 
+/* string */
+NK_LIB void nk_str_close_gap(struct nk_str *s);
+NK_LIB int nk_str_edit_insert_utf8(struct nk_str*, int pos, const char *text, int len);
+NK_LIB int nk_str_edit_insert_runes(struct nk_str*, int pos, const nk_rune *runes, int len);
+NK_LIB void nk_str_edit_delete_runes(struct nk_str*, int pos, int len);
+
 /* draw */
 NK_LIB void nk_command_buffer_init(struct nk_command_buffer *cb, struct nk_buffer *b, enum nk_command_clipping clip);
 NK_LIB void nk_command_buffer_reset(struct nk_command_buffer *b);
 NK_LIB void* nk_command_buffer_push(struct nk_command_buffer* b, enum nk_command_type t, nk_size size);
+NK_LIB nk_size nk_command_size(const struct nk_command *cmd);
+NK_LIB nk_hash nk_command_hash(const struct nk_command *cmd, nk_hash seed);
+NK_LIB struct nk_rect nk_command_bounds(const struct nk_command *cmd);
+NK_LIB nk_hash nk_command_buffer_digest(const struct nk_command_buffer *b);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_LIB nk_draw_vertex_writer nk_draw_vertex_writer_select(struct nk_draw_list *list);
+#ifdef NK_INCLUDE_FONT_BAKING
+NK_LIB struct nk_font *nk_font_from_user_font(const struct nk_user_font *font);
+#endif
+#endif
 NK_LIB void nk_draw_symbol(struct nk_command_buffer *out, enum nk_symbol_type type, struct nk_rect content, struct nk_color background, struct nk_color foreground, float border_width, const struct nk_user_font *font);
 
 /* buffering */
@@ -6015,19 +6787,47 @@ enum nk_window_insert_location {
 NK_LIB void *nk_create_window(struct nk_context *ctx);
 NK_LIB void nk_remove_window(struct nk_context*, struct nk_window*);
 NK_LIB void nk_free_window(struct nk_context *ctx, struct nk_window *win);
+NK_LIB struct nk_window_state *nk_window_acquire_state(struct nk_context *ctx, struct nk_window *win);
 NK_LIB struct nk_window *nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name);
 NK_LIB void nk_insert_window(struct nk_context *ctx, struct nk_window *win, enum nk_window_insert_location loc);
+NK_LIB void nk_window_index_clear(struct nk_context *ctx);
+NK_LIB void nk_window_index_free(struct nk_context *ctx);
 
 /* pool */
-NK_LIB void nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc, unsigned int capacity);
+NK_LIB void nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc, unsigned int capacity, nk_size element_size);
 NK_LIB void nk_pool_free(struct nk_pool *pool);
 NK_LIB void nk_pool_init_fixed(struct nk_pool *pool, void *memory, nk_size size);
 NK_LIB struct nk_page_element *nk_pool_alloc(struct nk_pool *pool);
+NK_LIB void nk_pool_free_element(struct nk_pool *pool, struct nk_page_element *elem);
+NK_LIB nk_size nk_pool_trim(struct nk_pool *pool);
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB nk_size nk_pool_memory(const struct nk_pool *pool);
+#endif
 
 /* page-element */
-NK_LIB struct nk_page_element* nk_create_page_element(struct nk_context *ctx);
+/* context */
+NK_LIB struct nk_text_edit *nk_context_text_edit(struct nk_context *ctx);
+
+/* frame arena */
+NK_LIB void nk_frame_arena_init(struct nk_frame_arena *arena, const struct nk_allocator *alloc);
+NK_LIB void nk_frame_arena_flip(struct nk_frame_arena *arena);
+NK_LIB void *nk_frame_arena_alloc(struct nk_frame_arena *arena, nk_size size, nk_size align);
+NK_LIB void nk_frame_arena_free(struct nk_frame_arena *arena);
+
+/* statistics */
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB void nk_stats_end_frame(struct nk_context *ctx);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_LIB void nk_stats_convert_begin(struct nk_context *ctx);
+NK_LIB void nk_stats_convert_command(struct nk_context *ctx, const struct nk_command *cmd);
+NK_LIB void nk_stats_convert_end(struct nk_context *ctx);
+#endif
+#endif
+
+NK_LIB nk_size nk_page_element_size(enum nk_page_element_type type);
+NK_LIB struct nk_page_element* nk_create_page_element(struct nk_context *ctx, enum nk_page_element_type type);
 NK_LIB void nk_link_page_element_into_freelist(struct nk_context *ctx, struct nk_page_element *elem);
-NK_LIB void nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem);
+NK_LIB void nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem, enum nk_page_element_type type);
 
 /* table */
 NK_LIB struct nk_table* nk_create_table(struct nk_context *ctx);
@@ -6036,6 +6836,8 @@ NK_LIB void nk_free_table(struct nk_context *ctx, struct nk_table *tbl);
 NK_LIB void nk_push_table(struct nk_window *win, struct nk_table *tbl);
 NK_LIB nk_uint *nk_add_value(struct nk_context *ctx, struct nk_window *win, nk_hash name, nk_uint value);
 NK_LIB nk_uint *nk_find_value(struct nk_window *win, nk_hash name);
+NK_LIB void nk_value_index_step(struct nk_context *ctx, struct nk_window *win);
+NK_LIB void nk_value_index_free(struct nk_context *ctx, struct nk_window *win);
 
 /* panel */
 NK_LIB void *nk_create_panel(struct nk_context *ctx);
@@ -6067,6 +6869,7 @@ struct nk_text {
     struct nk_color background;
     struct nk_color text;
 };
+NK_LIB float nk_text_width(struct nk_command_buffer *o, const struct nk_user_font *f, const char *string, int len);
 NK_LIB void nk_widget_text(struct nk_command_buffer *o, struct nk_rect b, const char *string, int len, const struct nk_text *t, nk_flags a, const struct nk_user_font *f);
 NK_LIB void nk_widget_text_wrap(struct nk_command_buffer *o, struct nk_rect b, const char *string, int len, const struct nk_text *t, const struct nk_user_font *f);
 
@@ -6584,6 +7387,30 @@ done:
     return (dst0);
 }
 #endif
+NK_LIB void
+nk_memmove(void *dst0, const void *src0, nk_size length)
+{
+    /* NK_MEMCPY may be a plain memcpy, so overlapping ranges are copied
+     * in pieces no larger than the distance between them */
+    char *dst = (char*)dst0;
+    const char *src = (const char*)src0;
+    nk_size dist, n;
+    if (!length || dst == src) return;
+    dist = (dst < src) ? (nk_size)(src - dst): (nk_size)(dst - src);
+    if (dist >= length) {
+        NK_MEMCPY(dst, src, length);
+    } else if (dst < src) {
+        for (; length; length -= n, dst += n, src += n) {
+            n = NK_MIN(dist, length);
+            NK_MEMCPY(dst, src, n);
+        }
+    } else {
+        for (; length; length -= n) {
+            n = NK_MIN(dist, length);
+            NK_MEMCPY(dst + length - n, src + length - n, n);
+        }
+    }
+}
 #ifndef NK_MEMSET
 #define NK_MEMSET nk_memset
 NK_LIB void
@@ -8273,6 +9100,105 @@ nk_buffer_init_fixed(struct nk_buffer *b, void *m, nk_size size)
     b->memory.size = size;
     b->size = size;
 }
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+NK_INTERN nk_size
+nk_vm_page_size(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (nk_size)info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? (nk_size)size: 4096;
+#endif
+}
+NK_INTERN void*
+nk_vm_reserve(nk_size size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(MAP_ANONYMOUS)
+    void *ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    return (ptr == MAP_FAILED) ? 0: ptr;
+#else
+    /* a system header included before nuklear already fixed the feature
+     * set without MAP_ANONYMOUS, so map private pages of /dev/zero instead */
+    void *ptr;
+    int fd = open("/dev/zero", O_RDWR);
+    if (fd < 0) return 0;
+    ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return (ptr == MAP_FAILED) ? 0: ptr;
+#endif
+}
+NK_INTERN nk_bool
+nk_vm_commit(void *ptr, nk_size size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+#else
+    return mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0;
+#endif
+}
+NK_INTERN void
+nk_vm_release(void *ptr, nk_size size)
+{
+#ifdef _WIN32
+    NK_UNUSED(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+NK_API nk_bool
+nk_buffer_init_virtual(struct nk_buffer *b, nk_size reserve)
+{
+    void *memory;
+    nk_size page;
+    NK_ASSERT(b);
+    NK_ASSERT(reserve);
+    if (!b || !reserve) return 0;
+
+    page = nk_vm_page_size();
+    reserve = (reserve + page - 1) / page * page;
+    memory = nk_vm_reserve(reserve);
+    NK_ASSERT(memory);
+    if (!memory) return 0;
+
+    nk_zero(b, sizeof(*b));
+    b->type = NK_BUFFER_VIRTUAL;
+    b->memory.ptr = memory;
+    b->memory.size = reserve;
+    b->size = reserve;
+    return 1;
+}
+NK_INTERN nk_bool
+nk_buffer_commit(struct nk_buffer *b, enum nk_buffer_allocation_type type,
+    nk_size required)
+{
+    /* make sure `required` bytes at the given end of the buffer are usable */
+    nk_size page, step, commit;
+    if (required <= b->committed[type])
+        return nk_true;
+
+    page = nk_vm_page_size();
+    step = (NK_BUFFER_VIRTUAL_COMMIT_SIZE + page - 1) / page * page;
+    commit = (required + step - 1) / step * step;
+    commit = NK_MIN(commit, b->memory.size);
+    if (type == NK_BUFFER_FRONT) {
+        void *begin = nk_ptr_add(void, b->memory.ptr, b->committed[type]);
+        if (!nk_vm_commit(begin, commit - b->committed[type]))
+            return nk_false;
+    } else {
+        void *begin = nk_ptr_add(void, b->memory.ptr, b->memory.size - commit);
+        if (!nk_vm_commit(begin, commit - b->committed[type]))
+            return nk_false;
+    }
+    b->committed[type] = commit;
+    return nk_true;
+}
+#endif
 NK_LIB void*
 nk_buffer_align(void *unaligned,
     nk_size align, nk_size *alignment,
@@ -8386,6 +9312,17 @@ nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type,
         else unaligned = nk_ptr_add(void, b->memory.ptr, b->size - size);
         memory = nk_buffer_align(unaligned, align, &alignment, type);
     }
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+    if (b->type == NK_BUFFER_VIRTUAL) {
+        /* commit pages for the new block instead of moving the buffer */
+        nk_size required;
+        if (type == NK_BUFFER_FRONT)
+            required = b->allocated + size + alignment;
+        else required = b->memory.size - (b->size - (size + alignment));
+        if (!nk_buffer_commit(b, type, required))
+            return 0;
+    }
+#endif
     if (type == NK_BUFFER_FRONT)
         b->allocated += size + alignment;
     else b->size -= (size + alignment);
@@ -8448,6 +9385,13 @@ nk_buffer_free(struct nk_buffer *b)
     NK_ASSERT(b);
     if (!b || !b->memory.ptr) return;
     if (b->type == NK_BUFFER_FIXED) return;
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+    if (b->type == NK_BUFFER_VIRTUAL) {
+        nk_vm_release(b->memory.ptr, b->memory.size);
+        b->memory.ptr = 0;
+        return;
+    }
+#endif
     if (!b->pool.free) return;
     NK_ASSERT(b->pool.free);
     b->pool.free(b->pool.userdata, b->memory.ptr);
@@ -8505,6 +9449,12 @@ nk_str_init_default(struct nk_str *str)
     alloc.free = nk_mfree;
     nk_buffer_init(&str->buffer, &alloc, 32);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 #endif
 
@@ -8513,12 +9463,267 @@ nk_str_init(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
 {
     nk_buffer_init(&str->buffer, alloc, size);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 NK_API void
 nk_str_init_fixed(struct nk_str *str, void *memory, nk_size size)
 {
     nk_buffer_init_fixed(&str->buffer, memory, size);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
+}
+NK_INTERN nk_size
+nk_str_physical(const struct nk_str *s, nk_size offset)
+{
+    /* text offsets behind the gap are stored `gap_size` bytes further */
+    return (s->gap_size && offset >= s->gap_begin) ? offset + s->gap_size: offset;
+}
+NK_INTERN nk_size
+nk_str_physical_end(const struct nk_str *s, nk_size offset)
+{
+    /* like `nk_str_physical` but for the end of a range */
+    return (s->gap_size && offset > s->gap_begin) ? offset + s->gap_size: offset;
+}
+NK_INTERN nk_size
+nk_str_logical(const struct nk_str *s, nk_size offset)
+{
+    return (s->gap_size && offset >= s->gap_begin + s->gap_size) ? offset - s->gap_size: offset;
+}
+NK_INTERN void
+nk_str_changed(struct nk_str *s, nk_size offset, nk_size removed, nk_size inserted)
+{
+    /* grows the changed range by text `[offset, offset + removed)` which
+     * has been replaced with `inserted` bytes */
+    if (s->changed_end == NK_SIZE_MAX) return;
+    if (s->changed_begin > s->changed_end) {
+        s->changed_begin = offset;
+        s->changed_end = offset + inserted;
+        return;
+    }
+    if (s->changed_end >= offset + removed)
+        s->changed_end = s->changed_end - removed + inserted;
+    else s->changed_end = offset + inserted;
+    s->changed_begin = NK_MIN(s->changed_begin, offset);
+}
+NK_INTERN int
+nk_str_checkpoint_after_rune(const struct nk_str *s, int rune)
+{
+    /* index of the first checkpoint behind `rune` */
+    int lo = 0, hi = s->checkpoint_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (s->checkpoints[mid].rune <= rune)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+NK_INTERN int
+nk_str_checkpoint_after_offset(const struct nk_str *s, nk_size offset)
+{
+    int lo = 0, hi = s->checkpoint_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (s->checkpoints[mid].offset <= offset)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+NK_INTERN void
+nk_str_add_checkpoint(struct nk_str *s, int index, int rune, nk_size offset)
+{
+    struct nk_str_checkpoint *cp;
+    if (!NK_STR_CHECKPOINT_STRIDE || s->buffer.type != NK_BUFFER_DYNAMIC ||
+        !s->buffer.pool.alloc || !s->buffer.pool.free) return;
+
+    if (s->checkpoint_count >= s->checkpoint_capacity) {
+        struct nk_str_checkpoint *temp;
+        int capacity = NK_MAX(16, s->checkpoint_capacity * 2);
+        temp = (struct nk_str_checkpoint*)s->buffer.pool.alloc(s->buffer.pool.userdata,
+            s->checkpoints, (nk_size)capacity * sizeof(*temp));
+        if (!temp) return;
+        if (temp != s->checkpoints && s->checkpoints) {
+            NK_MEMCPY(temp, s->checkpoints, (nk_size)s->checkpoint_count * sizeof(*temp));
+            s->buffer.pool.free(s->buffer.pool.userdata, s->checkpoints);
+        }
+        s->checkpoints = temp;
+        s->checkpoint_capacity = capacity;
+    }
+    cp = s->checkpoints + index;
+    nk_memmove(cp + 1, cp, (nk_size)(s->checkpoint_count - index) * sizeof(*cp));
+    cp->rune = rune;
+    cp->offset = offset;
+    s->checkpoint_count++;
+}
+NK_INTERN void
+nk_str_checkpoints_insert(struct nk_str *s, nk_size offset, nk_size len, int runes)
+{
+    /* checkpoints at `offset` still point at the same rune index */
+    int i = nk_str_checkpoint_after_offset(s, offset);
+    for (; i < s->checkpoint_count; ++i) {
+        s->checkpoints[i].rune += runes;
+        s->checkpoints[i].offset += len;
+    }
+}
+NK_INTERN void
+nk_str_checkpoints_delete(struct nk_str *s, nk_size offset, nk_size len, int runes)
+{
+    /* drops checkpoints inside the deleted text and moves the rest */
+    const int begin = nk_str_checkpoint_after_offset(s, offset);
+    const int end = nk_str_checkpoint_after_offset(s, offset + len);
+    int i;
+    nk_memmove(s->checkpoints + begin, s->checkpoints + end,
+        (nk_size)(s->checkpoint_count - end) * sizeof(*s->checkpoints));
+    s->checkpoint_count -= end - begin;
+    for (i = begin; i < s->checkpoint_count; ++i) {
+        s->checkpoints[i].rune -= runes;
+        s->checkpoints[i].offset -= len;
+    }
+}
+NK_INTERN nk_size
+nk_str_seek_rune(const struct nk_str *s, int pos, struct nk_str *record)
+{
+    /* returns the text offset of rune `pos` by decoding forward from the
+     * closest checkpoint or the gap. If `record` is set a checkpoint is
+     * remembered every NK_STR_CHECKPOINT_STRIDE runes on the way, so const
+     * lookups pass null and never allocate. Runes never straddle the gap. */
+    const char *text = (const char*)s->buffer.memory.ptr;
+    nk_size offset = 0, end = s->buffer.allocated;
+    int index, i, last = 0;
+    nk_rune unicode;
+
+    index = nk_str_checkpoint_after_rune(s, pos);
+    if (index > 0) {
+        last = s->checkpoints[index-1].rune;
+        offset = s->checkpoints[index-1].offset;
+    }
+    if (s->gap_size && s->gap_rune <= pos && s->gap_rune >= last) {
+        last = s->gap_rune;
+        offset = s->gap_begin;
+    }
+    if (last == pos) return offset;
+
+    if (index < s->checkpoint_count)
+        end = nk_str_physical_end(s, s->checkpoints[index].offset);
+    if (s->gap_size && s->gap_rune > pos)
+        end = NK_MIN(end, s->gap_begin);
+    offset = nk_str_physical(s, offset);
+    for (i = last; i < pos && offset < end; ++i) {
+        int glyph_len = nk_utf_decode(text + offset, &unicode, (int)(end - offset));
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+        if (record && i + 1 - last == NK_STR_CHECKPOINT_STRIDE && i + 1 < s->len) {
+            nk_str_add_checkpoint(record, index++, i + 1, nk_str_logical(s, offset));
+            last = i + 1;
+        }
+    }
+    return nk_str_logical(s, offset);
+}
+NK_INTERN nk_size
+nk_str_find_rune(struct nk_str *s, int pos)
+{
+    return nk_str_seek_rune(s, pos, s);
+}
+NK_INTERN int
+nk_str_rune_index(const struct nk_str *s, nk_size offset)
+{
+    /* rune index of a text offset, counted from the closest checkpoint or the gap */
+    const char *text = (const char*)s->buffer.memory.ptr;
+    const int index = nk_str_checkpoint_after_offset(s, offset);
+    nk_size begin = 0;
+    int rune = 0;
+
+    if (index > 0) {
+        rune = s->checkpoints[index-1].rune;
+        begin = s->checkpoints[index-1].offset;
+    }
+    if (s->gap_size && s->gap_begin <= offset && s->gap_begin >= begin) {
+        rune = s->gap_rune;
+        begin = s->gap_begin;
+    }
+    return rune + nk_utf_len(text + nk_str_physical(s, begin), (int)(offset - begin));
+}
+NK_INTERN int
+nk_str_open_gap(struct nk_str *s, nk_size pos, int rune, nk_size size)
+{
+    /* moves the gap to text offset `pos` and makes it at least `size` bytes */
+    char *text = (char*)s->buffer.memory.ptr;
+    if (!s->gap_size) {
+        s->gap_begin = pos;
+    } else if (pos < s->gap_begin) {
+        nk_memmove(text + pos + s->gap_size, text + pos, s->gap_begin - pos);
+    } else if (pos > s->gap_begin) {
+        nk_memmove(text + s->gap_begin, text + s->gap_begin + s->gap_size, pos - s->gap_begin);
+    }
+    s->gap_begin = pos;
+    s->gap_rune = rune;
+
+    if (s->gap_size < size) {
+        /* grow in proportion to the text so moving the tail stays amortized */
+        const nk_size tail = s->buffer.allocated - (s->gap_begin + s->gap_size);
+        nk_size grow = size - s->gap_size;
+        if (s->buffer.type != NK_BUFFER_FIXED)
+            grow += NK_MAX(NK_STR_GAP_SIZE, s->buffer.allocated / 16);
+        if (!nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, grow, 0))
+            return 0;
+        text = (char*)s->buffer.memory.ptr;
+        nk_memmove(text + s->gap_begin + s->gap_size + grow,
+            text + s->gap_begin + s->gap_size, tail);
+        s->gap_size += grow;
+    }
+    return 1;
+}
+NK_LIB void
+nk_str_close_gap(struct nk_str *s)
+{
+    char *text;
+    nk_size gap_end;
+    if (!s->gap_size) return;
+    text = (char*)s->buffer.memory.ptr;
+    gap_end = s->gap_begin + s->gap_size;
+    nk_memmove(text + s->gap_begin, text + gap_end, s->buffer.allocated - gap_end);
+    s->buffer.allocated -= s->gap_size;
+    s->gap_size = 0;
+}
+NK_INTERN int
+nk_str_insert_at(struct nk_str *s, nk_size pos, int rune, const char *str, int len)
+{
+    int runes;
+    if ((s->buffer.allocated - s->gap_size + (nk_size)len >= s->buffer.memory.size) &&
+        (s->buffer.type == NK_BUFFER_FIXED)) return 0;
+    if (!nk_str_open_gap(s, pos, rune, (nk_size)len))
+        return 0;
+
+    NK_MEMCPY(nk_ptr_add(char, s->buffer.memory.ptr, s->gap_begin), str, (nk_size)len);
+    runes = nk_utf_len(str, len);
+    s->gap_begin += (nk_size)len;
+    s->gap_size -= (nk_size)len;
+    s->gap_rune += runes;
+    s->len += runes;
+    nk_str_checkpoints_insert(s, pos, (nk_size)len, runes);
+    nk_str_changed(s, pos, 0, (nk_size)len);
+    return 1;
+}
+NK_INTERN void
+nk_str_delete_at(struct nk_str *s, nk_size pos, int rune, nk_size len, int runes)
+{
+    /* deleted bytes simply become part of the gap */
+    nk_str_open_gap(s, pos, rune, 0);
+    s->gap_size += len;
+    s->len -= runes;
+    nk_str_checkpoints_delete(s, pos, len, runes);
+    nk_str_changed(s, pos, len, 0);
 }
 NK_API int
 nk_str_append_text_char(struct nk_str *s, const char *str, int len)
@@ -8531,6 +9736,7 @@ nk_str_append_text_char(struct nk_str *s, const char *str, int len)
     if (!mem) return 0;
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len += nk_utf_len(str, len);
+    nk_str_changed(s, s->buffer.allocated - s->gap_size - (nk_size)len, 0, (nk_size)len);
     return len;
 }
 NK_API int
@@ -8602,56 +9808,33 @@ nk_str_append_str_runes(struct nk_str *str, const nk_rune *runes)
 NK_API int
 nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
 {
-    int i;
-    void *mem;
-    char *src;
-    char *dst;
-
-    int copylen;
+    int result;
     NK_ASSERT(s);
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
-    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated) return 0;
-    if ((s->buffer.allocated + (nk_size)len >= s->buffer.memory.size) &&
-        (s->buffer.type == NK_BUFFER_FIXED)) return 0;
-
-    copylen = (int)s->buffer.allocated - pos;
-    if (!copylen) {
-        nk_str_append_text_char(s, str, len);
-        return 1;
-    }
-    mem = nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
-    if (!mem) return 0;
-
-    /* memmove */
-    NK_ASSERT(((int)pos + (int)len + ((int)copylen - 1)) >= 0);
-    NK_ASSERT(((int)pos + ((int)copylen - 1)) >= 0);
-    dst = nk_ptr_add(char, s->buffer.memory.ptr, pos + len + (copylen - 1));
-    src = nk_ptr_add(char, s->buffer.memory.ptr, pos + (copylen-1));
-    for (i = 0; i < copylen; ++i) *dst-- = *src--;
-    mem = nk_ptr_add(void, s->buffer.memory.ptr, pos);
-    NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
-    s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
-    return 1;
+    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated - s->gap_size) return 0;
+    result = nk_str_insert_at(s, (nk_size)pos, nk_str_rune_index(s, (nk_size)pos), str, len);
+    nk_str_close_gap(s);
+    return result;
+}
+NK_INTERN int
+nk_str_edit_insert_at(struct nk_str *str, int pos, const char *cstr, int len)
+{
+    if (!str || !cstr || !len || pos < 0 || pos > str->len) return 0;
+    if (!str->len)
+        return nk_str_append_text_char(str, cstr, len);
+    return nk_str_insert_at(str, nk_str_find_rune(str, pos), pos, cstr, len);
 }
 NK_API int
 nk_str_insert_at_rune(struct nk_str *str, int pos, const char *cstr, int len)
 {
-    int glyph_len;
-    nk_rune unicode;
-    const char *begin;
-    const char *buffer;
-
+    int result;
     NK_ASSERT(str);
     NK_ASSERT(cstr);
     NK_ASSERT(len);
-    if (!str || !cstr || !len) return 0;
-    begin = nk_str_at_rune(str, pos, &unicode, &glyph_len);
-    if (!str->len)
-        return nk_str_append_text_char(str, cstr, len);
-    buffer = nk_str_get_const(str);
-    if (!begin) return 0;
-    return nk_str_insert_at_char(str, (int)(begin - buffer), cstr, len);
+    result = nk_str_edit_insert_at(str, pos, cstr, len);
+    if (str) nk_str_close_gap(str);
+    return result;
 }
 NK_API int
 nk_str_insert_text_char(struct nk_str *str, int pos, const char *text, int len)
@@ -8663,19 +9846,25 @@ nk_str_insert_str_char(struct nk_str *str, int pos, const char *text)
 {
     return nk_str_insert_text_utf8(str, pos, text, nk_strlen(text));
 }
-NK_API int
-nk_str_insert_text_utf8(struct nk_str *str, int pos, const char *text, int len)
+NK_LIB int
+nk_str_edit_insert_utf8(struct nk_str *str, int pos, const char *text, int len)
 {
     int i = 0;
     int byte_len = 0;
     nk_rune unicode;
-
-    NK_ASSERT(str);
-    NK_ASSERT(text);
     if (!str || !text || !len) return 0;
     for (i = 0; i < len; ++i)
         byte_len += nk_utf_decode(text+byte_len, &unicode, 4);
-    nk_str_insert_at_rune(str, pos, text, byte_len);
+    nk_str_edit_insert_at(str, pos, text, byte_len);
+    return len;
+}
+NK_API int
+nk_str_insert_text_utf8(struct nk_str *str, int pos, const char *text, int len)
+{
+    NK_ASSERT(str);
+    NK_ASSERT(text);
+    len = nk_str_edit_insert_utf8(str, pos, text, len);
+    if (str) nk_str_close_gap(str);
     return len;
 }
 NK_API int
@@ -8696,23 +9885,29 @@ nk_str_insert_str_utf8(struct nk_str *str, int pos, const char *text)
     nk_str_insert_at_rune(str, pos, text, byte_len);
     return num_runes;
 }
-NK_API int
-nk_str_insert_text_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
+NK_LIB int
+nk_str_edit_insert_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
 {
     int i = 0;
     int byte_len = 0;
     nk_glyph glyph;
-
-    NK_ASSERT(str);
     if (!str || !runes || !len) return 0;
     for (i = 0; i < len; ++i) {
         byte_len = nk_utf_encode(runes[i], glyph, NK_UTF_SIZE);
         if (!byte_len) break;
-        nk_str_insert_at_rune(str, pos+i, glyph, byte_len);
+        nk_str_edit_insert_at(str, pos+i, glyph, byte_len);
     }
     return len;
 }
 NK_API int
+nk_str_insert_text_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
+{
+    NK_ASSERT(str);
+    len = nk_str_edit_insert_runes(str, pos, runes, len);
+    if (str) nk_str_close_gap(str);
+    return len;
+}
+NK_API int
 nk_str_insert_str_runes(struct nk_str *str, int pos, const nk_rune *runes)
 {
     int i = 0;
@@ -8732,10 +9927,14 @@ nk_str_remove_chars(struct nk_str *s, int len)
 {
     NK_ASSERT(s);
     NK_ASSERT(len >= 0);
-    if (!s || len < 0 || (nk_size)len > s->buffer.allocated) return;
+    if (!s || len < 0) return;
+    nk_str_close_gap(s);
+    if ((nk_size)len > s->buffer.allocated) return;
     NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
     s->buffer.allocated -= (nk_size)len;
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_changed(s, s->buffer.allocated, (nk_size)len, 0);
+    s->checkpoint_count = nk_str_checkpoint_after_offset(s, s->buffer.allocated);
 }
 NK_API void
 nk_str_remove_runes(struct nk_str *str, int len)
@@ -8761,59 +9960,56 @@ nk_str_remove_runes(struct nk_str *str, int len)
 NK_API void
 nk_str_delete_chars(struct nk_str *s, int pos, int len)
 {
+    nk_size text_len;
+    int rune;
     NK_ASSERT(s);
-    if (!s || !len || (nk_size)pos > s->buffer.allocated ||
-        (nk_size)(pos + len) > s->buffer.allocated) return;
-
-    if ((nk_size)(pos + len) < s->buffer.allocated) {
-        /* memmove */
-        char *dst = nk_ptr_add(char, s->buffer.memory.ptr, pos);
-        char *src = nk_ptr_add(char, s->buffer.memory.ptr, pos + len);
-        NK_MEMCPY(dst, src, s->buffer.allocated - (nk_size)(pos + len));
-        NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
-        s->buffer.allocated -= (nk_size)len;
-    } else nk_str_remove_chars(s, len);
-    s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    if (!s || !len) return;
+    text_len = s->buffer.allocated - s->gap_size;
+    if ((nk_size)pos > text_len || (nk_size)(pos + len) > text_len) return;
+
+    rune = nk_str_rune_index(s, (nk_size)pos);
+    nk_str_delete_at(s, (nk_size)pos, rune, (nk_size)len,
+        nk_str_rune_index(s, (nk_size)(pos + len)) - rune);
+    nk_str_close_gap(s);
 }
-NK_API void
-nk_str_delete_runes(struct nk_str *s, int pos, int len)
+NK_LIB void
+nk_str_edit_delete_runes(struct nk_str *s, int pos, int len)
 {
-    char *temp;
-    nk_rune unicode;
-    char *begin;
-    char *end;
-    int unused;
+    nk_size begin;
+    nk_size end;
 
-    NK_ASSERT(s);
     NK_ASSERT(s->len >= pos + len);
     if (s->len < pos + len)
         len = NK_CLAMP(0, (s->len - pos), s->len);
-    if (!len) return;
+    if (!len || pos < 0) return;
 
-    temp = (char *)s->buffer.memory.ptr;
-    begin = nk_str_at_rune(s, pos, &unicode, &unused);
-    if (!begin) return;
-    s->buffer.memory.ptr = begin;
-    end = nk_str_at_rune(s, len, &unicode, &unused);
-    s->buffer.memory.ptr = temp;
-    if (!end) return;
-    nk_str_delete_chars(s, (int)(begin - temp), (int)(end - begin));
+    begin = nk_str_find_rune(s, pos);
+    end = nk_str_find_rune(s, pos + len);
+    nk_str_delete_at(s, begin, pos, end - begin, len);
 }
-NK_API char*
-nk_str_at_char(struct nk_str *s, int pos)
-{
+NK_API void
+nk_str_delete_runes(struct nk_str *s, int pos, int len)
+{
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
+    if (!s) return;
+    nk_str_edit_delete_runes(s, pos, len);
+    nk_str_close_gap(s);
+}
+NK_API char*
+nk_str_at_char(struct nk_str *s, int pos)
+{
+    NK_ASSERT(s);
+    if (!s) return 0;
+    nk_str_close_gap(s);
+    if (pos > (int)s->buffer.allocated) return 0;
     return nk_ptr_add(char, s->buffer.memory.ptr, pos);
 }
 NK_API char*
 nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
+    nk_size offset;
+    int glyph_len;
     char *text;
-    int text_len;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -8826,37 +10022,29 @@ nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    nk_str_close_gap(str);
+    if (pos > str->len) return 0;
+    offset = nk_str_find_rune(str, pos);
+    text = (char*)str->buffer.memory.ptr + offset;
+    glyph_len = nk_utf_decode(text, unicode, (int)(str->buffer.allocated - offset));
+    if (glyph_len) *len = glyph_len;
+    return text;
 }
 NK_API const char*
 nk_str_at_char_const(const struct nk_str *s, int pos)
 {
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
-    return nk_ptr_add(char, s->buffer.memory.ptr, pos);
+    if (!s) return 0;
+    /* only the text editor sees an open gap and it never reads past it */
+    if (pos > (int)(s->buffer.allocated - s->gap_size)) return 0;
+    return nk_ptr_add_const(char, s->buffer.memory.ptr, nk_str_physical(s, (nk_size)pos));
 }
 NK_API const char*
 nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
+    nk_size offset;
+    int glyph_len;
     char *text;
-    int text_len;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -8869,28 +10057,24 @@ nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    if (pos > str->len) return 0;
+    offset = nk_str_physical(str, nk_str_seek_rune(str, pos, 0));
+    text = (char*)str->buffer.memory.ptr + offset;
+    glyph_len = nk_utf_decode(text, unicode, (int)(str->buffer.allocated - offset));
+    if (glyph_len) *len = glyph_len;
+    return text;
 }
 NK_API nk_rune
 nk_str_rune_at(const struct nk_str *str, int pos)
 {
-    int len;
+    /* reads around the gap the text editor keeps open during an edit */
+    nk_size offset;
     nk_rune unicode = 0;
-    nk_str_at_const(str, pos, &unicode, &len);
+    NK_ASSERT(str);
+    if (!str || pos < 0 || pos >= str->len) return 0;
+    offset = nk_str_physical(str, nk_str_seek_rune(str, pos, 0));
+    nk_utf_decode((const char*)str->buffer.memory.ptr + offset, &unicode,
+        (int)(str->buffer.allocated - offset));
     return unicode;
 }
 NK_API char*
@@ -8898,6 +10082,7 @@ nk_str_get(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    nk_str_close_gap(s);
     return (char*)s->buffer.memory.ptr;
 }
 NK_API const char*
@@ -8905,6 +10090,8 @@ nk_str_get_const(const struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    /* every editing call closes the gap before it returns */
+    NK_ASSERT(!s->gap_size);
     return (const char*)s->buffer.memory.ptr;
 }
 NK_API int
@@ -8919,7 +10106,7 @@ nk_str_len_char(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (int)s->buffer.allocated;
+    return (int)(s->buffer.allocated - s->gap_size);
 }
 NK_API void
 nk_str_clear(struct nk_str *str)
@@ -8927,13 +10114,24 @@ nk_str_clear(struct nk_str *str)
     NK_ASSERT(str);
     nk_buffer_clear(&str->buffer);
     str->len = 0;
+    str->gap_size = 0;
+    str->checkpoint_count = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 NK_API void
 nk_str_free(struct nk_str *str)
 {
     NK_ASSERT(str);
+    if (str->checkpoints && str->buffer.pool.free)
+        str->buffer.pool.free(str->buffer.pool.userdata, str->checkpoints);
     nk_buffer_free(&str->buffer);
     str->len = 0;
+    str->gap_size = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 
 
@@ -8957,6 +10155,7 @@ nk_command_buffer_init(struct nk_command_buffer *cb,
     cb->begin = b->allocated;
     cb->end = b->allocated;
     cb->last = b->allocated;
+    cb->digest = 0;
 }
 NK_LIB void
 nk_command_buffer_reset(struct nk_command_buffer *b)
@@ -8966,6 +10165,7 @@ nk_command_buffer_reset(struct nk_command_buffer *b)
     b->begin = 0;
     b->end = 0;
     b->last = 0;
+    b->digest = 0;
     b->clip = nk_null_rect;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     b->userdata.ptr = 0;
@@ -8984,6 +10184,10 @@ nk_command_buffer_push(struct nk_command_buffer* b,
     NK_ASSERT(b);
     NK_ASSERT(b->base);
     if (!b) return 0;
+
+    /* previous command is finished so add it to the buffer digest */
+    if (b->end != b->begin)
+        b->digest = nk_command_buffer_digest(b);
     cmd = (struct nk_command*)nk_buffer_alloc(b->base,NK_BUFFER_FRONT,size,align);
     if (!cmd) return 0;
 
@@ -8998,12 +10202,189 @@ nk_command_buffer_push(struct nk_command_buffer* b,
 
     cmd->type = t;
     cmd->next = b->base->allocated + alignment;
+#ifdef NK_INCLUDE_STATISTICS
+    if (b->stats) b->stats->commands[t]++;
+#endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     cmd->userdata = b->userdata;
 #endif
     b->end = cmd->next;
     return cmd;
 }
+#define NK_COMMAND_END(type, member)\
+    (NK_OFFSETOF(struct type, member) + sizeof(((const struct type*)0)->member))
+#define NK_COMMAND_POINTS_END(type, cmd)\
+    (NK_OFFSETOF(struct type, points) + sizeof(struct nk_vec2i) *\
+    (nk_size)((const struct type*)(const void*)(cmd))->point_count)
+NK_LIB nk_size
+nk_command_size(const struct nk_command *cmd)
+{
+    /* number of bytes up to the end of the last member, so trailing
+     * padding left over from earlier frames is never hashed */
+    NK_ASSERT(cmd);
+    switch (cmd->type) {
+    default:
+    case NK_COMMAND_NOP: return sizeof(struct nk_command);
+    case NK_COMMAND_SCISSOR: return NK_COMMAND_END(nk_command_scissor, h);
+    case NK_COMMAND_LINE: return NK_COMMAND_END(nk_command_line, color);
+    case NK_COMMAND_CURVE: return NK_COMMAND_END(nk_command_curve, color);
+    case NK_COMMAND_RECT: return NK_COMMAND_END(nk_command_rect, color);
+    case NK_COMMAND_RECT_FILLED: return NK_COMMAND_END(nk_command_rect_filled, color);
+    case NK_COMMAND_RECT_MULTI_COLOR: return NK_COMMAND_END(nk_command_rect_multi_color, right);
+    case NK_COMMAND_CIRCLE: return NK_COMMAND_END(nk_command_circle, color);
+    case NK_COMMAND_CIRCLE_FILLED: return NK_COMMAND_END(nk_command_circle_filled, color);
+    case NK_COMMAND_ARC: return NK_COMMAND_END(nk_command_arc, color);
+    case NK_COMMAND_ARC_FILLED: return NK_COMMAND_END(nk_command_arc_filled, color);
+    case NK_COMMAND_TRIANGLE: return NK_COMMAND_END(nk_command_triangle, color);
+    case NK_COMMAND_TRIANGLE_FILLED: return NK_COMMAND_END(nk_command_triangle_filled, color);
+    case NK_COMMAND_POLYGON: return NK_COMMAND_POINTS_END(nk_command_polygon, cmd);
+    case NK_COMMAND_POLYGON_FILLED: return NK_COMMAND_POINTS_END(nk_command_polygon_filled, cmd);
+    case NK_COMMAND_POLYLINE: return NK_COMMAND_POINTS_END(nk_command_polyline, cmd);
+    case NK_COMMAND_TEXT: {
+        /* `string` already counts one byte of sizeof(), so the struct size
+         * would reach past the terminator into unwritten memory */
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        return NK_OFFSETOF(struct nk_command_text, string) + (nk_size)(t->length + 1);
+    }
+    case NK_COMMAND_IMAGE: return NK_COMMAND_END(nk_command_image, col);
+    case NK_COMMAND_CUSTOM: return NK_COMMAND_END(nk_command_custom, callback);
+    }
+}
+NK_LIB nk_hash
+nk_command_hash(const struct nk_command *cmd, nk_hash seed)
+{
+    /* hash everything but the offset to the next command */
+    nk_size size = nk_command_size(cmd);
+    seed = nk_murmur_hash(&cmd->type, (int)sizeof(cmd->type), seed);
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    seed = nk_murmur_hash(&cmd->userdata, (int)sizeof(cmd->userdata), seed);
+#endif
+    if (size > sizeof(*cmd)) {
+        const void *payload = nk_ptr_add_const(nk_byte, cmd, sizeof(*cmd));
+        seed = nk_murmur_hash(payload, (int)(size - sizeof(*cmd)), seed);
+    }
+    return seed;
+}
+NK_LIB nk_hash
+nk_command_buffer_digest(const struct nk_command_buffer *b)
+{
+    /* the last command can still be written to so it is only added to
+     * `b->digest` once the next command is pushed */
+    const struct nk_command *last;
+    NK_ASSERT(b);
+    if (!b) return 0;
+    if (b->end == b->begin) return b->digest;
+    last = nk_ptr_add_const(struct nk_command, b->base->memory.ptr, b->last);
+    return nk_command_hash(last, b->digest);
+}
+NK_INTERN struct nk_rect
+nk_points_bounds(const struct nk_vec2i *points, int count, float pad)
+{
+    int i;
+    short x0, y0, x1, y1;
+    NK_ASSERT(count > 0);
+    x0 = x1 = points[0].x;
+    y0 = y1 = points[0].y;
+    for (i = 1; i < count; ++i) {
+        x0 = NK_MIN(x0, points[i].x); x1 = NK_MAX(x1, points[i].x);
+        y0 = NK_MIN(y0, points[i].y); y1 = NK_MAX(y1, points[i].y);
+    }
+    return nk_rect(x0 - pad, y0 - pad, x1 - x0 + 2*pad, y1 - y0 + 2*pad);
+}
+NK_LIB struct nk_rect
+nk_command_bounds(const struct nk_command *cmd)
+{
+    /* conservative screen area touched by a command without clipping */
+    NK_ASSERT(cmd);
+    switch (cmd->type) {
+    default:
+    case NK_COMMAND_NOP: return nk_rect(0,0,0,0);
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        return nk_rect(s->x, s->y, s->w, s->h);
+    }
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        struct nk_vec2i p[2];
+        p[0] = l->begin; p[1] = l->end;
+        return nk_points_bounds(p, 2, l->line_thickness);
+    }
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        struct nk_vec2i p[4];
+        p[0] = q->begin; p[1] = q->ctrl[0]; p[2] = q->ctrl[1]; p[3] = q->end;
+        return nk_points_bounds(p, 4, q->line_thickness);
+    }
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        return nk_shrink_rect(nk_rect(r->x, r->y, r->w, r->h), -(float)r->line_thickness);
+    }
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        return nk_rect(r->x, r->y, r->w, r->h);
+    }
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        return nk_rect(r->x, r->y, r->w, r->h);
+    }
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        return nk_shrink_rect(nk_rect(c->x, c->y, c->w, c->h), -(float)c->line_thickness);
+    }
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        return nk_rect(c->x, c->y, c->w, c->h);
+    }
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *a = (const struct nk_command_arc*)cmd;
+        const float r = (float)a->r + (float)a->line_thickness;
+        return nk_rect(a->cx - r, a->cy - r, 2*r, 2*r);
+    }
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled*)cmd;
+        return nk_rect(a->cx - a->r, a->cy - a->r, 2*a->r, 2*a->r);
+    }
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        struct nk_vec2i p[3];
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_points_bounds(p, 3, t->line_thickness);
+    }
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        struct nk_vec2i p[3];
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_points_bounds(p, 3, 0);
+    }
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, p->line_thickness);
+    }
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, 0);
+    }
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, p->line_thickness);
+    }
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        return nk_rect(t->x, t->y, t->w, t->h);
+    }
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        return nk_rect(i->x, i->y, i->w, i->h);
+    }
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        return nk_rect(c->x, c->y, c->w, c->h);
+    }
+    }
+}
 NK_API void
 nk_push_scissor(struct nk_command_buffer *b, struct nk_rect r)
 {
@@ -9206,6 +10587,8 @@ nk_fill_arc(struct nk_command_buffer *b, float cx, float cy, float radius,
     cmd = (struct nk_command_arc_filled*)
         nk_command_buffer_push(b, NK_COMMAND_ARC_FILLED, sizeof(*cmd));
     if (!cmd) return;
+    /* the command hash covers the padding in front of `a` */
+    NK_MEMSET(&cmd->cx, 0, sizeof(*cmd) - NK_OFFSETOF(struct nk_command_arc_filled, cx));
     cmd->cx = (short)cx;
     cmd->cy = (short)cy;
     cmd->r = (unsigned short)radius;
@@ -9350,7 +10733,15 @@ nk_draw_image(struct nk_command_buffer *b, struct nk_rect r,
     cmd->y = (short)r.y;
     cmd->w = (unsigned short)NK_MAX(0, r.w);
     cmd->h = (unsigned short)NK_MAX(0, r.h);
-    cmd->img = *img;
+    /* copied by member so padding inside `img` stays zero for the hash */
+    NK_MEMSET(&cmd->img, 0, sizeof(cmd->img));
+    cmd->img.handle = img->handle;
+    cmd->img.w = img->w;
+    cmd->img.h = img->h;
+    cmd->img.region[0] = img->region[0];
+    cmd->img.region[1] = img->region[1];
+    cmd->img.region[2] = img->region[2];
+    cmd->img.region[3] = img->region[3];
     cmd->col = col;
 }
 NK_API void
@@ -9471,7 +10862,7 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     }
 
     /* make sure text fits inside bounds */
-    text_width = font->width(font->userdata, font->height, string, length);
+    text_width = nk_text_width(b, font, string, length);
     if (text_width > r.w){
         int glyphs = 0;
         float txt_width = (float)text_width;
@@ -9495,6 +10886,175 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     cmd->string[length] = '\0';
 }
 
+/* ==============================================================
+ *
+ *                          DAMAGE
+ *
+ * ===============================================================*/
+struct nk_damage_command {
+    nk_hash hash;
+    struct nk_rect bounds;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_damage_init_default(struct nk_damage *damage)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_damage_init(damage, &alloc);
+}
+#endif
+NK_API void
+nk_damage_init(struct nk_damage *damage, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(damage);
+    NK_ASSERT(alloc);
+    if (!damage || !alloc) return;
+
+    nk_zero(damage, sizeof(*damage));
+    nk_buffer_init(&damage->commands[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&damage->commands[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    damage->invalid = nk_true;
+}
+NK_API void
+nk_damage_free(struct nk_damage *damage)
+{
+    NK_ASSERT(damage);
+    if (!damage) return;
+    nk_buffer_free(&damage->commands[0]);
+    nk_buffer_free(&damage->commands[1]);
+    nk_zero(damage, sizeof(*damage));
+}
+NK_API void
+nk_damage_invalidate(struct nk_damage *damage)
+{
+    NK_ASSERT(damage);
+    if (!damage) return;
+    damage->invalid = nk_true;
+}
+NK_INTERN void
+nk_damage_add(struct nk_damage *damage, struct nk_rect r)
+{
+    int i;
+    float x0, y0, x1, y1;
+    if (r.w <= 0 || r.h <= 0) return;
+
+    /* round to whole pixels and grow by one pixel for anti-aliasing */
+    x0 = (float)(nk_ifloorf(r.x) - 1);
+    y0 = (float)(nk_ifloorf(r.y) - 1);
+    x1 = (float)(nk_iceilf(r.x + r.w) + 1);
+    y1 = (float)(nk_iceilf(r.y + r.h) + 1);
+
+    /* merge with every area it touches */
+    for (i = 0; i < damage->count;) {
+        const struct nk_rect *d = &damage->rects[i];
+        if (x0 <= d->x + d->w && d->x <= x1 && y0 <= d->y + d->h && d->y <= y1) {
+            x0 = NK_MIN(x0, d->x); y0 = NK_MIN(y0, d->y);
+            x1 = NK_MAX(x1, d->x + d->w); y1 = NK_MAX(y1, d->y + d->h);
+            damage->rects[i] = damage->rects[--damage->count];
+            i = 0;
+        } else i++;
+    }
+    if (damage->count == NK_DAMAGE_MAX_RECTS) {
+        /* out of space so grow the area that increases the least */
+        int best = 0;
+        float best_cost = 0;
+        for (i = 0; i < damage->count; ++i) {
+            const struct nk_rect *d = &damage->rects[i];
+            float w = NK_MAX(x1, d->x + d->w) - NK_MIN(x0, d->x);
+            float h = NK_MAX(y1, d->y + d->h) - NK_MIN(y0, d->y);
+            float cost = w * h - d->w * d->h;
+            if (!i || cost < best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+        {const struct nk_rect d = damage->rects[best];
+        x0 = NK_MIN(x0, d.x); y0 = NK_MIN(y0, d.y);
+        x1 = NK_MAX(x1, d.x + d.w); y1 = NK_MAX(y1, d.y + d.h);
+        damage->rects[best] = damage->rects[--damage->count];}
+    }
+    damage->rects[damage->count++] = nk_rect(x0, y0, x1 - x0, y1 - y0);
+}
+NK_API int
+nk_damage_update(struct nk_damage *damage, struct nk_context *ctx)
+{
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_damage_command);
+    const struct nk_damage_command *prev;
+    const struct nk_damage_command *cur;
+    const struct nk_command *cmd;
+    struct nk_buffer *buffer;
+    struct nk_rect clip = nk_null_rect;
+    unsigned int prev_count, cur_count = 0;
+    unsigned int i = 0, j = 0;
+    nk_bool full;
+
+    NK_ASSERT(damage);
+    NK_ASSERT(ctx);
+    if (!damage || !ctx) return 0;
+
+    /* record hash and clipped bounds of every command of this frame */
+    damage->seq++;
+    buffer = &damage->commands[damage->seq & 1];
+    nk_buffer_clear(buffer);
+    full = damage->invalid;
+    damage->invalid = nk_false;
+    nk_foreach(cmd, ctx) {
+        struct nk_rect bounds;
+        struct nk_damage_command *out = (struct nk_damage_command*)
+            nk_buffer_alloc(buffer, NK_BUFFER_FRONT, sizeof(*out), align);
+        if (!out) {
+            /* incomplete list can not be compared next frame either */
+            damage->invalid = nk_true;
+            full = nk_true;
+            break;
+        }
+        bounds = nk_command_bounds(cmd);
+        out->hash = nk_command_hash(cmd, 0);
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            out->bounds = bounds;
+            clip = bounds;
+        } else nk_unify(&out->bounds, &bounds, clip.x, clip.y,
+                clip.x + clip.w, clip.y + clip.h);
+        cur_count++;
+    }
+    damage->command_count[damage->seq & 1] = cur_count;
+    damage->count = 0;
+    if (full) {
+        damage->rects[damage->count++] = nk_null_rect;
+        return damage->count;
+    }
+
+    /* walk both frames and resynchronize on single inserts or removals */
+    prev_count = damage->command_count[(damage->seq-1) & 1];
+    prev = nk_ptr_add_const(struct nk_damage_command, damage->commands[(damage->seq-1) & 1].memory.ptr,
+        damage->commands[(damage->seq-1) & 1].allocated) - prev_count;
+    cur = nk_ptr_add_const(struct nk_damage_command, buffer->memory.ptr,
+        buffer->allocated) - cur_count;
+    while (i < prev_count && j < cur_count) {
+        if (prev[i].hash == cur[j].hash) {
+            if (prev[i].bounds.x != cur[j].bounds.x || prev[i].bounds.y != cur[j].bounds.y ||
+                prev[i].bounds.w != cur[j].bounds.w || prev[i].bounds.h != cur[j].bounds.h) {
+                nk_damage_add(damage, prev[i].bounds);
+                nk_damage_add(damage, cur[j].bounds);
+            } i++; j++;
+        } else if (j+1 < cur_count && prev[i].hash == cur[j+1].hash) {
+            nk_damage_add(damage, cur[j++].bounds);
+        } else if (i+1 < prev_count && prev[i+1].hash == cur[j].hash) {
+            nk_damage_add(damage, prev[i++].bounds);
+        } else {
+            nk_damage_add(damage, prev[i++].bounds);
+            nk_damage_add(damage, cur[j++].bounds);
+        }
+    }
+    for (; i < prev_count; ++i)
+        nk_damage_add(damage, prev[i].bounds);
+    for (; j < cur_count; ++j)
+        nk_damage_add(damage, cur[j].bounds);
+    return damage->count;
+}
 
 
 
@@ -9538,6 +11098,7 @@ nk_draw_list_setup(struct nk_draw_list *canvas, const struct nk_convert_config *
     canvas->line_AA = line_aa;
     canvas->shape_AA = shape_aa;
     canvas->clip_rect = nk_null_rect;
+    canvas->vertex_writer = nk_draw_vertex_writer_select(canvas);
 
     canvas->cmd_offset = 0;
     canvas->element_count = 0;
@@ -9545,6 +11106,9 @@ nk_draw_list_setup(struct nk_draw_list *canvas, const struct nk_convert_config *
     canvas->cmd_offset = 0;
     canvas->cmd_count = 0;
     canvas->path_count = 0;
+    canvas->scratch_arena = 0;
+    canvas->scratch = 0;
+    canvas->scratch_size = 0;
 }
 NK_API const struct nk_draw_command*
 nk__draw_list_begin(const struct nk_draw_list *canvas, const struct nk_buffer *buffer)
@@ -9890,9 +11454,11 @@ nk_draw_vertex_element(void *dst, const float *values, int value_count,
     }
 }
 NK_INTERN void*
-nk_draw_vertex(void *dst, const struct nk_convert_config *config,
+nk_draw_vertex(void *dst, const struct nk_draw_list *list,
     struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
 {
+    /* generic writer interpreting the vertex layout for each vertex */
+    const struct nk_convert_config *config = &list->config;
     void *result = (void*)((char*)dst + config->vertex_size);
     const struct nk_draw_vertex_layout_element *elem_iter = config->vertex_layout;
     while (!nk_draw_vertex_layout_element_is_end_of_layout(elem_iter)) {
@@ -9908,6 +11474,147 @@ nk_draw_vertex(void *dst, const struct nk_convert_config *config,
     }
     return result;
 }
+NK_INTERN void*
+nk_draw_vertex_rgba8(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
+{
+    /* float position and texture coordinates with R8G8B8A8 color */
+    nk_byte *vtx = (nk_byte*)dst;
+    float *p = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_POSITION]);
+    float *t = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_TEXCOORD]);
+    nk_byte *c = vtx + list->vertex_offsets[NK_VERTEX_COLOR];
+    p[0] = pos.x; p[1] = pos.y;
+    t[0] = uv.x; t[1] = uv.y;
+    c[0] = (nk_byte)(NK_SATURATE(color.r) * 255.0f);
+    c[1] = (nk_byte)(NK_SATURATE(color.g) * 255.0f);
+    c[2] = (nk_byte)(NK_SATURATE(color.b) * 255.0f);
+    c[3] = (nk_byte)(NK_SATURATE(color.a) * 255.0f);
+    return vtx + list->config.vertex_size;
+}
+NK_INTERN void*
+nk_draw_vertex_bgra8(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
+{
+    /* float position and texture coordinates with B8G8R8A8 color */
+    nk_byte *vtx = (nk_byte*)dst;
+    float *p = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_POSITION]);
+    float *t = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_TEXCOORD]);
+    nk_byte *c = vtx + list->vertex_offsets[NK_VERTEX_COLOR];
+    p[0] = pos.x; p[1] = pos.y;
+    t[0] = uv.x; t[1] = uv.y;
+    c[0] = (nk_byte)(NK_SATURATE(color.b) * 255.0f);
+    c[1] = (nk_byte)(NK_SATURATE(color.g) * 255.0f);
+    c[2] = (nk_byte)(NK_SATURATE(color.r) * 255.0f);
+    c[3] = (nk_byte)(NK_SATURATE(color.a) * 255.0f);
+    return vtx + list->config.vertex_size;
+}
+NK_LIB nk_draw_vertex_writer
+nk_draw_vertex_writer_select(struct nk_draw_list *list)
+{
+    /* picks a straight-line writer for common vertex layouts */
+    NK_STORAGE const nk_size float_align = NK_ALIGNOF(float);
+    const struct nk_convert_config *config = &list->config;
+    const struct nk_draw_vertex_layout_element *elem;
+    enum nk_draw_vertex_layout_format color = NK_FORMAT_COUNT;
+    unsigned found = 0;
+
+    if (!config->vertex_layout || config->vertex_alignment % float_align ||
+        config->vertex_size % float_align)
+        return nk_draw_vertex;
+    for (elem = config->vertex_layout; !nk_draw_vertex_layout_element_is_end_of_layout(elem); ++elem) {
+        const unsigned bit = 1u << elem->attribute;
+        if (found & bit) return nk_draw_vertex;
+        found |= bit;
+        list->vertex_offsets[elem->attribute] = elem->offset;
+        switch (elem->attribute) {
+        case NK_VERTEX_POSITION:
+        case NK_VERTEX_TEXCOORD:
+            if (elem->format != NK_FORMAT_FLOAT || elem->offset % float_align)
+                return nk_draw_vertex;
+            break;
+        case NK_VERTEX_COLOR:
+            color = elem->format;
+            break;
+        default: return nk_draw_vertex;
+        }
+    }
+    if (found != (1u << NK_VERTEX_POSITION | 1u << NK_VERTEX_TEXCOORD | 1u << NK_VERTEX_COLOR))
+        return nk_draw_vertex;
+    switch (color) {
+    case NK_FORMAT_R8G8B8A8:
+    case NK_FORMAT_R8G8B8: return nk_draw_vertex_rgba8;
+    case NK_FORMAT_B8G8R8A8: return nk_draw_vertex_bgra8;
+    default: return nk_draw_vertex;
+    }
+}
+NK_INTERN void*
+nk_draw_list_alloc_temp(struct nk_draw_list *list, nk_size size, nk_size align)
+{
+    /* temporaries only live for a single stroke or fill, so the same frame
+     * arena block is handed out again and only replaced when too small */
+    void *memory;
+    nk_size capacity;
+    if (!list->scratch_arena) return 0;
+    if (list->scratch) {
+        memory = NK_ALIGN_PTR(list->scratch, align);
+        if ((nk_byte*)memory + size <= (nk_byte*)list->scratch + list->scratch_size)
+            return memory;
+    }
+    capacity = NK_MAX(size + align, list->scratch_size * 2);
+    memory = nk_frame_arena_alloc(list->scratch_arena, capacity, 0);
+    if (!memory) return 0;
+    list->scratch = memory;
+    list->scratch_size = capacity;
+    return NK_ALIGN_PTR(memory, align);
+}
+NK_INTERN struct nk_vec2
+nk_draw_list_miter(struct nk_vec2 n0, struct nk_vec2 n1)
+{
+    /* average of two normals scaled by the inverse squared length
+     * so the stroke keeps its width around corners */
+    const struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(n0, n1), 0.5f);
+    const float dmr2 = dm.x * dm.x + dm.y * dm.y;
+    const float scale = (dmr2 > 0.000001f) ? NK_MIN(100.0f, 1.0f/dmr2): 1.0f;
+    return nk_vec2_muls(dm, scale);
+}
+#ifdef NK_SIMD_SSE2
+NK_INTERN __m128
+nk_draw_list_inv_sqrt_sse2(__m128 n)
+{
+    /* same steps as nk_inv_sqrt, so the results are identical */
+    const __m128 x2 = _mm_mul_ps(n, _mm_set1_ps(0.5f));
+    const __m128 f = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(0x5f375A84),
+        _mm_srli_epi32(_mm_castps_si128(n), 1)));
+    return _mm_mul_ps(f, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(x2, f), f)));
+}
+NK_INTERN __m128
+nk_draw_list_normals_sse2(__m128 p0, __m128 p1)
+{
+    /* normals of the two segments from `p0` to `p1`, each register holds
+     * two points. Lengths are summed in both lanes of a point */
+    const __m128 d = _mm_sub_ps(p1, p0);
+    const __m128 sq = _mm_mul_ps(d, d);
+    const __m128 len = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+    const __m128 empty = _mm_cmpeq_ps(len, _mm_setzero_ps());
+    const __m128 scale = _mm_or_ps(_mm_and_ps(empty, _mm_set1_ps(1.0f)),
+        _mm_andnot_ps(empty, nk_draw_list_inv_sqrt_sse2(len)));
+    const __m128 n = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2,3,0,1)),
+        _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+    return _mm_mul_ps(n, scale);
+}
+NK_INTERN __m128
+nk_draw_list_miter_sse2(__m128 n0, __m128 n1)
+{
+    /* nk_draw_list_miter for two points at once */
+    const __m128 dm = _mm_mul_ps(_mm_add_ps(n0, n1), _mm_set1_ps(0.5f));
+    const __m128 sq = _mm_mul_ps(dm, dm);
+    const __m128 dmr2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+    const __m128 valid = _mm_cmpgt_ps(dmr2, _mm_set1_ps(0.000001f));
+    const __m128 scale = _mm_min_ps(_mm_set1_ps(100.0f), _mm_div_ps(_mm_set1_ps(1.0f), dmr2));
+    return _mm_mul_ps(dm, _mm_or_ps(_mm_and_ps(valid, scale),
+        _mm_andnot_ps(valid, _mm_set1_ps(1.0f))));
+}
+#endif
 NK_API void
 nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *points,
     const unsigned int points_count, struct nk_color color, enum nk_draw_list_stroke closed,
@@ -9944,6 +11651,7 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         nk_size i1 = 0;
         nk_size vertex_offset;
         nk_size index = list->vertex_count;
+        nk_bool in_vertices = nk_false;
 
         const nk_size idx_count = (thick_line) ?  (count * 18) : (count * 12);
         const nk_size vtx_count = (thick_line) ? (points_count * 4): (points_count *3);
@@ -9956,68 +11664,91 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         if (!vtx || !ids) return;
 
         /* temporary allocate normals + points */
-        vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
-        nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
         size = pnt_size * ((thick_line) ? 5 : 3) * points_count;
-        normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
-        if (!normals) return;
+        normals = (struct nk_vec2*)nk_draw_list_alloc_temp(list, size, pnt_align);
+        if (!normals) {
+            vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
+            nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
+            normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
+            if (!normals) return;
+            in_vertices = nk_true;
+
+            /* make sure vertex pointer is still correct */
+            vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        }
         temp = normals + points_count;
 
-        /* make sure vertex pointer is still correct */
-        vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
-
-        /* calculate normals */
-        for (i1 = 0; i1 < count; ++i1) {
-            const nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-            struct nk_vec2 diff = nk_vec2_sub(points[i2], points[i1]);
-            float len;
-
-            /* vec2 inverted length  */
-            len = nk_vec2_len_sqr(diff);
-            if (len != 0.0f)
-                len = NK_INV_SQRT(len);
-            else len = 1.0f;
-
-            diff = nk_vec2_muls(diff, len);
-            normals[i1].x = diff.y;
-            normals[i1].y = -diff.x;
+        /* calculate normals, the segment closing the path is done outside
+         * of the loop so it stays free of branches and can be vectorized */
+        i1 = 0;
+#ifdef NK_SIMD_SSE2
+        for (; i1 + 4 < points_count; i1 += 4) {
+            const float *p = &points[i1].x;
+            _mm_storeu_ps(&normals[i1].x, nk_draw_list_normals_sse2(
+                _mm_loadu_ps(p), _mm_loadu_ps(p + 2)));
+            _mm_storeu_ps(&normals[i1+2].x, nk_draw_list_normals_sse2(
+                _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 6)));
         }
-
-        if (!closed)
-            normals[points_count-1] = normals[points_count-2];
+#endif
+        for (; i1 + 1 < points_count; ++i1) {
+            const float dx = points[i1+1].x - points[i1].x;
+            const float dy = points[i1+1].y - points[i1].y;
+            const float len = dx * dx + dy * dy;
+            const float inv_len = NK_INV_SQRT(len);
+            const float scale = (len != 0.0f) ? inv_len: 1.0f;
+            normals[i1].x = dy * scale;
+            normals[i1].y = -dx * scale;
+        }
+        if (closed) {
+            const struct nk_vec2 diff = nk_vec2_sub(points[0], points[points_count-1]);
+            const float len = nk_vec2_len_sqr(diff);
+            const float scale = (len != 0.0f) ? NK_INV_SQRT(len): 1.0f;
+            normals[points_count-1].x = diff.y * scale;
+            normals[points_count-1].y = -diff.x * scale;
+        } else normals[points_count-1] = normals[points_count-2];
 
         if (!thick_line) {
-            nk_size idx1, i;
+            nk_size i;
+            const struct nk_vec2 uv = list->config.tex_null.uv;
+
+            /* fringe points from the averaged normals of both adjacent segments */
             if (!closed) {
-                struct nk_vec2 d;
-                temp[0] = nk_vec2_add(points[0], nk_vec2_muls(normals[0], AA_SIZE));
-                temp[1] = nk_vec2_sub(points[0], nk_vec2_muls(normals[0], AA_SIZE));
-                d = nk_vec2_muls(normals[points_count-1], AA_SIZE);
-                temp[(points_count-1) * 2 + 0] = nk_vec2_add(points[points_count-1], d);
-                temp[(points_count-1) * 2 + 1] = nk_vec2_sub(points[points_count-1], d);
+                const struct nk_vec2 d = nk_vec2_muls(normals[0], AA_SIZE);
+                temp[0] = nk_vec2_add(points[0], d);
+                temp[1] = nk_vec2_sub(points[0], d);
+            } else {
+                const struct nk_vec2 dm = nk_vec2_muls(nk_draw_list_miter(
+                    normals[points_count-1], normals[0]), AA_SIZE);
+                temp[0] = nk_vec2_add(points[0], dm);
+                temp[1] = nk_vec2_sub(points[0], dm);
             }
-
-            /* fill elements */
-            idx1 = index;
-            for (i1 = 0; i1 < count; i1++) {
-                struct nk_vec2 dm;
-                float dmr2;
-                nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 3);
-
-                /* average normals */
-                dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+            i = 1;
+#ifdef NK_SIMD_SSE2
+            for (; i + 3 < points_count; i += 4) {
+                nk_size j;
+                for (j = i; j < i + 4; j += 2) {
+                    const __m128 p = _mm_loadu_ps(&points[j].x);
+                    const __m128 dm = _mm_mul_ps(nk_draw_list_miter_sse2(
+                        _mm_loadu_ps(&normals[j-1].x), _mm_loadu_ps(&normals[j].x)),
+                        _mm_set1_ps(AA_SIZE));
+                    const __m128 a = _mm_add_ps(p, dm);
+                    const __m128 b = _mm_sub_ps(p, dm);
+                    _mm_storeu_ps(&temp[j*2].x, _mm_movelh_ps(a, b));
+                    _mm_storeu_ps(&temp[j*2+2].x, _mm_movehl_ps(b, a));
                 }
+            }
+#endif
+            for (; i < points_count; ++i) {
+                const struct nk_vec2 dm = nk_vec2_muls(nk_draw_list_miter(
+                    normals[i-1], normals[i]), AA_SIZE);
+                temp[i*2+0] = nk_vec2_add(points[i], dm);
+                temp[i*2+1] = nk_vec2_sub(points[i], dm);
+            }
 
-                dm = nk_vec2_muls(dm, AA_SIZE);
-                temp[i2*2+0] = nk_vec2_add(points[i2], dm);
-                temp[i2*2+1] = nk_vec2_sub(points[i2], dm);
-
+            /* fill elements, every segment connects three vertices per point */
+            for (i1 = 0; i1 < count; ++i1) {
+                const nk_size idx1 = index + i1 * 3;
+                const nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 3);
                 ids[0] = (nk_draw_index)(idx2 + 0); ids[1] = (nk_draw_index)(idx1+0);
                 ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
                 ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+0);
@@ -10025,61 +11756,72 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 ids[8] = (nk_draw_index)(idx1 + 0); ids[9] = (nk_draw_index)(idx1+0);
                 ids[10]= (nk_draw_index)(idx2 + 0); ids[11]= (nk_draw_index)(idx2+1);
                 ids += 12;
-                idx1 = idx2;
             }
 
             /* fill vertices */
             for (i = 0; i < points_count; ++i) {
-                const struct nk_vec2 uv = list->config.tex_null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, points[i], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+1], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, points[i], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*2+0], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*2+1], uv, col_trans);
             }
         } else {
-            nk_size idx1, i;
+            nk_size i;
+            const struct nk_vec2 uv = list->config.tex_null.uv;
             const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
-            if (!closed) {
-                struct nk_vec2 d1 = nk_vec2_muls(normals[0], half_inner_thickness + AA_SIZE);
-                struct nk_vec2 d2 = nk_vec2_muls(normals[0], half_inner_thickness);
+            const float half_outer_thickness = half_inner_thickness + AA_SIZE;
 
+            /* outer and inner fringe points from the averaged normals */
+            if (!closed) {
+                const struct nk_vec2 d1 = nk_vec2_muls(normals[0], half_outer_thickness);
+                const struct nk_vec2 d2 = nk_vec2_muls(normals[0], half_inner_thickness);
                 temp[0] = nk_vec2_add(points[0], d1);
                 temp[1] = nk_vec2_add(points[0], d2);
                 temp[2] = nk_vec2_sub(points[0], d2);
                 temp[3] = nk_vec2_sub(points[0], d1);
-
-                d1 = nk_vec2_muls(normals[points_count-1], half_inner_thickness + AA_SIZE);
-                d2 = nk_vec2_muls(normals[points_count-1], half_inner_thickness);
-
-                temp[(points_count-1)*4+0] = nk_vec2_add(points[points_count-1], d1);
-                temp[(points_count-1)*4+1] = nk_vec2_add(points[points_count-1], d2);
-                temp[(points_count-1)*4+2] = nk_vec2_sub(points[points_count-1], d2);
-                temp[(points_count-1)*4+3] = nk_vec2_sub(points[points_count-1], d1);
+            } else {
+                const struct nk_vec2 dm = nk_draw_list_miter(normals[points_count-1], normals[0]);
+                const struct nk_vec2 dm_out = nk_vec2_muls(dm, half_outer_thickness);
+                const struct nk_vec2 dm_in = nk_vec2_muls(dm, half_inner_thickness);
+                temp[0] = nk_vec2_add(points[0], dm_out);
+                temp[1] = nk_vec2_add(points[0], dm_in);
+                temp[2] = nk_vec2_sub(points[0], dm_in);
+                temp[3] = nk_vec2_sub(points[0], dm_out);
             }
-
-            /* add all elements */
-            idx1 = index;
-            for (i1 = 0; i1 < count; ++i1) {
-                struct nk_vec2 dm_out, dm_in;
-                const nk_size i2 = ((i1+1) == points_count) ? 0: (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 4);
-
-                /* average normals */
-                struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                float dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+            i = 1;
+#ifdef NK_SIMD_SSE2
+            for (; i + 3 < points_count; i += 4) {
+                nk_size j;
+                for (j = i; j < i + 4; j += 2) {
+                    const __m128 p = _mm_loadu_ps(&points[j].x);
+                    const __m128 dm = nk_draw_list_miter_sse2(
+                        _mm_loadu_ps(&normals[j-1].x), _mm_loadu_ps(&normals[j].x));
+                    const __m128 dm_out = _mm_mul_ps(dm, _mm_set1_ps(half_outer_thickness));
+                    const __m128 dm_in = _mm_mul_ps(dm, _mm_set1_ps(half_inner_thickness));
+                    const __m128 out0 = _mm_add_ps(p, dm_out);
+                    const __m128 in0 = _mm_add_ps(p, dm_in);
+                    const __m128 in1 = _mm_sub_ps(p, dm_in);
+                    const __m128 out1 = _mm_sub_ps(p, dm_out);
+                    _mm_storeu_ps(&temp[j*4].x, _mm_movelh_ps(out0, in0));
+                    _mm_storeu_ps(&temp[j*4+2].x, _mm_movelh_ps(in1, out1));
+                    _mm_storeu_ps(&temp[j*4+4].x, _mm_movehl_ps(in0, out0));
+                    _mm_storeu_ps(&temp[j*4+6].x, _mm_movehl_ps(out1, in1));
                 }
+            }
+#endif
+            for (; i < points_count; ++i) {
+                const struct nk_vec2 dm = nk_draw_list_miter(normals[i-1], normals[i]);
+                const struct nk_vec2 dm_out = nk_vec2_muls(dm, half_outer_thickness);
+                const struct nk_vec2 dm_in = nk_vec2_muls(dm, half_inner_thickness);
+                temp[i*4+0] = nk_vec2_add(points[i], dm_out);
+                temp[i*4+1] = nk_vec2_add(points[i], dm_in);
+                temp[i*4+2] = nk_vec2_sub(points[i], dm_in);
+                temp[i*4+3] = nk_vec2_sub(points[i], dm_out);
+            }
 
-                dm_out = nk_vec2_muls(dm, ((half_inner_thickness) + AA_SIZE));
-                dm_in = nk_vec2_muls(dm, half_inner_thickness);
-                temp[i2*4+0] = nk_vec2_add(points[i2], dm_out);
-                temp[i2*4+1] = nk_vec2_add(points[i2], dm_in);
-                temp[i2*4+2] = nk_vec2_sub(points[i2], dm_in);
-                temp[i2*4+3] = nk_vec2_sub(points[i2], dm_out);
-
-                /* add indexes */
+            /* add all elements, every segment connects four vertices per point */
+            for (i1 = 0; i1 < count; ++i1) {
+                const nk_size idx1 = index + i1 * 4;
+                const nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 4);
                 ids[0] = (nk_draw_index)(idx2 + 1); ids[1] = (nk_draw_index)(idx1+1);
                 ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
                 ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+1);
@@ -10090,20 +11832,19 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 ids[14]= (nk_draw_index)(idx1 + 3); ids[15] = (nk_draw_index)(idx1+3);
                 ids[16]= (nk_draw_index)(idx2 + 3); ids[17] = (nk_draw_index)(idx2+2);
                 ids += 18;
-                idx1 = idx2;
             }
 
             /* add vertices */
             for (i = 0; i < points_count; ++i) {
-                const struct nk_vec2 uv = list->config.tex_null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+1], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+2], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+3], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+0], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+1], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+2], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+3], uv, col_trans);
             }
         }
         /* free temporary normals + points */
-        nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
+        if (in_vertices)
+            nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
     } else {
         /* NON ANTI-ALIASED STROKE */
         nk_size i1 = 0;
@@ -10134,10 +11875,10 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
             dx = diff.x * (thickness * 0.5f);
             dy = diff.y * (thickness * 0.5f);
 
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
 
             ids[0] = (nk_draw_index)(idx+0); ids[1] = (nk_draw_index)(idx+1);
             ids[2] = (nk_draw_index)(idx+2); ids[3] = (nk_draw_index)(idx+0);
@@ -10178,6 +11919,7 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
         const float AA_SIZE = 1.0f;
         nk_size vertex_offset = 0;
         nk_size index = list->vertex_count;
+        nk_bool in_vertices = nk_false;
 
         const nk_size idx_count = (points_count-2)*3 + points_count*6;
         const nk_size vtx_count = (points_count*2);
@@ -10192,12 +11934,16 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
         if (!vtx || !ids) return;
 
         /* temporary allocate normals */
-        vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
-        nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
         size = pnt_size * points_count;
-        normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
-        if (!normals) return;
-        vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        normals = (struct nk_vec2*)nk_draw_list_alloc_temp(list, size, pnt_align);
+        if (!normals) {
+            vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
+            nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
+            normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
+            if (!normals) return;
+            in_vertices = nk_true;
+            vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        }
 
         /* add elements */
         for (i = 2; i < points_count; i++) {
@@ -10239,8 +11985,8 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
             dm = nk_vec2_muls(dm, AA_SIZE * 0.5f);
 
             /* add vertices */
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_sub(points[i1], dm), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_add(points[i1], dm), uv, col_trans);
+            vtx = list->vertex_writer(vtx, list, nk_vec2_sub(points[i1], dm), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2_add(points[i1], dm), uv, col_trans);
 
             /* add indexes */
             ids[0] = (nk_draw_index)(vtx_inner_idx+(i1<<1));
@@ -10252,7 +11998,8 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
             ids += 6;
         }
         /* free temporary normals + points */
-        nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
+        if (in_vertices)
+            nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
     } else {
         nk_size i = 0;
         nk_size index = list->vertex_count;
@@ -10263,7 +12010,7 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
 
         if (!vtx || !ids) return;
         for (i = 0; i < vtx_count; ++i)
-            vtx = nk_draw_vertex(vtx, &list->config, points[i], list->config.tex_null.uv, col);
+            vtx = list->vertex_writer(vtx, list, points[i], list->config.tex_null.uv, col);
         for (i = 2; i < points_count; ++i) {
             ids[0] = (nk_draw_index)index;
             ids[1] = (nk_draw_index)(index+ i - 1);
@@ -10505,10 +12252,10 @@ nk_draw_list_fill_rect_multi_color(struct nk_draw_list *list, struct nk_rect rec
     idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
     idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
 
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y), list->config.tex_null.uv, col_left);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y), list->config.tex_null.uv, col_top);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.tex_null.uv, col_right);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y + rect.h), list->config.tex_null.uv, col_bottom);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x, rect.y), list->config.tex_null.uv, col_left);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x + rect.w, rect.y), list->config.tex_null.uv, col_top);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.tex_null.uv, col_right);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x, rect.y + rect.h), list->config.tex_null.uv, col_bottom);
 }
 NK_API void
 nk_draw_list_fill_triangle(struct nk_draw_list *list, struct nk_vec2 a,
@@ -10565,17 +12312,32 @@ nk_draw_list_stroke_curve(struct nk_draw_list *list, struct nk_vec2 p0,
     nk_draw_list_path_curve_to(list, cp0, cp1, p1, segments);
     nk_draw_list_path_stroke(list, col, NK_STROKE_OPEN, thickness);
 }
+NK_INTERN void*
+nk_draw_list_write_rect_uv(const struct nk_draw_list *list, void *vtx,
+    nk_draw_index *idx, nk_draw_index index, struct nk_vec2 a, struct nk_vec2 c,
+    struct nk_vec2 uva, struct nk_vec2 uvc, struct nk_colorf col)
+{
+    /* writes one textured quad into already reserved vertex and element memory */
+    struct nk_vec2 uvb = nk_vec2(uvc.x, uva.y);
+    struct nk_vec2 uvd = nk_vec2(uva.x, uvc.y);
+    struct nk_vec2 b = nk_vec2(c.x, a.y);
+    struct nk_vec2 d = nk_vec2(a.x, c.y);
+
+    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
+    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
+    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
+
+    vtx = list->vertex_writer(vtx, list, a, uva, col);
+    vtx = list->vertex_writer(vtx, list, b, uvb, col);
+    vtx = list->vertex_writer(vtx, list, c, uvc, col);
+    return list->vertex_writer(vtx, list, d, uvd, col);
+}
 NK_INTERN void
 nk_draw_list_push_rect_uv(struct nk_draw_list *list, struct nk_vec2 a,
     struct nk_vec2 c, struct nk_vec2 uva, struct nk_vec2 uvc,
     struct nk_color color)
 {
     void *vtx;
-    struct nk_vec2 uvb;
-    struct nk_vec2 uvd;
-    struct nk_vec2 b;
-    struct nk_vec2 d;
-
     struct nk_colorf col;
     nk_draw_index *idx;
     nk_draw_index index;
@@ -10583,24 +12345,11 @@ nk_draw_list_push_rect_uv(struct nk_draw_list *list, struct nk_vec2 a,
     if (!list) return;
 
     nk_color_fv(&col.r, color);
-    uvb = nk_vec2(uvc.x, uva.y);
-    uvd = nk_vec2(uva.x, uvc.y);
-    b = nk_vec2(c.x, a.y);
-    d = nk_vec2(a.x, c.y);
-
     index = (nk_draw_index)list->vertex_count;
     vtx = nk_draw_list_alloc_vertices(list, 4);
     idx = nk_draw_list_alloc_elements(list, 6);
     if (!vtx || !idx) return;
-
-    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
-    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
-    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
-
-    vtx = nk_draw_vertex(vtx, &list->config, a, uva, col);
-    vtx = nk_draw_vertex(vtx, &list->config, b, uvb, col);
-    vtx = nk_draw_vertex(vtx, &list->config, c, uvc, col);
-    vtx = nk_draw_vertex(vtx, &list->config, d, uvd, col);
+    nk_draw_list_write_rect_uv(list, vtx, idx, index, a, c, uva, uvc, col);
 }
 NK_API void
 nk_draw_list_add_image(struct nk_draw_list *list, struct nk_image texture,
@@ -10629,12 +12378,21 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
     struct nk_color fg)
 {
     float x = 0;
+    int i = 0;
     int text_len = 0;
     nk_rune unicode = 0;
     nk_rune next = 0;
     int glyph_len = 0;
-    int next_glyph_len = 0;
+    int glyph_count = 0;
     struct nk_user_font_glyph g;
+    struct nk_colorf col;
+    nk_draw_index *idx;
+    nk_draw_index index;
+    void *vtx;
+#ifdef NK_INCLUDE_FONT_BAKING
+    struct nk_font *baked = 0;
+    float scale = 0;
+#endif
 
     NK_ASSERT(list);
     if (!list || !len || !text) return;
@@ -10642,43 +12400,242 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
         list->clip_rect.x, list->clip_rect.y, list->clip_rect.w, list->clip_rect.h)) return;
 
     nk_draw_list_push_image(list, font->texture);
-    x = rect.x;
-    glyph_len = nk_utf_decode(text, &unicode, len);
-    if (!glyph_len) return;
+
+    /* count glyphs up to the first invalid one to reserve all quads at once */
+    while (text_len < len) {
+        if ((unsigned char)text[text_len] < 0x7F) {
+            glyph_len = 1;
+        } else {
+            glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+            if (!glyph_len || unicode == NK_UTF_INVALID) break;
+        }
+        text_len += glyph_len;
+        glyph_count++;
+    }
+    if (!glyph_count) return;
+    index = (nk_draw_index)list->vertex_count;
+    vtx = nk_draw_list_alloc_vertices(list, 4 * (nk_size)glyph_count);
+    idx = nk_draw_list_alloc_elements(list, 6 * (nk_size)glyph_count);
+    if (!vtx || !idx) return;
 
     /* draw every glyph image */
     fg.a = (nk_byte)((float)fg.a * list->config.global_alpha);
-    while (text_len < len && glyph_len) {
-        float gx, gy, gh, gw;
-        float char_width = 0;
-        if (unicode == NK_UTF_INVALID) break;
-
-        /* query currently drawn glyph information */
-        next_glyph_len = nk_utf_decode(text + text_len + glyph_len, &next, (int)len - text_len);
-        font->query(font->userdata, font_height, &g, unicode,
-                    (next == NK_UTF_INVALID) ? '\0' : next);
-
-        /* calculate and draw glyph drawing rectangle and image */
-        gx = x + g.offset.x;
-        gy = rect.y + g.offset.y;
-        gw = g.width; gh = g.height;
-        char_width = g.xadvance;
-        nk_draw_list_push_rect_uv(list, nk_vec2(gx,gy), nk_vec2(gx + gw, gy+ gh),
-            g.uv[0], g.uv[1], fg);
-
+    nk_color_fv(&col.r, fg);
+#ifdef NK_INCLUDE_FONT_BAKING
+    if ((baked = nk_font_from_user_font(font)) != 0)
+        scale = font_height / baked->info.height;
+#endif
+    x = rect.x;
+    text_len = 0;
+    for (i = 0; i < glyph_count; ++i) {
+        float gx, gy;
+        if ((unsigned char)text[text_len] < 0x7F) {
+            unicode = (nk_rune)text[text_len];
+            glyph_len = 1;
+        } else glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+#ifdef NK_INCLUDE_FONT_BAKING
+        if (baked) {
+            /* same glyph metrics `nk_font_query_font_glyph` would return */
+            const struct nk_font_glyph *bg = nk_font_find_glyph(baked, unicode);
+            gx = x + bg->x0 * scale;
+            gy = rect.y + bg->y0 * scale;
+            vtx = nk_draw_list_write_rect_uv(list, vtx, idx, index, nk_vec2(gx, gy),
+                nk_vec2(gx + (bg->x1 - bg->x0) * scale, gy + (bg->y1 - bg->y0) * scale),
+                nk_vec2(bg->u0, bg->v0), nk_vec2(bg->u1, bg->v1), col);
+            x += bg->xadvance * scale;
+        } else
+#endif
+        {
+            /* query currently drawn glyph information */
+            next = 0;
+            if (text_len + glyph_len < len) {
+                nk_utf_decode(text + text_len + glyph_len, &next, len - text_len - glyph_len);
+                if (next == NK_UTF_INVALID) next = 0;
+            }
+            font->query(font->userdata, font_height, &g, unicode, next);
+            gx = x + g.offset.x;
+            gy = rect.y + g.offset.y;
+            vtx = nk_draw_list_write_rect_uv(list, vtx, idx, index, nk_vec2(gx, gy),
+                nk_vec2(gx + g.width, gy + g.height), g.uv[0], g.uv[1], col);
+            x += g.xadvance;
+        }
         /* offset next glyph */
         text_len += glyph_len;
-        x += char_width;
-        glyph_len = next_glyph_len;
-        unicode = next;
+        index = (nk_draw_index)(index + 4);
+        idx += 6;
+    }
+}
+NK_INTERN void
+nk_convert_command(struct nk_draw_list *list, const struct nk_command *cmd,
+    const struct nk_convert_config *config)
+{
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = cmd->userdata;
+#endif
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_SCISSOR");
+        nk_draw_list_add_clip(list, nk_rect(s->x, s->y, s->w, s->h));
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_LINE");
+        nk_draw_list_stroke_line(list, nk_vec2(l->begin.x, l->begin.y),
+            nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CURVE");
+        nk_draw_list_stroke_curve(list, nk_vec2(q->begin.x, q->begin.y),
+            nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
+            q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
+            config->curve_segment_count, q->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT");
+        nk_draw_list_stroke_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding, r->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT_FILLED");
+        nk_draw_list_fill_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT_MULTI_COLOR");
+        nk_draw_list_fill_rect_multi_color(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->left, r->top, r->right, r->bottom);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CIRCLE");
+        nk_draw_list_stroke_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            config->circle_segment_count, c->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CIRCLE_FILLED");
+        nk_draw_list_fill_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            config->circle_segment_count);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_ARC");
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], config->arc_segment_count);
+        nk_draw_list_path_stroke(list, c->color, NK_STROKE_CLOSED, c->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_ARC_FILLED");
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], config->arc_segment_count);
+        nk_draw_list_path_fill(list, c->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TRIANGLE");
+        nk_draw_list_stroke_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
+            t->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TRIANGLE_FILLED");
+        nk_draw_list_fill_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYGON: {
+        int i;
+        const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYGON");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_CLOSED, p->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        int i;
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYGON_FILLED");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_fill(list, p->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        int i;
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYLINE");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_OPEN, p->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TEXT");
+        nk_draw_list_add_text(list, t->font, nk_rect(t->x, t->y, t->w, t->h),
+            t->string, t->length, t->height, t->foreground);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_IMAGE");
+        nk_draw_list_add_image(list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CUSTOM");
+        c->callback(list, c->x, c->y, c->w, c->h, c->callback_data);
+        NK_PROFILE_END;
+    } break;
+    default: break;
     }
 }
+NK_INTERN nk_flags
+nk_convert_result(const struct nk_buffer *cmds, const struct nk_buffer *vertices,
+    const struct nk_buffer *elements)
+{
+    nk_flags res = NK_CONVERT_SUCCESS;
+    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
+    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
+    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
+    return res;
+}
 NK_API nk_flags
 nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
     struct nk_buffer *vertices, struct nk_buffer *elements,
     const struct nk_convert_config *config)
 {
-    nk_flags res = NK_CONVERT_SUCCESS;
     const struct nk_command *cmd;
     NK_ASSERT(ctx);
     NK_ASSERT(cmds);
@@ -10687,133 +12644,527 @@ nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
     NK_ASSERT(config);
     NK_ASSERT(config->vertex_layout);
     NK_ASSERT(config->vertex_size);
-    if (!ctx || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+    if (!ctx || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert");
+
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    ctx->draw_list.scratch_arena = &ctx->frame;
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_begin(ctx);
+    nk_foreach(cmd, ctx) {
+        nk_stats_convert_command(ctx, cmd);
+        nk_convert_command(&ctx->draw_list, cmd, config);
+    }
+    nk_stats_convert_end(ctx);
+#else
+    nk_foreach(cmd, ctx)
+        nk_convert_command(&ctx->draw_list, cmd, config);
+#endif
+    NK_PROFILE_END;
+    return nk_convert_result(cmds, vertices, elements);
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_cache_init_default(struct nk_convert_cache *cache)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_cache_init(cache, &alloc);
+}
+#endif
+NK_API void
+nk_convert_cache_init(struct nk_convert_cache *cache, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(cache);
+    NK_ASSERT(alloc);
+    if (!cache || !alloc) return;
+
+    nk_zero(cache, sizeof(*cache));
+    nk_buffer_init(&cache->memory[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&cache->memory[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    /* window states start out zeroed so sequence zero never refers to valid data */
+    cache->seq = 1;
+}
+NK_API void
+nk_convert_cache_free(struct nk_convert_cache *cache)
+{
+    NK_ASSERT(cache);
+    if (!cache) return;
+    nk_buffer_free(&cache->memory[0]);
+    nk_buffer_free(&cache->memory[1]);
+    nk_zero(cache, sizeof(*cache));
+}
+NK_API void
+nk_convert_cache_invalidate(struct nk_convert_cache *cache)
+{
+    NK_ASSERT(cache);
+    if (!cache) return;
+    cache->invalid = nk_true;
+}
+NK_INTERN struct nk_draw_command*
+nk_draw_list_command_at(struct nk_draw_list *list, unsigned int index)
+{
+    /* draw commands are stored from the back of the buffer towards the front */
+    NK_ASSERT(index < list->cmd_count);
+    return nk_draw_list_command_last(list) + (list->cmd_count - 1 - index);
+}
+NK_INTERN nk_bool
+nk_draw_list_begin_segment(struct nk_draw_list *list)
+{
+    /* start a new draw command whose state does not depend on previous output */
+    struct nk_draw_command *cmd = 0;
+    if (list->cmd_count) {
+        cmd = nk_draw_list_command_last(list);
+        if (cmd->elem_count) cmd = 0;
+    }
+    if (!cmd) return nk_draw_list_push_command(list, list->clip_rect,
+        list->config.tex_null.texture) != 0;
+
+    cmd->clip_rect = list->clip_rect;
+    cmd->texture = list->config.tex_null.texture;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    cmd->userdata = list->userdata;
+#endif
+    return nk_true;
+}
+NK_INTERN nk_bool
+nk_convert_config_equal(const struct nk_convert_config *a,
+    const struct nk_convert_config *b)
+{
+    return a->global_alpha == b->global_alpha &&
+        a->line_AA == b->line_AA && a->shape_AA == b->shape_AA &&
+        a->circle_segment_count == b->circle_segment_count &&
+        a->arc_segment_count == b->arc_segment_count &&
+        a->curve_segment_count == b->curve_segment_count &&
+        a->tex_null.texture.id == b->tex_null.texture.id &&
+        a->tex_null.uv.x == b->tex_null.uv.x &&
+        a->tex_null.uv.y == b->tex_null.uv.y &&
+        a->vertex_layout == b->vertex_layout &&
+        a->vertex_size == b->vertex_size &&
+        a->vertex_alignment == b->vertex_alignment;
+}
+NK_INTERN void
+nk_convert_cache_replay(struct nk_draw_list *list, const struct nk_buffer *cache,
+    const struct nk_convert_cache_state *state)
+{
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    const nk_byte *memory = (const nk_byte*)cache->memory.ptr;
+    const struct nk_draw_command *cmds;
+    struct nk_draw_command *cmd;
+    unsigned int base = list->vertex_count;
+    unsigned int i;
+
+    /* first draw command was already started by `nk_draw_list_begin_segment` */
+    cmds = nk_ptr_add_const(struct nk_draw_command, memory, state->cmd_offset);
+    cmd = nk_draw_list_command_last(list);
+    *cmd = cmds[0];
+    for (i = 1; i < state->cmd_count; ++i) {
+        cmd = nk_draw_list_push_command(list, cmds[i].clip_rect, cmds[i].texture);
+        if (!cmd) return;
+        *cmd = cmds[i];
+    }
+    list->clip_rect = state->clip;
+
+    if (state->vertex_count) {
+        void *vtx = nk_draw_list_alloc_vertices(list, state->vertex_count);
+        if (!vtx) return;
+        NK_MEMCPY(vtx, memory + state->vertex_offset,
+            list->config.vertex_size * state->vertex_count);
+    }
+    if (state->element_count) {
+        const nk_draw_index *src;
+        nk_draw_index *ids = (nk_draw_index*)nk_buffer_alloc(list->elements,
+            NK_BUFFER_FRONT, elem_size * state->element_count, elem_align);
+        if (!ids) return;
+        src = nk_ptr_add_const(nk_draw_index, memory, state->element_offset);
+        for (i = 0; i < state->element_count; ++i)
+            ids[i] = (nk_draw_index)(src[i] + base);
+        list->element_count += state->element_count;
+    }
+}
+NK_INTERN nk_bool
+nk_convert_cache_store(struct nk_draw_list *list, struct nk_buffer *cache,
+    struct nk_convert_cache_state *state, unsigned int cmd_begin,
+    unsigned int vertex_begin, unsigned int element_begin)
+{
+    NK_STORAGE const nk_size cmd_align = NK_ALIGNOF(struct nk_draw_command);
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    void *dst;
+    unsigned int i;
+
+    /* partially converted output can not be cached */
+    if (nk_convert_result(list->buffer, list->vertices, list->elements) != NK_CONVERT_SUCCESS)
+        return nk_false;
+
+    state->cmd_count = list->cmd_count - cmd_begin;
+    state->vertex_count = list->vertex_count - vertex_begin;
+    state->element_count = list->element_count - element_begin;
+
+    dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT,
+        sizeof(struct nk_draw_command) * state->cmd_count, cmd_align);
+    if (!dst) return nk_false;
+    state->cmd_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+    for (i = 0; i < state->cmd_count; ++i)
+        ((struct nk_draw_command*)dst)[i] = *nk_draw_list_command_at(list, cmd_begin + i);
+
+    if (state->vertex_count) {
+        const nk_size size = list->config.vertex_size * state->vertex_count;
+        const void *src = nk_ptr_add_const(void, list->vertices->memory.ptr,
+            list->vertices->allocated - size);
+        dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT, size, list->config.vertex_alignment);
+        if (!dst) return nk_false;
+        state->vertex_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+        NK_MEMCPY(dst, src, size);
+    }
+    if (state->element_count) {
+        /* indices are stored relative to the first vertex of the window */
+        const nk_size size = elem_size * state->element_count;
+        const nk_draw_index *src = nk_ptr_add_const(nk_draw_index,
+            list->elements->memory.ptr, list->elements->allocated - size);
+        dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT, size, elem_align);
+        if (!dst) return nk_false;
+        state->element_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+        for (i = 0; i < state->element_count; ++i)
+            ((nk_draw_index*)dst)[i] = (nk_draw_index)(src[i] - vertex_begin);
+    }
+    state->clip = list->clip_rect;
+    return nk_true;
+}
+NK_INTERN struct nk_window*
+nk_convert_cache_next_window(const struct nk_context *ctx, struct nk_window *win)
+{
+    /* same visibility rules `nk_build` uses to link window command buffers */
+    while (win && (win->buffer.last == win->buffer.begin ||
+        (win->flags & NK_WINDOW_HIDDEN) || win->seq != ctx->seq))
+        win = win->next;
+    return win;
+}
+NK_INTERN const struct nk_command*
+nk_convert_cache_window(struct nk_context *ctx, struct nk_convert_cache *cache,
+    struct nk_window *win, const struct nk_command *begin, nk_bool valid)
+{
+    struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_convert_cache_state *state = &win->convert_cache;
+    struct nk_buffer *cur = &cache->memory[cache->seq & 1];
+    const struct nk_buffer *prev = &cache->memory[(cache->seq-1) & 1];
+    const struct nk_command *last;
+    const struct nk_command *end;
+    const struct nk_command *cmd;
+    unsigned int cmd_begin, vertex_begin, element_begin;
+    nk_bool cacheable = nk_true;
+    nk_hash hash[2];
+
+    /* hash every command of the window together with the incoming clip rect.
+     * A single 32-bit hash collides too easily to silently reuse stale
+     * vertices on, so two differently seeded lanes form a 64-bit key */
+    last = nk_ptr_add_const(struct nk_command, ctx->memory.memory.ptr, win->buffer.last);
+    hash[0] = nk_murmur_hash(&list->clip_rect, (int)sizeof(list->clip_rect), 0);
+    hash[1] = nk_murmur_hash(&list->clip_rect, (int)sizeof(list->clip_rect), 0x9E3779B9u);
+    for (cmd = begin; cmd; cmd = nk__next(ctx, cmd)) {
+        hash[0] = nk_command_hash(cmd, hash[0]);
+        hash[1] = nk_command_hash(cmd, hash[1]);
+        if (cmd->type == NK_COMMAND_CUSTOM)
+            cacheable = nk_false;
+        if (cmd == last) {
+            cmd = nk__next(ctx, cmd);
+            break;
+        }
+    }
+    end = cmd;
+
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = begin->userdata;
+#endif
+    if (!nk_draw_list_begin_segment(list))
+        cacheable = nk_false;
+    cmd_begin = list->cmd_count ? list->cmd_count - 1: 0;
+    vertex_begin = list->vertex_count;
+    element_begin = list->element_count;
+
+    if (valid && cacheable && state->seq && state->seq == cache->seq-1 &&
+        state->hash[0] == hash[0] && state->hash[1] == hash[1]) {
+        nk_convert_cache_replay(list, prev, state);
+        cache->reused++;
+    } else {
+        for (cmd = begin; cmd != end; cmd = nk__next(ctx, cmd))
+            nk_convert_command(list, cmd, &list->config);
+        cache->converted++;
+    }
+    if (cacheable && nk_convert_cache_store(list, cur, state, cmd_begin, vertex_begin, element_begin)) {
+        state->seq = cache->seq;
+        state->hash[0] = hash[0];
+        state->hash[1] = hash[1];
+    } else state->seq = 0;
+    return end;
+}
+NK_API nk_flags
+nk_convert_cached(struct nk_context *ctx, struct nk_convert_cache *cache,
+    struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    const struct nk_command *cmd;
+    struct nk_window *win;
+    nk_bool valid;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(cache);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cache || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert_cached");
+
+    /* a different configuration produces different vertices */
+    valid = !cache->invalid && nk_convert_config_equal(&cache->config, config);
+    cache->invalid = nk_false;
+    cache->config = *config;
+    cache->seq++;
+    cache->reused = 0;
+    cache->converted = 0;
+    nk_buffer_clear(&cache->memory[cache->seq & 1]);
+
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    ctx->draw_list.scratch_arena = &ctx->frame;
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_begin(ctx);
+#endif
+    cmd = nk__begin(ctx);
+    win = nk_convert_cache_next_window(ctx, ctx->begin);
+    while (cmd) {
+        const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+#ifdef NK_INCLUDE_STATISTICS
+        nk_stats_convert_command(ctx, cmd);
+#endif
+        if (win && offset == win->buffer.begin) {
+            /* window commands: either copied from cache or converted and stored */
+            cmd = nk_convert_cache_window(ctx, cache, win, cmd, valid);
+            win = nk_convert_cache_next_window(ctx, win->next);
+        } else {
+            /* popups and overlay are always converted */
+            nk_convert_command(&ctx->draw_list, cmd, config);
+            cmd = nk__next(ctx, cmd);
+        }
+    }
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_end(ctx);
+#endif
+    NK_PROFILE_END;
+    return nk_convert_result(cmds, vertices, elements);
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_pool_init_default(struct nk_convert_pool *pool,
+    nk_convert_dispatch dispatch, nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_pool_init(pool, &alloc, dispatch, userdata);
+}
+#endif
+NK_API void
+nk_convert_pool_init(struct nk_convert_pool *pool, const struct nk_allocator *alloc,
+    nk_convert_dispatch dispatch, nk_handle userdata)
+{
+    NK_ASSERT(pool);
+    NK_ASSERT(alloc);
+    if (!pool || !alloc) return;
+
+    nk_zero(pool, sizeof(*pool));
+    pool->alloc = *alloc;
+    pool->dispatch = dispatch;
+    pool->userdata = userdata;
+}
+NK_API void
+nk_convert_pool_free(struct nk_convert_pool *pool)
+{
+    int i;
+    NK_ASSERT(pool);
+    if (!pool) return;
+    for (i = 0; i < pool->capacity; ++i) {
+        nk_buffer_free(&pool->jobs[i].cmds);
+        nk_buffer_free(&pool->jobs[i].vertices);
+        nk_buffer_free(&pool->jobs[i].elements);
+    }
+    if (pool->jobs)
+        pool->alloc.free(pool->alloc.userdata, pool->jobs);
+    nk_zero(pool, sizeof(*pool));
+}
+NK_INTERN struct nk_convert_job*
+nk_convert_pool_push(struct nk_convert_pool *pool)
+{
+    struct nk_convert_job *job;
+    if (pool->count == pool->capacity) {
+        /* grow job array while keeping the buffers of existing jobs */
+        int i, capacity = NK_MAX(pool->capacity * 2, 8);
+        struct nk_convert_job *jobs = (struct nk_convert_job*)
+            pool->alloc.alloc(pool->alloc.userdata, pool->jobs,
+                sizeof(struct nk_convert_job) * (nk_size)capacity);
+        if (!jobs) return 0;
+        if (pool->jobs) {
+            NK_MEMCPY(jobs, pool->jobs, sizeof(struct nk_convert_job) * (nk_size)pool->capacity);
+            pool->alloc.free(pool->alloc.userdata, pool->jobs);
+        }
+        for (i = pool->capacity; i < capacity; ++i) {
+            nk_draw_list_init(&jobs[i].list);
+            nk_buffer_init(&jobs[i].cmds, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+            nk_buffer_init(&jobs[i].vertices, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+            nk_buffer_init(&jobs[i].elements, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+        }
+        pool->jobs = jobs;
+        pool->capacity = capacity;
+    }
+    job = &pool->jobs[pool->count++];
+    nk_buffer_clear(&job->cmds);
+    nk_buffer_clear(&job->vertices);
+    nk_buffer_clear(&job->elements);
+    job->result = NK_CONVERT_SUCCESS;
+    return job;
+}
+NK_API void
+nk_convert_job_run(struct nk_convert_job *job)
+{
+    const struct nk_command *cmd;
+    NK_ASSERT(job);
+    if (!job) return;
+
+    /* first draw command carries the clip rect left by previous jobs */
+    if (!nk_draw_list_begin_segment(&job->list)) {
+        job->result = nk_convert_result(&job->cmds, &job->vertices, &job->elements);
+        return;
+    }
+    for (cmd = job->begin; cmd != job->end; cmd = nk__next(job->ctx, cmd))
+        nk_convert_command(&job->list, cmd, &job->list.config);
+    job->result = nk_convert_result(&job->cmds, &job->vertices, &job->elements);
+}
+NK_INTERN void
+nk_convert_job_append(struct nk_draw_list *list, struct nk_convert_job *job)
+{
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    struct nk_draw_list *src = &job->list;
+    const unsigned int base = list->vertex_count;
+    unsigned int i;
+
+    for (i = 0; i < src->cmd_count; ++i) {
+        const struct nk_draw_command *from = nk_draw_list_command_at(src, i);
+        struct nk_draw_command *cmd = nk_draw_list_push_command(list, from->clip_rect, from->texture);
+        if (!cmd) return;
+        *cmd = *from;
+    }
+    if (src->vertex_count) {
+        const nk_size size = list->config.vertex_size * src->vertex_count;
+        void *vtx = nk_draw_list_alloc_vertices(list, src->vertex_count);
+        if (!vtx) return;
+        NK_MEMCPY(vtx, nk_ptr_add_const(void, job->vertices.memory.ptr,
+            job->vertices.allocated - size), size);
+    }
+    if (src->element_count) {
+        /* job indices start at the first vertex of the job */
+        const nk_size size = elem_size * src->element_count;
+        const nk_draw_index *from = nk_ptr_add_const(nk_draw_index,
+            job->elements.memory.ptr, job->elements.allocated - size);
+        nk_draw_index *ids = (nk_draw_index*)nk_buffer_alloc(list->elements,
+            NK_BUFFER_FRONT, size, elem_align);
+        if (!ids) return;
+        for (i = 0; i < src->element_count; ++i)
+            ids[i] = (nk_draw_index)(from[i] + base);
+        list->element_count += src->element_count;
+    }
+}
+NK_API nk_flags
+nk_convert_parallel(struct nk_context *ctx, struct nk_convert_pool *pool,
+    struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    const struct nk_command *cmd;
+    struct nk_convert_job *job = 0;
+    struct nk_window *win;
+    struct nk_rect clip = nk_null_rect;
+    nk_flags res;
+    int i;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(pool);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !pool || !cmds || !vertices || !elements || !config || !config->vertex_layout)
         return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert_parallel");
+
+    /* split draw commands on window boundaries into jobs */
+    pool->count = 0;
+    win = nk_convert_cache_next_window(ctx, ctx->begin);
+    for (cmd = nk__begin(ctx); cmd; cmd = nk__next(ctx, cmd)) {
+        const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+        if (!job || (win && offset == win->buffer.begin)) {
+            if (job) job->end = cmd;
+            job = nk_convert_pool_push(pool);
+            if (!job) {
+                NK_PROFILE_END;
+                return nk_convert(ctx, cmds, vertices, elements, config);
+            }
+            job->ctx = ctx;
+            job->begin = cmd;
+            job->end = 0;
+            job->clip = clip;
+            if (win && offset == win->buffer.begin)
+                win = nk_convert_cache_next_window(ctx, win->next);
+        }
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+            clip = nk_rect(s->x, s->y, s->w, s->h);
+        }
+    }
+
+    /* tessellate all jobs and append their output in order */
+    for (i = 0; i < pool->count; ++i) {
+        job = &pool->jobs[i];
+        nk_draw_list_setup(&job->list, config, &job->cmds, &job->vertices,
+            &job->elements, config->line_AA, config->shape_AA);
+        job->list.clip_rect = job->clip;
+    }
+    if (pool->dispatch && pool->count > 1)
+        pool->dispatch(pool->userdata, pool->jobs, pool->count);
+    else for (i = 0; i < pool->count; ++i)
+        nk_convert_job_run(&pool->jobs[i]);
 
     nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
         config->line_AA, config->shape_AA);
-    nk_foreach(cmd, ctx)
-    {
-#ifdef NK_INCLUDE_COMMAND_USERDATA
-        ctx->draw_list.userdata = cmd->userdata;
+    res = NK_CONVERT_SUCCESS;
+#ifdef NK_INCLUDE_STATISTICS
+    /* jobs start on window boundaries, so popups and overlay count
+     * towards the last window */
+    nk_stats_convert_begin(ctx);
 #endif
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
-            nk_draw_list_add_clip(&ctx->draw_list, nk_rect(s->x, s->y, s->w, s->h));
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line*)cmd;
-            nk_draw_list_stroke_line(&ctx->draw_list, nk_vec2(l->begin.x, l->begin.y),
-                nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
-            nk_draw_list_stroke_curve(&ctx->draw_list, nk_vec2(q->begin.x, q->begin.y),
-                nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
-                q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
-                config->curve_segment_count, q->line_thickness);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
-            nk_draw_list_stroke_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding, r->line_thickness);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
-            nk_draw_list_fill_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR: {
-            const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
-            nk_draw_list_fill_rect_multi_color(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->left, r->top, r->right, r->bottom);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
-            nk_draw_list_stroke_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count, c->line_thickness);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_draw_list_fill_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count);
-        } break;
-        case NK_COMMAND_ARC: {
-            const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_stroke(&ctx->draw_list, c->color, NK_STROKE_CLOSED, c->line_thickness);
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_fill(&ctx->draw_list, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
-            nk_draw_list_stroke_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
-                t->line_thickness);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
-            nk_draw_list_fill_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            int i;
-            const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_CLOSED, p->line_thickness);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            int i;
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_fill(&ctx->draw_list, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            int i;
-            const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_OPEN, p->line_thickness);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_draw_list_add_text(&ctx->draw_list, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *i = (const struct nk_command_image*)cmd;
-            nk_draw_list_add_image(&ctx->draw_list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
-        } break;
-        case NK_COMMAND_CUSTOM: {
-            const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
-            c->callback(&ctx->draw_list, c->x, c->y, c->w, c->h, c->callback_data);
-        } break;
-        default: break;
-        }
+    for (i = 0; i < pool->count; ++i) {
+#ifdef NK_INCLUDE_STATISTICS
+        nk_stats_convert_command(ctx, pool->jobs[i].begin);
+#endif
+        nk_convert_job_append(&ctx->draw_list, &pool->jobs[i]);
+        res |= pool->jobs[i].result;
     }
-    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
-    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
-    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
-    return res;
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_end(ctx);
+#endif
+    NK_PROFILE_END;
+    return res | nk_convert_result(cmds, vertices, elements);
 }
 NK_API const struct nk_draw_command*
 nk__draw_begin(const struct nk_context *ctx,
@@ -16998,18 +19349,22 @@ nk_font_text_width(nk_handle handle, float height, const char *text, int len)
         return 0;
 
     scale = height/font->info.height;
-    glyph_len = text_len = nk_utf_decode(text, &unicode, (int)len);
-    if (!glyph_len) return 0;
-    while (text_len <= (int)len && glyph_len) {
+    while (text_len < len) {
         const struct nk_font_glyph *g;
-        if (unicode == NK_UTF_INVALID) break;
+        const unsigned char c = (unsigned char)text[text_len];
+        if (c < 0x7F) {
+            /* ASCII: single byte glyph with precomputed advance
+             * (DEL is rejected by `nk_utf_decode` so it takes the slow path) */
+            text_width += font->ascii_advance[c] * scale;
+            text_len++;
+            continue;
+        }
+        glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+        if (!glyph_len || unicode == NK_UTF_INVALID) break;
 
         /* query currently drawn glyph information */
         g = nk_font_find_glyph(font, unicode);
         text_width += g->xadvance * scale;
-
-        /* offset next glyph */
-        glyph_len = nk_utf_decode(text + text_len, &unicode, (int)len - text_len);
         text_len += glyph_len;
     }
     return text_width;
@@ -17041,6 +19396,13 @@ nk_font_query_font_glyph(nk_handle handle, float height,
     glyph->uv[0] = nk_vec2(g->u0, g->v0);
     glyph->uv[1] = nk_vec2(g->u1, g->v1);
 }
+NK_LIB struct nk_font*
+nk_font_from_user_font(const struct nk_user_font *font)
+{
+    /* baked fonts can be read directly instead of through `query` */
+    if (!font || font->query != nk_font_query_font_glyph) return 0;
+    return (struct nk_font*)font->userdata.ptr;
+}
 #endif
 NK_API const struct nk_font_glyph*
 nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
@@ -17056,6 +19418,14 @@ nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
     NK_ASSERT(font->info.ranges);
     if (!font || !font->glyphs) return 0;
 
+    if (font->glyph_pages && unicode <= 0xFFFF) {
+        /* basic multilingual plane: two level table built at bake time */
+        nk_uint index;
+        nk_ushort page = font->glyph_pages[unicode >> 8];
+        if (!page) return font->fallback;
+        index = font->glyph_index[((nk_uint)(page - 1) << 8) | (unicode & 0xFF)];
+        return (index) ? &font->glyphs[index - 1] : font->fallback;
+    }
     glyph = font->fallback;
     iter = font->config;
     do {count = nk_range_count(iter->range);
@@ -17070,12 +19440,85 @@ nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
     } while ((iter = iter->n) != font->config);
     return glyph;
 }
+NK_INTERN int
+nk_font_glyph_pages(nk_ushort *pages, const struct nk_font_config *config)
+{
+    /* marks each basic plane page covered by the font's ranges */
+    int i, count, page_count = 0;
+    const struct nk_font_config *iter = config;
+    NK_MEMSET(pages, 0, 256 * sizeof(nk_ushort));
+    do {count = nk_range_count(iter->range);
+        for (i = 0; i < count; ++i) {
+            nk_rune f = iter->range[(i*2)+0];
+            nk_rune t = NK_MIN(iter->range[(i*2)+1], 0xFFFF);
+            for (; f <= t && f <= 0xFFFF; f = (f | 0xFF) + 1) {
+                if (!pages[f >> 8])
+                    pages[f >> 8] = (nk_ushort)++page_count;
+            }
+        }
+    } while ((iter = iter->n) != config);
+    return page_count;
+}
+NK_INTERN void
+nk_font_glyph_index(nk_uint *index, const nk_ushort *pages,
+    const struct nk_font_config *config)
+{
+    /* same search order as the range walk in `nk_font_find_glyph` */
+    int i, count;
+    nk_uint total_glyphs = 0;
+    const struct nk_font_config *iter = config;
+    do {count = nk_range_count(iter->range);
+        for (i = 0; i < count; ++i) {
+            nk_rune f = iter->range[(i*2)+0];
+            nk_rune t = iter->range[(i*2)+1];
+            nk_rune u;
+            for (u = f; u <= t && u <= 0xFFFF; ++u) {
+                nk_uint *slot = &index[((nk_uint)(pages[u >> 8] - 1) << 8) | (u & 0xFF)];
+                if (!*slot) *slot = total_glyphs + (u - f) + 1;
+            }
+            total_glyphs += (t - f) + 1;
+        }
+    } while ((iter = iter->n) != config);
+}
+NK_INTERN nk_bool
+nk_font_atlas_build_lookup(struct nk_font_atlas *atlas)
+{
+    /* one allocation holding the glyph page tables of all fonts */
+    nk_ushort pages[256];
+    struct nk_font *font;
+    nk_size font_count = 0, page_count = 0;
+    nk_ushort *page_iter;
+    nk_uint *index_iter;
+
+    for (font = atlas->fonts; font; font = font->next) {
+        page_count += (nk_size)nk_font_glyph_pages(pages, font->config);
+        font_count++;
+    }
+    atlas->glyph_lookup = atlas->permanent.alloc(atlas->permanent.userdata, 0,
+        font_count * sizeof(pages) + page_count * 256 * sizeof(nk_uint));
+    NK_ASSERT(atlas->glyph_lookup);
+    if (!atlas->glyph_lookup) return nk_false;
+
+    page_iter = (nk_ushort*)atlas->glyph_lookup;
+    index_iter = (nk_uint*)(void*)(page_iter + font_count * 256);
+    NK_MEMSET(index_iter, 0, page_count * 256 * sizeof(nk_uint));
+    for (font = atlas->fonts; font; font = font->next) {
+        int n = nk_font_glyph_pages(page_iter, font->config);
+        nk_font_glyph_index(index_iter, page_iter, font->config);
+        font->glyph_pages = page_iter;
+        font->glyph_index = index_iter;
+        page_iter += 256;
+        index_iter += n * 256;
+    }
+    return nk_true;
+}
 NK_INTERN void
 nk_font_init(struct nk_font *font, float pixel_height,
     nk_rune fallback_codepoint, struct nk_font_glyph *glyphs,
     const struct nk_baked_font *baked_font, nk_handle atlas)
 {
     struct nk_baked_font baked;
+    nk_size i;
     NK_ASSERT(font);
     NK_ASSERT(glyphs);
     NK_ASSERT(baked_font);
@@ -17090,6 +19533,10 @@ nk_font_init(struct nk_font *font, float pixel_height,
     font->texture = atlas;
     font->fallback_codepoint = fallback_codepoint;
     font->fallback = nk_font_find_glyph(font, fallback_codepoint);
+    for (i = 0; i < NK_LEN(font->ascii_advance); ++i) {
+        const struct nk_font_glyph *g = nk_font_find_glyph(font, (nk_rune)i);
+        font->ascii_advance[i] = (g) ? g->xadvance : 0;
+    }
 
     font->handle.height = font->info.height * font->scale;
     font->handle.width = nk_font_text_width;
@@ -17465,6 +19912,10 @@ nk_font_atlas_begin(struct nk_font_atlas *atlas)
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
         atlas->glyphs = 0;
     }
+    if (atlas->glyph_lookup) {
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
+        atlas->glyph_lookup = 0;
+    }
     if (atlas->pixel) {
         atlas->permanent.free(atlas->permanent.userdata, atlas->pixel);
         atlas->pixel = 0;
@@ -17709,6 +20160,7 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
         !atlas->temporary.alloc || !atlas->temporary.free ||
         !atlas->permanent.alloc || !atlas->permanent.free)
         return 0;
+    NK_PROFILE_BEGIN("nk_font_atlas_bake");
 
 #ifdef NK_INCLUDE_DEFAULT_FONT
     /* no font added so just use default font */
@@ -17716,7 +20168,10 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
         atlas->default_font = nk_font_atlas_add_default(atlas, 13.0f, 0);
 #endif
     NK_ASSERT(atlas->font_num);
-    if (!atlas->font_num) return 0;
+    if (!atlas->font_num) {
+        NK_PROFILE_END;
+        return 0;
+    }
 
     /* allocate temporary baker memory required for the baking process */
     nk_font_baker_memory(&tmp_size, &atlas->glyph_count, atlas->config, atlas->font_num);
@@ -17765,7 +20220,9 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
     atlas->tex_width = *width;
     atlas->tex_height = *height;
 
-    /* initialize each font */
+    /* build glyph lookup tables and initialize each font */
+    if (!nk_font_atlas_build_lookup(atlas))
+        goto failed;
     for (font_iter = atlas->fonts; font_iter; font_iter = font_iter->next) {
         struct nk_font *font = font_iter;
         struct nk_font_config *config = font->config;
@@ -17797,6 +20254,7 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
     }}
     /* free temporary memory */
     atlas->temporary.free(atlas->temporary.userdata, tmp);
+    NK_PROFILE_END;
     return atlas->pixel;
 
 failed:
@@ -17806,10 +20264,15 @@ failed:
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
         atlas->glyphs = 0;
     }
+    if (atlas->glyph_lookup) {
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
+        atlas->glyph_lookup = 0;
+    }
     if (atlas->pixel) {
         atlas->temporary.free(atlas->temporary.userdata, atlas->pixel);
         atlas->pixel = 0;
     }
+    NK_PROFILE_END;
     return 0;
 }
 NK_API void
@@ -17906,6 +20369,8 @@ nk_font_atlas_clear(struct nk_font_atlas *atlas)
     }
     if (atlas->glyphs)
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
+    if (atlas->glyph_lookup)
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
     nk_zero_struct(*atlas);
 }
 #endif
@@ -19051,6 +21516,19 @@ nk_setup(struct nk_context *ctx, const struct nk_user_font *font)
     nk_draw_list_init(&ctx->draw_list);
 #endif
 }
+NK_INTERN void
+nk_setup_pools(struct nk_context *ctx, const struct nk_allocator *alloc)
+{
+    /* every element type gets its own pool with exactly sized slots */
+    nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_WINDOW));
+    nk_pool_init(&ctx->state_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_WINDOW_STATE));
+    nk_pool_init(&ctx->panel_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_PANEL));
+    nk_pool_init(&ctx->table_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_TABLE));
+}
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API nk_bool
 nk_init_default(struct nk_context *ctx, const struct nk_user_font *font)
@@ -19080,6 +21558,7 @@ nk_init_custom(struct nk_context *ctx, struct nk_buffer *cmds,
     NK_ASSERT(cmds);
     NK_ASSERT(pool);
     if (!cmds || !pool) return 0;
+    NK_ASSERT(pool->type != NK_BUFFER_VIRTUAL);
 
     nk_setup(ctx, font);
     ctx->memory = *cmds;
@@ -19089,7 +21568,8 @@ nk_init_custom(struct nk_context *ctx, struct nk_buffer *cmds,
     } else {
         /* create dynamic pool from buffer allocator */
         struct nk_allocator *alloc = &pool->pool;
-        nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+        nk_setup_pools(ctx, alloc);
+        nk_frame_arena_init(&ctx->frame, alloc);
     }
     ctx->use_pool = nk_true;
     return 1;
@@ -19102,7 +21582,8 @@ nk_init(struct nk_context *ctx, const struct nk_allocator *alloc,
     if (!alloc) return 0;
     nk_setup(ctx, font);
     nk_buffer_init(&ctx->memory, alloc, NK_DEFAULT_COMMAND_BUFFER_SIZE);
-    nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+    nk_setup_pools(ctx, alloc);
+    nk_frame_arena_init(&ctx->frame, alloc);
     ctx->use_pool = nk_true;
     return 1;
 }
@@ -19122,8 +21603,22 @@ nk_free(struct nk_context *ctx)
     NK_ASSERT(ctx);
     if (!ctx) return;
     nk_buffer_free(&ctx->memory);
-    if (ctx->use_pool)
+    nk_frame_arena_free(&ctx->frame);
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    if (ctx->text_edit && !ctx->shared && ctx->use_pool && ctx->pool.alloc.free)
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, ctx->text_edit);
+    ctx->text_edit = 0;
+    ctx->shared = 0;
+#endif
+    nk_window_index_free(ctx);
+    while (ctx->value_index_owners)
+        nk_value_index_free(ctx, ctx->value_index_owners);
+    if (ctx->use_pool) {
         nk_pool_free(&ctx->pool);
+        nk_pool_free(&ctx->state_pool);
+        nk_pool_free(&ctx->panel_pool);
+        nk_pool_free(&ctx->table_pool);
+    }
 
     nk_zero(&ctx->input, sizeof(ctx->input));
     nk_zero(&ctx->style, sizeof(ctx->style));
@@ -19138,6 +21633,86 @@ nk_free(struct nk_context *ctx)
     ctx->freelist = 0;
     ctx->count = 0;
 }
+NK_LIB struct nk_text_edit*
+nk_context_text_edit(struct nk_context *ctx)
+{
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    /* the editor is followed by its initial undo storage, since the string
+     * it edits is user memory the history cannot grow from */
+    NK_STORAGE const nk_size size = sizeof(struct nk_text_edit) +
+        NK_TEXTEDIT_UNDOSTATECOUNT * sizeof(struct nk_text_undo_record) +
+        NK_TEXTEDIT_UNDOCHARCOUNT * sizeof(nk_rune);
+    struct nk_text_edit *edit = ctx->text_edit;
+    if (edit) return edit;
+    if (ctx->shared && ctx->shared->text_edit) {
+        /* one editor for every context of the shared state */
+        ctx->text_edit = ctx->shared->text_edit;
+        return ctx->text_edit;
+    }
+    if (ctx->shared) {
+        struct nk_shared_state *shared = ctx->shared;
+        if (shared->alloc.alloc)
+            edit = (struct nk_text_edit*)shared->alloc.alloc(
+                shared->alloc.userdata, 0, size);
+        shared->text_edit = edit;
+    } else if (ctx->use_pool) {
+        /* back buffer memory is cleared each frame so ask the allocator */
+        if (ctx->pool.alloc.alloc)
+            edit = (struct nk_text_edit*)ctx->pool.alloc.alloc(
+                ctx->pool.alloc.userdata, 0, size);
+    } else {
+        /* fixed memory contexts keep it at the back with the page elements */
+        NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_text_edit);
+        edit = (struct nk_text_edit*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK,
+            size, align);
+    }
+    NK_ASSERT(edit);
+    if (!edit) return 0;
+    nk_zero(edit, size);
+    edit->undo.undo_rec = (struct nk_text_undo_record*)(void*)(edit + 1);
+    edit->undo.undo_char = (nk_rune*)(void*)(edit->undo.undo_rec + NK_TEXTEDIT_UNDOSTATECOUNT);
+    ctx->text_edit = edit;
+    return edit;
+#else
+    return &ctx->text_edit;
+#endif
+}
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+NK_API void
+nk_shared_state_init(struct nk_shared_state *shared, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(shared);
+    NK_ASSERT(alloc);
+    if (!shared || !alloc) return;
+    nk_zero(shared, sizeof(*shared));
+    shared->alloc = *alloc;
+}
+NK_API void
+nk_shared_state_free(struct nk_shared_state *shared)
+{
+    NK_ASSERT(shared);
+    if (!shared) return;
+    if (shared->text_edit && shared->alloc.free)
+        shared->alloc.free(shared->alloc.userdata, shared->text_edit);
+    shared->text_edit = 0;
+}
+NK_API void
+nk_use_shared_state(struct nk_context *ctx, struct nk_shared_state *shared)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(!ctx->text_edit);
+    if (!ctx || ctx->text_edit) return;
+    ctx->shared = shared;
+}
+#endif
+NK_API nk_size
+nk_trim(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->use_pool) return 0;
+    return nk_pool_trim(&ctx->pool) + nk_pool_trim(&ctx->state_pool) +
+        nk_pool_trim(&ctx->panel_pool) + nk_pool_trim(&ctx->table_pool);
+}
 NK_API void
 nk_clear(struct nk_context *ctx)
 {
@@ -19146,10 +21721,20 @@ nk_clear(struct nk_context *ctx)
     NK_ASSERT(ctx);
 
     if (!ctx) return;
+    NK_PROFILE_BEGIN("nk_clear");
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_end_frame(ctx);
+#endif
     if (ctx->use_pool)
         nk_buffer_clear(&ctx->memory);
     else nk_buffer_reset(&ctx->memory, NK_BUFFER_FRONT);
+    nk_frame_arena_flip(&ctx->frame);
 
+    if (ctx->build) {
+        ctx->last_digest = ctx->digest;
+        ctx->last_digest_size = ctx->digest_size;
+        ctx->has_last_digest = nk_true;
+    }
     ctx->build = 0;
     ctx->memory.calls = 0;
     ctx->last_widget_state = 0;
@@ -19172,8 +21757,10 @@ nk_clear(struct nk_context *ctx)
             iter == ctx->active) {
             ctx->active = iter->prev;
             ctx->end = iter->prev;
-            if (!ctx->end)
+            if (!ctx->end) {
                 ctx->begin = 0;
+                nk_window_index_clear(ctx);
+            }
             if (ctx->active)
                 ctx->active->flags &= ~(unsigned)NK_WINDOW_ROM;
         }
@@ -19183,6 +21770,7 @@ nk_clear(struct nk_context *ctx)
             iter->popup.win = 0;
         }
         /* remove unused window state tables */
+        nk_value_index_step(ctx, iter);
         {struct nk_table *n, *it = iter->tables;
         while (it) {
             n = it->next;
@@ -19203,6 +21791,7 @@ nk_clear(struct nk_context *ctx)
         } else iter = iter->next;
     }
     ctx->seq++;
+    NK_PROFILE_END;
 }
 NK_LIB void
 nk_start_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
@@ -19213,6 +21802,7 @@ nk_start_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
     buffer->begin = ctx->memory.allocated;
     buffer->end = buffer->begin;
     buffer->last = buffer->begin;
+    buffer->digest = 0;
     buffer->clip = nk_null_rect;
 }
 NK_LIB void
@@ -19283,6 +21873,7 @@ nk_build(struct nk_context *ctx)
     struct nk_command *cmd = 0;
     nk_byte *buffer = 0;
 
+    NK_PROFILE_BEGIN("nk_build");
     /* draw cursor overlay */
     if (!ctx->style.cursor_active)
         ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_ARROW];
@@ -19291,6 +21882,9 @@ nk_build(struct nk_context *ctx)
         const struct nk_cursor *cursor = ctx->style.cursor_active;
         nk_command_buffer_init(&ctx->overlay, &ctx->memory, NK_CLIPPING_OFF);
         nk_start_buffer(ctx, &ctx->overlay);
+#ifdef NK_INCLUDE_STATISTICS
+        ctx->overlay.stats = &ctx->stats_frame;
+#endif
 
         mouse_bounds.x = ctx->input.mouse.pos.x - cursor->offset.x;
         mouse_bounds.y = ctx->input.mouse.pos.y - cursor->offset.y;
@@ -19303,12 +21897,17 @@ nk_build(struct nk_context *ctx)
     /* build one big draw command list out of all window buffers */
     it = ctx->begin;
     buffer = (nk_byte*)ctx->memory.memory.ptr;
+    ctx->digest = 0;
     while (it != 0) {
         struct nk_window *next = it->next;
+        nk_hash digest;
         if (it->buffer.last == it->buffer.begin || (it->flags & NK_WINDOW_HIDDEN)||
             it->seq != ctx->seq)
             goto cont;
 
+        /* popup commands are part of the parent window buffer digest */
+        digest = nk_command_buffer_digest(&it->buffer);
+        ctx->digest = nk_murmur_hash(&digest, (int)sizeof(digest), ctx->digest);
         cmd = nk_ptr_add(struct nk_command, buffer, it->buffer.last);
         while (next && ((next->buffer.last == next->buffer.begin) ||
             (next->flags & NK_WINDOW_HIDDEN) || next->seq != ctx->seq))
@@ -19333,10 +21932,15 @@ nk_build(struct nk_context *ctx)
     }
     if (cmd) {
         /* append overlay commands */
-        if (ctx->overlay.end != ctx->overlay.begin)
+        if (ctx->overlay.end != ctx->overlay.begin) {
+            nk_hash digest = nk_command_buffer_digest(&ctx->overlay);
+            ctx->digest = nk_murmur_hash(&digest, (int)sizeof(digest), ctx->digest);
             cmd->next = ctx->overlay.begin;
-        else cmd->next = ctx->memory.allocated;
+        } else cmd->next = ctx->memory.allocated;
     }
+    /* window, popup and overlay commands are the only front allocations */
+    ctx->digest_size = ctx->memory.allocated;
+    NK_PROFILE_END;
 }
 NK_API const struct nk_command*
 nk__begin(struct nk_context *ctx)
@@ -19372,8 +21976,409 @@ nk__next(struct nk_context *ctx, const struct nk_command *cmd)
     next = nk_ptr_add_const(struct nk_command, buffer, cmd->next);
     return next;
 }
+NK_API nk_hash
+nk_frame_digest(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->count) return 0;
+    if (!ctx->build) {
+        nk_build(ctx);
+        ctx->build = nk_true;
+    }
+    return ctx->digest;
+}
+NK_API nk_bool
+nk_frame_dirty(struct nk_context *ctx)
+{
+    nk_hash digest;
+    NK_ASSERT(ctx);
+    if (!ctx) return nk_true;
+    digest = nk_frame_digest(ctx);
+    return !ctx->has_last_digest || digest != ctx->last_digest ||
+        ctx->digest_size != ctx->last_digest_size;
+}
+
+
+
+
+
+
+/* ===============================================================
+ *
+ *                          FRAME ARENA
+ *
+ * ===============================================================*/
+NK_LIB void
+nk_frame_arena_init(struct nk_frame_arena *arena, const struct nk_allocator *alloc)
+{
+    nk_zero(arena, sizeof(*arena));
+    arena->alloc = *alloc;
+}
+NK_INTERN struct nk_frame_block*
+nk_frame_arena_block(struct nk_frame_arena *arena, nk_size size,
+    struct nk_frame_block *next)
+{
+    struct nk_frame_block *block;
+    if (!arena->alloc.alloc) return 0;
+    block = (struct nk_frame_block*)arena->alloc.alloc(arena->alloc.userdata, 0,
+        sizeof(struct nk_frame_block) + size);
+    NK_ASSERT(block);
+    if (!block) return 0;
+    block->next = next;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+NK_INTERN void
+nk_frame_arena_release(struct nk_frame_arena *arena, struct nk_frame_block *block)
+{
+    while (block) {
+        struct nk_frame_block *next = block->next;
+        arena->alloc.free(arena->alloc.userdata, block);
+        block = next;
+    }
+}
+NK_LIB void
+nk_frame_arena_flip(struct nk_frame_arena *arena)
+{
+    struct nk_frame_block *block;
+    arena->peak = NK_MAX(arena->peak, arena->used);
+    arena->used = 0;
+    arena->current = !arena->current;
+
+    /* reuse the blocks of the frame before last. If that frame needed more
+     * than one block replace them by a single block big enough for all */
+    block = arena->blocks[arena->current];
+    if (block && block->next) {
+        struct nk_frame_block *iter;
+        nk_size total = 0;
+        for (iter = block; iter; iter = iter->next)
+            total += iter->size;
+        nk_frame_arena_release(arena, block);
+        block = nk_frame_arena_block(arena, total, 0);
+        arena->blocks[arena->current] = block;
+    }
+    if (block) block->used = 0;
+}
+NK_LIB void
+nk_frame_arena_free(struct nk_frame_arena *arena)
+{
+    if (!arena->alloc.free) return;
+    nk_frame_arena_release(arena, arena->blocks[0]);
+    nk_frame_arena_release(arena, arena->blocks[1]);
+    arena->blocks[0] = 0;
+    arena->blocks[1] = 0;
+}
+NK_LIB void*
+nk_frame_arena_alloc(struct nk_frame_arena *arena, nk_size size, nk_size align)
+{
+    struct nk_frame_block *block;
+    nk_byte *begin;
+    void *memory;
+    nk_size end;
+
+    NK_ASSERT(arena);
+    NK_ASSERT(size);
+    if (!arena || !size) return 0;
+
+    /* try to fit the allocation into the newest block of this frame */
+    block = arena->blocks[arena->current];
+    if (block) {
+        begin = (nk_byte*)(block + 1);
+        memory = begin + block->used;
+        if (align) memory = NK_ALIGN_PTR(memory, align);
+        end = (nk_size)((nk_byte*)memory - begin) + size;
+        if (end <= block->size) {
+            arena->used += end - block->used;
+            block->used = end;
+            return memory;
+        }
+    }
+    /* out of space so chain a new block at least twice as big */
+    {nk_size capacity = NK_MAX(NK_FRAME_ARENA_BLOCK_SIZE, size + align);
+    if (block) capacity = NK_MAX(capacity, block->size * 2);
+    block = nk_frame_arena_block(arena, capacity, block);
+    if (!block) return 0;
+    arena->blocks[arena->current] = block;}
+
+    begin = (nk_byte*)(block + 1);
+    memory = (align) ? NK_ALIGN_PTR(begin, align): (void*)begin;
+    block->used = (nk_size)((nk_byte*)memory - begin) + size;
+    arena->used += block->used;
+    return memory;
+}
+NK_API void*
+nk_frame_alloc(struct nk_context *ctx, nk_size size, nk_size align)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    return nk_frame_arena_alloc(&ctx->frame, size, align);
+}
+NK_INTERN void*
+nk_frame_allocator_alloc(nk_handle handle, void *old, nk_size size)
+{
+    /* callers may store any type so align like malloc would */
+    NK_UNUSED(old);
+    return nk_frame_alloc((struct nk_context*)handle.ptr, size, 16);
+}
+NK_INTERN void
+nk_frame_allocator_free(nk_handle handle, void *ptr)
+{
+    NK_UNUSED(handle);
+    NK_UNUSED(ptr);
+}
+NK_API struct nk_allocator
+nk_frame_allocator(struct nk_context *ctx)
+{
+    struct nk_allocator alloc;
+    NK_ASSERT(ctx);
+    alloc.userdata = nk_handle_ptr(ctx);
+    alloc.alloc = nk_frame_allocator_alloc;
+    alloc.free = nk_frame_allocator_free;
+    return alloc;
+}
+
+
+
+
+
+/* ===============================================================
+ *
+ *                          STATISTICS
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_STATISTICS
+NK_INTERN struct nk_window_stats*
+nk_stats_window_entry(struct nk_stats *stats, const struct nk_window *win)
+{
+    struct nk_window_stats *entry;
+    unsigned int i;
+    for (i = 0; i < stats->window_count; ++i) {
+        if (stats->windows[i].hash == win->name)
+            return &stats->windows[i];
+    }
+    if (stats->window_count >= NK_STATS_MAX_WINDOWS)
+        return 0;
+    entry = &stats->windows[stats->window_count++];
+    NK_MEMCPY(entry->name, win->name_string, sizeof(entry->name));
+    entry->name[NK_WINDOW_MAX_NAME-1] = 0;
+    entry->hash = win->name;
+    return entry;
+}
+NK_INTERN void
+nk_stats_pool(struct nk_stats *stats, const struct nk_pool *pool)
+{
+    stats->pool_pages += pool->page_count;
+    stats->pool_live += pool->live_count;
+    stats->pool_free += pool->free_count;
+    stats->pool_peak += pool->peak_count;
+    stats->pool_memory += nk_pool_memory(pool);
+}
+NK_INTERN void
+nk_stats_value_lookups(struct nk_stats *stats, struct nk_window *win)
+{
+    stats->value_lookups += win->value_lookups;
+    stats->value_probes += win->value_probes;
+    win->value_lookups = 0;
+    win->value_probes = 0;
+}
+NK_LIB void
+nk_stats_end_frame(struct nk_context *ctx)
+{
+    struct nk_stats *stats = &ctx->stats_frame;
+    struct nk_window *iter;
+    nk_size command_peak;
+    unsigned int vertex_peak, element_peak;
+    unsigned int i;
+
+    /* command memory of every window drawn this frame */
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        struct nk_window_stats *entry;
+        nk_stats_value_lookups(stats, iter);
+        if (iter->popup.win)
+            nk_stats_value_lookups(stats, iter->popup.win);
+        if (iter->buffer.end == iter->buffer.begin ||
+            (iter->flags & NK_WINDOW_HIDDEN) || iter->seq != ctx->seq)
+            continue;
+        entry = nk_stats_window_entry(stats, iter);
+        if (entry) entry->command_bytes = iter->buffer.end - iter->buffer.begin;
+    }
+    for (i = 0; i < NK_LEN(stats->commands); ++i)
+        stats->command_count += stats->commands[i];
+    stats->command_memory = ctx->memory.allocated;
+    stats->command_needed = ctx->memory.needed;
+    stats->command_capacity = ctx->memory.memory.size;
+    stats->command_peak = NK_MAX(stats->command_peak, ctx->memory.needed);
+
+    /* unused pools are zeroed, a fixed pool holds every element in `ctx->pool` */
+    nk_stats_pool(stats, &ctx->pool);
+    nk_stats_pool(stats, &ctx->state_pool);
+    nk_stats_pool(stats, &ctx->panel_pool);
+    nk_stats_pool(stats, &ctx->table_pool);
+    stats->frame_memory = ctx->frame.used;
+    stats->frame_peak = ctx->frame.peak;
+
+    /* publish and start over, keeping peak values */
+    ctx->stats = *stats;
+    command_peak = stats->command_peak;
+    vertex_peak = stats->vertex_peak;
+    element_peak = stats->element_peak;
+    nk_zero(stats, sizeof(*stats));
+    stats->command_peak = command_peak;
+    stats->vertex_peak = vertex_peak;
+    stats->element_peak = element_peak;
+}
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_INTERN void
+nk_stats_convert_flush(struct nk_context *ctx)
+{
+    const struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_window_stats *entry;
+    if (!ctx->stats_owner) return;
+    entry = nk_stats_window_entry(&ctx->stats_frame, ctx->stats_owner);
+    if (!entry) return;
+    entry->vertices += list->vertex_count - ctx->stats_vertex_begin;
+    entry->elements += list->element_count - ctx->stats_element_begin;
+}
+NK_LIB void
+nk_stats_convert_begin(struct nk_context *ctx)
+{
+    unsigned int i;
+    for (i = 0; i < ctx->stats_frame.window_count; ++i) {
+        ctx->stats_frame.windows[i].vertices = 0;
+        ctx->stats_frame.windows[i].elements = 0;
+    }
+    ctx->stats_owner = 0;
+}
+NK_LIB void
+nk_stats_convert_command(struct nk_context *ctx, const struct nk_command *cmd)
+{
+    /* popups draw into their parent window's command memory and the
+     * overlay is not owned by any window */
+    const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+    struct nk_window *win = ctx->stats_owner;
+    if (win && offset >= win->buffer.begin && offset < win->buffer.end)
+        return;
 
+    nk_stats_convert_flush(ctx);
+    for (win = ctx->begin; win; win = win->next) {
+        if (win->seq == ctx->seq && offset >= win->buffer.begin &&
+            offset < win->buffer.end) break;
+    }
+    ctx->stats_owner = win;
+    ctx->stats_vertex_begin = ctx->draw_list.vertex_count;
+    ctx->stats_element_begin = ctx->draw_list.element_count;
+}
+NK_LIB void
+nk_stats_convert_end(struct nk_context *ctx)
+{
+    const struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_stats *stats = &ctx->stats_frame;
+    nk_stats_convert_flush(ctx);
+    ctx->stats_owner = 0;
+    stats->vertices = list->vertex_count;
+    stats->elements = list->element_count;
+    stats->draw_commands = list->cmd_count;
+    stats->vertex_peak = NK_MAX(stats->vertex_peak, list->vertex_count);
+    stats->element_peak = NK_MAX(stats->element_peak, list->element_count);
+}
+#endif
+NK_API const struct nk_stats*
+nk_statistics(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    return &ctx->stats;
+}
+NK_INTERN void
+nk_statistics_number(struct nk_context *ctx, nk_size value)
+{
+    char number[NK_MAX_NUMBER_BUFFER];
+    nk_itoa(number, (long)value);
+    nk_label(ctx, number, NK_TEXT_RIGHT);
+}
+NK_INTERN void
+nk_statistics_row(struct nk_context *ctx, const char *label, nk_size value)
+{
+    nk_label(ctx, label, NK_TEXT_LEFT);
+    nk_statistics_number(ctx, value);
+}
+NK_API nk_bool
+nk_statistics_window(struct nk_context *ctx, const char *title,
+    struct nk_rect bounds, nk_flags flags)
+{
+    NK_STORAGE const char *command_names[] = {
+        "nop", "scissor", "line", "curve", "rect", "rect filled",
+        "rect multi color", "circle", "circle filled", "arc", "arc filled",
+        "triangle", "triangle filled", "polygon", "polygon filled",
+        "polyline", "text", "image", "custom"
+    };
+    const struct nk_stats *stats;
+    nk_bool open;
+    unsigned int i;
 
+    NK_ASSERT(ctx);
+    NK_ASSERT(title);
+    if (!ctx || !title) return 0;
+
+    stats = &ctx->stats;
+    open = nk_begin(ctx, title, bounds, flags);
+    if (open) {
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Commands", NK_MAXIMIZED, title, nk_strlen(title), 0)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "total", stats->command_count);
+            for (i = 0; i < NK_LEN(stats->commands); ++i) {
+                if (stats->commands[i])
+                    nk_statistics_row(ctx, command_names[i], stats->commands[i]);
+            }
+            nk_statistics_row(ctx, "memory", stats->command_memory);
+            nk_statistics_row(ctx, "needed", stats->command_needed);
+            nk_statistics_row(ctx, "capacity", stats->command_capacity);
+            nk_statistics_row(ctx, "peak", stats->command_peak);
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Windows", NK_MAXIMIZED, title, nk_strlen(title), 1)) {
+            nk_layout_row_dynamic(ctx, 0, 4);
+            nk_label(ctx, "name", NK_TEXT_LEFT);
+            nk_label(ctx, "bytes", NK_TEXT_RIGHT);
+            nk_label(ctx, "vertices", NK_TEXT_RIGHT);
+            nk_label(ctx, "indices", NK_TEXT_RIGHT);
+            for (i = 0; i < stats->window_count; ++i) {
+                const struct nk_window_stats *win = &stats->windows[i];
+                nk_label(ctx, win->name, NK_TEXT_LEFT);
+                nk_statistics_number(ctx, win->command_bytes);
+                nk_statistics_number(ctx, win->vertices);
+                nk_statistics_number(ctx, win->elements);
+            }
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Memory", NK_MINIMIZED, title, nk_strlen(title), 2)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "pool pages", stats->pool_pages);
+            nk_statistics_row(ctx, "pool elements", stats->pool_live);
+            nk_statistics_row(ctx, "pool free", stats->pool_free);
+            nk_statistics_row(ctx, "pool peak", stats->pool_peak);
+            nk_statistics_row(ctx, "pool memory", stats->pool_memory);
+            nk_statistics_row(ctx, "frame arena", stats->frame_memory);
+            nk_statistics_row(ctx, "frame arena peak", stats->frame_peak);
+            nk_statistics_row(ctx, "value lookups", stats->value_lookups);
+            nk_statistics_row(ctx, "value probes", stats->value_probes);
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Vertex output", NK_MINIMIZED, title, nk_strlen(title), 3)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "vertices", stats->vertices);
+            nk_statistics_row(ctx, "indices", stats->elements);
+            nk_statistics_row(ctx, "draw commands", stats->draw_commands);
+            nk_statistics_row(ctx, "vertex peak", stats->vertex_peak);
+            nk_statistics_row(ctx, "index peak", stats->element_peak);
+            nk_tree_pop(ctx);
+        }
+    }
+    nk_end(ctx);
+    return open;
+}
+#endif
 
 
 
@@ -19383,14 +22388,30 @@ nk__next(struct nk_context *ctx, const struct nk_command *cmd)
  *                              POOL
  *
  * ===============================================================*/
+NK_INTERN nk_size
+nk_pool_page_size(const struct nk_pool *pool)
+{
+    /* slots are `element_size` apart instead of sizeof(struct nk_page_element) */
+    return (nk_size)NK_OFFSETOF(struct nk_page, win) +
+        (nk_size)pool->capacity * pool->element_size;
+}
+NK_INTERN struct nk_page_element*
+nk_pool_page_slot(const struct nk_pool *pool, struct nk_page *page, unsigned int index)
+{
+    return (struct nk_page_element*)(void*)
+        ((nk_byte*)page->win + (nk_size)index * pool->element_size);
+}
 NK_LIB void
 nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc,
-    unsigned int capacity)
+    unsigned int capacity, nk_size element_size)
 {
     NK_ASSERT(capacity >= 1);
+    NK_ASSERT(element_size > NK_OFFSETOF(struct nk_page_element, data));
+    NK_ASSERT(element_size <= sizeof(struct nk_page_element));
     nk_zero(pool, sizeof(*pool));
     pool->alloc = *alloc;
     pool->capacity = capacity;
+    pool->element_size = element_size;
     pool->type = NK_BUFFER_DYNAMIC;
     pool->pages = 0;
 }
@@ -19415,32 +22436,103 @@ nk_pool_init_fixed(struct nk_pool *pool, void *memory, nk_size size)
     if (size < sizeof(struct nk_page)) return;
     /* first nk_page_element is embedded in nk_page, additional elements follow in adjacent space */
     pool->capacity = (unsigned)(1 + (size - sizeof(struct nk_page)) / sizeof(struct nk_page_element));
+    pool->element_size = sizeof(struct nk_page_element);
     pool->pages = (struct nk_page*)memory;
+    pool->pages->size = 0;
+    pool->pages->used = 0;
+    pool->pages->next = 0;
+    pool->page_count = 1;
     pool->type = NK_BUFFER_FIXED;
     pool->size = size;
 }
 NK_LIB struct nk_page_element*
 nk_pool_alloc(struct nk_pool *pool)
 {
-    if (!pool->pages || pool->pages->size >= pool->capacity) {
-        /* allocate new page */
-        struct nk_page *page;
-        if (pool->type == NK_BUFFER_FIXED) {
-            NK_ASSERT(pool->pages);
-            if (!pool->pages) return 0;
-            NK_ASSERT(pool->pages->size < pool->capacity);
-            return 0;
-        } else {
-            nk_size size = sizeof(struct nk_page);
-            size += (pool->capacity - 1) * sizeof(struct nk_page_element);
-            page = (struct nk_page*)pool->alloc.alloc(pool->alloc.userdata,0, size);
+    struct nk_page_element *elem;
+    if (pool->freelist) {
+        /* recycle previously freed element */
+        elem = pool->freelist;
+        pool->freelist = elem->next;
+        pool->free_count--;
+    } else {
+        if (!pool->pages || pool->pages->size >= pool->capacity) {
+            /* allocate new page */
+            struct nk_page *page;
+            if (pool->type == NK_BUFFER_FIXED) {
+                NK_ASSERT(pool->pages);
+                if (!pool->pages) return 0;
+                NK_ASSERT(pool->pages->size < pool->capacity);
+                return 0;
+            }
+            page = (struct nk_page*)pool->alloc.alloc(pool->alloc.userdata,0,
+                nk_pool_page_size(pool));
+            NK_ASSERT(page);
+            if (!page) return 0;
             page->next = pool->pages;
             pool->pages = page;
             page->size = 0;
+            page->used = 0;
+            pool->page_count++;
         }
-    } return &pool->pages->win[pool->pages->size++];
+        elem = nk_pool_page_slot(pool, pool->pages, pool->pages->size++);
+        elem->page = pool->pages;
+    }
+    elem->page->used++;
+    pool->live_count++;
+    if (pool->live_count > pool->peak_count)
+        pool->peak_count = pool->live_count;
+    return elem;
+}
+NK_LIB void
+nk_pool_free_element(struct nk_pool *pool, struct nk_page_element *elem)
+{
+    NK_ASSERT(elem->page && elem->page->used);
+    NK_ASSERT(pool->live_count);
+    elem->page->used--;
+    pool->live_count--;
+    elem->next = pool->freelist;
+    pool->freelist = elem;
+    pool->free_count++;
 }
+NK_LIB nk_size
+nk_pool_trim(struct nk_pool *pool)
+{
+    struct nk_page_element **link;
+    struct nk_page **iter;
+    nk_size freed = 0;
+    if (!pool || pool->type == NK_BUFFER_FIXED || !pool->free_count)
+        return 0;
 
+    /* unlink free elements that live on otherwise empty pages */
+    link = &pool->freelist;
+    while (*link) {
+        struct nk_page_element *elem = *link;
+        if (!elem->page->used) {
+            *link = elem->next;
+            pool->free_count--;
+        } else link = &elem->next;
+    }
+    /* hand empty pages back to the allocator */
+    iter = &pool->pages;
+    while (*iter) {
+        struct nk_page *page = *iter;
+        if (!page->used) {
+            *iter = page->next;
+            pool->alloc.free(pool->alloc.userdata, page);
+            pool->page_count--;
+            freed += nk_pool_page_size(pool);
+        } else iter = &page->next;
+    }
+    return freed;
+}
+
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB nk_size
+nk_pool_memory(const struct nk_pool *pool)
+{
+    return (nk_size)pool->page_count * nk_pool_page_size(pool);
+}
+#endif
 
 
 
@@ -19450,19 +22542,46 @@ nk_pool_alloc(struct nk_pool *pool)
  *                          PAGE ELEMENT
  *
  * ===============================================================*/
+NK_LIB nk_size
+nk_page_element_size(enum nk_page_element_type type)
+{
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_page_element);
+    nk_size size = (nk_size)NK_OFFSETOF(struct nk_page_element, data);
+    switch (type) {
+    case NK_PAGE_ELEMENT_WINDOW: size += sizeof(struct nk_window); break;
+    case NK_PAGE_ELEMENT_WINDOW_STATE: size += sizeof(struct nk_window_state); break;
+    case NK_PAGE_ELEMENT_PANEL: size += sizeof(struct nk_panel); break;
+    case NK_PAGE_ELEMENT_TABLE: size += sizeof(struct nk_table); break;
+    default: return sizeof(struct nk_page_element);
+    }
+    return (size + (align - 1)) & ~(align - 1);
+}
+NK_INTERN struct nk_pool*
+nk_page_element_pool(struct nk_context *ctx, enum nk_page_element_type type)
+{
+    /* a fixed pool cannot be split so it keeps full sized slots */
+    if (ctx->pool.type == NK_BUFFER_FIXED)
+        return &ctx->pool;
+    switch (type) {
+    case NK_PAGE_ELEMENT_WINDOW_STATE: return &ctx->state_pool;
+    case NK_PAGE_ELEMENT_PANEL: return &ctx->panel_pool;
+    case NK_PAGE_ELEMENT_TABLE: return &ctx->table_pool;
+    default: return &ctx->pool;
+    }
+}
 NK_LIB struct nk_page_element*
-nk_create_page_element(struct nk_context *ctx)
+nk_create_page_element(struct nk_context *ctx, enum nk_page_element_type type)
 {
     struct nk_page_element *elem;
-    if (ctx->freelist) {
+    if (ctx->use_pool) {
+        /* allocate or recycle page element from the pool for this type */
+        elem = nk_pool_alloc(nk_page_element_pool(ctx, type));
+        NK_ASSERT(elem);
+        if (!elem) return 0;
+    } else if (ctx->freelist) {
         /* unlink page element from free list */
         elem = ctx->freelist;
         ctx->freelist = elem->next;
-    } else if (ctx->use_pool) {
-        /* allocate page element from memory pool */
-        elem = nk_pool_alloc(&ctx->pool);
-        NK_ASSERT(elem);
-        if (!elem) return 0;
     } else {
         /* allocate new page element from back of fixed size memory buffer */
         NK_STORAGE const nk_size size = sizeof(struct nk_page_element);
@@ -19470,8 +22589,11 @@ nk_create_page_element(struct nk_context *ctx)
         elem = (struct nk_page_element*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK, size, align);
         NK_ASSERT(elem);
         if (!elem) return 0;
+        elem->page = 0;
     }
-    nk_zero_struct(*elem);
+    /* slot may be smaller than the union so only clear the stored type */
+    nk_zero(&elem->data, nk_page_element_size(type) -
+        (nk_size)NK_OFFSETOF(struct nk_page_element, data));
     elem->next = 0;
     elem->prev = 0;
     return elem;
@@ -19489,11 +22611,12 @@ nk_link_page_element_into_freelist(struct nk_context *ctx,
     }
 }
 NK_LIB void
-nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem)
+nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem,
+    enum nk_page_element_type type)
 {
-    /* we have a pool so just add to free list */
+    /* we have a pool so hand the element back for reuse */
     if (ctx->use_pool) {
-        nk_link_page_element_into_freelist(ctx, elem);
+        nk_pool_free_element(nk_page_element_pool(ctx, type), elem);
         return;
     }
     /* if possible remove last element from back of fixed memory buffer */
@@ -19517,9 +22640,8 @@ NK_LIB struct nk_table*
 nk_create_table(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_TABLE);
     if (!elem) return 0;
-    nk_zero_struct(*elem);
     return &elem->data.tbl;
 }
 NK_LIB void
@@ -19527,7 +22649,7 @@ nk_free_table(struct nk_context *ctx, struct nk_table *tbl)
 {
     union nk_page_data *pd = NK_CONTAINER_OF(tbl, union nk_page_data, tbl);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_TABLE);
 }
 NK_LIB void
 nk_push_table(struct nk_window *win, struct nk_table *tbl)
@@ -19547,9 +22669,136 @@ nk_push_table(struct nk_window *win, struct nk_table *tbl)
     win->tables = tbl;
     win->table_count++;
 }
+NK_INTERN struct nk_value_slot*
+nk_value_index_lookup(struct nk_value_slot *slots, unsigned int size, nk_hash key)
+{
+    unsigned int mask = size - 1;
+    unsigned int i = (key * 2654435761u) >> 8;
+    if (!slots) return 0;
+    for (i &= mask; slots[i].tbl || slots[i].index; i = (i + 1) & mask) {
+        if (slots[i].tbl && slots[i].key == key)
+            return &slots[i];
+    }
+    return 0;
+}
+NK_INTERN void
+nk_value_index_put(struct nk_value_index *vi, nk_hash key,
+    struct nk_table *tbl, unsigned int index)
+{
+    /* reuses the first deleted slot on the probe sequence */
+    unsigned int mask = vi->size - 1;
+    unsigned int i = ((key * 2654435761u) >> 8) & mask;
+    struct nk_value_slot *slot = 0;
+    for (; vi->slots[i].tbl || vi->slots[i].index; i = (i + 1) & mask) {
+        if (!vi->slots[i].tbl && !slot)
+            slot = &vi->slots[i];
+    }
+    if (!slot) {
+        slot = &vi->slots[i];
+        vi->used++;
+    }
+    slot->key = key;
+    slot->index = index;
+    slot->tbl = tbl;
+    vi->live++;
+}
+NK_INTERN void
+nk_value_index_forget(struct nk_value_index *vi, struct nk_table *tbl)
+{
+    unsigned int i;
+    for (i = 0; i < tbl->size; ++i) {
+        struct nk_value_slot *s;
+        s = nk_value_index_lookup(vi->slots, vi->size, tbl->keys[i]);
+        if (s && s->tbl == tbl && s->index == i) {
+            s->tbl = 0; s->index = 1;
+            vi->live--;
+        }
+        s = nk_value_index_lookup(vi->old, vi->old_size, tbl->keys[i]);
+        if (s && s->tbl == tbl && s->index == i) {
+            s->tbl = 0; s->index = 1;
+        }
+    }
+}
+NK_INTERN void
+nk_value_index_migrate(struct nk_context *ctx, struct nk_window *win, unsigned int count)
+{
+    struct nk_value_index *vi = &win->values;
+    if (!vi->old) return;
+    for (; count && vi->migrated < vi->old_size; --count, ++vi->migrated) {
+        const struct nk_value_slot *s = &vi->old[vi->migrated];
+        if (s->tbl) nk_value_index_put(vi, s->key, s->tbl, s->index);
+    }
+    if (vi->migrated < vi->old_size) return;
+    ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->old);
+    vi->old = 0;
+    vi->old_size = 0;
+    vi->migrated = 0;
+}
+NK_INTERN nk_bool
+nk_value_index_resize(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_value_index *vi = &win->values;
+    struct nk_value_slot *slots;
+    unsigned int size = 16;
+
+    nk_value_index_migrate(ctx, win, vi->old_size);
+    while (size < (vi->live + 1) * 2)
+        size *= 2;
+    slots = (struct nk_value_slot*)ctx->pool.alloc.alloc(ctx->pool.alloc.userdata,
+        0, size * sizeof(struct nk_value_slot));
+    if (!slots) return nk_false;
+    nk_zero(slots, size * sizeof(struct nk_value_slot));
+
+    if (!vi->slots) {
+        /* first index for this window is built from all table pages */
+        struct nk_table *iter;
+        vi->slots = slots;
+        vi->size = size;
+        for (iter = win->tables; iter; iter = iter->next) {
+            unsigned int i;
+            for (i = 0; i < iter->size; ++i) {
+                if (!nk_value_index_lookup(vi->slots, vi->size, iter->keys[i]))
+                    nk_value_index_put(vi, iter->keys[i], iter, i);
+            }
+        }
+        vi->prev = 0;
+        vi->next = ctx->value_index_owners;
+        if (vi->next) vi->next->values.prev = win;
+        ctx->value_index_owners = win;
+        return nk_true;
+    }
+    /* keep the current slots as `old` and move them over a few at a time */
+    vi->old = vi->slots;
+    vi->old_size = vi->size;
+    vi->migrated = 0;
+    vi->slots = slots;
+    vi->size = size;
+    vi->used = 0;
+    vi->live = 0;
+    return nk_true;
+}
+NK_LIB void
+nk_value_index_free(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_value_index *vi = &win->values;
+    if (!vi->slots) return;
+    if (vi->old) ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->old);
+    ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->slots);
+    if (vi->prev) vi->prev->values.next = vi->next;
+    else ctx->value_index_owners = vi->next;
+    if (vi->next) vi->next->values.prev = vi->prev;
+    nk_zero_struct(*vi);
+}
+NK_LIB void
+nk_value_index_step(struct nk_context *ctx, struct nk_window *win)
+{
+    nk_value_index_migrate(ctx, win, 64);
+}
 NK_LIB void
 nk_remove_table(struct nk_window *win, struct nk_table *tbl)
 {
+    if (win->values.slots)
+        nk_value_index_forget(&win->values, tbl);
     if (win->tables == tbl)
         win->tables = tbl->next;
     if (tbl->next)
@@ -19575,21 +22824,78 @@ nk_add_value(struct nk_context *ctx, struct nk_window *win,
     win->tables->seq = win->seq;
     win->tables->keys[win->tables->size] = name;
     win->tables->values[win->tables->size] = value;
+
+    /* contexts without an allocator keep scanning the table pages */
+    if (ctx->pool.alloc.alloc) {
+        struct nk_value_index *vi = &win->values;
+        if (!vi->slots) {
+            win->tables->size++;
+            nk_value_index_resize(ctx, win);
+            return &win->tables->values[win->tables->size-1];
+        }
+        if ((vi->used + 1) * 4 > vi->size * 3 && !nk_value_index_resize(ctx, win)
+            && vi->used + 1 >= vi->size) {
+            /* out of memory and out of slots so fall back to scanning */
+            nk_value_index_free(ctx, win);
+        }
+        if (vi->slots) {
+            nk_value_index_put(vi, name, win->tables, win->tables->size);
+            nk_value_index_migrate(ctx, win, 4);
+        }
+    }
     return &win->tables->values[win->tables->size++];
 }
+#ifdef NK_INCLUDE_STATISTICS
+NK_INTERN unsigned int
+nk_value_index_probes(const struct nk_value_slot *slots, unsigned int size, nk_hash key)
+{
+    /* walks the same probe sequence as `nk_value_index_lookup` */
+    unsigned int mask = size - 1;
+    unsigned int i = (key * 2654435761u) >> 8;
+    unsigned int probes = 0;
+    if (!slots) return 0;
+    for (i &= mask; slots[i].tbl || slots[i].index; i = (i + 1) & mask) {
+        probes++;
+        if (slots[i].tbl && slots[i].key == key)
+            break;
+    }
+    return probes;
+}
+#endif
 NK_LIB nk_uint*
 nk_find_value(struct nk_window *win, nk_hash name)
 {
     struct nk_table *iter = win->tables;
+#ifdef NK_INCLUDE_STATISTICS
+    win->value_lookups++;
+#endif
+    if (win->values.slots) {
+        struct nk_value_index *vi = &win->values;
+        struct nk_value_slot *s = nk_value_index_lookup(vi->slots, vi->size, name);
+#ifdef NK_INCLUDE_STATISTICS
+        win->value_probes += nk_value_index_probes(vi->slots, vi->size, name);
+        if (!s) win->value_probes += nk_value_index_probes(vi->old, vi->old_size, name);
+#endif
+        if (!s) s = nk_value_index_lookup(vi->old, vi->old_size, name);
+        if (!s) return 0;
+        s->tbl->seq = win->seq;
+        return &s->tbl->values[s->index];
+    }
     while (iter) {
         unsigned int i = 0;
         unsigned int size = iter->size;
         for (i = 0; i < size; ++i) {
             if (iter->keys[i] == name) {
+#ifdef NK_INCLUDE_STATISTICS
+                win->value_probes += i + 1;
+#endif
                 iter->seq = win->seq;
                 return &iter->values[i];
             }
         } size = NK_VALUE_PAGE_CAPACITY;
+#ifdef NK_INCLUDE_STATISTICS
+        win->value_probes += iter->size;
+#endif
         iter = iter->next;
     }
     return 0;
@@ -19608,9 +22914,8 @@ NK_LIB void*
 nk_create_panel(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_PANEL);
     if (!elem) return 0;
-    nk_zero_struct(*elem);
     return &elem->data.pan;
 }
 NK_LIB void
@@ -19618,7 +22923,7 @@ nk_free_panel(struct nk_context *ctx, struct nk_panel *pan)
 {
     union nk_page_data *pd = NK_CONTAINER_OF(pan, union nk_page_data, pan);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_PANEL);
 }
 NK_LIB nk_bool
 nk_panel_has_header(nk_flags flags, const char *title)
@@ -19704,6 +23009,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         ctx->current->layout->type = panel_type;
         return 0;
     }
+    NK_PROFILE_BEGIN("nk_panel_begin");
     /* pull state into local stack */
     style = &ctx->style;
     font = style->font;
@@ -19713,6 +23019,12 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
     in = (win->flags & NK_WINDOW_NO_INPUT) ? 0: &ctx->input;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     win->buffer.userdata = ctx->userdata;
+#endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    win->buffer.text_cache = &ctx->text_cache;
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+    win->buffer.stats = &ctx->stats_frame;
 #endif
     /* pull style configuration into local stack */
     scrollbar_size = style->window.scrollbar_size;
@@ -19879,7 +23191,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         {/* window header title */
         int text_len = nk_strlen(title);
         struct nk_rect label = {0,0,0,0};
-        float t = font->width(font->userdata, font->height, title, text_len);
+        float t = nk_text_width(out, font, title, text_len);
         text.padding = nk_vec2(0,0);
 
         label.x = header.x + style->window.header.padding.x;
@@ -19919,6 +23231,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         layout->clip.x + layout->clip.w, layout->clip.y + layout->clip.h);
     nk_push_scissor(out, clip);
     layout->clip = clip;}
+    NK_PROFILE_END;
     return !(layout->flags & NK_WINDOW_HIDDEN) && !(layout->flags & NK_WINDOW_MINIMIZED);
 }
 NK_LIB void
@@ -20185,23 +23498,26 @@ nk_panel_end(struct nk_context *ctx)
     }
     window->flags = layout->flags;
 
-    /* property garbage collector */
-    if (window->property.active && window->property.old != window->property.seq &&
-        window->property.active == window->property.prev) {
-        nk_zero(&window->property, sizeof(window->property));
-    } else {
-        window->property.old = window->property.seq;
-        window->property.prev = window->property.active;
-        window->property.seq = 0;
-    }
-    /* edit garbage collector */
-    if (window->edit.active && window->edit.old != window->edit.seq &&
-       window->edit.active == window->edit.prev) {
-        nk_zero(&window->edit, sizeof(window->edit));
-    } else {
-        window->edit.old = window->edit.seq;
-        window->edit.prev = window->edit.active;
-        window->edit.seq = 0;
+    if (window->state) {
+        struct nk_window_state *ws = window->state;
+        /* property garbage collector */
+        if (ws->property.active && ws->property.old != ws->property.seq &&
+            ws->property.active == ws->property.prev) {
+            nk_zero(&ws->property, sizeof(ws->property));
+        } else {
+            ws->property.old = ws->property.seq;
+            ws->property.prev = ws->property.active;
+            ws->property.seq = 0;
+        }
+        /* edit garbage collector */
+        if (ws->edit.active && ws->edit.old != ws->edit.seq &&
+           ws->edit.active == ws->edit.prev) {
+            nk_zero(&ws->edit, sizeof(ws->edit));
+        } else {
+            ws->edit.old = ws->edit.seq;
+            ws->edit.prev = ws->edit.active;
+            ws->edit.seq = 0;
+        }
     }
     /* contextual garbage collector */
     if (window->popup.active_con && window->popup.con_old != window->popup.con_count) {
@@ -20230,20 +23546,37 @@ NK_LIB void*
 nk_create_window(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_WINDOW);
     if (!elem) return 0;
     elem->data.win.seq = ctx->seq;
     return &elem->data.win;
 }
+NK_LIB struct nk_window_state*
+nk_window_acquire_state(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_page_element *elem;
+    if (win->state) return win->state;
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_WINDOW_STATE);
+    if (!elem) return 0;
+    win->state = &elem->data.state;
+    return win->state;
+}
 NK_LIB void
 nk_free_window(struct nk_context *ctx, struct nk_window *win)
 {
     /* unlink windows from list */
     struct nk_table *it = win->tables;
+    nk_value_index_free(ctx, win);
     if (win->popup.win) {
         nk_free_window(ctx, win->popup.win);
         win->popup.win = 0;
     }
+    if (win->state) {
+        union nk_page_data *pd = NK_CONTAINER_OF(win->state, union nk_page_data, state);
+        struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
+        nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_WINDOW_STATE);
+        win->state = 0;
+    }
     win->next = 0;
     win->prev = 0;
 
@@ -20260,12 +23593,104 @@ nk_free_window(struct nk_context *ctx, struct nk_window *win)
     /* link windows into freelist */
     {union nk_page_data *pd = NK_CONTAINER_OF(win, union nk_page_data, win);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);}
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_WINDOW);}
+}
+NK_LIB void
+nk_window_index_clear(struct nk_context *ctx)
+{
+    if (!ctx->window_index) return;
+    nk_zero(ctx->window_index, ctx->window_index_size * sizeof(struct nk_window*));
+    ctx->window_index_count = 0;
+}
+NK_LIB void
+nk_window_index_free(struct nk_context *ctx)
+{
+    if (ctx->window_index && ctx->pool.alloc.free)
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, ctx->window_index);
+    ctx->window_index = 0;
+    ctx->window_index_size = 0;
+    ctx->window_index_count = 0;
+}
+NK_INTERN void
+nk_window_index_add(struct nk_context *ctx, struct nk_window *win)
+{
+    unsigned int mask = ctx->window_index_size - 1;
+    unsigned int i = win->name & mask;
+    while (ctx->window_index[i])
+        i = (i + 1) & mask;
+    ctx->window_index[i] = win;
+    ctx->window_index_count++;
+}
+NK_INTERN void
+nk_window_index_insert(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_window *iter;
+    unsigned int size;
+
+    /* contexts without an allocator keep searching the window list */
+    if (!ctx->pool.alloc.alloc) return;
+    if (ctx->window_index && (ctx->window_index_count + 1) * 2 <= ctx->window_index_size) {
+        nk_window_index_add(ctx, win);
+        return;
+    }
+    /* grow and rebuild from the window list which already contains `win` */
+    size = (ctx->window_index_size) ? ctx->window_index_size * 2 : 16;
+    nk_window_index_free(ctx);
+    ctx->window_index = (struct nk_window**)ctx->pool.alloc.alloc(
+        ctx->pool.alloc.userdata, 0, size * sizeof(struct nk_window*));
+    if (!ctx->window_index) return;
+    ctx->window_index_size = size;
+    nk_window_index_clear(ctx);
+    for (iter = ctx->begin; iter; iter = iter->next)
+        nk_window_index_add(ctx, iter);
+}
+NK_INTERN void
+nk_window_index_remove(struct nk_context *ctx, struct nk_window *win)
+{
+    unsigned int mask, i, j;
+    if (!ctx->window_index) return;
+    mask = ctx->window_index_size - 1;
+    i = win->name & mask;
+    while (ctx->window_index[i] && ctx->window_index[i] != win)
+        i = (i + 1) & mask;
+    if (!ctx->window_index[i]) return;
+
+    /* backward shift deletion keeps probe sequences intact without tombstones */
+    ctx->window_index[i] = 0;
+    ctx->window_index_count--;
+    for (j = (i + 1) & mask; ctx->window_index[j]; j = (j + 1) & mask) {
+        unsigned int k = ctx->window_index[j]->name & mask;
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+            ctx->window_index[i] = ctx->window_index[j];
+            ctx->window_index[j] = 0;
+            i = j;
+        }
+    }
+}
+NK_INTERN void
+nk_window_index_drop(struct nk_context *ctx, struct nk_window *iter)
+{
+    /* windows behind the list end become unreachable once it is relinked */
+    for (; iter; iter = iter->next)
+        nk_window_index_remove(ctx, iter);
 }
 NK_LIB struct nk_window*
 nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name)
 {
     struct nk_window *iter;
+    if (ctx->window_index) {
+        unsigned int mask = ctx->window_index_size - 1;
+        unsigned int i = hash & mask;
+        while ((iter = ctx->window_index[i]) != 0) {
+            if (iter->name == hash) {
+                int max_len = nk_strlen(iter->name_string);
+                if (!nk_stricmpn(iter->name_string, name, max_len))
+                    return iter;
+            }
+            i = (i + 1) & mask;
+        }
+        return 0;
+    }
     iter = ctx->begin;
     while (iter) {
         NK_ASSERT(iter != iter->next);
@@ -20301,12 +23726,14 @@ nk_insert_window(struct nk_context *ctx, struct nk_window *win,
         ctx->begin = win;
         ctx->end = win;
         ctx->count = 1;
+        nk_window_index_insert(ctx, win);
         return;
     }
     if (loc == NK_INSERT_BACK) {
         struct nk_window *end;
         end = ctx->end;
         end->flags |= NK_WINDOW_ROM;
+        nk_window_index_drop(ctx, end->next);
         end->next = win;
         win->prev = ctx->end;
         win->next = 0;
@@ -20322,6 +23749,7 @@ nk_insert_window(struct nk_context *ctx, struct nk_window *win,
         ctx->begin->flags &= ~(nk_flags)NK_WINDOW_ROM;
     }
     ctx->count++;
+    nk_window_index_insert(ctx, win);
 }
 NK_LIB void
 nk_remove_window(struct nk_context *ctx, struct nk_window *win)
@@ -20334,8 +23762,10 @@ nk_remove_window(struct nk_context *ctx, struct nk_window *win)
         }
         if (win == ctx->end) {
             ctx->end = win->prev;
-            if (win->prev)
+            if (win->prev) {
+                nk_window_index_drop(ctx, win->next);
                 win->prev->next = 0;
+            }
         }
     } else {
         if (win->next)
@@ -20351,6 +23781,7 @@ nk_remove_window(struct nk_context *ctx, struct nk_window *win)
     win->next = 0;
     win->prev = 0;
     ctx->count--;
+    nk_window_index_remove(ctx, win);
 }
 NK_API nk_bool
 nk_begin(struct nk_context *ctx, const char *title,
@@ -20375,6 +23806,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
     if (!ctx || ctx->current || !title || !name)
         return 0;
+    NK_PROFILE_BEGIN("nk_begin");
 
     /* find or create window */
     style = &ctx->style;
@@ -20386,8 +23818,16 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
         nk_size name_length = (nk_size)name_len;
         win = (struct nk_window*)nk_create_window(ctx);
         NK_ASSERT(win);
-        if (!win) return 0;
+        if (!win) {
+            NK_PROFILE_END;
+            return 0;
+        }
 
+        /* name has to be set before insertion since it keys the window index */
+        win->name = name_hash;
+        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
+        NK_MEMCPY(win->name_string, name, name_length);
+        win->name_string[name_length] = 0;
         if (flags & NK_WINDOW_BACKGROUND)
             nk_insert_window(ctx, win, NK_INSERT_FRONT);
         else nk_insert_window(ctx, win, NK_INSERT_BACK);
@@ -20395,10 +23835,6 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
 
         win->flags = flags;
         win->bounds = bounds;
-        win->name = name_hash;
-        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
-        NK_MEMCPY(win->name_string, name, name_length);
-        win->name_string[name_length] = 0;
         win->popup.win = 0;
         win->widgets_disabled = nk_false;
         if (!ctx->active)
@@ -20426,6 +23862,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     if (win->flags & NK_WINDOW_HIDDEN) {
         ctx->current = win;
         win->layout = 0;
+        NK_PROFILE_END;
         return 0;
     } else nk_start(ctx, win);
 
@@ -20511,6 +23948,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     ret = nk_panel_begin(ctx, title, NK_PANEL_WINDOW);
     win->layout->offset_x = &win->scrollbar.x;
     win->layout->offset_y = &win->scrollbar.y;
+    NK_PROFILE_END;
     return ret;
 }
 NK_API void
@@ -20527,9 +23965,11 @@ nk_end(struct nk_context *ctx)
         ctx->current = 0;
         return;
     }
+    NK_PROFILE_BEGIN("nk_end");
     nk_panel_end(ctx);
     nk_free_panel(ctx, ctx->current->layout);
     ctx->current = 0;
+    NK_PROFILE_END;
 }
 NK_API struct nk_rect
 nk_window_get_bounds(const struct nk_context *ctx)
@@ -22743,7 +26183,7 @@ nk_tree_element_image_push_hashed_base(struct nk_context *ctx, enum nk_tree_type
     struct nk_rect label;
     /* calculate size of the text and tooltip */
     text_len = nk_strlen(title);
-    text_width = style->font->width(style->font->userdata, style->font->height, title, text_len);
+    text_width = nk_text_width(out, style->font, title, text_len);
     text_width += (4 * padding.x);
 
     header.w = NK_MAX(header.w, sym.w + item_spacing.x);
@@ -23496,6 +26936,61 @@ nk_widget_disable_end(struct nk_context* ctx)
  *                              TEXT
  *
  * ===============================================================*/
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+NK_API void
+nk_text_width_cache_clear(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    nk_zero_struct(ctx->text_cache);
+}
+#endif
+NK_LIB float
+nk_text_width(struct nk_command_buffer *o, const struct nk_user_font *f,
+    const char *string, int len)
+{
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache *cache;
+    struct nk_text_width_entry *set;
+    nk_hash hash;
+    int i, set_index;
+
+    NK_ASSERT(f);
+    cache = (o) ? o->text_cache : 0;
+    if (!cache || !string || len <= 0)
+        return f->width(f->userdata, f->height, string, len);
+
+    hash = nk_murmur_hash(string, len, 0);
+    set_index = (int)(hash & (NK_TEXT_WIDTH_CACHE_SIZE / NK_TEXT_WIDTH_CACHE_WAYS - 1));
+    set = &cache->entries[set_index * NK_TEXT_WIDTH_CACHE_WAYS];
+    for (i = 0; i < NK_TEXT_WIDTH_CACHE_WAYS; ++i) {
+        struct nk_text_width_entry *e = &set[i];
+        if (e->font == f && e->hash == hash && e->len == len && e->height == f->height) {
+            e->referenced = nk_true;
+            return e->width;
+        }
+    }
+    {/* miss: replace the first entry not referenced since the hand last passed it */
+    struct nk_text_width_entry *e;
+    int hand = cache->hand[set_index];
+    while (set[hand].referenced) {
+        set[hand].referenced = nk_false;
+        hand = (hand + 1) % NK_TEXT_WIDTH_CACHE_WAYS;
+    }
+    e = &set[hand];
+    cache->hand[set_index] = (nk_byte)((hand + 1) % NK_TEXT_WIDTH_CACHE_WAYS);
+    e->font = f;
+    e->hash = hash;
+    e->len = len;
+    e->height = f->height;
+    e->width = f->width(f->userdata, f->height, string, len);
+    e->referenced = nk_true;
+    return e->width;}
+#else
+    NK_UNUSED(o);
+    return f->width(f->userdata, f->height, string, len);
+#endif
+}
 NK_LIB void
 nk_widget_text(struct nk_command_buffer *o, struct nk_rect b,
     const char *string, int len, const struct nk_text *t,
@@ -23513,7 +27008,7 @@ nk_widget_text(struct nk_command_buffer *o, struct nk_rect b,
     label.y = b.y + t->padding.y;
     label.h = NK_MIN(f->height, b.h - 2 * t->padding.y);
 
-    text_width = f->width(f->userdata, f->height, (const char*)string, len);
+    text_width = nk_text_width(o, f, (const char*)string, len);
     text_width += (2.0f * t->padding.x);
 
     /* align in x-axis */
@@ -26257,6 +29752,8 @@ struct nk_text_edit_row {
 NK_INTERN void nk_textedit_makeundo_delete(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_insert(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_replace(struct nk_text_edit*, int, int, int);
+NK_INTERN void nk_textedit_makeundo_type(struct nk_text_edit*, int, nk_rune);
+NK_INTERN void nk_textedit_flush_redo(struct nk_text_undo_state*);
 #define NK_TEXT_HAS_SELECTION(s)   ((s)->select_start != (s)->select_end)
 
 NK_INTERN float
@@ -26502,17 +29999,19 @@ nk_textedit_move_to_last(struct nk_text_edit *state)
     }
 }
 NK_INTERN int
-nk_is_word_boundary( struct nk_text_edit *state, int idx)
+nk_is_word_separator(nk_rune c)
 {
-    int len;
-    nk_rune c;
-    if (idx <= 0) return 1;
-    if (!nk_str_at_rune(&state->string, idx, &c, &len)) return 1;
     return (c == ' ' || c == '\t' ||c == 0x3000 || c == ',' || c == ';' ||
             c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' ||
             c == '|');
 }
 NK_INTERN int
+nk_is_word_boundary( struct nk_text_edit *state, int idx)
+{
+    if (idx <= 0 || idx > state->string.len) return 1;
+    return nk_is_word_separator(nk_str_rune_at(&state->string, idx));
+}
+NK_INTERN int
 nk_textedit_move_to_word_previous(struct nk_text_edit *state)
 {
    int c = state->cursor - 1;
@@ -26579,8 +30078,10 @@ nk_textedit_paste(struct nk_text_edit *state, char const *ctext, int len)
         return 1;
     }
     /* remove the undo since we didn't actually insert the characters */
-    if (state->undo.undo_point)
+    if (state->undo.undo_point > state->undo.record_begin) {
         --state->undo.undo_point;
+        nk_textedit_flush_redo(&state->undo);
+    }
     return 0;
 }
 NK_API void
@@ -26605,13 +30106,12 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
         if (state->filter && !state->filter(state, unicode)) goto next;
 
         if (!NK_TEXT_HAS_SELECTION(state) &&
-            state->cursor < state->string.len)
+            state->cursor < state->string.len &&
+            state->mode == NK_TEXT_EDIT_MODE_REPLACE)
         {
-            if (state->mode == NK_TEXT_EDIT_MODE_REPLACE) {
-                nk_textedit_makeundo_replace(state, state->cursor, 1, 1);
-                nk_str_delete_runes(&state->string, state->cursor, 1);
-            }
-            if (nk_str_insert_text_utf8(&state->string, state->cursor,
+            nk_textedit_makeundo_replace(state, state->cursor, 1, 1);
+            nk_str_edit_delete_runes(&state->string, state->cursor, 1);
+            if (nk_str_edit_insert_utf8(&state->string, state->cursor,
                                         text+text_len, 1))
             {
                 ++state->cursor;
@@ -26619,10 +30119,10 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
             }
         } else {
             nk_textedit_delete_selection(state); /* implicitly clamps */
-            if (nk_str_insert_text_utf8(&state->string, state->cursor,
+            if (nk_str_edit_insert_utf8(&state->string, state->cursor,
                                         text+text_len, 1))
             {
-                nk_textedit_makeundo_insert(state, state->cursor, 1);
+                nk_textedit_makeundo_type(state, state->cursor, unicode);
                 state->cursor = NK_MIN(state->cursor + 1, state->string.len);
                 state->has_preferred_x = 0;
             }
@@ -26631,6 +30131,8 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
         text_len += glyph_len;
         glyph_len = nk_utf_decode(text + text_len, &unicode, total_len-text_len);
     }
+    /* all runes went into the same gap, move the text behind it only once */
+    nk_str_close_gap(&state->string);
 }
 NK_LIB void
 nk_textedit_key(struct nk_text_edit *state, enum nk_keys key, int shift_mod,
@@ -26942,263 +30444,299 @@ retry:
         }} break;
     }
 }
+NK_INTERN struct nk_text_undo_record*
+nk_textedit_undo_record(struct nk_text_undo_state *s, nk_size index)
+{
+    struct nk_text_undo_record *records = s->records ? s->records: s->undo_rec;
+    return &records[index % s->record_capacity];
+}
+NK_INTERN nk_rune*
+nk_textedit_undo_char(struct nk_text_undo_state *s, nk_size index)
+{
+    nk_rune *chars = s->chars ? s->chars: s->undo_char;
+    return &chars[index % s->char_capacity];
+}
 NK_INTERN void
-nk_textedit_flush_redo(struct nk_text_undo_state *state)
+nk_textedit_flush_redo(struct nk_text_undo_state *s)
 {
-    state->redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
-    state->redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+    /* drop the undone records and every rune stored after the last
+     * record that can still be undone */
+    s->record_end = s->undo_point;
+    if (s->undo_point > s->record_begin) {
+        const struct nk_text_undo_record *r = nk_textedit_undo_record(s, s->undo_point-1);
+        s->char_end = r->char_storage + (nk_size)r->delete_length;
+    } else s->char_end = s->char_begin;
 }
 NK_INTERN void
-nk_textedit_discard_undo(struct nk_text_undo_state *state)
+nk_textedit_discard_undo(struct nk_text_undo_state *s)
 {
     /* discard the oldest entry in the undo list */
-    if (state->undo_point > 0) {
-        /* if the 0th undo state has characters, clean those up */
-        if (state->undo_rec[0].char_storage >= 0) {
-            int n = state->undo_rec[0].insert_length, i;
-            /* delete n characters from all other records */
-            state->undo_char_point = (short)(state->undo_char_point - n);
-            NK_MEMCPY(state->undo_char, state->undo_char + n,
-                (nk_size)state->undo_char_point*sizeof(nk_rune));
-            for (i=0; i < state->undo_point; ++i) {
-                if (state->undo_rec[i].char_storage >= 0)
-                state->undo_rec[i].char_storage = (short)
-                    (state->undo_rec[i].char_storage - n);
-            }
+    NK_ASSERT(s->record_begin < s->undo_point);
+    s->record_begin++;
+    if (s->record_begin < s->record_end)
+        s->char_begin = nk_textedit_undo_record(s, s->record_begin)->char_storage;
+    else s->char_begin = s->char_end;
+}
+NK_INTERN int
+nk_textedit_undo_grow(struct nk_text_edit *state, nk_size records, nk_size chars)
+{
+    /* moves the history into allocator memory for at least `records`
+     * records and `chars` runes. Capacities double until `limit` */
+    struct nk_text_undo_state *s = &state->undo;
+    const struct nk_allocator *alloc = &state->string.buffer.pool;
+    const nk_size limit = s->limit ? s->limit: NK_TEXTEDIT_UNDO_LIMIT;
+    struct nk_text_undo_record *record_memory = 0;
+    nk_rune *char_memory = 0;
+    nk_size record_capacity = s->record_capacity;
+    nk_size char_capacity = s->char_capacity;
+    nk_size memory, i;
+
+    if (state->string.buffer.type != NK_BUFFER_DYNAMIC || !alloc->alloc || !alloc->free)
+        return 0;
+    if (records > record_capacity)
+        record_capacity = NK_MAX(record_capacity * 2, records);
+    if (chars > char_capacity)
+        char_capacity = NK_MAX(char_capacity * 2, chars);
+    memory = record_capacity * sizeof(struct nk_text_undo_record) +
+        char_capacity * sizeof(nk_rune);
+    if (memory > limit) {
+        /* only take what is left below the limit */
+        record_capacity = NK_MAX(records, s->record_capacity);
+        char_capacity = NK_MAX(chars, s->char_capacity);
+        memory = record_capacity * sizeof(struct nk_text_undo_record) +
+            char_capacity * sizeof(nk_rune);
+        if (memory > limit) return 0;
+        if (char_capacity != s->char_capacity)
+            char_capacity += (limit - memory) / sizeof(nk_rune);
+        else record_capacity += (limit - memory) / sizeof(struct nk_text_undo_record);
+    }
+
+    if (record_capacity != s->record_capacity) {
+        record_memory = (struct nk_text_undo_record*)alloc->alloc(alloc->userdata, 0,
+            record_capacity * sizeof(struct nk_text_undo_record));
+        if (!record_memory) return 0;
+    }
+    if (char_capacity != s->char_capacity) {
+        char_memory = (nk_rune*)alloc->alloc(alloc->userdata, 0,
+            char_capacity * sizeof(nk_rune));
+        if (!char_memory) {
+            if (record_memory) alloc->free(alloc->userdata, record_memory);
+            return 0;
         }
-        --state->undo_point;
-        NK_MEMCPY(state->undo_rec, state->undo_rec+1,
-            (nk_size)((nk_size)state->undo_point * sizeof(state->undo_rec[0])));
     }
+    if (record_memory) {
+        for (i = s->record_begin; i < s->record_end; ++i)
+            record_memory[i % record_capacity] = *nk_textedit_undo_record(s, i);
+        if (s->records) alloc->free(alloc->userdata, s->records);
+        s->records = record_memory;
+        s->record_capacity = record_capacity;
+    }
+    if (char_memory) {
+        for (i = s->char_begin; i < s->char_end; ++i)
+            char_memory[i % char_capacity] = *nk_textedit_undo_char(s, i);
+        if (s->chars) alloc->free(alloc->userdata, s->chars);
+        s->chars = char_memory;
+        s->char_capacity = char_capacity;
+    }
+    return 1;
 }
-NK_INTERN void
-nk_textedit_discard_redo(struct nk_text_undo_state *state)
-{
-/*  discard the oldest entry in the redo list--it's bad if this
-    ever happens, but because undo & redo have to store the actual
-    characters in different cases, the redo character buffer can
-    fill up even though the undo buffer didn't */
-    nk_size num;
-    int k = NK_TEXTEDIT_UNDOSTATECOUNT-1;
-    if (state->redo_point <= k) {
-        /* if the k'th undo state has characters, clean those up */
-        if (state->undo_rec[k].char_storage >= 0) {
-            int n = state->undo_rec[k].insert_length, i;
-            /* delete n characters from all other records */
-            state->redo_char_point = (short)(state->redo_char_point + n);
-            num = (nk_size)(NK_TEXTEDIT_UNDOCHARCOUNT - state->redo_char_point);
-            NK_MEMCPY(state->undo_char + state->redo_char_point,
-                state->undo_char + state->redo_char_point-n, num * sizeof(char));
-            for (i = state->redo_point; i < k; ++i) {
-                if (state->undo_rec[i].char_storage >= 0) {
-                    state->undo_rec[i].char_storage = (short)
-                        (state->undo_rec[i].char_storage + n);
-                }
-            }
-        }
-        ++state->redo_point;
-        num = (nk_size)(NK_TEXTEDIT_UNDOSTATECOUNT - state->redo_point);
-        if (num) NK_MEMCPY(state->undo_rec + state->redo_point-1,
-            state->undo_rec + state->redo_point, num * sizeof(state->undo_rec[0]));
+NK_INTERN int
+nk_textedit_undo_reserve(struct nk_text_edit *state, nk_size records,
+    nk_size chars, nk_size keep)
+{
+    /* makes room for more records and runes by growing the history or
+     * else by dropping the oldest records before `keep` */
+    struct nk_text_undo_state *s = &state->undo;
+    while (s->record_end - s->record_begin + records > s->record_capacity ||
+        s->char_end - s->char_begin + chars > s->char_capacity)
+    {
+        if (nk_textedit_undo_grow(state, s->record_end - s->record_begin + records,
+            s->char_end - s->char_begin + chars)) continue;
+        if (s->record_begin >= keep) return 0;
+        nk_textedit_discard_undo(s);
     }
+    return 1;
 }
-NK_INTERN struct nk_text_undo_record*
-nk_textedit_create_undo_record(struct nk_text_undo_state *state, int numchars)
+NK_INTERN void
+nk_textedit_undo_save(struct nk_text_edit *state, nk_size index, int where, int len)
 {
-    /* any time we create a new undo record, we discard redo*/
-    nk_textedit_flush_redo(state);
-
-    /* if we have no free records, we have to make room,
-     * by sliding the existing records down */
-    if (state->undo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
-        nk_textedit_discard_undo(state);
+    /* copies `len` runes of the string into the char ring. Short runs are
+     * read around the gap, longer ones close it and are decoded in a single pass */
+    struct nk_text_undo_state *s = &state->undo;
+    const char *text, *end;
+    nk_rune unicode = 0;
+    int i, glyph_len = 0;
 
-    /* if the characters to store won't possibly fit in the buffer,
-     * we can't undo */
-    if (numchars > NK_TEXTEDIT_UNDOCHARCOUNT) {
-        state->undo_point = 0;
-        state->undo_char_point = 0;
-        return 0;
+    if (len <= 64) {
+        for (i = 0; i < len; ++i)
+            *nk_textedit_undo_char(s, index + (nk_size)i) =
+                nk_str_rune_at(&state->string, where + i);
+        return;
     }
-
-    /* if we don't have enough free characters in the buffer,
-     * we have to make room */
-    while (state->undo_char_point + numchars > NK_TEXTEDIT_UNDOCHARCOUNT)
-        nk_textedit_discard_undo(state);
-    return &state->undo_rec[state->undo_point++];
+    nk_str_close_gap(&state->string);
+    text = nk_str_at_const(&state->string, where, &unicode, &glyph_len);
+    end = nk_str_get_const(&state->string) + nk_str_len_char(&state->string);
+    if (!text) glyph_len = 0;
+    for (i = 0; i < len && glyph_len; ++i) {
+        *nk_textedit_undo_char(s, index + (nk_size)i) = unicode;
+        text += glyph_len;
+        glyph_len = nk_utf_decode(text, &unicode, (int)(end - text));
+    }
+    for (; i < len; ++i)
+        *nk_textedit_undo_char(s, index + (nk_size)i) = 0;
 }
-NK_INTERN nk_rune*
-nk_textedit_createundo(struct nk_text_undo_state *state, int pos,
+NK_INTERN void
+nk_textedit_undo_insert(struct nk_text_edit *state, int where, nk_size index, int len)
+{
+    /* inserts `len` runes from the char ring, which wrap around at most once */
+    struct nk_text_undo_state *s = &state->undo;
+    nk_size start;
+    int first;
+    if (len <= 0) return;
+    start = index % s->char_capacity;
+    first = (int)NK_MIN((nk_size)len, s->char_capacity - start);
+    if (first > 0)
+        nk_str_edit_insert_runes(&state->string, where, nk_textedit_undo_char(s, index), first);
+    if (len > first)
+        nk_str_edit_insert_runes(&state->string, where + first, nk_textedit_undo_char(s, 0), len - first);
+}
+NK_INTERN struct nk_text_undo_record*
+nk_textedit_create_undo_record(struct nk_text_edit *state, int where,
     int insert_len, int delete_len)
 {
-    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, insert_len);
-    if (r == 0)
-        return 0;
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_record *r;
 
-    r->where = pos;
-    r->insert_length = (short) insert_len;
-    r->delete_length = (short) delete_len;
+    /* any time we create a new undo record, we discard redo */
+    nk_textedit_flush_redo(s);
+    s->coalesce = 0;
 
-    if (insert_len == 0) {
-        r->char_storage = -1;
+    /* if the removed characters won't fit even into an empty history,
+     * we can't undo */
+    if (!nk_textedit_undo_reserve(state, 1, (nk_size)delete_len, s->undo_point))
         return 0;
-    } else {
-        r->char_storage = state->undo_char_point;
-        state->undo_char_point = (short)(state->undo_char_point +  insert_len);
-        return &state->undo_char[r->char_storage];
-    }
+
+    r = nk_textedit_undo_record(s, s->record_end);
+    r->where = where;
+    r->insert_length = insert_len;
+    r->delete_length = delete_len;
+    r->char_storage = s->char_end;
+    s->char_end += (nk_size)delete_len;
+    s->undo_point = ++s->record_end;
+    return r;
 }
 NK_API void
 nk_textedit_undo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
-    struct nk_text_undo_record u, *r;
-    if (s->undo_point == 0)
+    struct nk_text_undo_record *r;
+    int keep_redo;
+    if (s->undo_point == s->record_begin)
         return;
 
-    /* we need to do two things: apply the undo record, and create a redo record */
-    u = s->undo_rec[s->undo_point-1];
-    r = &s->undo_rec[s->redo_point-1];
-    r->char_storage = -1;
-
-    r->insert_length = u.delete_length;
-    r->delete_length = u.insert_length;
-    r->where = u.where;
-
-    if (u.delete_length)
-    {
-       /*   if the undo record says to delete characters, then the redo record will
-            need to re-insert the characters that get deleted, so we need to store
-            them.
-            there are three cases:
-                - there's enough room to store the characters
-                - characters stored for *redoing* don't leave room for redo
-                - characters stored for *undoing* don't leave room for redo
-            if the last is true, we have to bail */
-        if (s->undo_char_point + u.delete_length >= NK_TEXTEDIT_UNDOCHARCOUNT) {
-            /* the undo records take up too much character space; there's no space
-            * to store the redo characters */
-            r->insert_length = 0;
-        } else {
-            int i;
-            /* there's definitely room to store the characters eventually */
-            while (s->undo_char_point + u.delete_length > s->redo_char_point) {
-                /* there's currently not enough room, so discard a redo record */
-                nk_textedit_discard_redo(s);
-                /* should never happen: */
-                if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
-                    return;
-            }
-
-            r = &s->undo_rec[s->redo_point-1];
-            r->char_storage = (short)(s->redo_char_point - u.delete_length);
-            s->redo_char_point = (short)(s->redo_char_point -  u.delete_length);
-
-            /* now save the characters */
-            for (i=0; i < u.delete_length; ++i)
-                s->undo_char[r->char_storage + i] =
-                    nk_str_rune_at(&state->string, u.where + i);
-        }
-        /* now we can carry out the deletion */
-        nk_str_delete_runes(&state->string, u.where, u.delete_length);
+    /* the inserted characters go onto the redo stack. If there is no room
+     * even after dropping older records the edit can't be redone */
+    r = nk_textedit_undo_record(s, s->undo_point-1);
+    keep_redo = nk_textedit_undo_reserve(state, 0, (nk_size)r->insert_length, s->undo_point-1);
+    r = nk_textedit_undo_record(s, s->undo_point-1);
+    if (keep_redo) {
+        nk_textedit_undo_save(state, s->char_end, r->where, r->insert_length);
+        s->char_end += (nk_size)r->insert_length;
     }
 
-    /* check type of recorded action: */
-    if (u.insert_length) {
-        /* easy case: was a deletion, so we need to insert n characters */
-        nk_str_insert_text_runes(&state->string, u.where,
-            &s->undo_char[u.char_storage], u.insert_length);
-        s->undo_char_point = (short)(s->undo_char_point - u.insert_length);
-    }
-    state->cursor = (short)(u.where + u.insert_length);
+    nk_str_edit_delete_runes(&state->string, r->where, r->insert_length);
+    nk_textedit_undo_insert(state, r->where, r->char_storage, r->delete_length);
+    nk_str_close_gap(&state->string);
+    state->cursor = r->where + r->delete_length;
 
     s->undo_point--;
-    s->redo_point--;
+    s->coalesce = 0;
+    if (!keep_redo)
+        nk_textedit_flush_redo(s);
 }
 NK_API void
 nk_textedit_redo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
-    struct nk_text_undo_record *u, r;
-    if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
+    struct nk_text_undo_record *r;
+    if (s->undo_point == s->record_end)
         return;
 
-    /* we need to do two things: apply the redo record, and create an undo record */
-    u = &s->undo_rec[s->undo_point];
-    r = s->undo_rec[s->redo_point];
-
-    /* we KNOW there must be room for the undo record, because the redo record
-    was derived from an undo record */
-    u->delete_length = r.insert_length;
-    u->insert_length = r.delete_length;
-    u->where = r.where;
-    u->char_storage = -1;
-
-    if (r.delete_length) {
-        /* the redo record requires us to delete characters, so the undo record
-        needs to store the characters */
-        if (s->undo_char_point + u->insert_length > s->redo_char_point) {
-            u->insert_length = 0;
-            u->delete_length = 0;
-        } else {
-            int i;
-            u->char_storage = s->undo_char_point;
-            s->undo_char_point = (short)(s->undo_char_point + u->insert_length);
-
-            /* now save the characters */
-            for (i=0; i < u->insert_length; ++i) {
-                s->undo_char[u->char_storage + i] =
-                    nk_str_rune_at(&state->string, u->where + i);
-            }
-        }
-        nk_str_delete_runes(&state->string, r.where, r.delete_length);
-    }
-
-    if (r.insert_length) {
-        /* easy case: need to insert n characters */
-        nk_str_insert_text_runes(&state->string, r.where,
-            &s->undo_char[r.char_storage], r.insert_length);
-    }
-    state->cursor = r.where + r.insert_length;
+    /* the removed characters are still stored with the record, the
+     * inserted ones are on top of the redo stack */
+    r = nk_textedit_undo_record(s, s->undo_point);
+    nk_str_edit_delete_runes(&state->string, r->where, r->delete_length);
+    s->char_end -= (nk_size)r->insert_length;
+    nk_textedit_undo_insert(state, r->where, s->char_end, r->insert_length);
+    nk_str_close_gap(&state->string);
+    state->cursor = r->where + r->insert_length;
 
     s->undo_point++;
-    s->redo_point++;
+    s->coalesce = 0;
 }
 NK_INTERN void
 nk_textedit_makeundo_insert(struct nk_text_edit *state, int where, int length)
 {
-    nk_textedit_createundo(&state->undo, where, 0, length);
+    nk_textedit_create_undo_record(state, where, length, 0);
 }
 NK_INTERN void
-nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
+nk_textedit_makeundo_type(struct nk_text_edit *state, int where, nk_rune unicode)
 {
-    int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, length, 0);
-    if (p) {
-        for (i=0; i < length; ++i)
-            p[i] = nk_str_rune_at(&state->string, where+i);
+    /* typing extends the newest record until a new word starts */
+    struct nk_text_undo_state *s = &state->undo;
+    const nk_rune prev = s->coalesce;
+    if (prev && s->undo_point == s->record_end) {
+        struct nk_text_undo_record *r = nk_textedit_undo_record(s, s->undo_point-1);
+        if (r->where + r->insert_length == where && (nk_is_word_separator(unicode) ||
+            !(prev == '\n' || nk_is_word_separator(prev)))) {
+            r->insert_length++;
+            s->coalesce = unicode;
+            return;
+        }
     }
+    if (nk_textedit_create_undo_record(state, where, 1, 0))
+        s->coalesce = unicode;
+}
+NK_INTERN void
+nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
+{
+    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, where, 0, length);
+    if (r) nk_textedit_undo_save(state, r->char_storage, where, length);
 }
 NK_INTERN void
 nk_textedit_makeundo_replace(struct nk_text_edit *state, int where,
     int old_length, int new_length)
 {
-    int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
-    if (p) {
-        for (i=0; i < old_length; ++i)
-            p[i] = nk_str_rune_at(&state->string, where+i);
-    }
+    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, where,
+        new_length, old_length);
+    if (r) nk_textedit_undo_save(state, r->char_storage, where, old_length);
+}
+NK_INTERN void
+nk_textedit_clear_undo(struct nk_text_undo_state *s)
+{
+    /* empties the history but keeps its memory */
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    if (!s->records)
+        s->record_capacity = (s->undo_rec) ? NK_TEXTEDIT_UNDOSTATECOUNT: 0;
+    if (!s->chars)
+        s->char_capacity = (s->undo_char) ? NK_TEXTEDIT_UNDOCHARCOUNT: 0;
+#else
+    if (!s->records)
+        s->record_capacity = NK_TEXTEDIT_UNDOSTATECOUNT;
+    if (!s->chars)
+        s->char_capacity = NK_TEXTEDIT_UNDOCHARCOUNT;
+#endif
+    s->record_begin = s->record_end = 0;
+    s->undo_point = 0;
+    s->char_begin = s->char_end = 0;
+    s->coalesce = 0;
 }
 NK_LIB void
 nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type,
     nk_plugin_filter filter)
 {
     /* reset the state to default */
-   state->undo.undo_point = 0;
-   state->undo.undo_char_point = 0;
-   state->undo.redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
-   state->undo.redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+   nk_textedit_clear_undo(&state->undo);
    state->select_end = state->select_start = 0;
    state->cursor = 0;
    state->has_preferred_x = 0;
@@ -27253,6 +30791,18 @@ nk_textedit_free(struct nk_text_edit *state)
 {
     NK_ASSERT(state);
     if (!state) return;
+    if (state->lines.line && state->string.buffer.pool.free)
+        state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->lines.line);
+    nk_zero(&state->lines, sizeof(state->lines));
+    if (state->string.buffer.pool.free) {
+        if (state->undo.records)
+            state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->undo.records);
+        if (state->undo.chars)
+            state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->undo.chars);
+    }
+    state->undo.records = 0;
+    state->undo.chars = 0;
+    nk_textedit_clear_undo(&state->undo);
     nk_str_free(&state->string);
 }
 
@@ -27356,6 +30906,18 @@ nk_edit_draw_text(struct nk_command_buffer *out,
     foreground = nk_rgb_factor(foreground, style->color_factor);
     background = nk_rgb_factor(background, style->color_factor);
 
+    /* skip lines above the clipping rectangle without measuring them */
+    if (pos_y >= out->clip.y + out->clip.h) return;
+    while (pos_y + line_offset + row_height <= out->clip.y) {
+        while (text_len < byte_len && text[text_len] != '\n')
+            text_len++;
+        if (text_len >= byte_len) return;
+        text_len++;
+        line_count++;
+        line_offset += row_height;
+    }
+    line = text + text_len;
+
     glyph_len = nk_utf_decode(text+text_len, &unicode, byte_len-text_len);
     if (!glyph_len) return;
     while ((text_len < byte_len) && glyph_len)
@@ -27380,6 +30942,8 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             line_width = 0;
             line = text + text_len;
             line_offset += row_height;
+            if (pos_y + line_offset >= out->clip.y + out->clip.h)
+                return; /* everything below is clipped */
             glyph_len = nk_utf_decode(text + text_len, &unicode, (int)(byte_len-text_len));
             continue;
         }
@@ -27410,6 +30974,188 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             &txt, NK_TEXT_LEFT, font);
     }}
 }
+NK_INTERN int
+nk_edit_line_of_rune(const struct nk_text_edit_lines *lines, int rune)
+{
+    /* index of the last line starting at or before `rune` */
+    int lo = 0, hi = lines->count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (lines->line[mid].rune <= rune)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return NK_MAX(lo - 1, 0);
+}
+NK_INTERN int
+nk_edit_line_of_offset(const struct nk_text_edit_lines *lines, nk_size offset)
+{
+    int lo = 0, hi = lines->count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (lines->line[mid].offset <= offset)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return NK_MAX(lo - 1, 0);
+}
+NK_INTERN int
+nk_edit_lines_reserve(struct nk_text_edit *edit, int count)
+{
+    struct nk_text_edit_lines *lines = &edit->lines;
+    const struct nk_allocator *alloc = &edit->string.buffer.pool;
+    struct nk_text_edit_line *temp;
+    int capacity;
+
+    if (count <= lines->capacity) return 1;
+    capacity = NK_MAX(NK_MAX(64, count), lines->capacity * 2);
+    temp = (struct nk_text_edit_line*)alloc->alloc(alloc->userdata, lines->line,
+        (nk_size)capacity * sizeof(*temp));
+    if (!temp) return 0;
+    if (temp != lines->line && lines->line) {
+        NK_MEMCPY(temp, lines->line, (nk_size)lines->count * sizeof(*temp));
+        alloc->free(alloc->userdata, lines->line);
+    }
+    lines->line = temp;
+    lines->capacity = capacity;
+    return 1;
+}
+NK_INTERN int
+nk_edit_lines_update(struct nk_text_edit *edit, const char *text, int len,
+    const struct nk_user_font *font)
+{
+    /* Brings the line index up to date with the text range the string
+     * marked as changed: lines in front of it are kept, lines behind it
+     * are moved and only the lines in between are measured again. */
+    struct nk_text_edit_lines *lines = &edit->lines;
+    struct nk_str *str = &edit->string;
+    const nk_size text_len = (nk_size)len;
+    nk_size begin, end, offset;
+    int first, keep, count, rune, i;
+    nk_bool widest = nk_false;
+
+    if (str->buffer.type != NK_BUFFER_DYNAMIC || !str->buffer.pool.alloc ||
+        !str->buffer.pool.free) return 0;
+    if (lines->font != font || lines->font_height != font->height || !lines->count) {
+        str->changed_begin = 0;
+        str->changed_end = NK_SIZE_MAX;
+    }
+    if (str->changed_begin > str->changed_end) return 1;
+
+    if (str->changed_end == NK_SIZE_MAX) {
+        first = 0;
+        keep = lines->count;
+        begin = 0;
+        end = text_len;
+        rune = 0;
+        widest = nk_true;
+    } else {
+        /* `changed_end` mapped back to the text the lines were measured for */
+        const nk_size old_end = str->changed_end + lines->text_len - text_len;
+        first = nk_edit_line_of_offset(lines, str->changed_begin);
+        keep = nk_edit_line_of_offset(lines, old_end) + 1;
+        begin = lines->line[first].offset;
+        rune = lines->line[first].rune;
+        end = (keep < lines->count) ? lines->line[keep].offset + text_len - lines->text_len: text_len;
+        for (i = first; i < keep; ++i)
+            widest = widest || lines->line[i].width >= lines->width;
+    }
+
+    /* every new line in between ends one line, the last line ends the text */
+    count = (keep < lines->count) ? 0: 1;
+    for (offset = begin; offset < end; ++offset)
+        count += (text[offset] == '\n');
+    if (!nk_edit_lines_reserve(edit, lines->count - (keep - first) + count))
+        return 0;
+    nk_memmove(lines->line + first + count, lines->line + keep,
+        (nk_size)(lines->count - keep) * sizeof(*lines->line));
+    lines->count += count - (keep - first);
+    for (i = first + count; i < lines->count; ++i) {
+        lines->line[i].offset = lines->line[i].offset + text_len - lines->text_len;
+        lines->line[i].rune += str->len - lines->rune_len;
+    }
+
+    /* measure the lines in between glyph by glyph */
+    {struct nk_text_edit_line *line = lines->line + first;
+    line->offset = begin;
+    line->rune = rune;
+    line->width = 0;
+    offset = begin;
+    while (offset < end) {
+        nk_rune unicode;
+        int glyph_len = nk_utf_decode(text + offset, &unicode, (int)(end - offset));
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+        rune++;
+        if (unicode == '\n') {
+            if (++line == lines->line + first + count) break;
+            line->offset = offset;
+            line->rune = rune;
+            line->width = 0;
+        } else line->width += font->width(font->userdata, font->height,
+            text + offset - glyph_len, glyph_len);
+    }}
+
+    if (widest) {
+        lines->width = 0;
+        for (i = 0; i < lines->count; ++i)
+            lines->width = NK_MAX(lines->width, lines->line[i].width);
+    } else {
+        for (i = first; i < first + count; ++i)
+            lines->width = NK_MAX(lines->width, lines->line[i].width);
+    }
+    lines->text_len = text_len;
+    lines->rune_len = str->len;
+    lines->font = font;
+    lines->font_height = font->height;
+    str->changed_begin = NK_SIZE_MAX;
+    str->changed_end = 0;
+    return 1;
+}
+NK_INTERN const char*
+nk_edit_lines_locate(const struct nk_text_edit *edit, const char *text, int len,
+    int rune, const struct nk_user_font *font, float row_height, struct nk_vec2 *pos)
+{
+    /* 2D position of `rune` and a pointer to it, or null past the last glyph */
+    const struct nk_text_edit_lines *lines = &edit->lines;
+    const int index = nk_edit_line_of_rune(lines, rune);
+    const struct nk_text_edit_line *line = &lines->line[index];
+    nk_size offset = line->offset;
+    int i;
+
+    for (i = line->rune; i < rune && offset < (nk_size)len; ++i) {
+        nk_rune unicode;
+        int glyph_len = nk_utf_decode(text + offset, &unicode, len - (int)offset);
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+    }
+    pos->y = (float)index * row_height;
+    pos->x = 0;
+    if (offset > line->offset) {
+        int glyph_offset;
+        struct nk_vec2 out_offset;
+        const char *remaining;
+        pos->x = nk_text_calculate_text_bounds(font, text + line->offset,
+            (int)(offset - line->offset), row_height, &remaining,
+            &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE).x;
+    }
+    return (offset < (nk_size)len) ? text + offset: 0;
+}
+NK_INTERN nk_size
+nk_edit_lines_skip(const struct nk_text_edit *edit, int len, float top,
+    float row_height, float *line_y)
+{
+    /* text offset and position of the first line not above `top`, taken
+     * from the line index if it is up to date */
+    const struct nk_text_edit_lines *lines = &edit->lines;
+    int index;
+    *line_y = 0;
+    if (!lines->count || lines->text_len != (nk_size)len || top <= 0 ||
+        edit->string.changed_begin <= edit->string.changed_end) return 0;
+    index = NK_MIN((int)(top / row_height), lines->count - 1);
+    *line_y = (float)index * row_height;
+    return lines->line[index].offset;
+}
 NK_LIB nk_flags
 nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter,
@@ -27431,6 +31177,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     NK_ASSERT(style);
     if (!state || !out || !style)
         return ret;
+    NK_PROFILE_BEGIN("nk_do_edit");
 
     /* visible text area calculation */
     area.x = bounds.x + style->padding.x + style->border;
@@ -27626,7 +31373,21 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
         /* calculate total line count + total space + cursor/selection position */
         float line_width = 0.0f;
-        if (text && len)
+        if (text && len && nk_edit_lines_update(edit, text, len, font))
+        {
+            /* text edits with an allocator keep line starts and widths */
+            total_lines = edit->lines.count;
+            text_size.x = edit->lines.width;
+            text_size.y = (float)total_lines * row_height;
+            cursor_ptr = nk_edit_lines_locate(edit, text, len, edit->cursor,
+                font, row_height, &cursor_pos);
+            if (edit->select_start != edit->select_end) {
+                select_begin_ptr = nk_edit_lines_locate(edit, text, len,
+                    selection_begin, font, row_height, &selection_offset_start);
+                select_end_ptr = nk_edit_lines_locate(edit, text, len,
+                    selection_end, font, row_height, &selection_offset_end);
+            }
+        } else if (text && len)
         {
             /* utf8 encoding */
             float glyph_width;
@@ -27813,11 +31574,18 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         cursor_text_color = nk_rgb_factor(cursor_text_color, style->color_factor);
 
         if (edit->select_start == edit->select_end) {
-            /* no selection so just draw the complete text */
+            /* no selection so just draw the visible text */
             const char *begin = nk_str_get_const(&edit->string);
             int l = nk_str_len_char(&edit->string);
+            float skip_y;
+            nk_size skip = nk_edit_lines_skip(edit, l,
+                clip.y - (area.y - edit->scrollbar.y), row_height, &skip_y);
+            if (skip) {
+                begin += skip;
+                l -= (int)skip;
+            }
             nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
+                area.y - edit->scrollbar.y + skip_y, 0, begin, l, row_height, font,
                 background_color, text_color, nk_false);
         } else {
             /* edit has selection so draw 1-3 text chunks */
@@ -27896,9 +31664,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             }
         }}
     } else {
-        /* not active so just draw text */
+        /* not active so just draw the visible text */
         int l = nk_str_len_char(&edit->string);
         const char *begin = nk_str_get_const(&edit->string);
+        float skip_y = 0;
 
         const struct nk_style_item *background;
         struct nk_color background_color;
@@ -27922,11 +31691,18 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         background_color = nk_rgb_factor(background_color, style->color_factor);
         text_color = nk_rgb_factor(text_color, style->color_factor);
 
+        if (begin && l && nk_edit_lines_update(edit, begin, l, font)) {
+            const nk_size skip = nk_edit_lines_skip(edit, l,
+                clip.y - (area.y - edit->scrollbar.y), row_height, &skip_y);
+            begin += skip;
+            l -= (int)skip;
+        }
         nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-            area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
+            area.y - edit->scrollbar.y + skip_y, 0, begin, l, row_height, font,
             background_color, text_color, nk_false);
     }
     nk_push_scissor(out, old_clip);}
+    NK_PROFILE_END;
     return ret;
 }
 NK_API void
@@ -27940,11 +31716,12 @@ nk_edit_focus(struct nk_context *ctx, nk_flags flags)
     if (!ctx || !ctx->current) return;
 
     win = ctx->current;
-    hash = win->edit.seq;
-    win->edit.active = nk_true;
-    win->edit.name = hash;
+    if (!nk_window_acquire_state(ctx, win)) return;
+    hash = win->state->edit.seq;
+    win->state->edit.active = nk_true;
+    win->state->edit.name = hash;
     if (flags & NK_EDIT_ALWAYS_INSERT_MODE)
-        win->edit.mode = NK_TEXT_EDIT_MODE_INSERT;
+        win->state->edit.mode = NK_TEXT_EDIT_MODE_INSERT;
 }
 NK_API void
 nk_edit_unfocus(struct nk_context *ctx)
@@ -27955,8 +31732,9 @@ nk_edit_unfocus(struct nk_context *ctx)
     if (!ctx || !ctx->current) return;
 
     win = ctx->current;
-    win->edit.active = nk_false;
-    win->edit.name = 0;
+    if (!win->state) return;
+    win->state->edit.active = nk_false;
+    win->state->edit.name = 0;
 }
 NK_API nk_flags
 nk_edit_string(struct nk_context *ctx, nk_flags flags,
@@ -27975,25 +31753,27 @@ nk_edit_string(struct nk_context *ctx, nk_flags flags,
 
     filter = (!filter) ? nk_filter_default: filter;
     win = ctx->current;
-    hash = win->edit.seq;
-    edit = &ctx->text_edit;
-    nk_textedit_clear_state(&ctx->text_edit, (flags & NK_EDIT_MULTILINE)?
+    if (!nk_window_acquire_state(ctx, win)) return 0;
+    hash = win->state->edit.seq;
+    edit = nk_context_text_edit(ctx);
+    if (!edit) return 0;
+    nk_textedit_clear_state(edit, (flags & NK_EDIT_MULTILINE)?
         NK_TEXT_EDIT_MULTI_LINE: NK_TEXT_EDIT_SINGLE_LINE, filter);
 
-    if (win->edit.active && hash == win->edit.name) {
+    if (win->state->edit.active && hash == win->state->edit.name) {
         if (flags & NK_EDIT_NO_CURSOR)
             edit->cursor = nk_utf_len(memory, *len);
-        else edit->cursor = win->edit.cursor;
+        else edit->cursor = win->state->edit.cursor;
         if (!(flags & NK_EDIT_SELECTABLE)) {
-            edit->select_start = win->edit.cursor;
-            edit->select_end = win->edit.cursor;
+            edit->select_start = win->state->edit.cursor;
+            edit->select_end = win->state->edit.cursor;
         } else {
-            edit->select_start = win->edit.sel_start;
-            edit->select_end = win->edit.sel_end;
+            edit->select_start = win->state->edit.sel_start;
+            edit->select_end = win->state->edit.sel_end;
         }
-        edit->mode = win->edit.mode;
-        edit->scrollbar.x = (float)win->edit.scrollbar.x;
-        edit->scrollbar.y = (float)win->edit.scrollbar.y;
+        edit->mode = win->state->edit.mode;
+        edit->scrollbar.x = (float)win->state->edit.scrollbar.x;
+        edit->scrollbar.y = (float)win->state->edit.scrollbar.y;
         edit->active = nk_true;
     } else edit->active = nk_false;
 
@@ -28003,15 +31783,16 @@ nk_edit_string(struct nk_context *ctx, nk_flags flags,
     edit->string.buffer.allocated = (nk_size)*len;
     edit->string.len = nk_utf_len(memory, *len);
     state = nk_edit_buffer(ctx, flags, edit, filter);
+    nk_str_close_gap(&edit->string);
     *len = (int)edit->string.buffer.allocated;
 
     if (edit->active) {
-        win->edit.cursor = edit->cursor;
-        win->edit.sel_start = edit->select_start;
-        win->edit.sel_end = edit->select_end;
-        win->edit.mode = edit->mode;
-        win->edit.scrollbar.x = (nk_uint)edit->scrollbar.x;
-        win->edit.scrollbar.y = (nk_uint)edit->scrollbar.y;
+        win->state->edit.cursor = edit->cursor;
+        win->state->edit.sel_start = edit->select_start;
+        win->state->edit.sel_end = edit->select_end;
+        win->state->edit.mode = edit->mode;
+        win->state->edit.scrollbar.x = (nk_uint)edit->scrollbar.x;
+        win->state->edit.scrollbar.y = (nk_uint)edit->scrollbar.y;
     } return state;
 }
 NK_API nk_flags
@@ -28043,11 +31824,12 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
     if (!state) return state;
     else if (state == NK_WIDGET_DISABLED)
         flags |= NK_EDIT_READ_ONLY;
+    if (!nk_window_acquire_state(ctx, win)) return 0;
     in = (win->layout->flags & NK_WINDOW_ROM) ? 0 : &ctx->input;
 
     /* check if edit is currently hot item */
-    hash = win->edit.seq++;
-    if (win->edit.active && hash == win->edit.name) {
+    hash = win->state->edit.seq++;
+    if (win->state->edit.active && hash == win->state->edit.name) {
         if (flags & NK_EDIT_NO_CURSOR)
             edit->cursor = edit->string.len;
         if (!(flags & NK_EDIT_SELECTABLE)) {
@@ -28056,9 +31838,9 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
         }
         if (flags & NK_EDIT_CLIPBOARD)
             edit->clip = ctx->clip;
-        edit->active = (unsigned char)win->edit.active;
+        edit->active = (unsigned char)win->state->edit.active;
     } else edit->active = nk_false;
-    edit->mode = win->edit.mode;
+    edit->mode = win->state->edit.mode;
 
     filter = (!filter) ? nk_filter_default: filter;
     prev_state = (unsigned char)edit->active;
@@ -28070,11 +31852,11 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
         ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_TEXT];
     if (edit->active && prev_state != edit->active) {
         /* current edit is now hot */
-        win->edit.active = nk_true;
-        win->edit.name = hash;
+        win->state->edit.active = nk_true;
+        win->state->edit.name = hash;
     } else if (prev_state && !edit->active) {
         /* current edit is now cold */
-        win->edit.active = nk_false;
+        win->state->edit.active = nk_false;
     } return ret_flags;
 }
 NK_API nk_flags
@@ -28240,7 +32022,7 @@ nk_do_property(nk_flags *ws,
     if (name && name[0] != '#') {
         name_len = nk_strlen(name);
     }
-    size = font->width(font->userdata, font->height, name, name_len);
+    size = nk_text_width(out, font, name, name_len);
     label.x = left.x + left.w + style->padding.x;
     label.w = (float)size + 2 * style->padding.x;
     label.y = property.y + style->border + style->padding.y;
@@ -28254,7 +32036,7 @@ nk_do_property(nk_flags *ws,
 
     /* edit */
     if (*state == NK_PROPERTY_EDIT) {
-        size = font->width(font->userdata, font->height, buffer, *len);
+        size = nk_text_width(out, font, buffer, *len);
         size += style->edit.cursor_size;
         length = len;
         dst = buffer;
@@ -28274,7 +32056,7 @@ nk_do_property(nk_flags *ws,
             num_len = nk_string_float_limit(string, NK_MAX_FLOAT_PRECISION);
             break;
         }
-        size = font->width(font->userdata, font->height, string, num_len);
+        size = nk_text_width(out, font, string, num_len);
         dst = string;
         length = &num_len;
     }
@@ -28345,9 +32127,11 @@ nk_do_property(nk_flags *ws,
     text_edit->string.buffer.memory.size = NK_MAX_NUMBER_BUFFER;
     text_edit->string.buffer.memory.ptr = dst;
     text_edit->string.buffer.size = NK_MAX_NUMBER_BUFFER;
+    text_edit->string.gap_size = 0;
     text_edit->mode = NK_TEXT_EDIT_MODE_INSERT;
     nk_do_edit(ws, out, edit, (int)NK_EDIT_FIELD|(int)NK_EDIT_AUTO_SELECT,
         filters[filter], text_edit, &style->edit, (*state == NK_PROPERTY_EDIT) ? in: 0, font);
+    nk_str_close_gap(&text_edit->string);
 
     *length = text_edit->string.len;
     *cursor = text_edit->cursor;
@@ -28421,6 +32205,7 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
     struct nk_panel *layout;
     struct nk_input *in;
     const struct nk_style *style;
+    struct nk_text_edit *text_edit;
 
     struct nk_rect bounds;
     enum nk_widget_layout_states s;
@@ -28452,21 +32237,24 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
     style = &ctx->style;
     s = nk_widget(&bounds, ctx);
     if (!s) return;
+    if (!nk_window_acquire_state(ctx, win)) return;
+    text_edit = nk_context_text_edit(ctx);
+    if (!text_edit) return;
 
     /* calculate hash from name */
     if (name[0] == '#') {
-        hash = nk_murmur_hash(name, (int)nk_strlen(name), win->property.seq++);
+        hash = nk_murmur_hash(name, (int)nk_strlen(name), win->state->property.seq++);
         name++; /* special number hash */
     } else hash = nk_murmur_hash(name, (int)nk_strlen(name), 42);
 
     /* check if property is currently hot item */
-    if (win->property.active && hash == win->property.name) {
-        buffer = win->property.buffer;
-        len = &win->property.length;
-        cursor = &win->property.cursor;
-        state = &win->property.state;
-        select_begin = &win->property.select_start;
-        select_end = &win->property.select_end;
+    if (win->state->property.active && hash == win->state->property.name) {
+        buffer = win->state->property.buffer;
+        len = &win->state->property.length;
+        cursor = &win->state->property.cursor;
+        state = &win->state->property.state;
+        select_begin = &win->state->property.select_start;
+        select_end = &win->state->property.select_end;
     } else {
         buffer = dummy_buffer;
         len = &dummy_length;
@@ -28478,24 +32266,24 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
 
     /* execute property widget */
     old_state = *state;
-    ctx->text_edit.clip = ctx->clip;
-    in = ((s == NK_WIDGET_ROM && !win->property.active) ||
+    text_edit->clip = ctx->clip;
+    in = ((s == NK_WIDGET_ROM && !win->state->property.active) ||
         layout->flags & NK_WINDOW_ROM || s == NK_WIDGET_DISABLED) ? 0 : &ctx->input;
     nk_do_property(&ctx->last_widget_state, &win->buffer, bounds, name,
         variant, inc_per_pixel, buffer, len, state, cursor, select_begin,
-        select_end, &style->property, filter, in, style->font, &ctx->text_edit,
+        select_end, &style->property, filter, in, style->font, text_edit,
         ctx->button_behavior);
 
-    if (in && *state != NK_PROPERTY_DEFAULT && !win->property.active) {
+    if (in && *state != NK_PROPERTY_DEFAULT && !win->state->property.active) {
         /* current property is now hot */
-        win->property.active = 1;
-        NK_MEMCPY(win->property.buffer, buffer, (nk_size)*len);
-        win->property.length = *len;
-        win->property.cursor = *cursor;
-        win->property.state = *state;
-        win->property.name = hash;
-        win->property.select_start = *select_begin;
-        win->property.select_end = *select_end;
+        win->state->property.active = 1;
+        NK_MEMCPY(win->state->property.buffer, buffer, (nk_size)*len);
+        win->state->property.length = *len;
+        win->state->property.cursor = *cursor;
+        win->state->property.state = *state;
+        win->state->property.name = hash;
+        win->state->property.select_start = *select_begin;
+        win->state->property.select_end = *select_end;
         if (*state == NK_PROPERTY_DRAG) {
             ctx->input.mouse.grab = nk_true;
             ctx->input.mouse.grabbed = nk_true;
@@ -28508,9 +32296,9 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
             ctx->input.mouse.grabbed = nk_false;
             ctx->input.mouse.ungrab = nk_true;
         }
-        win->property.select_start = 0;
-        win->property.select_end = 0;
-        win->property.active = 0;
+        win->state->property.select_start = 0;
+        win->state->property.select_end = 0;
+        win->state->property.active = 0;
     }
 }
 NK_API void
@@ -30066,8 +33854,7 @@ nk_tooltip(struct nk_context *ctx, const char *text)
 
     /* calculate size of the text and tooltip */
     text_len = nk_strlen(text);
-    text_width = style->font->width(style->font->userdata,
-                    style->font->height, text, text_len);
+    text_width = nk_text_width(&ctx->current->buffer, style->font, text, text_len);
     text_width += (4 * padding.x);
     text_height = (style->font->height + 2 * padding.y);
 
@@ -30153,6 +33940,45 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 ///   - [y]: Minor version with non-breaking API and library changes
 ///   - [z]: Patch version with no direct changes to the API
 ///
+/// - 2026/10/18 (6.3.1) - NK_INCLUDE_VIRTUAL_BUFFER builds with -std=c89 on glibc by defining _DEFAULT_SOURCE or mapping /dev/zero
+/// - 2026/10/18 (6.3.0) - NK_LIGHTWEIGHT_CONTEXT defaults the configuration stacks to 4 or 8 entries, shrinking a context to about 11.4KB
+/// - 2026/10/18 (6.2.3) - Const nk_str rune lookups use existing checkpoints but no longer add any
+/// - 2026/10/18 (6.2.2) - nk_str only keeps its gap inside a single text editor call, so buffer.allocated is the text length again and const getters no longer modify the string
+/// - 2026/10/18 (6.2.1) - nk_frame_dirty also compares the byte size of all draw commands next to the 32-bit digest
+/// - 2026/10/18 (6.2.0) - Add nk_convert_cache_invalidate and compare cached windows by two hash lanes
+/// - 2026/10/18 (6.1.0) - Text editor undo history grows from the string allocator up to NK_TEXTEDIT_UNDO_LIMIT, drops the oldest edits in O(1) and merges typing into word records
+/// - 2026/10/18 (6.0.3) - Edit boxes only measure and draw the lines inside the visible area
+/// - 2026/10/18 (6.0.2) - Multiline edit boxes keep a line index so idle frames no longer measure the whole text
+/// - 2026/10/18 (6.0.1) - nk_str remembers rune offsets every NK_STR_CHECKPOINT_STRIDE runes so rune lookups no longer decode from the start
+/// - 2026/10/18 (6.0.0) - BREAKING CHANGE: nk_str keeps a gap buffer at the edit position so inserts and
+///                        deletes no longer move or recount the whole text. `buffer.allocated`
+///                        counts the gap, so read text through `nk_str_get`, `nk_str_len_char`
+///                        and `nk_str_at_*` instead of `buffer.memory.ptr`/`buffer.allocated`.
+///                        6.2.2 restores `buffer.allocated` as the text length between calls.
+/// - 2026/10/18 (5.5.0) - Add NK_PROFILE_BEGIN/NK_PROFILE_END hooks and a Chrome trace profiler in demo/common
+/// - 2026/10/18 (5.4.0) - Add NK_INCLUDE_STATISTICS per frame counters and nk_statistics_window
+/// - 2026/10/18 (5.3.0) - Add NK_LIGHTWEIGHT_CONTEXT with lazily allocated and shareable text editor
+/// - 2026/10/18 (5.2.0) - Add double buffered frame arena with nk_frame_alloc and nk_frame_allocator
+/// - 2026/10/18 (5.1.0) - Add NK_INCLUDE_VIRTUAL_BUFFER and nk_buffer_init_virtual
+/// - 2026/10/18 (5.0.0) - BREAKING CHANGE: Split the page element pool by type and move edit/property
+///                        state out of nk_window. `nk_window` no longer has `edit` and
+///                        `property` members, they live in `win->state`, which stays
+///                        null until the window's first edit box or property. Replace
+///                        `win->edit`/`win->property` with `win->state->edit`/`win->state->property`
+///                        after checking `win->state`.
+/// - 2026/10/18 (4.18.0) - Recycle pool elements and add nk_trim to release empty pages
+/// - 2026/10/18 (4.17.3) - Index per-window state values with an incrementally rehashed table
+/// - 2026/10/18 (4.17.2) - Find windows through a hash index in nk_context
+/// - 2026/10/18 (4.17.1) - Batch glyph quads in nk_draw_list_add_text
+/// - 2026/10/18 (4.17.0) - Add optional NK_INCLUDE_TEXT_WIDTH_CACHE measurement cache
+/// - 2026/10/18 (4.16.4) - ASCII fast path with cached advances in font text width measurement
+/// - 2026/10/18 (4.16.3) - Look up glyphs through a page table built in nk_font_atlas_bake
+/// - 2026/10/18 (4.16.2) - Select specialized vertex writers for common layouts in nk_draw_list_setup
+/// - 2026/10/18 (4.16.1) - Restructured anti-aliased polyline stroking into vectorizable loops
+/// - 2026/10/18 (4.16.0) - Added nk_convert_parallel to tessellate windows on a worker pool
+/// - 2026/10/18 (4.15.0) - Added nk_damage to track damaged screen areas between frames
+/// - 2026/10/18 (4.14.0) - Added nk_frame_digest() and nk_frame_dirty() to detect unchanged frames
+/// - 2026/10/18 (4.13.0) - Added nk_convert_cached() to reuse vertices of unchanged windows
 /// - 2024/03/07 (4.12.1) - Fix bitwise operations warnings in C++20
 /// - 2023/11/26 (4.12.0) - Added an alignment option to checkboxes and radio buttons.
 /// - 2023/10/11 (4.11.0) - Added nk_widget_disable_begin() and nk_widget_disable_end()
@@ -30162,11 +33988,11 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2022/09/03 (4.10.3) - Renamed the `null` texture variable to `tex_null`
 /// - 2022/08/01 (4.10.2) - Fix Apple Silicon with incorrect NK_SITE_TYPE and NK_POINTER_TYPE
 /// - 2022/08/01 (4.10.1) - Fix cursor jumping back to beginning of text when typing more than
-///                         nk_edit_xxx limit
+///                          nk_edit_xxx limit
 /// - 2022/05/27 (4.10.0) - Add nk_input_has_mouse_click_in_button_rect() to fix window move bug
 /// - 2022/04/19 (4.9.8)  - Added nk_rule_horizontal() widget
 /// - 2022/04/18 (4.9.7)  - Change button behavior when NK_BUTTON_TRIGGER_ON_RELEASE is defined to
-///                         only trigger when the mouse position was inside the same button on down
+///                          only trigger when the mouse position was inside the same button on down
 /// - 2022/02/03 (4.9.6)  - Allow overriding the NK_INV_SQRT function, similar to NK_SIN and NK_COS
 /// - 2021/12/22 (4.9.5)  - Revert layout bounds not accounting for padding due to regressions
 /// - 2021/12/22 (4.9.4)  - Fix checking hovering when window is minimized
@@ -30202,30 +34028,30 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2020/05/08 (4.02.3) - Fix missing stdarg.h with NK_INCLUDE_STANDARD_VARARGS
 /// - 2020/04/30 (4.02.2) - Fix nk_edit border drawing bug
 /// - 2020/04/09 (4.02.1) - Removed unused nk_sqrt function to fix compiler warnings
-///                       - Fixed compiler warnings if you bring your own methods for
-///                        nk_cos/nk_sin/nk_strtod/nk_memset/nk_memcopy/nk_dtoa
+///                        - Fixed compiler warnings if you bring your own methods for
+///                         nk_cos/nk_sin/nk_strtod/nk_memset/nk_memcopy/nk_dtoa
 /// - 2020/04/06 (4.01.10) - Fix bug: Do not use pool before checking for NULL
 /// - 2020/03/22 (4.01.9) - Fix bug where layout state wasn't restored correctly after
-///                        popping a tree.
+///                         popping a tree.
 /// - 2020/03/11 (4.01.8) - Fix bug where padding is subtracted from widget
 /// - 2020/03/06 (4.01.7) - Fix bug where width padding was applied twice
 /// - 2020/02/06 (4.01.6) - Update stb_truetype.h and stb_rect_pack.h and separate them
 /// - 2019/12/10 (4.01.5) - Fix off-by-one error in NK_INTERSECT
 /// - 2019/10/09 (4.01.4) - Fix bug for autoscrolling in nk_do_edit
 /// - 2019/09/20 (4.01.3) - Fixed a bug wherein combobox cannot be closed by clicking the header
-///                        when NK_BUTTON_TRIGGER_ON_RELEASE is defined.
+///                         when NK_BUTTON_TRIGGER_ON_RELEASE is defined.
 /// - 2019/09/10 (4.01.2) - Fixed the nk_cos function, which deviated significantly.
 /// - 2019/09/08 (4.01.1) - Fixed a bug wherein re-baking of fonts caused a segmentation
-///                        fault due to dst_font->glyph_count not being zeroed on subsequent
-///                        bakes of the same set of fonts.
+///                         fault due to dst_font->glyph_count not being zeroed on subsequent
+///                         bakes of the same set of fonts.
 /// - 2019/06/23 (4.01.0) - Added nk_***_get_scroll and nk_***_set_scroll for groups, windows, and popups.
 /// - 2019/06/12 (4.00.3) - Fix panel background drawing bug.
 /// - 2018/10/31 (4.00.2) - Added NK_KEYSTATE_BASED_INPUT to "fix" state based backends
-///                        like GLFW without breaking key repeat behavior on event based.
+///                         like GLFW without breaking key repeat behavior on event based.
 /// - 2018/04/01 (4.00.1) - Fixed calling `nk_convert` multiple time per single frame.
 /// - 2018/04/01 (4.00.0) - BREAKING CHANGE: nk_draw_list_clear no longer tries to
-///                        clear provided buffers. So make sure to either free
-///                        or clear each passed buffer after calling nk_convert.
+///                         clear provided buffers. So make sure to either free
+///                         or clear each passed buffer after calling nk_convert.
 /// - 2018/02/23 (3.00.6) - Fixed slider dragging behavior.
 /// - 2018/01/31 (3.00.5) - Fixed overcalculation of cursor data in font baking process.
 /// - 2018/01/31 (3.00.4) - Removed name collision with stb_truetype.
@@ -30233,11 +34059,11 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2018/01/12 (3.00.2) - Added `nk_group_begin_titled` for separated group identifier and title.
 /// - 2018/01/07 (3.00.1) - Started to change documentation style.
 /// - 2018/01/05 (3.00.0) - BREAKING CHANGE: The previous color picker API was broken
-///                        because of conversions between float and byte color representation.
-///                        Color pickers now use floating point values to represent
-///                        HSV values. To get back the old behavior I added some additional
-///                        color conversion functions to cast between nk_color and
-///                        nk_colorf.
+///                         because of conversions between float and byte color representation.
+///                         Color pickers now use floating point values to represent
+///                         HSV values. To get back the old behavior I added some additional
+///                         color conversion functions to cast between nk_color and
+///                         nk_colorf.
 /// - 2017/12/23 (2.00.7) - Fixed small warning.
 /// - 2017/12/23 (2.00.7) - Fixed `nk_edit_buffer` behavior if activated to allow input.
 /// - 2017/12/23 (2.00.7) - Fixed modifyable progressbar dragging visuals and input behavior.
@@ -30248,28 +34074,28 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2017/09/14 (2.00.2) - Fixed `nk_edit_buffer` and `nk_edit_focus` behavior.
 /// - 2017/09/14 (2.00.1) - Fixed window closing behavior.
 /// - 2017/09/14 (2.00.0) - BREAKING CHANGE: Modifying window position and size functions now
-///                        require the name of the window and must happen outside the window
-///                        building process (between function call nk_begin and nk_end).
+///                         require the name of the window and must happen outside the window
+///                         building process (between function call nk_begin and nk_end).
 /// - 2017/09/11 (1.40.9) - Fixed window background flag if background window is declared last.
 /// - 2017/08/27 (1.40.8) - Fixed `nk_item_is_any_active` for hidden windows.
 /// - 2017/08/27 (1.40.7) - Fixed window background flag.
 /// - 2017/07/07 (1.40.6) - Fixed missing clipping rect check for hovering/clicked
-///                        query for widgets.
+///                         query for widgets.
 /// - 2017/07/07 (1.40.5) - Fixed drawing bug for vertex output for lines and stroked
-///                        and filled rectangles.
+///                         and filled rectangles.
 /// - 2017/07/07 (1.40.4) - Fixed bug in nk_convert trying to add windows that are in
-///                        process of being destroyed.
+///                         process of being destroyed.
 /// - 2017/07/07 (1.40.3) - Fixed table internal bug caused by storing table size in
-///                        window instead of directly in table.
+///                         window instead of directly in table.
 /// - 2017/06/30 (1.40.2) - Removed unneeded semicolon in C++ NK_ALIGNOF macro.
 /// - 2017/06/30 (1.40.1) - Fixed drawing lines smaller or equal zero.
 /// - 2017/06/08 (1.40.0) - Removed the breaking part of last commit. Auto layout now only
-///                        comes in effect if you pass in zero was row height argument.
+///                         comes in effect if you pass in zero was row height argument.
 /// - 2017/06/08 (1.40.0) - BREAKING CHANGE: while not directly API breaking it will change
-///                        how layouting works. From now there will be an internal minimum
-///                        row height derived from font height. If you need a row smaller than
-///                        that you can directly set it by `nk_layout_set_min_row_height` and
-///                        reset the value back by calling `nk_layout_reset_min_row_height.
+///                         how layouting works. From now there will be an internal minimum
+///                         row height derived from font height. If you need a row smaller than
+///                         that you can directly set it by `nk_layout_set_min_row_height` and
+///                         reset the value back by calling `nk_layout_reset_min_row_height.
 /// - 2017/06/08 (1.39.1) - Fixed property text edit handling bug caused by past `nk_widget` fix.
 /// - 2017/06/08 (1.39.0) - Added function to retrieve window space without calling a `nk_layout_xxx` function.
 /// - 2017/06/06 (1.38.5) - Fixed `nk_convert` return flag for command buffer.
@@ -30297,7 +34123,7 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2017/01/21 (1.32.1) - Fixed slider behavior and drawing.
 /// - 2017/01/13 (1.32.0) - Added flag to put scaler into the bottom left corner.
 /// - 2017/01/13 (1.31.0) - Added additional row layouting method to combine both
-///                        dynamic and static widgets.
+///                         dynamic and static widgets.
 /// - 2016/12/31 (1.30.0) - Extended scrollbar offset from 16-bit to 32-bit.
 /// - 2016/12/31 (1.29.2) - Fixed closing window bug of minimized windows.
 /// - 2016/12/03 (1.29.1) - Fixed wrapped text with no separator and C89 error.
@@ -30309,185 +34135,185 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 /// - 2016/11/18 (1.28.2) - Fixed memory leak caused by popup panel allocation.
 /// - 2016/11/10 (1.28.1) - Fixed some warnings and C++ error.
 /// - 2016/11/10 (1.28.0) - Added additional `nk_button` versions which allows to directly
-///                        pass in a style struct to change buttons visual.
+///                         pass in a style struct to change buttons visual.
 /// - 2016/11/10 (1.27.0) - Added additional `nk_tree` versions to support external state
-///                        storage. Just like last the `nk_group` commit the main
-///                        advantage is that you optionally can minimize nuklears runtime
-///                        memory consumption or handle hash collisions.
+///                         storage. Just like last the `nk_group` commit the main
+///                         advantage is that you optionally can minimize nuklears runtime
+///                         memory consumption or handle hash collisions.
 /// - 2016/11/09 (1.26.0) - Added additional `nk_group` version to support external scrollbar
-///                        offset storage. Main advantage is that you can externalize
-///                        the memory management for the offset. It could also be helpful
-///                        if you have a hash collision in `nk_group_begin` but really
-///                        want the name. In addition I added `nk_list_view` which allows
-///                        to draw big lists inside a group without actually having to
-///                        commit the whole list to nuklear (issue #269).
+///                         offset storage. Main advantage is that you can externalize
+///                         the memory management for the offset. It could also be helpful
+///                         if you have a hash collision in `nk_group_begin` but really
+///                         want the name. In addition I added `nk_list_view` which allows
+///                         to draw big lists inside a group without actually having to
+///                         commit the whole list to nuklear (issue #269).
 /// - 2016/10/30 (1.25.1) - Fixed clipping rectangle bug inside `nk_draw_list`.
 /// - 2016/10/29 (1.25.0) - Pulled `nk_panel` memory management into nuklear and out of
-///                        the hands of the user. From now on users don't have to care
-///                        about panels unless they care about some information. If you
-///                        still need the panel just call `nk_window_get_panel`.
+///                         the hands of the user. From now on users don't have to care
+///                         about panels unless they care about some information. If you
+///                         still need the panel just call `nk_window_get_panel`.
 /// - 2016/10/21 (1.24.0) - Changed widget border drawing to stroked rectangle from filled
-///                        rectangle for less overdraw and widget background transparency.
+///                         rectangle for less overdraw and widget background transparency.
 /// - 2016/10/18 (1.23.0) - Added `nk_edit_focus` for manually edit widget focus control.
 /// - 2016/09/29 (1.22.7) - Fixed deduction of basic type in non `<stdint.h>` compilation.
 /// - 2016/09/29 (1.22.6) - Fixed edit widget UTF-8 text cursor drawing bug.
 /// - 2016/09/28 (1.22.5) - Fixed edit widget UTF-8 text appending/inserting/removing.
 /// - 2016/09/28 (1.22.4) - Fixed drawing bug inside edit widgets which offset all text
-///                        text in every edit widget if one of them is scrolled.
+///                         text in every edit widget if one of them is scrolled.
 /// - 2016/09/28 (1.22.3) - Fixed small bug in edit widgets if not active. The wrong
-///                        text length is passed. It should have been in bytes but
-///                        was passed as glyphs.
+///                         text length is passed. It should have been in bytes but
+///                         was passed as glyphs.
 /// - 2016/09/20 (1.22.2) - Fixed color button size calculation.
 /// - 2016/09/20 (1.22.1) - Fixed some `nk_vsnprintf` behavior bugs and removed `<stdio.h>`
-///                        again from `NK_INCLUDE_STANDARD_VARARGS`.
+///                         again from `NK_INCLUDE_STANDARD_VARARGS`.
 /// - 2016/09/18 (1.22.0) - C89 does not support vsnprintf only C99 and newer as well
-///                        as C++11 and newer. In addition to use vsnprintf you have
-///                        to include <stdio.h>. So just defining `NK_INCLUDE_STD_VAR_ARGS`
-///                        is not enough. That behavior is now fixed. By default if
-///                        both varargs as well as stdio is selected I try to use
-///                        vsnprintf if not possible I will revert to vsprintf. If
-///                        varargs but not stdio was defined I will use my own function.
+///                         as C++11 and newer. In addition to use vsnprintf you have
+///                         to include <stdio.h>. So just defining `NK_INCLUDE_STD_VAR_ARGS`
+///                         is not enough. That behavior is now fixed. By default if
+///                         both varargs as well as stdio is selected I try to use
+///                         vsnprintf if not possible I will revert to vsprintf. If
+///                         varargs but not stdio was defined I will use my own function.
 /// - 2016/09/15 (1.21.2) - Fixed panel `close` behavior for deeper panel levels.
 /// - 2016/09/15 (1.21.1) - Fixed C++ errors and wrong argument to `nk_panel_get_xxxx`.
 /// - 2016/09/13 (1.21.0) - !BREAKING! Fixed nonblocking popup behavior in menu, combo,
-///                        and contextual which prevented closing in y-direction if
-///                        popup did not reach max height.
-///                        In addition the height parameter was changed into vec2
-///                        for width and height to have more control over the popup size.
+///                         and contextual which prevented closing in y-direction if
+///                         popup did not reach max height.
+///                         In addition the height parameter was changed into vec2
+///                         for width and height to have more control over the popup size.
 /// - 2016/09/13 (1.20.3) - Cleaned up and extended type selection.
 /// - 2016/09/13 (1.20.2) - Fixed slider behavior hopefully for the last time. This time
-///                        all calculation are correct so no more hackery.
+///                         all calculation are correct so no more hackery.
 /// - 2016/09/13 (1.20.1) - Internal change to divide window/panel flags into panel flags and types.
-///                        Suprisinly spend years in C and still happened to confuse types
-///                        with flags. Probably something to take note.
+///                         Suprisinly spend years in C and still happened to confuse types
+///                         with flags. Probably something to take note.
 /// - 2016/09/08 (1.20.0) - Added additional helper function to make it easier to just
-///                        take the produced buffers from `nk_convert` and unplug the
-///                        iteration process from `nk_context`. So now you can
-///                        just use the vertex,element and command buffer + two pointer
-///                        inside the command buffer retrieved by calls `nk__draw_begin`
-///                        and `nk__draw_end` and macro `nk_draw_foreach_bounded`.
+///                         take the produced buffers from `nk_convert` and unplug the
+///                         iteration process from `nk_context`. So now you can
+///                         just use the vertex,element and command buffer + two pointer
+///                         inside the command buffer retrieved by calls `nk__draw_begin`
+///                         and `nk__draw_end` and macro `nk_draw_foreach_bounded`.
 /// - 2016/09/08 (1.19.0) - Added additional asserts to make sure every `nk_xxx_begin` call
-///                        for windows, popups, combobox, menu and contextual is guarded by
-///                        `if` condition and does not produce false drawing output.
+///                         for windows, popups, combobox, menu and contextual is guarded by
+///                         `if` condition and does not produce false drawing output.
 /// - 2016/09/08 (1.18.0) - Changed confusing name for `NK_SYMBOL_RECT_FILLED`, `NK_SYMBOL_RECT`
-///                        to hopefully easier to understand `NK_SYMBOL_RECT_FILLED` and
-///                        `NK_SYMBOL_RECT_OUTLINE`.
+///                         to hopefully easier to understand `NK_SYMBOL_RECT_FILLED` and
+///                         `NK_SYMBOL_RECT_OUTLINE`.
 /// - 2016/09/08 (1.17.0) - Changed confusing name for `NK_SYMBOL_CIRLCE_FILLED`, `NK_SYMBOL_CIRCLE`
-///                        to hopefully easier to understand `NK_SYMBOL_CIRCLE_FILLED` and
-///                        `NK_SYMBOL_CIRCLE_OUTLINE`.
+///                         to hopefully easier to understand `NK_SYMBOL_CIRCLE_FILLED` and
+///                         `NK_SYMBOL_CIRCLE_OUTLINE`.
 /// - 2016/09/08 (1.16.0) - Added additional checks to select correct types if `NK_INCLUDE_FIXED_TYPES`
-///                        is not defined by supporting the biggest compiler GCC, clang and MSVC.
+///                         is not defined by supporting the biggest compiler GCC, clang and MSVC.
 /// - 2016/09/07 (1.15.3) - Fixed `NK_INCLUDE_COMMAND_USERDATA` define to not cause an error.
 /// - 2016/09/04 (1.15.2) - Fixed wrong combobox height calculation.
 /// - 2016/09/03 (1.15.1) - Fixed gaps inside combo boxes in OpenGL.
 /// - 2016/09/02 (1.15.0) - Changed nuklear to not have any default vertex layout and
-///                        instead made it user provided. The range of types to convert
-///                        to is quite limited at the moment, but I would be more than
-///                        happy to accept PRs to add additional.
+///                         instead made it user provided. The range of types to convert
+///                         to is quite limited at the moment, but I would be more than
+///                         happy to accept PRs to add additional.
 /// - 2016/08/30 (1.14.2) - Removed unused variables.
 /// - 2016/08/30 (1.14.1) - Fixed C++ build errors.
 /// - 2016/08/30 (1.14.0) - Removed mouse dragging from SDL demo since it does not work correctly.
 /// - 2016/08/30 (1.13.4) - Tweaked some default styling variables.
 /// - 2016/08/30 (1.13.3) - Hopefully fixed drawing bug in slider, in general I would
-///                        refrain from using slider with a big number of steps.
+///                         refrain from using slider with a big number of steps.
 /// - 2016/08/30 (1.13.2) - Fixed close and minimize button which would fire even if the
-///                        window was in Read Only Mode.
+///                         window was in Read Only Mode.
 /// - 2016/08/30 (1.13.1) - Fixed popup panel padding handling which was previously just
-///                        a hack for combo box and menu.
+///                         a hack for combo box and menu.
 /// - 2016/08/30 (1.13.0) - Removed `NK_WINDOW_DYNAMIC` flag from public API since
-///                        it is bugged and causes issues in window selection.
+///                         it is bugged and causes issues in window selection.
 /// - 2016/08/30 (1.12.0) - Removed scaler size. The size of the scaler is now
-///                        determined by the scrollbar size.
+///                         determined by the scrollbar size.
 /// - 2016/08/30 (1.11.2) - Fixed some drawing bugs caused by changes from 1.11.0.
 /// - 2016/08/30 (1.11.1) - Fixed overlapping minimized window selection.
 /// - 2016/08/30 (1.11.0) - Removed some internal complexity and overly complex code
-///                        handling panel padding and panel border.
+///                         handling panel padding and panel border.
 /// - 2016/08/29 (1.10.0) - Added additional height parameter to `nk_combobox_xxx`.
 /// - 2016/08/29 (1.10.0) - Fixed drawing bug in dynamic popups.
 /// - 2016/08/29 (1.10.0) - Added experimental mouse scrolling to popups, menus and comboboxes.
 /// - 2016/08/26 (1.10.0) - Added window name string prepresentation to account for
-///                        hash collisions. Currently limited to `NK_WINDOW_MAX_NAME`
-///                        which in term can be redefined if not big enough.
+///                         hash collisions. Currently limited to `NK_WINDOW_MAX_NAME`
+///                         which in term can be redefined if not big enough.
 /// - 2016/08/26 (1.10.0) - Added stacks for temporary style/UI changes in code.
 /// - 2016/08/25 (1.10.0) - Changed `nk_input_is_key_pressed` and 'nk_input_is_key_released'
-///                        to account for key press and release happening in one frame.
+///                         to account for key press and release happening in one frame.
 /// - 2016/08/25 (1.10.0) - Added additional nk_edit flag to directly jump to the end on activate.
 /// - 2016/08/17 (1.09.6) - Removed invalid check for value zero in `nk_propertyx`.
 /// - 2016/08/16 (1.09.5) - Fixed ROM mode for deeper levels of popup windows parents.
 /// - 2016/08/15 (1.09.4) - Editbox are now still active if enter was pressed with flag
-///                        `NK_EDIT_SIG_ENTER`. Main reasoning is to be able to keep
-///                        typing after committing.
+///                         `NK_EDIT_SIG_ENTER`. Main reasoning is to be able to keep
+///                         typing after committing.
 /// - 2016/08/15 (1.09.4) - Removed redundant code.
 /// - 2016/08/15 (1.09.4) - Fixed negative numbers in `nk_strtoi` and remove unused variable.
 /// - 2016/08/15 (1.09.3) - Fixed `NK_WINDOW_BACKGROUND` flag behavior to select a background
-///                        window only as selected by hovering and not by clicking.
+///                         window only as selected by hovering and not by clicking.
 /// - 2016/08/14 (1.09.2) - Fixed a bug in font atlas which caused wrong loading
-///                        of glyphs for font with multiple ranges.
+///                         of glyphs for font with multiple ranges.
 /// - 2016/08/12 (1.09.1) - Added additional function to check if window is currently
-///                        hidden and therefore not visible.
+///                         hidden and therefore not visible.
 /// - 2016/08/12 (1.09.1) - nk_window_is_closed now queries the correct flag `NK_WINDOW_CLOSED`
-///                        instead of the old flag `NK_WINDOW_HIDDEN`.
+///                         instead of the old flag `NK_WINDOW_HIDDEN`.
 /// - 2016/08/09 (1.09.0) - Added additional double version to nk_property and changed
-///                        the underlying implementation to not cast to float and instead
-///                        work directly on the given values.
+///                         the underlying implementation to not cast to float and instead
+///                         work directly on the given values.
 /// - 2016/08/09 (1.08.0) - Added additional define to overwrite library internal
-///                        floating pointer number to string conversion for additional
-///                        precision.
+///                         floating pointer number to string conversion for additional
+///                         precision.
 /// - 2016/08/09 (1.08.0) - Added additional define to overwrite library internal
-///                        string to floating point number conversion for additional
-///                        precision.
+///                         string to floating point number conversion for additional
+///                         precision.
 /// - 2016/08/08 (1.07.2) - Fixed compiling error without define `NK_INCLUDE_FIXED_TYPE`.
 /// - 2016/08/08 (1.07.1) - Fixed possible floating point error inside `nk_widget` leading
-///                        to wrong widget width calculation which results in widgets falsely
-///                        becoming tagged as not inside window and cannot be accessed.
+///                         to wrong widget width calculation which results in widgets falsely
+///                         becoming tagged as not inside window and cannot be accessed.
 /// - 2016/08/08 (1.07.0) - Nuklear now differentiates between hiding a window (NK_WINDOW_HIDDEN) and
-///                        closing a window (NK_WINDOW_CLOSED). A window can be hidden/shown
-///                        by using `nk_window_show` and closed by either clicking the close
-///                        icon in a window or by calling `nk_window_close`. Only closed
-///                        windows get removed at the end of the frame while hidden windows
-///                        remain.
+///                         closing a window (NK_WINDOW_CLOSED). A window can be hidden/shown
+///                         by using `nk_window_show` and closed by either clicking the close
+///                         icon in a window or by calling `nk_window_close`. Only closed
+///                         windows get removed at the end of the frame while hidden windows
+///                         remain.
 /// - 2016/08/08 (1.06.0) - Added `nk_edit_string_zero_terminated` as a second option to
-///                        `nk_edit_string` which takes, edits and outputs a '\0' terminated string.
+///                         `nk_edit_string` which takes, edits and outputs a '\0' terminated string.
 /// - 2016/08/08 (1.05.4) - Fixed scrollbar auto hiding behavior.
 /// - 2016/08/08 (1.05.3) - Fixed wrong panel padding selection in `nk_layout_widget_space`.
 /// - 2016/08/07 (1.05.2) - Fixed old bug in dynamic immediate mode layout API, calculating
-///                        wrong item spacing and panel width.
+///                         wrong item spacing and panel width.
 /// - 2016/08/07 (1.05.1) - Hopefully finally fixed combobox popup drawing bug.
 /// - 2016/08/07 (1.05.0) - Split varargs away from `NK_INCLUDE_STANDARD_IO` into own
-///                        define `NK_INCLUDE_STANDARD_VARARGS` to allow more fine
-///                        grained controlled over library includes.
+///                         define `NK_INCLUDE_STANDARD_VARARGS` to allow more fine
+///                         grained controlled over library includes.
 /// - 2016/08/06 (1.04.5) - Changed memset calls to `NK_MEMSET`.
 /// - 2016/08/04 (1.04.4) - Fixed fast window scaling behavior.
 /// - 2016/08/04 (1.04.3) - Fixed window scaling, movement bug which appears if you
-///                        move/scale a window and another window is behind it.
-///                        If you are fast enough then the window behind gets activated
-///                        and the operation is blocked. I now require activating
-///                        by hovering only if mouse is not pressed.
+///                         move/scale a window and another window is behind it.
+///                         If you are fast enough then the window behind gets activated
+///                         and the operation is blocked. I now require activating
+///                         by hovering only if mouse is not pressed.
 /// - 2016/08/04 (1.04.2) - Fixed changing fonts.
 /// - 2016/08/03 (1.04.1) - Fixed `NK_WINDOW_BACKGROUND` behavior.
 /// - 2016/08/03 (1.04.0) - Added color parameter to `nk_draw_image`.
 /// - 2016/08/03 (1.04.0) - Added additional window padding style attributes for
-///                        sub windows (combo, menu, ...).
+///                         sub windows (combo, menu, ...).
 /// - 2016/08/03 (1.04.0) - Added functions to show/hide software cursor.
 /// - 2016/08/03 (1.04.0) - Added `NK_WINDOW_BACKGROUND` flag to force a window
-///                        to be always in the background of the screen.
+///                         to be always in the background of the screen.
 /// - 2016/08/03 (1.03.2) - Removed invalid assert macro for NK_RGB color picker.
 /// - 2016/08/01 (1.03.1) - Added helper macros into header include guard.
 /// - 2016/07/29 (1.03.0) - Moved the window/table pool into the header part to
-///                        simplify memory management by removing the need to
-///                        allocate the pool.
+///                         simplify memory management by removing the need to
+///                         allocate the pool.
 /// - 2016/07/29 (1.02.0) - Added auto scrollbar hiding window flag which if enabled
-///                        will hide the window scrollbar after NK_SCROLLBAR_HIDING_TIMEOUT
-///                        seconds without window interaction. To make it work
-///                        you have to also set a delta time inside the `nk_context`.
+///                         will hide the window scrollbar after NK_SCROLLBAR_HIDING_TIMEOUT
+///                         seconds without window interaction. To make it work
+///                         you have to also set a delta time inside the `nk_context`.
 /// - 2016/07/25 (1.01.1) - Fixed small panel and panel border drawing bugs.
 /// - 2016/07/15 (1.01.0) - Added software cursor to `nk_style` and `nk_context`.
 /// - 2016/07/15 (1.01.0) - Added const correctness to `nk_buffer_push' data argument.
 /// - 2016/07/15 (1.01.0) - Removed internal font baking API and simplified
-///                        font atlas memory management by converting pointer
-///                        arrays for fonts and font configurations to lists.
+///                         font atlas memory management by converting pointer
+///                         arrays for fonts and font configurations to lists.
 /// - 2016/07/15 (1.00.0) - Changed button API to use context dependent button
-///                        behavior instead of passing it for every function call.
+///                         behavior instead of passing it for every function call.
 /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 /// ## Gallery
 /// ![Figure [blue]: Feature overview with blue color styling](https://cloud.githubusercontent.com/assets/8057201/13538240/acd96876-e249-11e5-9547-5ac0b19667a0.png)
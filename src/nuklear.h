@@ -23,6 +23,12 @@ extern "C" {
 #ifndef NK_SCROLLBAR_HIDING_TIMEOUT
   #define NK_SCROLLBAR_HIDING_TIMEOUT 4.0f
 #endif
+#ifndef NK_DAMAGE_MAX_RECTS
+  #define NK_DAMAGE_MAX_RECTS 16
+#endif
+#ifndef NK_TEXT_WIDTH_CACHE_SIZE
+  #define NK_TEXT_WIDTH_CACHE_SIZE 256
+#endif
 /*
  * ==============================================================
  *
@@ -229,12 +235,17 @@ struct nk_allocator;
 struct nk_command_buffer;
 struct nk_draw_command;
 struct nk_convert_config;
+struct nk_convert_cache;
+struct nk_convert_pool;
+struct nk_text_width_cache;
 struct nk_style_item;
 struct nk_text_edit;
 struct nk_draw_list;
 struct nk_user_font;
 struct nk_panel;
 struct nk_context;
+struct nk_shared_state;
+struct nk_stats;
 struct nk_draw_vertex_layout_element;
 struct nk_style_button;
 struct nk_style_toggle;
@@ -453,6 +464,116 @@ NK_API void nk_clear(struct nk_context*);
 /// __ctx__     | Must point to a previously initialized `nk_context` struct
 */
 NK_API void nk_free(struct nk_context*);
+/*/// #### nk_trim
+/// Returns memory pool pages without any live window, panel or table back
+/// to the allocator. Nuklear keeps freed pool elements around for reuse so
+/// a burst of windows or popups otherwise stays allocated until `nk_free`.
+/// Has no effect on contexts initialized with `nk_init_fixed` or a fixed
+/// size pool. Call it between frames, for example after `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_size nk_trim(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns the number of bytes given back to the allocator
+*/
+NK_API nk_size nk_trim(struct nk_context*);
+/*/// #### nk_frame_alloc
+/// Allocates scratch memory that stays valid until the `nk_clear` after
+/// the next one. In other words memory taken while building a frame can
+/// still be used while drawing it and during the following frame.
+/// Allocations are never freed individually. The arena reuses its memory
+/// every other frame and settles on a single block once the frame size
+/// stops growing. `nk_convert` and `nk_convert_cached` take the temporary
+/// normals of anti-aliased strokes and fills from the same arena instead of
+/// the vertex buffer. Returns 0 for contexts initialized with `nk_init_fixed`
+/// or with a fixed size pool.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void *nk_frame_alloc(struct nk_context *ctx, nk_size size, nk_size align);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __size__    | Number of bytes to allocate
+/// __align__   | Required alignment as power of two or 0 for none
+///
+/// Returns a pointer to the allocated memory or 0 on failure
+*/
+NK_API void *nk_frame_alloc(struct nk_context*, nk_size size, nk_size align);
+/*/// #### nk_frame_allocator
+/// Returns an allocator that hands out frame scratch memory from `nk_frame_alloc`.
+/// Its free callback does nothing. You can pass it anywhere nuklear takes an
+/// `nk_allocator`, for example to build a temporary `nk_buffer` or `nk_str`
+/// that is thrown away with the frame.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_allocator nk_frame_allocator(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns an allocator bound to the context's frame arena
+*/
+NK_API struct nk_allocator nk_frame_allocator(struct nk_context*);
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+/*/// #### nk_shared_state_init
+/// Initializes state that may be shared between all contexts used by the
+/// same thread. Only available with NK_LIGHTWEIGHT_CONTEXT. Right now this
+/// is the text editor that edit and property widgets need while they run.
+/// It is allocated on first use.
+///
+/// Most of the remaining per context memory is `nk_style` (about 9KB).
+/// Style stays per context because `nk_style_push_*` and cursor handling
+/// write to it. The configuration stacks use smaller `NK_*_STACK_SIZE`
+/// defaults in this mode.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_shared_state_init(struct nk_shared_state *shared, const struct nk_allocator *alloc);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __shared__  | Must point to an either stack or heap allocated `nk_shared_state` struct
+/// __alloc__   | Must point to a previously allocated memory allocator
+*/
+NK_API void nk_shared_state_init(struct nk_shared_state*, const struct nk_allocator*);
+/*/// #### nk_shared_state_free
+/// Frees memory held by shared state. All contexts using it must no longer
+/// be used afterwards.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_shared_state_free(struct nk_shared_state *shared);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __shared__  | Must point to a previously initialized `nk_shared_state` struct
+*/
+NK_API void nk_shared_state_free(struct nk_shared_state*);
+/*/// #### nk_use_shared_state
+/// Makes a context use shared state instead of allocating its own. Must be
+/// called directly after initializing the context. Contexts sharing state
+/// must not be used from different threads at the same time.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_use_shared_state(struct nk_context *ctx, struct nk_shared_state *shared);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __shared__  | Must point to a previously initialized `nk_shared_state` struct
+*/
+NK_API void nk_use_shared_state(struct nk_context*, struct nk_shared_state*);
+#endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
 /*/// #### nk_set_user_data
 /// Sets the currently passed userdata passed down into each draw command.
@@ -468,6 +589,62 @@ NK_API void nk_free(struct nk_context*);
 */
 NK_API void nk_set_user_data(struct nk_context*, nk_handle handle);
 #endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+/*/// #### nk_text_width_cache_clear
+/// Drops all cached text widths. Entries are keyed by font pointer, font
+/// height and string hash so switching fonts needs no call. Call this if
+/// the metrics behind an existing `nk_user_font` change, for example after
+/// rebaking a font atlas or pointing `userdata` to a different font.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_text_width_cache_clear(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API void nk_text_width_cache_clear(struct nk_context*);
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+/*/// #### nk_statistics
+/// Returns counters collected over the last finished frame. Only available
+/// with NK_INCLUDE_STATISTICS. A frame ends with `nk_clear`, so call this
+/// after `nk_clear` for the frame just drawn. Covers draw commands by type,
+/// command memory in total and per window, pool usage, the frame arena,
+/// persistent value lookups and the output of `nk_convert`. Peak values are
+/// kept across frames.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// const struct nk_stats *nk_statistics(const struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns a pointer to the statistics, valid until the next `nk_clear`
+*/
+NK_API const struct nk_stats *nk_statistics(const struct nk_context*);
+/*/// #### nk_statistics_window
+/// Draws a window showing the statistics of the last finished frame. The
+/// window itself shows up in the numbers like any other window.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_bool nk_statistics_window(struct nk_context *ctx, const char *title, struct nk_rect bounds, nk_flags flags);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __title__   | Window title and identifier
+/// __bounds__  | Initial position and window size
+/// __flags__   | Window flags defined in the nk_panel_flags section
+///
+/// Returns `true(1)` if the window is open and not minimized
+*/
+NK_API nk_bool nk_statistics_window(struct nk_context*, const char *title, struct nk_rect bounds, nk_flags flags);
+#endif
 /* =============================================================================
  *
  *                                  INPUT
@@ -935,7 +1112,11 @@ NK_API void nk_input_end(struct nk_context*);
 /// __nk__begin__       | Returns the first draw command in the context draw command list to be drawn
 /// __nk__next__        | Increments the draw command iterator to the next command inside the context draw command list
 /// __nk_foreach__      | Iterates over each draw command inside the context draw command list
+/// __nk_frame_digest__ | Returns a hash over all draw commands of the current frame
+/// __nk_frame_dirty__  | Returns if the draw commands of the current frame differ from the last drawn frame
 /// __nk_convert__      | Converts from the abstract draw commands list into a hardware accessible vertex format
+/// __nk_convert_cached__| Same as `nk_convert` but reuses vertices of windows that did not change since the last call
+/// __nk_convert_parallel__| Same as `nk_convert` but tessellates each window as a separate job on a caller supplied worker pool
 /// __nk_draw_begin__   | Returns the first vertex command in the context vertex draw list to be executed
 /// __nk__draw_next__   | Increments the vertex command iterator to the next command inside the context vertex command list
 /// __nk__draw_end__    | Returns the end of the vertex draw list
@@ -1010,6 +1191,43 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// Iterates over each draw command inside the context draw command list
 */
 #define nk_foreach(c, ctx) for((c) = nk__begin(ctx); (c) != 0; (c) = nk__next(ctx,c))
+/*/// #### nk_frame_digest
+/// Returns a hash over all draw commands of the current frame in drawing order.
+/// The hash is accumulated while commands are pushed so calling this function
+/// only combines the hash of each window.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_hash nk_frame_digest(struct nk_context*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+///
+/// Returns the hash of all draw commands or 0 if nothing was drawn
+*/
+NK_API nk_hash nk_frame_digest(struct nk_context*);
+/*/// #### nk_frame_dirty
+/// Checks if the draw commands of the current frame differ from the last frame
+/// that was built with `nk__begin`, `nk_convert` or `nk_frame_digest` before `nk_clear`.
+/// Backends can skip converting, uploading and presenting a frame if it is not dirty.
+/// Frames are compared by the `nk_frame_digest` hash and the total byte size of
+/// all draw commands, so a 32-bit hash collision alone does not hide a change.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_bool nk_frame_dirty(struct nk_context*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+///
+/// Returns `true(1)` if the frame needs to be drawn and `false(0)` if it is equal to the last one
+///
+/// !!! Note
+///     Custom commands are only compared by callback and data pointer.
+*/
+NK_API nk_bool nk_frame_dirty(struct nk_context*);
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
 /*/// #### nk_convert
 /// Converts all internal draw commands into vertex draw commands and fills
@@ -1041,6 +1259,68 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// NK_CONVERT_ELEMENT_BUFFER_FULL  | The provided buffer for storing indices is full or failed to allocate more memory
 */
 NK_API nk_flags nk_convert(struct nk_context*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_cached
+/// Converts all internal draw commands into vertex draw commands like `nk_convert`,
+/// but hashes the draw commands of each window and copies the vertices and indices
+/// of every window whose commands did not change since the previous call out of `cache`
+/// instead of tessellating them again. Windows are compared by two independently
+/// seeded 32-bit hashes over their draw commands. Only windows that changed are converted.
+/// Output is equal to `nk_convert` except that every window starts a new vertex draw command.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_flags nk_convert_cached(struct nk_context *ctx, struct nk_convert_cache *cache, struct nk_buffer *cmds,
+///     struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __cache__   | Must point to a `nk_convert_cache` initialized with `nk_convert_cache_init` and only used with this context
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes
+///
+/// !!! Note
+///     Windows containing `nk_push_custom` commands are always converted. Changing
+///     the `nk_convert_config` between calls invalidates the whole cache.
+///     Text commands only store the `nk_user_font` pointer, so after rebaking a font
+///     atlas or changing glyph metrics behind the same font call
+///     `nk_convert_cache_invalidate` to convert every window on the next call.
+*/
+NK_API nk_flags nk_convert_cached(struct nk_context*, struct nk_convert_cache*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_parallel
+/// Converts all internal draw commands into vertex draw commands like `nk_convert`,
+/// but splits the draw command list on window boundaries into jobs which are
+/// tessellated into separate vertex and index buffers by `pool`. Afterwards the
+/// output of all jobs is appended in order into the given buffers.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_flags nk_convert_parallel(struct nk_context *ctx, struct nk_convert_pool *pool, struct nk_buffer *cmds,
+///     struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __pool__    | Must point to a `nk_convert_pool` initialized with `nk_convert_pool_init`
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes
+///
+/// !!! Note
+///     The dispatch callback of `pool` has to call `nk_convert_job_run` exactly once
+///     for every job it is handed and may only return after all of them finished.
+///     Jobs are independent of each other and can run on any thread, but font width
+///     and glyph queries, `nk_push_custom` callbacks and the `NK_PROFILE_BEGIN`/
+///     `NK_PROFILE_END` hooks will be called from these threads.
+*/
+NK_API nk_flags nk_convert_parallel(struct nk_context*, struct nk_convert_pool*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
 /*/// #### nk__draw_begin
 /// Returns a draw vertex command buffer iterator to iterate over the vertex draw command buffer
 ///
@@ -3879,6 +4159,9 @@ struct nk_font {
     nk_rune fallback_codepoint;
     nk_handle texture;
     struct nk_font_config *config;
+    const nk_ushort *glyph_pages; /* 256 basic plane pages: index into glyph_index + 1 or 0 */
+    const nk_uint *glyph_index; /* 256 entries per page: glyph index + 1 or 0 */
+    float ascii_advance[128]; /* unscaled advance of each ASCII codepoint */
 };
 
 enum nk_font_atlas_format {
@@ -3899,6 +4182,7 @@ struct nk_font_atlas {
 
     int glyph_count;
     struct nk_font_glyph *glyphs;
+    void *glyph_lookup;
     struct nk_font *default_font;
     struct nk_font *fonts;
     struct nk_font_config *config;
@@ -3969,6 +4253,12 @@ NK_API void nk_font_atlas_clear(struct nk_font_atlas*);
 /// NK_INCLUDE_DEFAULT_ALLOCATOR which uses the standard library memory
 /// allocation functions malloc and free and takes over complete control over
 /// memory in this library.
+///
+/// For very large command or vertex buffers NK_INCLUDE_VIRTUAL_BUFFER adds
+/// `nk_buffer_init_virtual`. It reserves address space for the largest size the
+/// buffer may ever reach and only commits pages once they are used. Growing
+/// such a buffer never copies memory and pointers into it stay valid until
+/// `nk_buffer_free`.
 */
 struct nk_memory_status {
     void *memory;
@@ -3981,7 +4271,8 @@ struct nk_memory_status {
 
 enum nk_allocation_type {
     NK_BUFFER_FIXED,
-    NK_BUFFER_DYNAMIC
+    NK_BUFFER_DYNAMIC,
+    NK_BUFFER_VIRTUAL
 };
 
 enum nk_buffer_allocation_type {
@@ -4015,11 +4306,16 @@ struct nk_buffer {
     /* number of allocation calls */
     nk_size size;
     /* current size of the buffer */
+    nk_size committed[NK_BUFFER_MAX];
+    /* bytes backed by pages at the front and back of a virtual buffer */
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_buffer_init_default(struct nk_buffer*);
 #endif
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+NK_API nk_bool nk_buffer_init_virtual(struct nk_buffer*, nk_size reserve);
+#endif
 NK_API void nk_buffer_init(struct nk_buffer*, const struct nk_allocator*, nk_size size);
 NK_API void nk_buffer_init_fixed(struct nk_buffer*, void *memory, nk_size size);
 NK_API void nk_buffer_info(struct nk_memory_status*, struct nk_buffer*);
@@ -4041,10 +4337,37 @@ NK_API nk_size nk_buffer_total(struct nk_buffer*);
  *  to manage and manipulate dynamic or fixed size string content. This is _NOT_
  *  the default string handling method. The only instance you should have any contact
  *  with this API is if you interact with an `nk_text_edit` object inside one of the
- *  copy and paste functions and even there only for more advanced cases. */
+ *  copy and paste functions and even there only for more advanced cases.
+ *
+ *  While the text editor applies the edits of one call it keeps a gap of
+ *  unused bytes at the edit position, so typing several runes, replacing a
+ *  selection or undoing an edit moves the rest of the text only once. Every
+ *  `nk_str_*` and `nk_textedit_*` function closes the gap before it returns,
+ *  so `buffer` always holds the contiguous text and `buffer.allocated` its size.
+ *
+ *  Strings with an allocator also remember the text offset of every
+ *  NK_STR_CHECKPOINT_STRIDE-th rune, so finding a rune only decodes the text
+ *  between the closest two checkpoints instead of the whole string. Only
+ *  inserts, deletes and `nk_str_at_rune` add checkpoints, the const lookups
+ *  `nk_str_at_const` and `nk_str_rune_at` use them but never allocate. */
+struct nk_str_checkpoint {
+    int rune;
+    nk_size offset;
+};
 struct nk_str {
     struct nk_buffer buffer;
     int len; /* in codepoints/runes/glyphs */
+    /* text is [0, gap_begin) followed by [gap_begin + gap_size, buffer.allocated) */
+    nk_size gap_begin;
+    nk_size gap_size;
+    int gap_rune; /* rune index of `gap_begin` while the gap is open */
+    /* sorted by rune, allocated from `buffer.pool` */
+    struct nk_str_checkpoint *checkpoints;
+    int checkpoint_count;
+    int checkpoint_capacity;
+    /* text range edited since the text editor last looked, empty if begin > end */
+    nk_size changed_begin;
+    nk_size changed_end;
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -4125,6 +4448,10 @@ NK_API int nk_str_len_char(struct nk_str*);
 #define NK_TEXTEDIT_UNDOCHARCOUNT      999
 #endif
 
+#ifndef NK_TEXTEDIT_UNDO_LIMIT
+#define NK_TEXTEDIT_UNDO_LIMIT         (256*1024)
+#endif
+
 struct nk_text_edit;
 struct nk_clipboard {
     nk_handle userdata;
@@ -4134,18 +4461,39 @@ struct nk_clipboard {
 
 struct nk_text_undo_record {
    int where;
-   short insert_length;
-   short delete_length;
-   short char_storage;
+   int insert_length; /* runes inserted by the edit */
+   int delete_length; /* runes removed by the edit */
+   nk_size char_storage; /* removed runes in the char ring */
 };
 
+/* The history is a ring of records with the oldest at `record_begin`.
+ * Records before `undo_point` can be undone, the ones after it redone.
+ * Runes removed by each edit are kept in a second ring in record order,
+ * followed by a stack with the inserted runes of undone edits. Both
+ * rings start out in the arrays below and move into memory from the
+ * string allocator once they fill up, until `limit` bytes are used.
+ * After that the oldest records are dropped. With NK_LIGHTWEIGHT_CONTEXT
+ * the arrays are not embedded. Only the context's own editor points them
+ * at memory behind itself, all other editors start out empty. */
 struct nk_text_undo_state {
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+   struct nk_text_undo_record *undo_rec;
+   nk_rune *undo_char;
+#else
    struct nk_text_undo_record undo_rec[NK_TEXTEDIT_UNDOSTATECOUNT];
    nk_rune undo_char[NK_TEXTEDIT_UNDOCHARCOUNT];
-   short undo_point;
-   short redo_point;
-   short undo_char_point;
-   short redo_char_point;
+#endif
+   struct nk_text_undo_record *records; /* 0 while `undo_rec` is used */
+   nk_rune *chars; /* 0 while `undo_char` is used */
+   nk_size record_capacity;
+   nk_size char_capacity;
+   nk_size record_begin;
+   nk_size record_end;
+   nk_size undo_point;
+   nk_size char_begin;
+   nk_size char_end;
+   nk_size limit; /* 0 uses NK_TEXTEDIT_UNDO_LIMIT */
+   nk_rune coalesce; /* last rune typed into the newest record or 0 */
 };
 
 enum nk_text_edit_type {
@@ -4159,6 +4507,23 @@ enum nk_text_edit_mode {
     NK_TEXT_EDIT_MODE_REPLACE
 };
 
+struct nk_text_edit_line {
+    nk_size offset; /* text offset of the first byte */
+    int rune; /* rune index of the first rune */
+    float width;
+};
+
+struct nk_text_edit_lines {
+    struct nk_text_edit_line *line; /* allocated from `string.buffer.pool` */
+    int count;
+    int capacity;
+    float width; /* of the widest line */
+    nk_size text_len; /* text the lines were measured for */
+    int rune_len;
+    const struct nk_user_font *font;
+    float font_height;
+};
+
 struct nk_text_edit {
     struct nk_clipboard clip;
     struct nk_str string;
@@ -4177,6 +4542,7 @@ struct nk_text_edit {
     unsigned char padding1;
     float preferred_x;
     struct nk_text_undo_state undo;
+    struct nk_text_edit_lines lines;
 };
 
 /* filter function */
@@ -4450,6 +4816,13 @@ struct nk_command_buffer {
     int use_clipping;
     nk_handle userdata;
     nk_size begin, end, last;
+    nk_hash digest;
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache *text_cache;
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+    struct nk_stats *stats; /* counts pushed commands by type */
+#endif
 };
 
 /* shape outlines */
@@ -4477,6 +4850,35 @@ NK_API void nk_draw_text(struct nk_command_buffer*, struct nk_rect, const char *
 NK_API void nk_push_scissor(struct nk_command_buffer*, struct nk_rect);
 NK_API void nk_push_custom(struct nk_command_buffer*, struct nk_rect, nk_command_custom_callback, nk_handle usr);
 
+/* damage tracking
+ *  Compares the hash and screen bounds of each draw command with the
+ *  previous frame and returns the screen areas which have to be repainted.
+ *  Software renderers can restrict clearing, drawing and presenting to
+ *  `rects` instead of redrawing the whole screen every frame. If `rects`
+ *  contains `nk_null_rect` everything has to be repainted, which happens
+ *  for the first frame and after `nk_damage_invalidate`. */
+struct nk_damage {
+    struct nk_buffer commands[2];
+    /* hash and screen bounds of each draw command of the last two frames */
+    unsigned int command_count[2];
+    /* number of draw commands inside each buffer */
+    struct nk_rect rects[NK_DAMAGE_MAX_RECTS];
+    /* screen areas that changed since the last update */
+    int count;
+    /* number of screen areas inside `rects` */
+    unsigned int seq;
+    /* number of updates done */
+    int invalid;
+    /* repaint everything on the next update */
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_damage_init_default(struct nk_damage*);
+#endif
+NK_API void nk_damage_init(struct nk_damage*, const struct nk_allocator*);
+NK_API void nk_damage_free(struct nk_damage*);
+NK_API void nk_damage_invalidate(struct nk_damage*);
+NK_API int nk_damage_update(struct nk_damage*, struct nk_context*);
+
 /* ===============================================================
  *
  *                          INPUT
@@ -4619,10 +5021,13 @@ struct nk_draw_command {
 #endif
 };
 
+typedef void*(*nk_draw_vertex_writer)(void *dst, const struct nk_draw_list*, struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color);
 struct nk_draw_list {
     struct nk_rect clip_rect;
     struct nk_vec2 circle_vtx[12];
     struct nk_convert_config config;
+    nk_draw_vertex_writer vertex_writer;
+    nk_size vertex_offsets[NK_VERTEX_ATTRIBUTE_COUNT];
 
     struct nk_buffer *buffer;
     struct nk_buffer *vertices;
@@ -4636,6 +5041,12 @@ struct nk_draw_list {
     unsigned int path_count;
     unsigned int path_offset;
 
+    /* temporary normals of anti-aliased strokes and fills. Taken from the
+     * frame arena when set, otherwise from the back of `vertices` */
+    struct nk_frame_arena *scratch_arena;
+    void *scratch;
+    nk_size scratch_size;
+
     enum nk_anti_aliasing line_AA;
     enum nk_anti_aliasing shape_AA;
 
@@ -4644,6 +5055,65 @@ struct nk_draw_list {
 #endif
 };
 
+struct nk_convert_cache {
+    struct nk_buffer memory[2];
+    /* vertices, indices and draw commands of the last two conversions */
+    struct nk_convert_config config;
+    /* configuration used by the last conversion */
+    unsigned int seq;
+    /* number of conversions done with this cache */
+    unsigned int reused;
+    /* number of windows copied from the cache by the last conversion */
+    unsigned int converted;
+    /* number of windows tessellated by the last conversion */
+    int invalid;
+    /* convert every window on the next conversion */
+};
+
+/* convert cache */
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_cache_init_default(struct nk_convert_cache*);
+#endif
+NK_API void nk_convert_cache_init(struct nk_convert_cache*, const struct nk_allocator*);
+NK_API void nk_convert_cache_free(struct nk_convert_cache*);
+NK_API void nk_convert_cache_invalidate(struct nk_convert_cache*);
+
+struct nk_convert_job {
+    struct nk_context *ctx;
+    const struct nk_command *begin;
+    const struct nk_command *end;
+    /* draw commands to convert excluding `end` */
+    struct nk_rect clip;
+    /* clip rect left by the draw commands before `begin` */
+    struct nk_draw_list list;
+    struct nk_buffer cmds;
+    struct nk_buffer vertices;
+    struct nk_buffer elements;
+    /* private output of the job */
+    nk_flags result;
+    /* enum nk_convert_result of the job */
+};
+
+typedef void(*nk_convert_dispatch)(nk_handle userdata, struct nk_convert_job *jobs, int count);
+struct nk_convert_pool {
+    nk_handle userdata;
+    nk_convert_dispatch dispatch;
+    /* runs `nk_convert_job_run` for all jobs and returns once all are done.
+     * Jobs are run one after another on the calling thread if null */
+    struct nk_allocator alloc;
+    struct nk_convert_job *jobs;
+    int count;
+    int capacity;
+};
+
+/* convert pool */
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_pool_init_default(struct nk_convert_pool*, nk_convert_dispatch, nk_handle userdata);
+#endif
+NK_API void nk_convert_pool_init(struct nk_convert_pool*, const struct nk_allocator*, nk_convert_dispatch, nk_handle userdata);
+NK_API void nk_convert_pool_free(struct nk_convert_pool*);
+NK_API void nk_convert_job_run(struct nk_convert_job*);
+
 /* draw list */
 NK_API void nk_draw_list_init(struct nk_draw_list*);
 NK_API void nk_draw_list_setup(struct nk_draw_list*, const struct nk_convert_config*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, enum nk_anti_aliasing line_aa,enum nk_anti_aliasing shape_aa);
@@ -5326,12 +5796,53 @@ struct nk_property_state {
     int state;
 };
 
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+struct nk_convert_cache_state {
+    nk_hash hash[2];
+    unsigned int seq;
+    struct nk_rect clip;
+    nk_size cmd_offset;
+    nk_size vertex_offset;
+    nk_size element_offset;
+    unsigned int cmd_count;
+    unsigned int vertex_count;
+    unsigned int element_count;
+};
+#endif
+
+struct nk_value_slot {
+    nk_hash key;
+    unsigned int index; /* value index inside `tbl` or 1 for deleted slots */
+    struct nk_table *tbl; /* table page holding the value or 0 if unused */
+};
+
+struct nk_value_index {
+    /* open addressing index over the window's table pages. Growing
+     * allocates a new slot array and moves `old` over incrementally */
+    struct nk_value_slot *slots;
+    struct nk_value_slot *old;
+    unsigned int size, used, live;
+    unsigned int old_size, migrated;
+    /* windows owning index memory, freed in `nk_free` */
+    struct nk_window *next, *prev;
+};
+
+struct nk_window_state {
+    struct nk_property_state property;
+    struct nk_edit_state edit;
+};
+
 struct nk_window {
+    /* fields touched by every window list walk come first */
     unsigned int seq;
     nk_hash name;
-    char name_string[NK_WINDOW_MAX_NAME];
     nk_flags flags;
 
+    /* window list hooks */
+    struct nk_window *next;
+    struct nk_window *prev;
+    struct nk_window *parent;
+
     struct nk_rect bounds;
     struct nk_scroll scrollbar;
     struct nk_command_buffer buffer;
@@ -5339,19 +5850,22 @@ struct nk_window {
     float scrollbar_hiding_timer;
 
     /* persistent widget state */
-    struct nk_property_state property;
     struct nk_popup_state popup;
-    struct nk_edit_state edit;
+    struct nk_window_state *state; /* allocated by the first edit or property */
     unsigned int scrolled;
     nk_bool widgets_disabled;
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    struct nk_convert_cache_state convert_cache;
+#endif
 
     struct nk_table *tables;
     unsigned int table_count;
-
-    /* window list hooks */
-    struct nk_window *next;
-    struct nk_window *prev;
-    struct nk_window *parent;
+    struct nk_value_index values;
+#ifdef NK_INCLUDE_STATISTICS
+    unsigned int value_lookups;
+    unsigned int value_probes;
+#endif
+    char name_string[NK_WINDOW_MAX_NAME];
 };
 
 /*==============================================================
@@ -5378,35 +5892,64 @@ struct nk_window {
 ///
 /// Nuklear has a stack for style_items, float properties, vector properties,
 /// flags, colors, fonts and for button_behavior. Each has it's own fixed size stack
-/// which can be changed at compile time.
+/// which can be changed at compile time. With NK_LIGHTWEIGHT_CONTEXT the stacks
+/// default to 4 or 8 entries instead of 8 to 32.
  */
 #ifndef NK_BUTTON_BEHAVIOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_BUTTON_BEHAVIOR_STACK_SIZE 4
+#else
 #define NK_BUTTON_BEHAVIOR_STACK_SIZE 8
 #endif
+#endif
 
 #ifndef NK_FONT_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FONT_STACK_SIZE 4
+#else
 #define NK_FONT_STACK_SIZE 8
 #endif
+#endif
 
 #ifndef NK_STYLE_ITEM_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_STYLE_ITEM_STACK_SIZE 4
+#else
 #define NK_STYLE_ITEM_STACK_SIZE 16
 #endif
+#endif
 
 #ifndef NK_FLOAT_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FLOAT_STACK_SIZE 8
+#else
 #define NK_FLOAT_STACK_SIZE 32
 #endif
+#endif
 
 #ifndef NK_VECTOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_VECTOR_STACK_SIZE 4
+#else
 #define NK_VECTOR_STACK_SIZE 16
 #endif
+#endif
 
 #ifndef NK_FLAGS_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_FLAGS_STACK_SIZE 8
+#else
 #define NK_FLAGS_STACK_SIZE 32
 #endif
+#endif
 
 #ifndef NK_COLOR_STACK_SIZE
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+#define NK_COLOR_STACK_SIZE 8
+#else
 #define NK_COLOR_STACK_SIZE 32
 #endif
+#endif
 
 #define NK_CONFIGURATION_STACK_TYPE(prefix, name, type)\
     struct nk_config_stack_##name##_element {\
@@ -5464,16 +6007,27 @@ union nk_page_data {
     struct nk_table tbl;
     struct nk_panel pan;
     struct nk_window win;
+    struct nk_window_state state;
 };
 
+enum nk_page_element_type {
+    NK_PAGE_ELEMENT_WINDOW,
+    NK_PAGE_ELEMENT_WINDOW_STATE,
+    NK_PAGE_ELEMENT_PANEL,
+    NK_PAGE_ELEMENT_TABLE
+};
+
+/* pool slots are cut to the size of the stored type, so `data` must come last */
 struct nk_page_element {
-    union nk_page_data data;
     struct nk_page_element *next;
     struct nk_page_element *prev;
+    struct nk_page *page; /* owning pool page or 0 */
+    union nk_page_data data;
 };
 
 struct nk_page {
-    unsigned int size;
+    unsigned int size; /* elements handed out so far */
+    unsigned int used; /* elements currently alive */
     struct nk_page *next;
     struct nk_page_element win[1];
 };
@@ -5485,9 +6039,97 @@ struct nk_pool {
     struct nk_page *pages;
     struct nk_page_element *freelist;
     unsigned capacity;
+    nk_size element_size;
     nk_size size;
     nk_size cap;
+    /* element counters */
+    unsigned int live_count;
+    unsigned int free_count;
+    unsigned int peak_count;
+};
+
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+struct nk_shared_state {
+    struct nk_allocator alloc;
+    struct nk_text_edit *text_edit; /* allocated on first use */
+};
+#endif
+
+struct nk_frame_block {
+    struct nk_frame_block *next;
+    nk_size size; /* usable bytes following the header */
+    nk_size used;
+};
+
+struct nk_frame_arena {
+    struct nk_allocator alloc;
+    struct nk_frame_block *blocks[2]; /* newest block first */
+    unsigned int current; /* blocks of the frame being built */
+    nk_size used; /* bytes handed out this frame */
+    nk_size peak; /* largest frame so far */
+};
+
+#ifdef NK_INCLUDE_STATISTICS
+#ifndef NK_STATS_MAX_WINDOWS
+#define NK_STATS_MAX_WINDOWS 16
+#endif
+struct nk_window_stats {
+    char name[NK_WINDOW_MAX_NAME];
+    nk_hash hash;
+    nk_size command_bytes;
+    unsigned int vertices; /* written by nk_convert */
+    unsigned int elements;
+};
+
+struct nk_stats {
+    /* draw commands */
+    unsigned int commands[NK_COMMAND_CUSTOM+1]; /* indexed by nk_command_type */
+    unsigned int command_count;
+    nk_size command_memory;
+    nk_size command_needed;
+    nk_size command_capacity;
+    nk_size command_peak;
+    /* windows with commands, in draw order, until NK_STATS_MAX_WINDOWS */
+    struct nk_window_stats windows[NK_STATS_MAX_WINDOWS];
+    unsigned int window_count;
+    /* window, state, panel and table pools together */
+    unsigned int pool_pages;
+    unsigned int pool_live;
+    unsigned int pool_free;
+    unsigned int pool_peak;
+    nk_size pool_memory;
+    /* frame arena */
+    nk_size frame_memory;
+    nk_size frame_peak;
+    /* `nk_find_value` lookups and compared keys */
+    unsigned int value_lookups;
+    unsigned int value_probes;
+    /* nk_convert output */
+    unsigned int vertices;
+    unsigned int elements;
+    unsigned int draw_commands;
+    unsigned int vertex_peak;
+    unsigned int element_peak;
+};
+#endif
+
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+#define NK_TEXT_WIDTH_CACHE_WAYS 4
+struct nk_text_width_entry {
+    const struct nk_user_font *font;
+    nk_hash hash;
+    int len;
+    float height;
+    float width;
+    int referenced;
 };
+struct nk_text_width_cache {
+    /* set associative: each string hash maps to a set of
+     * NK_TEXT_WIDTH_CACHE_WAYS entries replaced in clock order */
+    struct nk_text_width_entry entries[NK_TEXT_WIDTH_CACHE_SIZE];
+    nk_byte hand[NK_TEXT_WIDTH_CACHE_SIZE / NK_TEXT_WIDTH_CACHE_WAYS];
+};
+#endif
 
 struct nk_context {
 /* public: can be accessed freely */
@@ -5508,19 +6150,39 @@ struct nk_context {
 #endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     nk_handle userdata;
+#endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache text_cache;
 #endif
     /* text editor objects are quite big because of an internal
      * undo/redo stack. Therefore it does not make sense to have one for
      * each window for temporary use cases, so I only provide *one* instance
      * for all windows. This works because the content is cleared anyway */
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    struct nk_text_edit *text_edit;
+    struct nk_shared_state *shared;
+#else
     struct nk_text_edit text_edit;
+#endif
     /* draw buffer used for overlay drawing operation like cursor */
     struct nk_command_buffer overlay;
 
+    /* hash and byte size of all draw commands of the current and last drawn
+     * frame. Together they form the 64-bit key `nk_frame_dirty` compares */
+    nk_hash digest;
+    nk_hash last_digest;
+    nk_size digest_size;
+    nk_size last_digest_size;
+    int has_last_digest;
+
     /* windows */
     int build;
     int use_pool;
-    struct nk_pool pool;
+    struct nk_pool pool; /* windows, or every element for a fixed pool */
+    struct nk_pool state_pool;
+    struct nk_pool panel_pool;
+    struct nk_pool table_pool;
+    struct nk_frame_arena frame;
     struct nk_window *begin;
     struct nk_window *end;
     struct nk_window *active;
@@ -5528,6 +6190,20 @@ struct nk_context {
     struct nk_page_element *freelist;
     unsigned int count;
     unsigned int seq;
+
+    /* open addressing index from window name hash to windows in the list */
+    struct nk_window **window_index;
+    unsigned int window_index_size;
+    unsigned int window_index_count;
+    struct nk_window *value_index_owners;
+
+#ifdef NK_INCLUDE_STATISTICS
+    struct nk_stats stats; /* last finished frame */
+    struct nk_stats stats_frame; /* frame being built */
+    struct nk_window *stats_owner; /* window receiving converted vertices */
+    unsigned int stats_vertex_begin;
+    unsigned int stats_element_begin;
+#endif
 };
 
 /* ==============================================================
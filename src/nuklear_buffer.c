@@ -62,6 +62,105 @@ nk_buffer_init_fixed(struct nk_buffer *b, void *m, nk_size size)
     b->memory.size = size;
     b->size = size;
 }
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+NK_INTERN nk_size
+nk_vm_page_size(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (nk_size)info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? (nk_size)size: 4096;
+#endif
+}
+NK_INTERN void*
+nk_vm_reserve(nk_size size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(MAP_ANONYMOUS)
+    void *ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    return (ptr == MAP_FAILED) ? 0: ptr;
+#else
+    /* a system header included before nuklear already fixed the feature
+     * set without MAP_ANONYMOUS, so map private pages of /dev/zero instead */
+    void *ptr;
+    int fd = open("/dev/zero", O_RDWR);
+    if (fd < 0) return 0;
+    ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return (ptr == MAP_FAILED) ? 0: ptr;
+#endif
+}
+NK_INTERN nk_bool
+nk_vm_commit(void *ptr, nk_size size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+#else
+    return mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0;
+#endif
+}
+NK_INTERN void
+nk_vm_release(void *ptr, nk_size size)
+{
+#ifdef _WIN32
+    NK_UNUSED(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+NK_API nk_bool
+nk_buffer_init_virtual(struct nk_buffer *b, nk_size reserve)
+{
+    void *memory;
+    nk_size page;
+    NK_ASSERT(b);
+    NK_ASSERT(reserve);
+    if (!b || !reserve) return 0;
+
+    page = nk_vm_page_size();
+    reserve = (reserve + page - 1) / page * page;
+    memory = nk_vm_reserve(reserve);
+    NK_ASSERT(memory);
+    if (!memory) return 0;
+
+    nk_zero(b, sizeof(*b));
+    b->type = NK_BUFFER_VIRTUAL;
+    b->memory.ptr = memory;
+    b->memory.size = reserve;
+    b->size = reserve;
+    return 1;
+}
+NK_INTERN nk_bool
+nk_buffer_commit(struct nk_buffer *b, enum nk_buffer_allocation_type type,
+    nk_size required)
+{
+    /* make sure `required` bytes at the given end of the buffer are usable */
+    nk_size page, step, commit;
+    if (required <= b->committed[type])
+        return nk_true;
+
+    page = nk_vm_page_size();
+    step = (NK_BUFFER_VIRTUAL_COMMIT_SIZE + page - 1) / page * page;
+    commit = (required + step - 1) / step * step;
+    commit = NK_MIN(commit, b->memory.size);
+    if (type == NK_BUFFER_FRONT) {
+        void *begin = nk_ptr_add(void, b->memory.ptr, b->committed[type]);
+        if (!nk_vm_commit(begin, commit - b->committed[type]))
+            return nk_false;
+    } else {
+        void *begin = nk_ptr_add(void, b->memory.ptr, b->memory.size - commit);
+        if (!nk_vm_commit(begin, commit - b->committed[type]))
+            return nk_false;
+    }
+    b->committed[type] = commit;
+    return nk_true;
+}
+#endif
 NK_LIB void*
 nk_buffer_align(void *unaligned,
     nk_size align, nk_size *alignment,
@@ -175,6 +274,17 @@ nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type,
         else unaligned = nk_ptr_add(void, b->memory.ptr, b->size - size);
         memory = nk_buffer_align(unaligned, align, &alignment, type);
     }
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+    if (b->type == NK_BUFFER_VIRTUAL) {
+        /* commit pages for the new block instead of moving the buffer */
+        nk_size required;
+        if (type == NK_BUFFER_FRONT)
+            required = b->allocated + size + alignment;
+        else required = b->memory.size - (b->size - (size + alignment));
+        if (!nk_buffer_commit(b, type, required))
+            return 0;
+    }
+#endif
     if (type == NK_BUFFER_FRONT)
         b->allocated += size + alignment;
     else b->size -= (size + alignment);
@@ -237,6 +347,13 @@ nk_buffer_free(struct nk_buffer *b)
     NK_ASSERT(b);
     if (!b || !b->memory.ptr) return;
     if (b->type == NK_BUFFER_FIXED) return;
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+    if (b->type == NK_BUFFER_VIRTUAL) {
+        nk_vm_release(b->memory.ptr, b->memory.size);
+        b->memory.ptr = 0;
+        return;
+    }
+#endif
     if (!b->pool.free) return;
     NK_ASSERT(b->pool.free);
     b->pool.free(b->pool.userdata, b->memory.ptr);
@@ -19,6 +19,19 @@ nk_setup(struct nk_context *ctx, const struct nk_user_font *font)
     nk_draw_list_init(&ctx->draw_list);
 #endif
 }
+NK_INTERN void
+nk_setup_pools(struct nk_context *ctx, const struct nk_allocator *alloc)
+{
+    /* every element type gets its own pool with exactly sized slots */
+    nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_WINDOW));
+    nk_pool_init(&ctx->state_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_WINDOW_STATE));
+    nk_pool_init(&ctx->panel_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_PANEL));
+    nk_pool_init(&ctx->table_pool, alloc, NK_POOL_DEFAULT_CAPACITY,
+        nk_page_element_size(NK_PAGE_ELEMENT_TABLE));
+}
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API nk_bool
 nk_init_default(struct nk_context *ctx, const struct nk_user_font *font)
@@ -48,6 +61,7 @@ nk_init_custom(struct nk_context *ctx, struct nk_buffer *cmds,
     NK_ASSERT(cmds);
     NK_ASSERT(pool);
     if (!cmds || !pool) return 0;
+    NK_ASSERT(pool->type != NK_BUFFER_VIRTUAL);
 
     nk_setup(ctx, font);
     ctx->memory = *cmds;
@@ -57,7 +71,8 @@ nk_init_custom(struct nk_context *ctx, struct nk_buffer *cmds,
     } else {
         /* create dynamic pool from buffer allocator */
         struct nk_allocator *alloc = &pool->pool;
-        nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+        nk_setup_pools(ctx, alloc);
+        nk_frame_arena_init(&ctx->frame, alloc);
     }
     ctx->use_pool = nk_true;
     return 1;
@@ -70,7 +85,8 @@ nk_init(struct nk_context *ctx, const struct nk_allocator *alloc,
     if (!alloc) return 0;
     nk_setup(ctx, font);
     nk_buffer_init(&ctx->memory, alloc, NK_DEFAULT_COMMAND_BUFFER_SIZE);
-    nk_pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+    nk_setup_pools(ctx, alloc);
+    nk_frame_arena_init(&ctx->frame, alloc);
     ctx->use_pool = nk_true;
     return 1;
 }
@@ -90,8 +106,22 @@ nk_free(struct nk_context *ctx)
     NK_ASSERT(ctx);
     if (!ctx) return;
     nk_buffer_free(&ctx->memory);
-    if (ctx->use_pool)
+    nk_frame_arena_free(&ctx->frame);
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    if (ctx->text_edit && !ctx->shared && ctx->use_pool && ctx->pool.alloc.free)
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, ctx->text_edit);
+    ctx->text_edit = 0;
+    ctx->shared = 0;
+#endif
+    nk_window_index_free(ctx);
+    while (ctx->value_index_owners)
+        nk_value_index_free(ctx, ctx->value_index_owners);
+    if (ctx->use_pool) {
         nk_pool_free(&ctx->pool);
+        nk_pool_free(&ctx->state_pool);
+        nk_pool_free(&ctx->panel_pool);
+        nk_pool_free(&ctx->table_pool);
+    }
 
     nk_zero(&ctx->input, sizeof(ctx->input));
     nk_zero(&ctx->style, sizeof(ctx->style));
@@ -106,6 +136,86 @@ nk_free(struct nk_context *ctx)
     ctx->freelist = 0;
     ctx->count = 0;
 }
+NK_LIB struct nk_text_edit*
+nk_context_text_edit(struct nk_context *ctx)
+{
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    /* the editor is followed by its initial undo storage, since the string
+     * it edits is user memory the history cannot grow from */
+    NK_STORAGE const nk_size size = sizeof(struct nk_text_edit) +
+        NK_TEXTEDIT_UNDOSTATECOUNT * sizeof(struct nk_text_undo_record) +
+        NK_TEXTEDIT_UNDOCHARCOUNT * sizeof(nk_rune);
+    struct nk_text_edit *edit = ctx->text_edit;
+    if (edit) return edit;
+    if (ctx->shared && ctx->shared->text_edit) {
+        /* one editor for every context of the shared state */
+        ctx->text_edit = ctx->shared->text_edit;
+        return ctx->text_edit;
+    }
+    if (ctx->shared) {
+        struct nk_shared_state *shared = ctx->shared;
+        if (shared->alloc.alloc)
+            edit = (struct nk_text_edit*)shared->alloc.alloc(
+                shared->alloc.userdata, 0, size);
+        shared->text_edit = edit;
+    } else if (ctx->use_pool) {
+        /* back buffer memory is cleared each frame so ask the allocator */
+        if (ctx->pool.alloc.alloc)
+            edit = (struct nk_text_edit*)ctx->pool.alloc.alloc(
+                ctx->pool.alloc.userdata, 0, size);
+    } else {
+        /* fixed memory contexts keep it at the back with the page elements */
+        NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_text_edit);
+        edit = (struct nk_text_edit*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK,
+            size, align);
+    }
+    NK_ASSERT(edit);
+    if (!edit) return 0;
+    nk_zero(edit, size);
+    edit->undo.undo_rec = (struct nk_text_undo_record*)(void*)(edit + 1);
+    edit->undo.undo_char = (nk_rune*)(void*)(edit->undo.undo_rec + NK_TEXTEDIT_UNDOSTATECOUNT);
+    ctx->text_edit = edit;
+    return edit;
+#else
+    return &ctx->text_edit;
+#endif
+}
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+NK_API void
+nk_shared_state_init(struct nk_shared_state *shared, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(shared);
+    NK_ASSERT(alloc);
+    if (!shared || !alloc) return;
+    nk_zero(shared, sizeof(*shared));
+    shared->alloc = *alloc;
+}
+NK_API void
+nk_shared_state_free(struct nk_shared_state *shared)
+{
+    NK_ASSERT(shared);
+    if (!shared) return;
+    if (shared->text_edit && shared->alloc.free)
+        shared->alloc.free(shared->alloc.userdata, shared->text_edit);
+    shared->text_edit = 0;
+}
+NK_API void
+nk_use_shared_state(struct nk_context *ctx, struct nk_shared_state *shared)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(!ctx->text_edit);
+    if (!ctx || ctx->text_edit) return;
+    ctx->shared = shared;
+}
+#endif
+NK_API nk_size
+nk_trim(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->use_pool) return 0;
+    return nk_pool_trim(&ctx->pool) + nk_pool_trim(&ctx->state_pool) +
+        nk_pool_trim(&ctx->panel_pool) + nk_pool_trim(&ctx->table_pool);
+}
 NK_API void
 nk_clear(struct nk_context *ctx)
 {
@@ -114,10 +224,20 @@ nk_clear(struct nk_context *ctx)
     NK_ASSERT(ctx);
 
     if (!ctx) return;
+    NK_PROFILE_BEGIN("nk_clear");
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_end_frame(ctx);
+#endif
     if (ctx->use_pool)
         nk_buffer_clear(&ctx->memory);
     else nk_buffer_reset(&ctx->memory, NK_BUFFER_FRONT);
+    nk_frame_arena_flip(&ctx->frame);
 
+    if (ctx->build) {
+        ctx->last_digest = ctx->digest;
+        ctx->last_digest_size = ctx->digest_size;
+        ctx->has_last_digest = nk_true;
+    }
     ctx->build = 0;
     ctx->memory.calls = 0;
     ctx->last_widget_state = 0;
@@ -140,8 +260,10 @@ nk_clear(struct nk_context *ctx)
             iter == ctx->active) {
             ctx->active = iter->prev;
             ctx->end = iter->prev;
-            if (!ctx->end)
+            if (!ctx->end) {
                 ctx->begin = 0;
+                nk_window_index_clear(ctx);
+            }
             if (ctx->active)
                 ctx->active->flags &= ~(unsigned)NK_WINDOW_ROM;
         }
@@ -151,6 +273,7 @@ nk_clear(struct nk_context *ctx)
             iter->popup.win = 0;
         }
         /* remove unused window state tables */
+        nk_value_index_step(ctx, iter);
         {struct nk_table *n, *it = iter->tables;
         while (it) {
             n = it->next;
@@ -171,6 +294,7 @@ nk_clear(struct nk_context *ctx)
         } else iter = iter->next;
     }
     ctx->seq++;
+    NK_PROFILE_END;
 }
 NK_LIB void
 nk_start_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
@@ -181,6 +305,7 @@ nk_start_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
     buffer->begin = ctx->memory.allocated;
     buffer->end = buffer->begin;
     buffer->last = buffer->begin;
+    buffer->digest = 0;
     buffer->clip = nk_null_rect;
 }
 NK_LIB void
@@ -251,6 +376,7 @@ nk_build(struct nk_context *ctx)
     struct nk_command *cmd = 0;
     nk_byte *buffer = 0;
 
+    NK_PROFILE_BEGIN("nk_build");
     /* draw cursor overlay */
     if (!ctx->style.cursor_active)
         ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_ARROW];
@@ -259,6 +385,9 @@ nk_build(struct nk_context *ctx)
         const struct nk_cursor *cursor = ctx->style.cursor_active;
         nk_command_buffer_init(&ctx->overlay, &ctx->memory, NK_CLIPPING_OFF);
         nk_start_buffer(ctx, &ctx->overlay);
+#ifdef NK_INCLUDE_STATISTICS
+        ctx->overlay.stats = &ctx->stats_frame;
+#endif
 
         mouse_bounds.x = ctx->input.mouse.pos.x - cursor->offset.x;
         mouse_bounds.y = ctx->input.mouse.pos.y - cursor->offset.y;
@@ -271,12 +400,17 @@ nk_build(struct nk_context *ctx)
     /* build one big draw command list out of all window buffers */
     it = ctx->begin;
     buffer = (nk_byte*)ctx->memory.memory.ptr;
+    ctx->digest = 0;
     while (it != 0) {
         struct nk_window *next = it->next;
+        nk_hash digest;
         if (it->buffer.last == it->buffer.begin || (it->flags & NK_WINDOW_HIDDEN)||
             it->seq != ctx->seq)
             goto cont;
 
+        /* popup commands are part of the parent window buffer digest */
+        digest = nk_command_buffer_digest(&it->buffer);
+        ctx->digest = nk_murmur_hash(&digest, (int)sizeof(digest), ctx->digest);
         cmd = nk_ptr_add(struct nk_command, buffer, it->buffer.last);
         while (next && ((next->buffer.last == next->buffer.begin) ||
             (next->flags & NK_WINDOW_HIDDEN) || next->seq != ctx->seq))
@@ -301,10 +435,15 @@ nk_build(struct nk_context *ctx)
     }
     if (cmd) {
         /* append overlay commands */
-        if (ctx->overlay.end != ctx->overlay.begin)
+        if (ctx->overlay.end != ctx->overlay.begin) {
+            nk_hash digest = nk_command_buffer_digest(&ctx->overlay);
+            ctx->digest = nk_murmur_hash(&digest, (int)sizeof(digest), ctx->digest);
             cmd->next = ctx->overlay.begin;
-        else cmd->next = ctx->memory.allocated;
+        } else cmd->next = ctx->memory.allocated;
     }
+    /* window, popup and overlay commands are the only front allocations */
+    ctx->digest_size = ctx->memory.allocated;
+    NK_PROFILE_END;
 }
 NK_API const struct nk_command*
 nk__begin(struct nk_context *ctx)
@@ -340,5 +479,26 @@ nk__next(struct nk_context *ctx, const struct nk_command *cmd)
     next = nk_ptr_add_const(struct nk_command, buffer, cmd->next);
     return next;
 }
+NK_API nk_hash
+nk_frame_digest(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->count) return 0;
+    if (!ctx->build) {
+        nk_build(ctx);
+        ctx->build = nk_true;
+    }
+    return ctx->digest;
+}
+NK_API nk_bool
+nk_frame_dirty(struct nk_context *ctx)
+{
+    nk_hash digest;
+    NK_ASSERT(ctx);
+    if (!ctx) return nk_true;
+    digest = nk_frame_digest(ctx);
+    return !ctx->has_last_digest || digest != ctx->last_digest ||
+        ctx->digest_size != ctx->last_digest_size;
+}
 
 
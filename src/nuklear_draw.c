@@ -18,6 +18,7 @@ nk_command_buffer_init(struct nk_command_buffer *cb,
     cb->begin = b->allocated;
     cb->end = b->allocated;
     cb->last = b->allocated;
+    cb->digest = 0;
 }
 NK_LIB void
 nk_command_buffer_reset(struct nk_command_buffer *b)
@@ -27,6 +28,7 @@ nk_command_buffer_reset(struct nk_command_buffer *b)
     b->begin = 0;
     b->end = 0;
     b->last = 0;
+    b->digest = 0;
     b->clip = nk_null_rect;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     b->userdata.ptr = 0;
@@ -45,6 +47,10 @@ nk_command_buffer_push(struct nk_command_buffer* b,
     NK_ASSERT(b);
     NK_ASSERT(b->base);
     if (!b) return 0;
+
+    /* previous command is finished so add it to the buffer digest */
+    if (b->end != b->begin)
+        b->digest = nk_command_buffer_digest(b);
     cmd = (struct nk_command*)nk_buffer_alloc(b->base,NK_BUFFER_FRONT,size,align);
     if (!cmd) return 0;
 
@@ -59,12 +65,189 @@ nk_command_buffer_push(struct nk_command_buffer* b,
 
     cmd->type = t;
     cmd->next = b->base->allocated + alignment;
+#ifdef NK_INCLUDE_STATISTICS
+    if (b->stats) b->stats->commands[t]++;
+#endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     cmd->userdata = b->userdata;
 #endif
     b->end = cmd->next;
     return cmd;
 }
+#define NK_COMMAND_END(type, member)\
+    (NK_OFFSETOF(struct type, member) + sizeof(((const struct type*)0)->member))
+#define NK_COMMAND_POINTS_END(type, cmd)\
+    (NK_OFFSETOF(struct type, points) + sizeof(struct nk_vec2i) *\
+    (nk_size)((const struct type*)(const void*)(cmd))->point_count)
+NK_LIB nk_size
+nk_command_size(const struct nk_command *cmd)
+{
+    /* number of bytes up to the end of the last member, so trailing
+     * padding left over from earlier frames is never hashed */
+    NK_ASSERT(cmd);
+    switch (cmd->type) {
+    default:
+    case NK_COMMAND_NOP: return sizeof(struct nk_command);
+    case NK_COMMAND_SCISSOR: return NK_COMMAND_END(nk_command_scissor, h);
+    case NK_COMMAND_LINE: return NK_COMMAND_END(nk_command_line, color);
+    case NK_COMMAND_CURVE: return NK_COMMAND_END(nk_command_curve, color);
+    case NK_COMMAND_RECT: return NK_COMMAND_END(nk_command_rect, color);
+    case NK_COMMAND_RECT_FILLED: return NK_COMMAND_END(nk_command_rect_filled, color);
+    case NK_COMMAND_RECT_MULTI_COLOR: return NK_COMMAND_END(nk_command_rect_multi_color, right);
+    case NK_COMMAND_CIRCLE: return NK_COMMAND_END(nk_command_circle, color);
+    case NK_COMMAND_CIRCLE_FILLED: return NK_COMMAND_END(nk_command_circle_filled, color);
+    case NK_COMMAND_ARC: return NK_COMMAND_END(nk_command_arc, color);
+    case NK_COMMAND_ARC_FILLED: return NK_COMMAND_END(nk_command_arc_filled, color);
+    case NK_COMMAND_TRIANGLE: return NK_COMMAND_END(nk_command_triangle, color);
+    case NK_COMMAND_TRIANGLE_FILLED: return NK_COMMAND_END(nk_command_triangle_filled, color);
+    case NK_COMMAND_POLYGON: return NK_COMMAND_POINTS_END(nk_command_polygon, cmd);
+    case NK_COMMAND_POLYGON_FILLED: return NK_COMMAND_POINTS_END(nk_command_polygon_filled, cmd);
+    case NK_COMMAND_POLYLINE: return NK_COMMAND_POINTS_END(nk_command_polyline, cmd);
+    case NK_COMMAND_TEXT: {
+        /* `string` already counts one byte of sizeof(), so the struct size
+         * would reach past the terminator into unwritten memory */
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        return NK_OFFSETOF(struct nk_command_text, string) + (nk_size)(t->length + 1);
+    }
+    case NK_COMMAND_IMAGE: return NK_COMMAND_END(nk_command_image, col);
+    case NK_COMMAND_CUSTOM: return NK_COMMAND_END(nk_command_custom, callback);
+    }
+}
+NK_LIB nk_hash
+nk_command_hash(const struct nk_command *cmd, nk_hash seed)
+{
+    /* hash everything but the offset to the next command */
+    nk_size size = nk_command_size(cmd);
+    seed = nk_murmur_hash(&cmd->type, (int)sizeof(cmd->type), seed);
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    seed = nk_murmur_hash(&cmd->userdata, (int)sizeof(cmd->userdata), seed);
+#endif
+    if (size > sizeof(*cmd)) {
+        const void *payload = nk_ptr_add_const(nk_byte, cmd, sizeof(*cmd));
+        seed = nk_murmur_hash(payload, (int)(size - sizeof(*cmd)), seed);
+    }
+    return seed;
+}
+NK_LIB nk_hash
+nk_command_buffer_digest(const struct nk_command_buffer *b)
+{
+    /* the last command can still be written to so it is only added to
+     * `b->digest` once the next command is pushed */
+    const struct nk_command *last;
+    NK_ASSERT(b);
+    if (!b) return 0;
+    if (b->end == b->begin) return b->digest;
+    last = nk_ptr_add_const(struct nk_command, b->base->memory.ptr, b->last);
+    return nk_command_hash(last, b->digest);
+}
+NK_INTERN struct nk_rect
+nk_points_bounds(const struct nk_vec2i *points, int count, float pad)
+{
+    int i;
+    short x0, y0, x1, y1;
+    NK_ASSERT(count > 0);
+    x0 = x1 = points[0].x;
+    y0 = y1 = points[0].y;
+    for (i = 1; i < count; ++i) {
+        x0 = NK_MIN(x0, points[i].x); x1 = NK_MAX(x1, points[i].x);
+        y0 = NK_MIN(y0, points[i].y); y1 = NK_MAX(y1, points[i].y);
+    }
+    return nk_rect(x0 - pad, y0 - pad, x1 - x0 + 2*pad, y1 - y0 + 2*pad);
+}
+NK_LIB struct nk_rect
+nk_command_bounds(const struct nk_command *cmd)
+{
+    /* conservative screen area touched by a command without clipping */
+    NK_ASSERT(cmd);
+    switch (cmd->type) {
+    default:
+    case NK_COMMAND_NOP: return nk_rect(0,0,0,0);
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        return nk_rect(s->x, s->y, s->w, s->h);
+    }
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        struct nk_vec2i p[2];
+        p[0] = l->begin; p[1] = l->end;
+        return nk_points_bounds(p, 2, l->line_thickness);
+    }
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        struct nk_vec2i p[4];
+        p[0] = q->begin; p[1] = q->ctrl[0]; p[2] = q->ctrl[1]; p[3] = q->end;
+        return nk_points_bounds(p, 4, q->line_thickness);
+    }
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        return nk_shrink_rect(nk_rect(r->x, r->y, r->w, r->h), -(float)r->line_thickness);
+    }
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        return nk_rect(r->x, r->y, r->w, r->h);
+    }
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        return nk_rect(r->x, r->y, r->w, r->h);
+    }
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        return nk_shrink_rect(nk_rect(c->x, c->y, c->w, c->h), -(float)c->line_thickness);
+    }
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        return nk_rect(c->x, c->y, c->w, c->h);
+    }
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *a = (const struct nk_command_arc*)cmd;
+        const float r = (float)a->r + (float)a->line_thickness;
+        return nk_rect(a->cx - r, a->cy - r, 2*r, 2*r);
+    }
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled*)cmd;
+        return nk_rect(a->cx - a->r, a->cy - a->r, 2*a->r, 2*a->r);
+    }
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        struct nk_vec2i p[3];
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_points_bounds(p, 3, t->line_thickness);
+    }
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        struct nk_vec2i p[3];
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_points_bounds(p, 3, 0);
+    }
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, p->line_thickness);
+    }
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, 0);
+    }
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        if (!p->point_count) return nk_rect(0,0,0,0);
+        return nk_points_bounds(p->points, p->point_count, p->line_thickness);
+    }
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        return nk_rect(t->x, t->y, t->w, t->h);
+    }
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        return nk_rect(i->x, i->y, i->w, i->h);
+    }
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        return nk_rect(c->x, c->y, c->w, c->h);
+    }
+    }
+}
 NK_API void
 nk_push_scissor(struct nk_command_buffer *b, struct nk_rect r)
 {
@@ -267,6 +450,8 @@ nk_fill_arc(struct nk_command_buffer *b, float cx, float cy, float radius,
     cmd = (struct nk_command_arc_filled*)
         nk_command_buffer_push(b, NK_COMMAND_ARC_FILLED, sizeof(*cmd));
     if (!cmd) return;
+    /* the command hash covers the padding in front of `a` */
+    NK_MEMSET(&cmd->cx, 0, sizeof(*cmd) - NK_OFFSETOF(struct nk_command_arc_filled, cx));
     cmd->cx = (short)cx;
     cmd->cy = (short)cy;
     cmd->r = (unsigned short)radius;
@@ -411,7 +596,15 @@ nk_draw_image(struct nk_command_buffer *b, struct nk_rect r,
     cmd->y = (short)r.y;
     cmd->w = (unsigned short)NK_MAX(0, r.w);
     cmd->h = (unsigned short)NK_MAX(0, r.h);
-    cmd->img = *img;
+    /* copied by member so padding inside `img` stays zero for the hash */
+    NK_MEMSET(&cmd->img, 0, sizeof(cmd->img));
+    cmd->img.handle = img->handle;
+    cmd->img.w = img->w;
+    cmd->img.h = img->h;
+    cmd->img.region[0] = img->region[0];
+    cmd->img.region[1] = img->region[1];
+    cmd->img.region[2] = img->region[2];
+    cmd->img.region[3] = img->region[3];
     cmd->col = col;
 }
 NK_API void
@@ -532,7 +725,7 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     }
 
     /* make sure text fits inside bounds */
-    text_width = font->width(font->userdata, font->height, string, length);
+    text_width = nk_text_width(b, font, string, length);
     if (text_width > r.w){
         int glyphs = 0;
         float txt_width = (float)text_width;
@@ -556,3 +749,172 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     cmd->string[length] = '\0';
 }
 
+/* ==============================================================
+ *
+ *                          DAMAGE
+ *
+ * ===============================================================*/
+struct nk_damage_command {
+    nk_hash hash;
+    struct nk_rect bounds;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_damage_init_default(struct nk_damage *damage)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_damage_init(damage, &alloc);
+}
+#endif
+NK_API void
+nk_damage_init(struct nk_damage *damage, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(damage);
+    NK_ASSERT(alloc);
+    if (!damage || !alloc) return;
+
+    nk_zero(damage, sizeof(*damage));
+    nk_buffer_init(&damage->commands[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&damage->commands[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    damage->invalid = nk_true;
+}
+NK_API void
+nk_damage_free(struct nk_damage *damage)
+{
+    NK_ASSERT(damage);
+    if (!damage) return;
+    nk_buffer_free(&damage->commands[0]);
+    nk_buffer_free(&damage->commands[1]);
+    nk_zero(damage, sizeof(*damage));
+}
+NK_API void
+nk_damage_invalidate(struct nk_damage *damage)
+{
+    NK_ASSERT(damage);
+    if (!damage) return;
+    damage->invalid = nk_true;
+}
+NK_INTERN void
+nk_damage_add(struct nk_damage *damage, struct nk_rect r)
+{
+    int i;
+    float x0, y0, x1, y1;
+    if (r.w <= 0 || r.h <= 0) return;
+
+    /* round to whole pixels and grow by one pixel for anti-aliasing */
+    x0 = (float)(nk_ifloorf(r.x) - 1);
+    y0 = (float)(nk_ifloorf(r.y) - 1);
+    x1 = (float)(nk_iceilf(r.x + r.w) + 1);
+    y1 = (float)(nk_iceilf(r.y + r.h) + 1);
+
+    /* merge with every area it touches */
+    for (i = 0; i < damage->count;) {
+        const struct nk_rect *d = &damage->rects[i];
+        if (x0 <= d->x + d->w && d->x <= x1 && y0 <= d->y + d->h && d->y <= y1) {
+            x0 = NK_MIN(x0, d->x); y0 = NK_MIN(y0, d->y);
+            x1 = NK_MAX(x1, d->x + d->w); y1 = NK_MAX(y1, d->y + d->h);
+            damage->rects[i] = damage->rects[--damage->count];
+            i = 0;
+        } else i++;
+    }
+    if (damage->count == NK_DAMAGE_MAX_RECTS) {
+        /* out of space so grow the area that increases the least */
+        int best = 0;
+        float best_cost = 0;
+        for (i = 0; i < damage->count; ++i) {
+            const struct nk_rect *d = &damage->rects[i];
+            float w = NK_MAX(x1, d->x + d->w) - NK_MIN(x0, d->x);
+            float h = NK_MAX(y1, d->y + d->h) - NK_MIN(y0, d->y);
+            float cost = w * h - d->w * d->h;
+            if (!i || cost < best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+        {const struct nk_rect d = damage->rects[best];
+        x0 = NK_MIN(x0, d.x); y0 = NK_MIN(y0, d.y);
+        x1 = NK_MAX(x1, d.x + d.w); y1 = NK_MAX(y1, d.y + d.h);
+        damage->rects[best] = damage->rects[--damage->count];}
+    }
+    damage->rects[damage->count++] = nk_rect(x0, y0, x1 - x0, y1 - y0);
+}
+NK_API int
+nk_damage_update(struct nk_damage *damage, struct nk_context *ctx)
+{
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_damage_command);
+    const struct nk_damage_command *prev;
+    const struct nk_damage_command *cur;
+    const struct nk_command *cmd;
+    struct nk_buffer *buffer;
+    struct nk_rect clip = nk_null_rect;
+    unsigned int prev_count, cur_count = 0;
+    unsigned int i = 0, j = 0;
+    nk_bool full;
+
+    NK_ASSERT(damage);
+    NK_ASSERT(ctx);
+    if (!damage || !ctx) return 0;
+
+    /* record hash and clipped bounds of every command of this frame */
+    damage->seq++;
+    buffer = &damage->commands[damage->seq & 1];
+    nk_buffer_clear(buffer);
+    full = damage->invalid;
+    damage->invalid = nk_false;
+    nk_foreach(cmd, ctx) {
+        struct nk_rect bounds;
+        struct nk_damage_command *out = (struct nk_damage_command*)
+            nk_buffer_alloc(buffer, NK_BUFFER_FRONT, sizeof(*out), align);
+        if (!out) {
+            /* incomplete list can not be compared next frame either */
+            damage->invalid = nk_true;
+            full = nk_true;
+            break;
+        }
+        bounds = nk_command_bounds(cmd);
+        out->hash = nk_command_hash(cmd, 0);
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            out->bounds = bounds;
+            clip = bounds;
+        } else nk_unify(&out->bounds, &bounds, clip.x, clip.y,
+                clip.x + clip.w, clip.y + clip.h);
+        cur_count++;
+    }
+    damage->command_count[damage->seq & 1] = cur_count;
+    damage->count = 0;
+    if (full) {
+        damage->rects[damage->count++] = nk_null_rect;
+        return damage->count;
+    }
+
+    /* walk both frames and resynchronize on single inserts or removals */
+    prev_count = damage->command_count[(damage->seq-1) & 1];
+    prev = nk_ptr_add_const(struct nk_damage_command, damage->commands[(damage->seq-1) & 1].memory.ptr,
+        damage->commands[(damage->seq-1) & 1].allocated) - prev_count;
+    cur = nk_ptr_add_const(struct nk_damage_command, buffer->memory.ptr,
+        buffer->allocated) - cur_count;
+    while (i < prev_count && j < cur_count) {
+        if (prev[i].hash == cur[j].hash) {
+            if (prev[i].bounds.x != cur[j].bounds.x || prev[i].bounds.y != cur[j].bounds.y ||
+                prev[i].bounds.w != cur[j].bounds.w || prev[i].bounds.h != cur[j].bounds.h) {
+                nk_damage_add(damage, prev[i].bounds);
+                nk_damage_add(damage, cur[j].bounds);
+            } i++; j++;
+        } else if (j+1 < cur_count && prev[i].hash == cur[j+1].hash) {
+            nk_damage_add(damage, cur[j++].bounds);
+        } else if (i+1 < prev_count && prev[i+1].hash == cur[j].hash) {
+            nk_damage_add(damage, prev[i++].bounds);
+        } else {
+            nk_damage_add(damage, prev[i++].bounds);
+            nk_damage_add(damage, cur[j++].bounds);
+        }
+    }
+    for (; i < prev_count; ++i)
+        nk_damage_add(damage, prev[i].bounds);
+    for (; j < cur_count; ++j)
+        nk_damage_add(damage, cur[j].bounds);
+    return damage->count;
+}
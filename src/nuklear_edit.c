@@ -97,6 +97,18 @@ nk_edit_draw_text(struct nk_command_buffer *out,
     foreground = nk_rgb_factor(foreground, style->color_factor);
     background = nk_rgb_factor(background, style->color_factor);
 
+    /* skip lines above the clipping rectangle without measuring them */
+    if (pos_y >= out->clip.y + out->clip.h) return;
+    while (pos_y + line_offset + row_height <= out->clip.y) {
+        while (text_len < byte_len && text[text_len] != '\n')
+            text_len++;
+        if (text_len >= byte_len) return;
+        text_len++;
+        line_count++;
+        line_offset += row_height;
+    }
+    line = text + text_len;
+
     glyph_len = nk_utf_decode(text+text_len, &unicode, byte_len-text_len);
     if (!glyph_len) return;
     while ((text_len < byte_len) && glyph_len)
@@ -121,6 +133,8 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             line_width = 0;
             line = text + text_len;
             line_offset += row_height;
+            if (pos_y + line_offset >= out->clip.y + out->clip.h)
+                return; /* everything below is clipped */
             glyph_len = nk_utf_decode(text + text_len, &unicode, (int)(byte_len-text_len));
             continue;
         }
@@ -151,6 +165,188 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             &txt, NK_TEXT_LEFT, font);
     }}
 }
+NK_INTERN int
+nk_edit_line_of_rune(const struct nk_text_edit_lines *lines, int rune)
+{
+    /* index of the last line starting at or before `rune` */
+    int lo = 0, hi = lines->count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (lines->line[mid].rune <= rune)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return NK_MAX(lo - 1, 0);
+}
+NK_INTERN int
+nk_edit_line_of_offset(const struct nk_text_edit_lines *lines, nk_size offset)
+{
+    int lo = 0, hi = lines->count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (lines->line[mid].offset <= offset)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return NK_MAX(lo - 1, 0);
+}
+NK_INTERN int
+nk_edit_lines_reserve(struct nk_text_edit *edit, int count)
+{
+    struct nk_text_edit_lines *lines = &edit->lines;
+    const struct nk_allocator *alloc = &edit->string.buffer.pool;
+    struct nk_text_edit_line *temp;
+    int capacity;
+
+    if (count <= lines->capacity) return 1;
+    capacity = NK_MAX(NK_MAX(64, count), lines->capacity * 2);
+    temp = (struct nk_text_edit_line*)alloc->alloc(alloc->userdata, lines->line,
+        (nk_size)capacity * sizeof(*temp));
+    if (!temp) return 0;
+    if (temp != lines->line && lines->line) {
+        NK_MEMCPY(temp, lines->line, (nk_size)lines->count * sizeof(*temp));
+        alloc->free(alloc->userdata, lines->line);
+    }
+    lines->line = temp;
+    lines->capacity = capacity;
+    return 1;
+}
+NK_INTERN int
+nk_edit_lines_update(struct nk_text_edit *edit, const char *text, int len,
+    const struct nk_user_font *font)
+{
+    /* Brings the line index up to date with the text range the string
+     * marked as changed: lines in front of it are kept, lines behind it
+     * are moved and only the lines in between are measured again. */
+    struct nk_text_edit_lines *lines = &edit->lines;
+    struct nk_str *str = &edit->string;
+    const nk_size text_len = (nk_size)len;
+    nk_size begin, end, offset;
+    int first, keep, count, rune, i;
+    nk_bool widest = nk_false;
+
+    if (str->buffer.type != NK_BUFFER_DYNAMIC || !str->buffer.pool.alloc ||
+        !str->buffer.pool.free) return 0;
+    if (lines->font != font || lines->font_height != font->height || !lines->count) {
+        str->changed_begin = 0;
+        str->changed_end = NK_SIZE_MAX;
+    }
+    if (str->changed_begin > str->changed_end) return 1;
+
+    if (str->changed_end == NK_SIZE_MAX) {
+        first = 0;
+        keep = lines->count;
+        begin = 0;
+        end = text_len;
+        rune = 0;
+        widest = nk_true;
+    } else {
+        /* `changed_end` mapped back to the text the lines were measured for */
+        const nk_size old_end = str->changed_end + lines->text_len - text_len;
+        first = nk_edit_line_of_offset(lines, str->changed_begin);
+        keep = nk_edit_line_of_offset(lines, old_end) + 1;
+        begin = lines->line[first].offset;
+        rune = lines->line[first].rune;
+        end = (keep < lines->count) ? lines->line[keep].offset + text_len - lines->text_len: text_len;
+        for (i = first; i < keep; ++i)
+            widest = widest || lines->line[i].width >= lines->width;
+    }
+
+    /* every new line in between ends one line, the last line ends the text */
+    count = (keep < lines->count) ? 0: 1;
+    for (offset = begin; offset < end; ++offset)
+        count += (text[offset] == '\n');
+    if (!nk_edit_lines_reserve(edit, lines->count - (keep - first) + count))
+        return 0;
+    nk_memmove(lines->line + first + count, lines->line + keep,
+        (nk_size)(lines->count - keep) * sizeof(*lines->line));
+    lines->count += count - (keep - first);
+    for (i = first + count; i < lines->count; ++i) {
+        lines->line[i].offset = lines->line[i].offset + text_len - lines->text_len;
+        lines->line[i].rune += str->len - lines->rune_len;
+    }
+
+    /* measure the lines in between glyph by glyph */
+    {struct nk_text_edit_line *line = lines->line + first;
+    line->offset = begin;
+    line->rune = rune;
+    line->width = 0;
+    offset = begin;
+    while (offset < end) {
+        nk_rune unicode;
+        int glyph_len = nk_utf_decode(text + offset, &unicode, (int)(end - offset));
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+        rune++;
+        if (unicode == '\n') {
+            if (++line == lines->line + first + count) break;
+            line->offset = offset;
+            line->rune = rune;
+            line->width = 0;
+        } else line->width += font->width(font->userdata, font->height,
+            text + offset - glyph_len, glyph_len);
+    }}
+
+    if (widest) {
+        lines->width = 0;
+        for (i = 0; i < lines->count; ++i)
+            lines->width = NK_MAX(lines->width, lines->line[i].width);
+    } else {
+        for (i = first; i < first + count; ++i)
+            lines->width = NK_MAX(lines->width, lines->line[i].width);
+    }
+    lines->text_len = text_len;
+    lines->rune_len = str->len;
+    lines->font = font;
+    lines->font_height = font->height;
+    str->changed_begin = NK_SIZE_MAX;
+    str->changed_end = 0;
+    return 1;
+}
+NK_INTERN const char*
+nk_edit_lines_locate(const struct nk_text_edit *edit, const char *text, int len,
+    int rune, const struct nk_user_font *font, float row_height, struct nk_vec2 *pos)
+{
+    /* 2D position of `rune` and a pointer to it, or null past the last glyph */
+    const struct nk_text_edit_lines *lines = &edit->lines;
+    const int index = nk_edit_line_of_rune(lines, rune);
+    const struct nk_text_edit_line *line = &lines->line[index];
+    nk_size offset = line->offset;
+    int i;
+
+    for (i = line->rune; i < rune && offset < (nk_size)len; ++i) {
+        nk_rune unicode;
+        int glyph_len = nk_utf_decode(text + offset, &unicode, len - (int)offset);
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+    }
+    pos->y = (float)index * row_height;
+    pos->x = 0;
+    if (offset > line->offset) {
+        int glyph_offset;
+        struct nk_vec2 out_offset;
+        const char *remaining;
+        pos->x = nk_text_calculate_text_bounds(font, text + line->offset,
+            (int)(offset - line->offset), row_height, &remaining,
+            &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE).x;
+    }
+    return (offset < (nk_size)len) ? text + offset: 0;
+}
+NK_INTERN nk_size
+nk_edit_lines_skip(const struct nk_text_edit *edit, int len, float top,
+    float row_height, float *line_y)
+{
+    /* text offset and position of the first line not above `top`, taken
+     * from the line index if it is up to date */
+    const struct nk_text_edit_lines *lines = &edit->lines;
+    int index;
+    *line_y = 0;
+    if (!lines->count || lines->text_len != (nk_size)len || top <= 0 ||
+        edit->string.changed_begin <= edit->string.changed_end) return 0;
+    index = NK_MIN((int)(top / row_height), lines->count - 1);
+    *line_y = (float)index * row_height;
+    return lines->line[index].offset;
+}
 NK_LIB nk_flags
 nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter,
@@ -172,6 +368,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     NK_ASSERT(style);
     if (!state || !out || !style)
         return ret;
+    NK_PROFILE_BEGIN("nk_do_edit");
 
     /* visible text area calculation */
     area.x = bounds.x + style->padding.x + style->border;
@@ -367,7 +564,21 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
         /* calculate total line count + total space + cursor/selection position */
         float line_width = 0.0f;
-        if (text && len)
+        if (text && len && nk_edit_lines_update(edit, text, len, font))
+        {
+            /* text edits with an allocator keep line starts and widths */
+            total_lines = edit->lines.count;
+            text_size.x = edit->lines.width;
+            text_size.y = (float)total_lines * row_height;
+            cursor_ptr = nk_edit_lines_locate(edit, text, len, edit->cursor,
+                font, row_height, &cursor_pos);
+            if (edit->select_start != edit->select_end) {
+                select_begin_ptr = nk_edit_lines_locate(edit, text, len,
+                    selection_begin, font, row_height, &selection_offset_start);
+                select_end_ptr = nk_edit_lines_locate(edit, text, len,
+                    selection_end, font, row_height, &selection_offset_end);
+            }
+        } else if (text && len)
         {
             /* utf8 encoding */
             float glyph_width;
@@ -554,11 +765,18 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         cursor_text_color = nk_rgb_factor(cursor_text_color, style->color_factor);
 
         if (edit->select_start == edit->select_end) {
-            /* no selection so just draw the complete text */
+            /* no selection so just draw the visible text */
             const char *begin = nk_str_get_const(&edit->string);
             int l = nk_str_len_char(&edit->string);
+            float skip_y;
+            nk_size skip = nk_edit_lines_skip(edit, l,
+                clip.y - (area.y - edit->scrollbar.y), row_height, &skip_y);
+            if (skip) {
+                begin += skip;
+                l -= (int)skip;
+            }
             nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
+                area.y - edit->scrollbar.y + skip_y, 0, begin, l, row_height, font,
                 background_color, text_color, nk_false);
         } else {
             /* edit has selection so draw 1-3 text chunks */
@@ -637,9 +855,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             }
         }}
     } else {
-        /* not active so just draw text */
+        /* not active so just draw the visible text */
         int l = nk_str_len_char(&edit->string);
         const char *begin = nk_str_get_const(&edit->string);
+        float skip_y = 0;
 
         const struct nk_style_item *background;
         struct nk_color background_color;
@@ -663,11 +882,18 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         background_color = nk_rgb_factor(background_color, style->color_factor);
         text_color = nk_rgb_factor(text_color, style->color_factor);
 
+        if (begin && l && nk_edit_lines_update(edit, begin, l, font)) {
+            const nk_size skip = nk_edit_lines_skip(edit, l,
+                clip.y - (area.y - edit->scrollbar.y), row_height, &skip_y);
+            begin += skip;
+            l -= (int)skip;
+        }
         nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-            area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
+            area.y - edit->scrollbar.y + skip_y, 0, begin, l, row_height, font,
             background_color, text_color, nk_false);
     }
     nk_push_scissor(out, old_clip);}
+    NK_PROFILE_END;
     return ret;
 }
 NK_API void
@@ -681,11 +907,12 @@ nk_edit_focus(struct nk_context *ctx, nk_flags flags)
     if (!ctx || !ctx->current) return;
 
     win = ctx->current;
-    hash = win->edit.seq;
-    win->edit.active = nk_true;
-    win->edit.name = hash;
+    if (!nk_window_acquire_state(ctx, win)) return;
+    hash = win->state->edit.seq;
+    win->state->edit.active = nk_true;
+    win->state->edit.name = hash;
     if (flags & NK_EDIT_ALWAYS_INSERT_MODE)
-        win->edit.mode = NK_TEXT_EDIT_MODE_INSERT;
+        win->state->edit.mode = NK_TEXT_EDIT_MODE_INSERT;
 }
 NK_API void
 nk_edit_unfocus(struct nk_context *ctx)
@@ -696,8 +923,9 @@ nk_edit_unfocus(struct nk_context *ctx)
     if (!ctx || !ctx->current) return;
 
     win = ctx->current;
-    win->edit.active = nk_false;
-    win->edit.name = 0;
+    if (!win->state) return;
+    win->state->edit.active = nk_false;
+    win->state->edit.name = 0;
 }
 NK_API nk_flags
 nk_edit_string(struct nk_context *ctx, nk_flags flags,
@@ -716,25 +944,27 @@ nk_edit_string(struct nk_context *ctx, nk_flags flags,
 
     filter = (!filter) ? nk_filter_default: filter;
     win = ctx->current;
-    hash = win->edit.seq;
-    edit = &ctx->text_edit;
-    nk_textedit_clear_state(&ctx->text_edit, (flags & NK_EDIT_MULTILINE)?
+    if (!nk_window_acquire_state(ctx, win)) return 0;
+    hash = win->state->edit.seq;
+    edit = nk_context_text_edit(ctx);
+    if (!edit) return 0;
+    nk_textedit_clear_state(edit, (flags & NK_EDIT_MULTILINE)?
         NK_TEXT_EDIT_MULTI_LINE: NK_TEXT_EDIT_SINGLE_LINE, filter);
 
-    if (win->edit.active && hash == win->edit.name) {
+    if (win->state->edit.active && hash == win->state->edit.name) {
         if (flags & NK_EDIT_NO_CURSOR)
             edit->cursor = nk_utf_len(memory, *len);
-        else edit->cursor = win->edit.cursor;
+        else edit->cursor = win->state->edit.cursor;
         if (!(flags & NK_EDIT_SELECTABLE)) {
-            edit->select_start = win->edit.cursor;
-            edit->select_end = win->edit.cursor;
+            edit->select_start = win->state->edit.cursor;
+            edit->select_end = win->state->edit.cursor;
         } else {
-            edit->select_start = win->edit.sel_start;
-            edit->select_end = win->edit.sel_end;
+            edit->select_start = win->state->edit.sel_start;
+            edit->select_end = win->state->edit.sel_end;
         }
-        edit->mode = win->edit.mode;
-        edit->scrollbar.x = (float)win->edit.scrollbar.x;
-        edit->scrollbar.y = (float)win->edit.scrollbar.y;
+        edit->mode = win->state->edit.mode;
+        edit->scrollbar.x = (float)win->state->edit.scrollbar.x;
+        edit->scrollbar.y = (float)win->state->edit.scrollbar.y;
         edit->active = nk_true;
     } else edit->active = nk_false;
 
@@ -744,15 +974,16 @@ nk_edit_string(struct nk_context *ctx, nk_flags flags,
     edit->string.buffer.allocated = (nk_size)*len;
     edit->string.len = nk_utf_len(memory, *len);
     state = nk_edit_buffer(ctx, flags, edit, filter);
+    nk_str_close_gap(&edit->string);
     *len = (int)edit->string.buffer.allocated;
 
     if (edit->active) {
-        win->edit.cursor = edit->cursor;
-        win->edit.sel_start = edit->select_start;
-        win->edit.sel_end = edit->select_end;
-        win->edit.mode = edit->mode;
-        win->edit.scrollbar.x = (nk_uint)edit->scrollbar.x;
-        win->edit.scrollbar.y = (nk_uint)edit->scrollbar.y;
+        win->state->edit.cursor = edit->cursor;
+        win->state->edit.sel_start = edit->select_start;
+        win->state->edit.sel_end = edit->select_end;
+        win->state->edit.mode = edit->mode;
+        win->state->edit.scrollbar.x = (nk_uint)edit->scrollbar.x;
+        win->state->edit.scrollbar.y = (nk_uint)edit->scrollbar.y;
     } return state;
 }
 NK_API nk_flags
@@ -784,11 +1015,12 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
     if (!state) return state;
     else if (state == NK_WIDGET_DISABLED)
         flags |= NK_EDIT_READ_ONLY;
+    if (!nk_window_acquire_state(ctx, win)) return 0;
     in = (win->layout->flags & NK_WINDOW_ROM) ? 0 : &ctx->input;
 
     /* check if edit is currently hot item */
-    hash = win->edit.seq++;
-    if (win->edit.active && hash == win->edit.name) {
+    hash = win->state->edit.seq++;
+    if (win->state->edit.active && hash == win->state->edit.name) {
         if (flags & NK_EDIT_NO_CURSOR)
             edit->cursor = edit->string.len;
         if (!(flags & NK_EDIT_SELECTABLE)) {
@@ -797,9 +1029,9 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
         }
         if (flags & NK_EDIT_CLIPBOARD)
             edit->clip = ctx->clip;
-        edit->active = (unsigned char)win->edit.active;
+        edit->active = (unsigned char)win->state->edit.active;
     } else edit->active = nk_false;
-    edit->mode = win->edit.mode;
+    edit->mode = win->state->edit.mode;
 
     filter = (!filter) ? nk_filter_default: filter;
     prev_state = (unsigned char)edit->active;
@@ -811,11 +1043,11 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
         ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_TEXT];
     if (edit->active && prev_state != edit->active) {
         /* current edit is now hot */
-        win->edit.active = nk_true;
-        win->edit.name = hash;
+        win->state->edit.active = nk_true;
+        win->state->edit.name = hash;
     } else if (prev_state && !edit->active) {
         /* current edit is now cold */
-        win->edit.active = nk_false;
+        win->state->edit.active = nk_false;
     } return ret_flags;
 }
 NK_API nk_flags
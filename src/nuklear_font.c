@@ -459,18 +459,22 @@ nk_font_text_width(nk_handle handle, float height, const char *text, int len)
         return 0;
 
     scale = height/font->info.height;
-    glyph_len = text_len = nk_utf_decode(text, &unicode, (int)len);
-    if (!glyph_len) return 0;
-    while (text_len <= (int)len && glyph_len) {
+    while (text_len < len) {
         const struct nk_font_glyph *g;
-        if (unicode == NK_UTF_INVALID) break;
+        const unsigned char c = (unsigned char)text[text_len];
+        if (c < 0x7F) {
+            /* ASCII: single byte glyph with precomputed advance
+             * (DEL is rejected by `nk_utf_decode` so it takes the slow path) */
+            text_width += font->ascii_advance[c] * scale;
+            text_len++;
+            continue;
+        }
+        glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+        if (!glyph_len || unicode == NK_UTF_INVALID) break;
 
         /* query currently drawn glyph information */
         g = nk_font_find_glyph(font, unicode);
         text_width += g->xadvance * scale;
-
-        /* offset next glyph */
-        glyph_len = nk_utf_decode(text + text_len, &unicode, (int)len - text_len);
         text_len += glyph_len;
     }
     return text_width;
@@ -502,6 +506,13 @@ nk_font_query_font_glyph(nk_handle handle, float height,
     glyph->uv[0] = nk_vec2(g->u0, g->v0);
     glyph->uv[1] = nk_vec2(g->u1, g->v1);
 }
+NK_LIB struct nk_font*
+nk_font_from_user_font(const struct nk_user_font *font)
+{
+    /* baked fonts can be read directly instead of through `query` */
+    if (!font || font->query != nk_font_query_font_glyph) return 0;
+    return (struct nk_font*)font->userdata.ptr;
+}
 #endif
 NK_API const struct nk_font_glyph*
 nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
@@ -517,6 +528,14 @@ nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
     NK_ASSERT(font->info.ranges);
     if (!font || !font->glyphs) return 0;
 
+    if (font->glyph_pages && unicode <= 0xFFFF) {
+        /* basic multilingual plane: two level table built at bake time */
+        nk_uint index;
+        nk_ushort page = font->glyph_pages[unicode >> 8];
+        if (!page) return font->fallback;
+        index = font->glyph_index[((nk_uint)(page - 1) << 8) | (unicode & 0xFF)];
+        return (index) ? &font->glyphs[index - 1] : font->fallback;
+    }
     glyph = font->fallback;
     iter = font->config;
     do {count = nk_range_count(iter->range);
@@ -531,12 +550,85 @@ nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
     } while ((iter = iter->n) != font->config);
     return glyph;
 }
+NK_INTERN int
+nk_font_glyph_pages(nk_ushort *pages, const struct nk_font_config *config)
+{
+    /* marks each basic plane page covered by the font's ranges */
+    int i, count, page_count = 0;
+    const struct nk_font_config *iter = config;
+    NK_MEMSET(pages, 0, 256 * sizeof(nk_ushort));
+    do {count = nk_range_count(iter->range);
+        for (i = 0; i < count; ++i) {
+            nk_rune f = iter->range[(i*2)+0];
+            nk_rune t = NK_MIN(iter->range[(i*2)+1], 0xFFFF);
+            for (; f <= t && f <= 0xFFFF; f = (f | 0xFF) + 1) {
+                if (!pages[f >> 8])
+                    pages[f >> 8] = (nk_ushort)++page_count;
+            }
+        }
+    } while ((iter = iter->n) != config);
+    return page_count;
+}
+NK_INTERN void
+nk_font_glyph_index(nk_uint *index, const nk_ushort *pages,
+    const struct nk_font_config *config)
+{
+    /* same search order as the range walk in `nk_font_find_glyph` */
+    int i, count;
+    nk_uint total_glyphs = 0;
+    const struct nk_font_config *iter = config;
+    do {count = nk_range_count(iter->range);
+        for (i = 0; i < count; ++i) {
+            nk_rune f = iter->range[(i*2)+0];
+            nk_rune t = iter->range[(i*2)+1];
+            nk_rune u;
+            for (u = f; u <= t && u <= 0xFFFF; ++u) {
+                nk_uint *slot = &index[((nk_uint)(pages[u >> 8] - 1) << 8) | (u & 0xFF)];
+                if (!*slot) *slot = total_glyphs + (u - f) + 1;
+            }
+            total_glyphs += (t - f) + 1;
+        }
+    } while ((iter = iter->n) != config);
+}
+NK_INTERN nk_bool
+nk_font_atlas_build_lookup(struct nk_font_atlas *atlas)
+{
+    /* one allocation holding the glyph page tables of all fonts */
+    nk_ushort pages[256];
+    struct nk_font *font;
+    nk_size font_count = 0, page_count = 0;
+    nk_ushort *page_iter;
+    nk_uint *index_iter;
+
+    for (font = atlas->fonts; font; font = font->next) {
+        page_count += (nk_size)nk_font_glyph_pages(pages, font->config);
+        font_count++;
+    }
+    atlas->glyph_lookup = atlas->permanent.alloc(atlas->permanent.userdata, 0,
+        font_count * sizeof(pages) + page_count * 256 * sizeof(nk_uint));
+    NK_ASSERT(atlas->glyph_lookup);
+    if (!atlas->glyph_lookup) return nk_false;
+
+    page_iter = (nk_ushort*)atlas->glyph_lookup;
+    index_iter = (nk_uint*)(void*)(page_iter + font_count * 256);
+    NK_MEMSET(index_iter, 0, page_count * 256 * sizeof(nk_uint));
+    for (font = atlas->fonts; font; font = font->next) {
+        int n = nk_font_glyph_pages(page_iter, font->config);
+        nk_font_glyph_index(index_iter, page_iter, font->config);
+        font->glyph_pages = page_iter;
+        font->glyph_index = index_iter;
+        page_iter += 256;
+        index_iter += n * 256;
+    }
+    return nk_true;
+}
 NK_INTERN void
 nk_font_init(struct nk_font *font, float pixel_height,
     nk_rune fallback_codepoint, struct nk_font_glyph *glyphs,
     const struct nk_baked_font *baked_font, nk_handle atlas)
 {
     struct nk_baked_font baked;
+    nk_size i;
     NK_ASSERT(font);
     NK_ASSERT(glyphs);
     NK_ASSERT(baked_font);
@@ -551,6 +643,10 @@ nk_font_init(struct nk_font *font, float pixel_height,
     font->texture = atlas;
     font->fallback_codepoint = fallback_codepoint;
     font->fallback = nk_font_find_glyph(font, fallback_codepoint);
+    for (i = 0; i < NK_LEN(font->ascii_advance); ++i) {
+        const struct nk_font_glyph *g = nk_font_find_glyph(font, (nk_rune)i);
+        font->ascii_advance[i] = (g) ? g->xadvance : 0;
+    }
 
     font->handle.height = font->info.height * font->scale;
     font->handle.width = nk_font_text_width;
@@ -926,6 +1022,10 @@ nk_font_atlas_begin(struct nk_font_atlas *atlas)
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
         atlas->glyphs = 0;
     }
+    if (atlas->glyph_lookup) {
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
+        atlas->glyph_lookup = 0;
+    }
     if (atlas->pixel) {
         atlas->permanent.free(atlas->permanent.userdata, atlas->pixel);
         atlas->pixel = 0;
@@ -1170,6 +1270,7 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
         !atlas->temporary.alloc || !atlas->temporary.free ||
         !atlas->permanent.alloc || !atlas->permanent.free)
         return 0;
+    NK_PROFILE_BEGIN("nk_font_atlas_bake");
 
 #ifdef NK_INCLUDE_DEFAULT_FONT
     /* no font added so just use default font */
@@ -1177,7 +1278,10 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
         atlas->default_font = nk_font_atlas_add_default(atlas, 13.0f, 0);
 #endif
     NK_ASSERT(atlas->font_num);
-    if (!atlas->font_num) return 0;
+    if (!atlas->font_num) {
+        NK_PROFILE_END;
+        return 0;
+    }
 
     /* allocate temporary baker memory required for the baking process */
     nk_font_baker_memory(&tmp_size, &atlas->glyph_count, atlas->config, atlas->font_num);
@@ -1226,7 +1330,9 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
     atlas->tex_width = *width;
     atlas->tex_height = *height;
 
-    /* initialize each font */
+    /* build glyph lookup tables and initialize each font */
+    if (!nk_font_atlas_build_lookup(atlas))
+        goto failed;
     for (font_iter = atlas->fonts; font_iter; font_iter = font_iter->next) {
         struct nk_font *font = font_iter;
         struct nk_font_config *config = font->config;
@@ -1258,6 +1364,7 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
     }}
     /* free temporary memory */
     atlas->temporary.free(atlas->temporary.userdata, tmp);
+    NK_PROFILE_END;
     return atlas->pixel;
 
 failed:
@@ -1267,10 +1374,15 @@ failed:
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
         atlas->glyphs = 0;
     }
+    if (atlas->glyph_lookup) {
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
+        atlas->glyph_lookup = 0;
+    }
     if (atlas->pixel) {
         atlas->temporary.free(atlas->temporary.userdata, atlas->pixel);
         atlas->pixel = 0;
     }
+    NK_PROFILE_END;
     return 0;
 }
 NK_API void
@@ -1367,6 +1479,8 @@ nk_font_atlas_clear(struct nk_font_atlas *atlas)
     }
     if (atlas->glyphs)
         atlas->permanent.free(atlas->permanent.userdata, atlas->glyphs);
+    if (atlas->glyph_lookup)
+        atlas->permanent.free(atlas->permanent.userdata, atlas->glyph_lookup);
     nk_zero_struct(*atlas);
 }
 #endif
@@ -0,0 +1,138 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          FRAME ARENA
+ *
+ * ===============================================================*/
+NK_LIB void
+nk_frame_arena_init(struct nk_frame_arena *arena, const struct nk_allocator *alloc)
+{
+    nk_zero(arena, sizeof(*arena));
+    arena->alloc = *alloc;
+}
+NK_INTERN struct nk_frame_block*
+nk_frame_arena_block(struct nk_frame_arena *arena, nk_size size,
+    struct nk_frame_block *next)
+{
+    struct nk_frame_block *block;
+    if (!arena->alloc.alloc) return 0;
+    block = (struct nk_frame_block*)arena->alloc.alloc(arena->alloc.userdata, 0,
+        sizeof(struct nk_frame_block) + size);
+    NK_ASSERT(block);
+    if (!block) return 0;
+    block->next = next;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+NK_INTERN void
+nk_frame_arena_release(struct nk_frame_arena *arena, struct nk_frame_block *block)
+{
+    while (block) {
+        struct nk_frame_block *next = block->next;
+        arena->alloc.free(arena->alloc.userdata, block);
+        block = next;
+    }
+}
+NK_LIB void
+nk_frame_arena_flip(struct nk_frame_arena *arena)
+{
+    struct nk_frame_block *block;
+    arena->peak = NK_MAX(arena->peak, arena->used);
+    arena->used = 0;
+    arena->current = !arena->current;
+
+    /* reuse the blocks of the frame before last. If that frame needed more
+     * than one block replace them by a single block big enough for all */
+    block = arena->blocks[arena->current];
+    if (block && block->next) {
+        struct nk_frame_block *iter;
+        nk_size total = 0;
+        for (iter = block; iter; iter = iter->next)
+            total += iter->size;
+        nk_frame_arena_release(arena, block);
+        block = nk_frame_arena_block(arena, total, 0);
+        arena->blocks[arena->current] = block;
+    }
+    if (block) block->used = 0;
+}
+NK_LIB void
+nk_frame_arena_free(struct nk_frame_arena *arena)
+{
+    if (!arena->alloc.free) return;
+    nk_frame_arena_release(arena, arena->blocks[0]);
+    nk_frame_arena_release(arena, arena->blocks[1]);
+    arena->blocks[0] = 0;
+    arena->blocks[1] = 0;
+}
+NK_LIB void*
+nk_frame_arena_alloc(struct nk_frame_arena *arena, nk_size size, nk_size align)
+{
+    struct nk_frame_block *block;
+    nk_byte *begin;
+    void *memory;
+    nk_size end;
+
+    NK_ASSERT(arena);
+    NK_ASSERT(size);
+    if (!arena || !size) return 0;
+
+    /* try to fit the allocation into the newest block of this frame */
+    block = arena->blocks[arena->current];
+    if (block) {
+        begin = (nk_byte*)(block + 1);
+        memory = begin + block->used;
+        if (align) memory = NK_ALIGN_PTR(memory, align);
+        end = (nk_size)((nk_byte*)memory - begin) + size;
+        if (end <= block->size) {
+            arena->used += end - block->used;
+            block->used = end;
+            return memory;
+        }
+    }
+    /* out of space so chain a new block at least twice as big */
+    {nk_size capacity = NK_MAX(NK_FRAME_ARENA_BLOCK_SIZE, size + align);
+    if (block) capacity = NK_MAX(capacity, block->size * 2);
+    block = nk_frame_arena_block(arena, capacity, block);
+    if (!block) return 0;
+    arena->blocks[arena->current] = block;}
+
+    begin = (nk_byte*)(block + 1);
+    memory = (align) ? NK_ALIGN_PTR(begin, align): (void*)begin;
+    block->used = (nk_size)((nk_byte*)memory - begin) + size;
+    arena->used += block->used;
+    return memory;
+}
+NK_API void*
+nk_frame_alloc(struct nk_context *ctx, nk_size size, nk_size align)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    return nk_frame_arena_alloc(&ctx->frame, size, align);
+}
+NK_INTERN void*
+nk_frame_allocator_alloc(nk_handle handle, void *old, nk_size size)
+{
+    /* callers may store any type so align like malloc would */
+    NK_UNUSED(old);
+    return nk_frame_alloc((struct nk_context*)handle.ptr, size, 16);
+}
+NK_INTERN void
+nk_frame_allocator_free(nk_handle handle, void *ptr)
+{
+    NK_UNUSED(handle);
+    NK_UNUSED(ptr);
+}
+NK_API struct nk_allocator
+nk_frame_allocator(struct nk_context *ctx)
+{
+    struct nk_allocator alloc;
+    NK_ASSERT(ctx);
+    alloc.userdata = nk_handle_ptr(ctx);
+    alloc.alloc = nk_frame_allocator_alloc;
+    alloc.free = nk_frame_allocator_free;
+    return alloc;
+}
+
@@ -13,6 +13,22 @@
 #define NK_BUFFER_DEFAULT_INITIAL_SIZE (4*1024)
 #endif
 
+#ifndef NK_FRAME_ARENA_BLOCK_SIZE
+#define NK_FRAME_ARENA_BLOCK_SIZE (4*1024)
+#endif
+
+#ifndef NK_BUFFER_VIRTUAL_COMMIT_SIZE
+#define NK_BUFFER_VIRTUAL_COMMIT_SIZE (64*1024)
+#endif
+
+#ifndef NK_STR_GAP_SIZE
+#define NK_STR_GAP_SIZE 64
+#endif
+
+#ifndef NK_STR_CHECKPOINT_STRIDE
+#define NK_STR_CHECKPOINT_STRIDE 256
+#endif
+
 /* standard library headers */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 #include <stdlib.h> /* malloc, free */
@@ -23,11 +39,44 @@
 #ifdef NK_INCLUDE_STANDARD_VARARGS
 #include <stdarg.h> /* valist, va_start, va_end, ... */
 #endif
+#ifdef NK_INCLUDE_VIRTUAL_BUFFER
+#ifdef _WIN32
+#include <windows.h> /* VirtualAlloc, VirtualFree, GetSystemInfo */
+#else
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS on glibc with -std=c89 */
+#endif
+#include <sys/mman.h> /* mmap, mprotect, munmap */
+#include <unistd.h> /* sysconf, close */
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_ANONYMOUS
+#include <fcntl.h> /* open */
+#endif
+#endif
+#endif
 #ifndef NK_ASSERT
 #include <assert.h>
 #define NK_ASSERT(expr) assert(expr)
 #endif
 
+/* SSE2 paths reproduce the scalar results bit for bit, which includes the
+ * approximation of the built-in inverse square root */
+#if !defined(NK_NO_SIMD) && !defined(NK_INV_SQRT) &&\
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h> /* SSE2 intrinsics */
+#define NK_SIMD_SSE2
+#endif
+
+/* profiling hooks around expensive regions, no-ops unless defined */
+#ifndef NK_PROFILE_BEGIN
+#define NK_PROFILE_BEGIN(name)
+#endif
+#ifndef NK_PROFILE_END
+#define NK_PROFILE_END
+#endif
+
 #define NK_DEFAULT (-1)
 
 #ifndef NK_VSNPRINTF
@@ -58,6 +107,7 @@
 #define NK_SINT_MAX 2147483647
 #define NK_UINT_MIN 0
 #define NK_UINT_MAX 4294967295u
+#define NK_SIZE_MAX ((nk_size)-1)
 
 /* Make sure correct type size:
  * This will fire with a negative subscript error if the type sizes
@@ -65,6 +115,10 @@
 NK_STATIC_ASSERT(sizeof(nk_size) >= sizeof(void*));
 NK_STATIC_ASSERT(sizeof(nk_ptr) == sizeof(void*));
 NK_STATIC_ASSERT(sizeof(nk_flags) >= 4);
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+NK_STATIC_ASSERT(!(NK_TEXT_WIDTH_CACHE_SIZE & (NK_TEXT_WIDTH_CACHE_SIZE - 1)));
+NK_STATIC_ASSERT(NK_TEXT_WIDTH_CACHE_SIZE >= NK_TEXT_WIDTH_CACHE_WAYS);
+#endif
 NK_STATIC_ASSERT(sizeof(nk_rune) >= 4);
 NK_STATIC_ASSERT(sizeof(nk_ushort) == 2);
 NK_STATIC_ASSERT(sizeof(nk_short) == 2);
@@ -126,6 +180,7 @@ NK_LIB void* nk_memcopy(void *dst, const void *src, nk_size n);
 #ifndef NK_MEMSET
 NK_LIB void nk_memset(void *ptr, int c0, nk_size size);
 #endif
+NK_LIB void nk_memmove(void *dst, const void *src, nk_size n);
 NK_LIB void nk_zero(void *ptr, nk_size size);
 NK_LIB char *nk_itoa(char *s, long n);
 NK_LIB int nk_string_float_limit(char *string, int prec);
@@ -150,10 +205,26 @@ NK_LIB void* nk_buffer_align(void *unaligned, nk_size align, nk_size *alignment,
 NK_LIB void* nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type, nk_size size, nk_size align);
 NK_LIB void* nk_buffer_realloc(struct nk_buffer *b, nk_size capacity, nk_size *size);
 
+/* string */
+NK_LIB void nk_str_close_gap(struct nk_str *s);
+NK_LIB int nk_str_edit_insert_utf8(struct nk_str*, int pos, const char *text, int len);
+NK_LIB int nk_str_edit_insert_runes(struct nk_str*, int pos, const nk_rune *runes, int len);
+NK_LIB void nk_str_edit_delete_runes(struct nk_str*, int pos, int len);
+
 /* draw */
 NK_LIB void nk_command_buffer_init(struct nk_command_buffer *cb, struct nk_buffer *b, enum nk_command_clipping clip);
 NK_LIB void nk_command_buffer_reset(struct nk_command_buffer *b);
 NK_LIB void* nk_command_buffer_push(struct nk_command_buffer* b, enum nk_command_type t, nk_size size);
+NK_LIB nk_size nk_command_size(const struct nk_command *cmd);
+NK_LIB nk_hash nk_command_hash(const struct nk_command *cmd, nk_hash seed);
+NK_LIB struct nk_rect nk_command_bounds(const struct nk_command *cmd);
+NK_LIB nk_hash nk_command_buffer_digest(const struct nk_command_buffer *b);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_LIB nk_draw_vertex_writer nk_draw_vertex_writer_select(struct nk_draw_list *list);
+#ifdef NK_INCLUDE_FONT_BAKING
+NK_LIB struct nk_font *nk_font_from_user_font(const struct nk_user_font *font);
+#endif
+#endif
 NK_LIB void nk_draw_symbol(struct nk_command_buffer *out, enum nk_symbol_type type, struct nk_rect content, struct nk_color background, struct nk_color foreground, float border_width, const struct nk_user_font *font);
 
 /* buffering */
@@ -179,19 +250,47 @@ enum nk_window_insert_location {
 NK_LIB void *nk_create_window(struct nk_context *ctx);
 NK_LIB void nk_remove_window(struct nk_context*, struct nk_window*);
 NK_LIB void nk_free_window(struct nk_context *ctx, struct nk_window *win);
+NK_LIB struct nk_window_state *nk_window_acquire_state(struct nk_context *ctx, struct nk_window *win);
 NK_LIB struct nk_window *nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name);
 NK_LIB void nk_insert_window(struct nk_context *ctx, struct nk_window *win, enum nk_window_insert_location loc);
+NK_LIB void nk_window_index_clear(struct nk_context *ctx);
+NK_LIB void nk_window_index_free(struct nk_context *ctx);
 
 /* pool */
-NK_LIB void nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc, unsigned int capacity);
+NK_LIB void nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc, unsigned int capacity, nk_size element_size);
 NK_LIB void nk_pool_free(struct nk_pool *pool);
 NK_LIB void nk_pool_init_fixed(struct nk_pool *pool, void *memory, nk_size size);
 NK_LIB struct nk_page_element *nk_pool_alloc(struct nk_pool *pool);
+NK_LIB void nk_pool_free_element(struct nk_pool *pool, struct nk_page_element *elem);
+NK_LIB nk_size nk_pool_trim(struct nk_pool *pool);
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB nk_size nk_pool_memory(const struct nk_pool *pool);
+#endif
 
 /* page-element */
-NK_LIB struct nk_page_element* nk_create_page_element(struct nk_context *ctx);
+/* context */
+NK_LIB struct nk_text_edit *nk_context_text_edit(struct nk_context *ctx);
+
+/* frame arena */
+NK_LIB void nk_frame_arena_init(struct nk_frame_arena *arena, const struct nk_allocator *alloc);
+NK_LIB void nk_frame_arena_flip(struct nk_frame_arena *arena);
+NK_LIB void *nk_frame_arena_alloc(struct nk_frame_arena *arena, nk_size size, nk_size align);
+NK_LIB void nk_frame_arena_free(struct nk_frame_arena *arena);
+
+/* statistics */
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB void nk_stats_end_frame(struct nk_context *ctx);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_LIB void nk_stats_convert_begin(struct nk_context *ctx);
+NK_LIB void nk_stats_convert_command(struct nk_context *ctx, const struct nk_command *cmd);
+NK_LIB void nk_stats_convert_end(struct nk_context *ctx);
+#endif
+#endif
+
+NK_LIB nk_size nk_page_element_size(enum nk_page_element_type type);
+NK_LIB struct nk_page_element* nk_create_page_element(struct nk_context *ctx, enum nk_page_element_type type);
 NK_LIB void nk_link_page_element_into_freelist(struct nk_context *ctx, struct nk_page_element *elem);
-NK_LIB void nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem);
+NK_LIB void nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem, enum nk_page_element_type type);
 
 /* table */
 NK_LIB struct nk_table* nk_create_table(struct nk_context *ctx);
@@ -200,6 +299,8 @@ NK_LIB void nk_free_table(struct nk_context *ctx, struct nk_table *tbl);
 NK_LIB void nk_push_table(struct nk_window *win, struct nk_table *tbl);
 NK_LIB nk_uint *nk_add_value(struct nk_context *ctx, struct nk_window *win, nk_hash name, nk_uint value);
 NK_LIB nk_uint *nk_find_value(struct nk_window *win, nk_hash name);
+NK_LIB void nk_value_index_step(struct nk_context *ctx, struct nk_window *win);
+NK_LIB void nk_value_index_free(struct nk_context *ctx, struct nk_window *win);
 
 /* panel */
 NK_LIB void *nk_create_panel(struct nk_context *ctx);
@@ -231,6 +332,7 @@ struct nk_text {
     struct nk_color background;
     struct nk_color text;
 };
+NK_LIB float nk_text_width(struct nk_command_buffer *o, const struct nk_user_font *f, const char *string, int len);
 NK_LIB void nk_widget_text(struct nk_command_buffer *o, struct nk_rect b, const char *string, int len, const struct nk_text *t, nk_flags a, const struct nk_user_font *f);
 NK_LIB void nk_widget_text_wrap(struct nk_command_buffer *o, struct nk_rect b, const char *string, int len, const struct nk_text *t, const struct nk_user_font *f);
 
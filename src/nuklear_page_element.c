@@ -6,19 +6,46 @@
  *                          PAGE ELEMENT
  *
  * ===============================================================*/
+NK_LIB nk_size
+nk_page_element_size(enum nk_page_element_type type)
+{
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_page_element);
+    nk_size size = (nk_size)NK_OFFSETOF(struct nk_page_element, data);
+    switch (type) {
+    case NK_PAGE_ELEMENT_WINDOW: size += sizeof(struct nk_window); break;
+    case NK_PAGE_ELEMENT_WINDOW_STATE: size += sizeof(struct nk_window_state); break;
+    case NK_PAGE_ELEMENT_PANEL: size += sizeof(struct nk_panel); break;
+    case NK_PAGE_ELEMENT_TABLE: size += sizeof(struct nk_table); break;
+    default: return sizeof(struct nk_page_element);
+    }
+    return (size + (align - 1)) & ~(align - 1);
+}
+NK_INTERN struct nk_pool*
+nk_page_element_pool(struct nk_context *ctx, enum nk_page_element_type type)
+{
+    /* a fixed pool cannot be split so it keeps full sized slots */
+    if (ctx->pool.type == NK_BUFFER_FIXED)
+        return &ctx->pool;
+    switch (type) {
+    case NK_PAGE_ELEMENT_WINDOW_STATE: return &ctx->state_pool;
+    case NK_PAGE_ELEMENT_PANEL: return &ctx->panel_pool;
+    case NK_PAGE_ELEMENT_TABLE: return &ctx->table_pool;
+    default: return &ctx->pool;
+    }
+}
 NK_LIB struct nk_page_element*
-nk_create_page_element(struct nk_context *ctx)
+nk_create_page_element(struct nk_context *ctx, enum nk_page_element_type type)
 {
     struct nk_page_element *elem;
-    if (ctx->freelist) {
+    if (ctx->use_pool) {
+        /* allocate or recycle page element from the pool for this type */
+        elem = nk_pool_alloc(nk_page_element_pool(ctx, type));
+        NK_ASSERT(elem);
+        if (!elem) return 0;
+    } else if (ctx->freelist) {
         /* unlink page element from free list */
         elem = ctx->freelist;
         ctx->freelist = elem->next;
-    } else if (ctx->use_pool) {
-        /* allocate page element from memory pool */
-        elem = nk_pool_alloc(&ctx->pool);
-        NK_ASSERT(elem);
-        if (!elem) return 0;
     } else {
         /* allocate new page element from back of fixed size memory buffer */
         NK_STORAGE const nk_size size = sizeof(struct nk_page_element);
@@ -26,8 +53,11 @@ nk_create_page_element(struct nk_context *ctx)
         elem = (struct nk_page_element*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK, size, align);
         NK_ASSERT(elem);
         if (!elem) return 0;
+        elem->page = 0;
     }
-    nk_zero_struct(*elem);
+    /* slot may be smaller than the union so only clear the stored type */
+    nk_zero(&elem->data, nk_page_element_size(type) -
+        (nk_size)NK_OFFSETOF(struct nk_page_element, data));
     elem->next = 0;
     elem->prev = 0;
     return elem;
@@ -45,11 +75,12 @@ nk_link_page_element_into_freelist(struct nk_context *ctx,
     }
 }
 NK_LIB void
-nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem)
+nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem,
+    enum nk_page_element_type type)
 {
-    /* we have a pool so just add to free list */
+    /* we have a pool so hand the element back for reuse */
     if (ctx->use_pool) {
-        nk_link_page_element_into_freelist(ctx, elem);
+        nk_pool_free_element(nk_page_element_pool(ctx, type), elem);
         return;
     }
     /* if possible remove last element from back of fixed memory buffer */
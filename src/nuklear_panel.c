@@ -10,9 +10,8 @@ NK_LIB void*
 nk_create_panel(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_PANEL);
     if (!elem) return 0;
-    nk_zero_struct(*elem);
     return &elem->data.pan;
 }
 NK_LIB void
@@ -20,7 +19,7 @@ nk_free_panel(struct nk_context *ctx, struct nk_panel *pan)
 {
     union nk_page_data *pd = NK_CONTAINER_OF(pan, union nk_page_data, pan);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_PANEL);
 }
 NK_LIB nk_bool
 nk_panel_has_header(nk_flags flags, const char *title)
@@ -106,6 +105,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         ctx->current->layout->type = panel_type;
         return 0;
     }
+    NK_PROFILE_BEGIN("nk_panel_begin");
     /* pull state into local stack */
     style = &ctx->style;
     font = style->font;
@@ -115,6 +115,12 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
     in = (win->flags & NK_WINDOW_NO_INPUT) ? 0: &ctx->input;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     win->buffer.userdata = ctx->userdata;
+#endif
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    win->buffer.text_cache = &ctx->text_cache;
+#endif
+#ifdef NK_INCLUDE_STATISTICS
+    win->buffer.stats = &ctx->stats_frame;
 #endif
     /* pull style configuration into local stack */
     scrollbar_size = style->window.scrollbar_size;
@@ -281,7 +287,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         {/* window header title */
         int text_len = nk_strlen(title);
         struct nk_rect label = {0,0,0,0};
-        float t = font->width(font->userdata, font->height, title, text_len);
+        float t = nk_text_width(out, font, title, text_len);
         text.padding = nk_vec2(0,0);
 
         label.x = header.x + style->window.header.padding.x;
@@ -321,6 +327,7 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
         layout->clip.x + layout->clip.w, layout->clip.y + layout->clip.h);
     nk_push_scissor(out, clip);
     layout->clip = clip;}
+    NK_PROFILE_END;
     return !(layout->flags & NK_WINDOW_HIDDEN) && !(layout->flags & NK_WINDOW_MINIMIZED);
 }
 NK_LIB void
@@ -587,23 +594,26 @@ nk_panel_end(struct nk_context *ctx)
     }
     window->flags = layout->flags;
 
-    /* property garbage collector */
-    if (window->property.active && window->property.old != window->property.seq &&
-        window->property.active == window->property.prev) {
-        nk_zero(&window->property, sizeof(window->property));
-    } else {
-        window->property.old = window->property.seq;
-        window->property.prev = window->property.active;
-        window->property.seq = 0;
-    }
-    /* edit garbage collector */
-    if (window->edit.active && window->edit.old != window->edit.seq &&
-       window->edit.active == window->edit.prev) {
-        nk_zero(&window->edit, sizeof(window->edit));
-    } else {
-        window->edit.old = window->edit.seq;
-        window->edit.prev = window->edit.active;
-        window->edit.seq = 0;
+    if (window->state) {
+        struct nk_window_state *ws = window->state;
+        /* property garbage collector */
+        if (ws->property.active && ws->property.old != ws->property.seq &&
+            ws->property.active == ws->property.prev) {
+            nk_zero(&ws->property, sizeof(ws->property));
+        } else {
+            ws->property.old = ws->property.seq;
+            ws->property.prev = ws->property.active;
+            ws->property.seq = 0;
+        }
+        /* edit garbage collector */
+        if (ws->edit.active && ws->edit.old != ws->edit.seq &&
+           ws->edit.active == ws->edit.prev) {
+            nk_zero(&ws->edit, sizeof(ws->edit));
+        } else {
+            ws->edit.old = ws->edit.seq;
+            ws->edit.prev = ws->edit.active;
+            ws->edit.seq = 0;
+        }
     }
     /* contextual garbage collector */
     if (window->popup.active_con && window->popup.con_old != window->popup.con_count) {
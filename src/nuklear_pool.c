@@ -6,14 +6,30 @@
  *                              POOL
  *
  * ===============================================================*/
+NK_INTERN nk_size
+nk_pool_page_size(const struct nk_pool *pool)
+{
+    /* slots are `element_size` apart instead of sizeof(struct nk_page_element) */
+    return (nk_size)NK_OFFSETOF(struct nk_page, win) +
+        (nk_size)pool->capacity * pool->element_size;
+}
+NK_INTERN struct nk_page_element*
+nk_pool_page_slot(const struct nk_pool *pool, struct nk_page *page, unsigned int index)
+{
+    return (struct nk_page_element*)(void*)
+        ((nk_byte*)page->win + (nk_size)index * pool->element_size);
+}
 NK_LIB void
 nk_pool_init(struct nk_pool *pool, const struct nk_allocator *alloc,
-    unsigned int capacity)
+    unsigned int capacity, nk_size element_size)
 {
     NK_ASSERT(capacity >= 1);
+    NK_ASSERT(element_size > NK_OFFSETOF(struct nk_page_element, data));
+    NK_ASSERT(element_size <= sizeof(struct nk_page_element));
     nk_zero(pool, sizeof(*pool));
     pool->alloc = *alloc;
     pool->capacity = capacity;
+    pool->element_size = element_size;
     pool->type = NK_BUFFER_DYNAMIC;
     pool->pages = 0;
 }
@@ -38,29 +54,100 @@ nk_pool_init_fixed(struct nk_pool *pool, void *memory, nk_size size)
     if (size < sizeof(struct nk_page)) return;
     /* first nk_page_element is embedded in nk_page, additional elements follow in adjacent space */
     pool->capacity = (unsigned)(1 + (size - sizeof(struct nk_page)) / sizeof(struct nk_page_element));
+    pool->element_size = sizeof(struct nk_page_element);
     pool->pages = (struct nk_page*)memory;
+    pool->pages->size = 0;
+    pool->pages->used = 0;
+    pool->pages->next = 0;
+    pool->page_count = 1;
     pool->type = NK_BUFFER_FIXED;
     pool->size = size;
 }
 NK_LIB struct nk_page_element*
 nk_pool_alloc(struct nk_pool *pool)
 {
-    if (!pool->pages || pool->pages->size >= pool->capacity) {
-        /* allocate new page */
-        struct nk_page *page;
-        if (pool->type == NK_BUFFER_FIXED) {
-            NK_ASSERT(pool->pages);
-            if (!pool->pages) return 0;
-            NK_ASSERT(pool->pages->size < pool->capacity);
-            return 0;
-        } else {
-            nk_size size = sizeof(struct nk_page);
-            size += (pool->capacity - 1) * sizeof(struct nk_page_element);
-            page = (struct nk_page*)pool->alloc.alloc(pool->alloc.userdata,0, size);
+    struct nk_page_element *elem;
+    if (pool->freelist) {
+        /* recycle previously freed element */
+        elem = pool->freelist;
+        pool->freelist = elem->next;
+        pool->free_count--;
+    } else {
+        if (!pool->pages || pool->pages->size >= pool->capacity) {
+            /* allocate new page */
+            struct nk_page *page;
+            if (pool->type == NK_BUFFER_FIXED) {
+                NK_ASSERT(pool->pages);
+                if (!pool->pages) return 0;
+                NK_ASSERT(pool->pages->size < pool->capacity);
+                return 0;
+            }
+            page = (struct nk_page*)pool->alloc.alloc(pool->alloc.userdata,0,
+                nk_pool_page_size(pool));
+            NK_ASSERT(page);
+            if (!page) return 0;
             page->next = pool->pages;
             pool->pages = page;
             page->size = 0;
+            page->used = 0;
+            pool->page_count++;
         }
-    } return &pool->pages->win[pool->pages->size++];
+        elem = nk_pool_page_slot(pool, pool->pages, pool->pages->size++);
+        elem->page = pool->pages;
+    }
+    elem->page->used++;
+    pool->live_count++;
+    if (pool->live_count > pool->peak_count)
+        pool->peak_count = pool->live_count;
+    return elem;
+}
+NK_LIB void
+nk_pool_free_element(struct nk_pool *pool, struct nk_page_element *elem)
+{
+    NK_ASSERT(elem->page && elem->page->used);
+    NK_ASSERT(pool->live_count);
+    elem->page->used--;
+    pool->live_count--;
+    elem->next = pool->freelist;
+    pool->freelist = elem;
+    pool->free_count++;
 }
+NK_LIB nk_size
+nk_pool_trim(struct nk_pool *pool)
+{
+    struct nk_page_element **link;
+    struct nk_page **iter;
+    nk_size freed = 0;
+    if (!pool || pool->type == NK_BUFFER_FIXED || !pool->free_count)
+        return 0;
 
+    /* unlink free elements that live on otherwise empty pages */
+    link = &pool->freelist;
+    while (*link) {
+        struct nk_page_element *elem = *link;
+        if (!elem->page->used) {
+            *link = elem->next;
+            pool->free_count--;
+        } else link = &elem->next;
+    }
+    /* hand empty pages back to the allocator */
+    iter = &pool->pages;
+    while (*iter) {
+        struct nk_page *page = *iter;
+        if (!page->used) {
+            *iter = page->next;
+            pool->alloc.free(pool->alloc.userdata, page);
+            pool->page_count--;
+            freed += nk_pool_page_size(pool);
+        } else iter = &page->next;
+    }
+    return freed;
+}
+
+#ifdef NK_INCLUDE_STATISTICS
+NK_LIB nk_size
+nk_pool_memory(const struct nk_pool *pool)
+{
+    return (nk_size)pool->page_count * nk_pool_page_size(pool);
+}
+#endif
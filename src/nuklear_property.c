@@ -149,7 +149,7 @@ nk_do_property(nk_flags *ws,
     if (name && name[0] != '#') {
         name_len = nk_strlen(name);
     }
-    size = font->width(font->userdata, font->height, name, name_len);
+    size = nk_text_width(out, font, name, name_len);
     label.x = left.x + left.w + style->padding.x;
     label.w = (float)size + 2 * style->padding.x;
     label.y = property.y + style->border + style->padding.y;
@@ -163,7 +163,7 @@ nk_do_property(nk_flags *ws,
 
     /* edit */
     if (*state == NK_PROPERTY_EDIT) {
-        size = font->width(font->userdata, font->height, buffer, *len);
+        size = nk_text_width(out, font, buffer, *len);
         size += style->edit.cursor_size;
         length = len;
         dst = buffer;
@@ -183,7 +183,7 @@ nk_do_property(nk_flags *ws,
             num_len = nk_string_float_limit(string, NK_MAX_FLOAT_PRECISION);
             break;
         }
-        size = font->width(font->userdata, font->height, string, num_len);
+        size = nk_text_width(out, font, string, num_len);
         dst = string;
         length = &num_len;
     }
@@ -254,9 +254,11 @@ nk_do_property(nk_flags *ws,
     text_edit->string.buffer.memory.size = NK_MAX_NUMBER_BUFFER;
     text_edit->string.buffer.memory.ptr = dst;
     text_edit->string.buffer.size = NK_MAX_NUMBER_BUFFER;
+    text_edit->string.gap_size = 0;
     text_edit->mode = NK_TEXT_EDIT_MODE_INSERT;
     nk_do_edit(ws, out, edit, (int)NK_EDIT_FIELD|(int)NK_EDIT_AUTO_SELECT,
         filters[filter], text_edit, &style->edit, (*state == NK_PROPERTY_EDIT) ? in: 0, font);
+    nk_str_close_gap(&text_edit->string);
 
     *length = text_edit->string.len;
     *cursor = text_edit->cursor;
@@ -330,6 +332,7 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
     struct nk_panel *layout;
     struct nk_input *in;
     const struct nk_style *style;
+    struct nk_text_edit *text_edit;
 
     struct nk_rect bounds;
     enum nk_widget_layout_states s;
@@ -361,21 +364,24 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
     style = &ctx->style;
     s = nk_widget(&bounds, ctx);
     if (!s) return;
+    if (!nk_window_acquire_state(ctx, win)) return;
+    text_edit = nk_context_text_edit(ctx);
+    if (!text_edit) return;
 
     /* calculate hash from name */
     if (name[0] == '#') {
-        hash = nk_murmur_hash(name, (int)nk_strlen(name), win->property.seq++);
+        hash = nk_murmur_hash(name, (int)nk_strlen(name), win->state->property.seq++);
         name++; /* special number hash */
     } else hash = nk_murmur_hash(name, (int)nk_strlen(name), 42);
 
     /* check if property is currently hot item */
-    if (win->property.active && hash == win->property.name) {
-        buffer = win->property.buffer;
-        len = &win->property.length;
-        cursor = &win->property.cursor;
-        state = &win->property.state;
-        select_begin = &win->property.select_start;
-        select_end = &win->property.select_end;
+    if (win->state->property.active && hash == win->state->property.name) {
+        buffer = win->state->property.buffer;
+        len = &win->state->property.length;
+        cursor = &win->state->property.cursor;
+        state = &win->state->property.state;
+        select_begin = &win->state->property.select_start;
+        select_end = &win->state->property.select_end;
     } else {
         buffer = dummy_buffer;
         len = &dummy_length;
@@ -387,24 +393,24 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
 
     /* execute property widget */
     old_state = *state;
-    ctx->text_edit.clip = ctx->clip;
-    in = ((s == NK_WIDGET_ROM && !win->property.active) ||
+    text_edit->clip = ctx->clip;
+    in = ((s == NK_WIDGET_ROM && !win->state->property.active) ||
         layout->flags & NK_WINDOW_ROM || s == NK_WIDGET_DISABLED) ? 0 : &ctx->input;
     nk_do_property(&ctx->last_widget_state, &win->buffer, bounds, name,
         variant, inc_per_pixel, buffer, len, state, cursor, select_begin,
-        select_end, &style->property, filter, in, style->font, &ctx->text_edit,
+        select_end, &style->property, filter, in, style->font, text_edit,
         ctx->button_behavior);
 
-    if (in && *state != NK_PROPERTY_DEFAULT && !win->property.active) {
+    if (in && *state != NK_PROPERTY_DEFAULT && !win->state->property.active) {
         /* current property is now hot */
-        win->property.active = 1;
-        NK_MEMCPY(win->property.buffer, buffer, (nk_size)*len);
-        win->property.length = *len;
-        win->property.cursor = *cursor;
-        win->property.state = *state;
-        win->property.name = hash;
-        win->property.select_start = *select_begin;
-        win->property.select_end = *select_end;
+        win->state->property.active = 1;
+        NK_MEMCPY(win->state->property.buffer, buffer, (nk_size)*len);
+        win->state->property.length = *len;
+        win->state->property.cursor = *cursor;
+        win->state->property.state = *state;
+        win->state->property.name = hash;
+        win->state->property.select_start = *select_begin;
+        win->state->property.select_end = *select_end;
         if (*state == NK_PROPERTY_DRAG) {
             ctx->input.mouse.grab = nk_true;
             ctx->input.mouse.grabbed = nk_true;
@@ -417,9 +423,9 @@ nk_property(struct nk_context *ctx, const char *name, struct nk_property_variant
             ctx->input.mouse.grabbed = nk_false;
             ctx->input.mouse.ungrab = nk_true;
         }
-        win->property.select_start = 0;
-        win->property.select_end = 0;
-        win->property.active = 0;
+        win->state->property.select_start = 0;
+        win->state->property.select_end = 0;
+        win->state->property.active = 0;
     }
 }
 NK_API void
@@ -0,0 +1,240 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          STATISTICS
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_STATISTICS
+NK_INTERN struct nk_window_stats*
+nk_stats_window_entry(struct nk_stats *stats, const struct nk_window *win)
+{
+    struct nk_window_stats *entry;
+    unsigned int i;
+    for (i = 0; i < stats->window_count; ++i) {
+        if (stats->windows[i].hash == win->name)
+            return &stats->windows[i];
+    }
+    if (stats->window_count >= NK_STATS_MAX_WINDOWS)
+        return 0;
+    entry = &stats->windows[stats->window_count++];
+    NK_MEMCPY(entry->name, win->name_string, sizeof(entry->name));
+    entry->name[NK_WINDOW_MAX_NAME-1] = 0;
+    entry->hash = win->name;
+    return entry;
+}
+NK_INTERN void
+nk_stats_pool(struct nk_stats *stats, const struct nk_pool *pool)
+{
+    stats->pool_pages += pool->page_count;
+    stats->pool_live += pool->live_count;
+    stats->pool_free += pool->free_count;
+    stats->pool_peak += pool->peak_count;
+    stats->pool_memory += nk_pool_memory(pool);
+}
+NK_INTERN void
+nk_stats_value_lookups(struct nk_stats *stats, struct nk_window *win)
+{
+    stats->value_lookups += win->value_lookups;
+    stats->value_probes += win->value_probes;
+    win->value_lookups = 0;
+    win->value_probes = 0;
+}
+NK_LIB void
+nk_stats_end_frame(struct nk_context *ctx)
+{
+    struct nk_stats *stats = &ctx->stats_frame;
+    struct nk_window *iter;
+    nk_size command_peak;
+    unsigned int vertex_peak, element_peak;
+    unsigned int i;
+
+    /* command memory of every window drawn this frame */
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        struct nk_window_stats *entry;
+        nk_stats_value_lookups(stats, iter);
+        if (iter->popup.win)
+            nk_stats_value_lookups(stats, iter->popup.win);
+        if (iter->buffer.end == iter->buffer.begin ||
+            (iter->flags & NK_WINDOW_HIDDEN) || iter->seq != ctx->seq)
+            continue;
+        entry = nk_stats_window_entry(stats, iter);
+        if (entry) entry->command_bytes = iter->buffer.end - iter->buffer.begin;
+    }
+    for (i = 0; i < NK_LEN(stats->commands); ++i)
+        stats->command_count += stats->commands[i];
+    stats->command_memory = ctx->memory.allocated;
+    stats->command_needed = ctx->memory.needed;
+    stats->command_capacity = ctx->memory.memory.size;
+    stats->command_peak = NK_MAX(stats->command_peak, ctx->memory.needed);
+
+    /* unused pools are zeroed, a fixed pool holds every element in `ctx->pool` */
+    nk_stats_pool(stats, &ctx->pool);
+    nk_stats_pool(stats, &ctx->state_pool);
+    nk_stats_pool(stats, &ctx->panel_pool);
+    nk_stats_pool(stats, &ctx->table_pool);
+    stats->frame_memory = ctx->frame.used;
+    stats->frame_peak = ctx->frame.peak;
+
+    /* publish and start over, keeping peak values */
+    ctx->stats = *stats;
+    command_peak = stats->command_peak;
+    vertex_peak = stats->vertex_peak;
+    element_peak = stats->element_peak;
+    nk_zero(stats, sizeof(*stats));
+    stats->command_peak = command_peak;
+    stats->vertex_peak = vertex_peak;
+    stats->element_peak = element_peak;
+}
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_INTERN void
+nk_stats_convert_flush(struct nk_context *ctx)
+{
+    const struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_window_stats *entry;
+    if (!ctx->stats_owner) return;
+    entry = nk_stats_window_entry(&ctx->stats_frame, ctx->stats_owner);
+    if (!entry) return;
+    entry->vertices += list->vertex_count - ctx->stats_vertex_begin;
+    entry->elements += list->element_count - ctx->stats_element_begin;
+}
+NK_LIB void
+nk_stats_convert_begin(struct nk_context *ctx)
+{
+    unsigned int i;
+    for (i = 0; i < ctx->stats_frame.window_count; ++i) {
+        ctx->stats_frame.windows[i].vertices = 0;
+        ctx->stats_frame.windows[i].elements = 0;
+    }
+    ctx->stats_owner = 0;
+}
+NK_LIB void
+nk_stats_convert_command(struct nk_context *ctx, const struct nk_command *cmd)
+{
+    /* popups draw into their parent window's command memory and the
+     * overlay is not owned by any window */
+    const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+    struct nk_window *win = ctx->stats_owner;
+    if (win && offset >= win->buffer.begin && offset < win->buffer.end)
+        return;
+
+    nk_stats_convert_flush(ctx);
+    for (win = ctx->begin; win; win = win->next) {
+        if (win->seq == ctx->seq && offset >= win->buffer.begin &&
+            offset < win->buffer.end) break;
+    }
+    ctx->stats_owner = win;
+    ctx->stats_vertex_begin = ctx->draw_list.vertex_count;
+    ctx->stats_element_begin = ctx->draw_list.element_count;
+}
+NK_LIB void
+nk_stats_convert_end(struct nk_context *ctx)
+{
+    const struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_stats *stats = &ctx->stats_frame;
+    nk_stats_convert_flush(ctx);
+    ctx->stats_owner = 0;
+    stats->vertices = list->vertex_count;
+    stats->elements = list->element_count;
+    stats->draw_commands = list->cmd_count;
+    stats->vertex_peak = NK_MAX(stats->vertex_peak, list->vertex_count);
+    stats->element_peak = NK_MAX(stats->element_peak, list->element_count);
+}
+#endif
+NK_API const struct nk_stats*
+nk_statistics(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    return &ctx->stats;
+}
+NK_INTERN void
+nk_statistics_number(struct nk_context *ctx, nk_size value)
+{
+    char number[NK_MAX_NUMBER_BUFFER];
+    nk_itoa(number, (long)value);
+    nk_label(ctx, number, NK_TEXT_RIGHT);
+}
+NK_INTERN void
+nk_statistics_row(struct nk_context *ctx, const char *label, nk_size value)
+{
+    nk_label(ctx, label, NK_TEXT_LEFT);
+    nk_statistics_number(ctx, value);
+}
+NK_API nk_bool
+nk_statistics_window(struct nk_context *ctx, const char *title,
+    struct nk_rect bounds, nk_flags flags)
+{
+    NK_STORAGE const char *command_names[] = {
+        "nop", "scissor", "line", "curve", "rect", "rect filled",
+        "rect multi color", "circle", "circle filled", "arc", "arc filled",
+        "triangle", "triangle filled", "polygon", "polygon filled",
+        "polyline", "text", "image", "custom"
+    };
+    const struct nk_stats *stats;
+    nk_bool open;
+    unsigned int i;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(title);
+    if (!ctx || !title) return 0;
+
+    stats = &ctx->stats;
+    open = nk_begin(ctx, title, bounds, flags);
+    if (open) {
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Commands", NK_MAXIMIZED, title, nk_strlen(title), 0)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "total", stats->command_count);
+            for (i = 0; i < NK_LEN(stats->commands); ++i) {
+                if (stats->commands[i])
+                    nk_statistics_row(ctx, command_names[i], stats->commands[i]);
+            }
+            nk_statistics_row(ctx, "memory", stats->command_memory);
+            nk_statistics_row(ctx, "needed", stats->command_needed);
+            nk_statistics_row(ctx, "capacity", stats->command_capacity);
+            nk_statistics_row(ctx, "peak", stats->command_peak);
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Windows", NK_MAXIMIZED, title, nk_strlen(title), 1)) {
+            nk_layout_row_dynamic(ctx, 0, 4);
+            nk_label(ctx, "name", NK_TEXT_LEFT);
+            nk_label(ctx, "bytes", NK_TEXT_RIGHT);
+            nk_label(ctx, "vertices", NK_TEXT_RIGHT);
+            nk_label(ctx, "indices", NK_TEXT_RIGHT);
+            for (i = 0; i < stats->window_count; ++i) {
+                const struct nk_window_stats *win = &stats->windows[i];
+                nk_label(ctx, win->name, NK_TEXT_LEFT);
+                nk_statistics_number(ctx, win->command_bytes);
+                nk_statistics_number(ctx, win->vertices);
+                nk_statistics_number(ctx, win->elements);
+            }
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Memory", NK_MINIMIZED, title, nk_strlen(title), 2)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "pool pages", stats->pool_pages);
+            nk_statistics_row(ctx, "pool elements", stats->pool_live);
+            nk_statistics_row(ctx, "pool free", stats->pool_free);
+            nk_statistics_row(ctx, "pool peak", stats->pool_peak);
+            nk_statistics_row(ctx, "pool memory", stats->pool_memory);
+            nk_statistics_row(ctx, "frame arena", stats->frame_memory);
+            nk_statistics_row(ctx, "frame arena peak", stats->frame_peak);
+            nk_statistics_row(ctx, "value lookups", stats->value_lookups);
+            nk_statistics_row(ctx, "value probes", stats->value_probes);
+            nk_tree_pop(ctx);
+        }
+        if (nk_tree_push_hashed(ctx, NK_TREE_TAB, "Vertex output", NK_MINIMIZED, title, nk_strlen(title), 3)) {
+            nk_layout_row_dynamic(ctx, 0, 2);
+            nk_statistics_row(ctx, "vertices", stats->vertices);
+            nk_statistics_row(ctx, "indices", stats->elements);
+            nk_statistics_row(ctx, "draw commands", stats->draw_commands);
+            nk_statistics_row(ctx, "vertex peak", stats->vertex_peak);
+            nk_statistics_row(ctx, "index peak", stats->element_peak);
+            nk_tree_pop(ctx);
+        }
+    }
+    nk_end(ctx);
+    return open;
+}
+#endif
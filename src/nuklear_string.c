@@ -16,6 +16,12 @@ nk_str_init_default(struct nk_str *str)
     alloc.free = nk_mfree;
     nk_buffer_init(&str->buffer, &alloc, 32);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 #endif
 
@@ -24,12 +30,267 @@ nk_str_init(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
 {
     nk_buffer_init(&str->buffer, alloc, size);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 NK_API void
 nk_str_init_fixed(struct nk_str *str, void *memory, nk_size size)
 {
     nk_buffer_init_fixed(&str->buffer, memory, size);
     str->len = 0;
+    str->gap_begin = str->gap_size = 0;
+    str->gap_rune = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
+}
+NK_INTERN nk_size
+nk_str_physical(const struct nk_str *s, nk_size offset)
+{
+    /* text offsets behind the gap are stored `gap_size` bytes further */
+    return (s->gap_size && offset >= s->gap_begin) ? offset + s->gap_size: offset;
+}
+NK_INTERN nk_size
+nk_str_physical_end(const struct nk_str *s, nk_size offset)
+{
+    /* like `nk_str_physical` but for the end of a range */
+    return (s->gap_size && offset > s->gap_begin) ? offset + s->gap_size: offset;
+}
+NK_INTERN nk_size
+nk_str_logical(const struct nk_str *s, nk_size offset)
+{
+    return (s->gap_size && offset >= s->gap_begin + s->gap_size) ? offset - s->gap_size: offset;
+}
+NK_INTERN void
+nk_str_changed(struct nk_str *s, nk_size offset, nk_size removed, nk_size inserted)
+{
+    /* grows the changed range by text `[offset, offset + removed)` which
+     * has been replaced with `inserted` bytes */
+    if (s->changed_end == NK_SIZE_MAX) return;
+    if (s->changed_begin > s->changed_end) {
+        s->changed_begin = offset;
+        s->changed_end = offset + inserted;
+        return;
+    }
+    if (s->changed_end >= offset + removed)
+        s->changed_end = s->changed_end - removed + inserted;
+    else s->changed_end = offset + inserted;
+    s->changed_begin = NK_MIN(s->changed_begin, offset);
+}
+NK_INTERN int
+nk_str_checkpoint_after_rune(const struct nk_str *s, int rune)
+{
+    /* index of the first checkpoint behind `rune` */
+    int lo = 0, hi = s->checkpoint_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (s->checkpoints[mid].rune <= rune)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+NK_INTERN int
+nk_str_checkpoint_after_offset(const struct nk_str *s, nk_size offset)
+{
+    int lo = 0, hi = s->checkpoint_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (s->checkpoints[mid].offset <= offset)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+NK_INTERN void
+nk_str_add_checkpoint(struct nk_str *s, int index, int rune, nk_size offset)
+{
+    struct nk_str_checkpoint *cp;
+    if (!NK_STR_CHECKPOINT_STRIDE || s->buffer.type != NK_BUFFER_DYNAMIC ||
+        !s->buffer.pool.alloc || !s->buffer.pool.free) return;
+
+    if (s->checkpoint_count >= s->checkpoint_capacity) {
+        struct nk_str_checkpoint *temp;
+        int capacity = NK_MAX(16, s->checkpoint_capacity * 2);
+        temp = (struct nk_str_checkpoint*)s->buffer.pool.alloc(s->buffer.pool.userdata,
+            s->checkpoints, (nk_size)capacity * sizeof(*temp));
+        if (!temp) return;
+        if (temp != s->checkpoints && s->checkpoints) {
+            NK_MEMCPY(temp, s->checkpoints, (nk_size)s->checkpoint_count * sizeof(*temp));
+            s->buffer.pool.free(s->buffer.pool.userdata, s->checkpoints);
+        }
+        s->checkpoints = temp;
+        s->checkpoint_capacity = capacity;
+    }
+    cp = s->checkpoints + index;
+    nk_memmove(cp + 1, cp, (nk_size)(s->checkpoint_count - index) * sizeof(*cp));
+    cp->rune = rune;
+    cp->offset = offset;
+    s->checkpoint_count++;
+}
+NK_INTERN void
+nk_str_checkpoints_insert(struct nk_str *s, nk_size offset, nk_size len, int runes)
+{
+    /* checkpoints at `offset` still point at the same rune index */
+    int i = nk_str_checkpoint_after_offset(s, offset);
+    for (; i < s->checkpoint_count; ++i) {
+        s->checkpoints[i].rune += runes;
+        s->checkpoints[i].offset += len;
+    }
+}
+NK_INTERN void
+nk_str_checkpoints_delete(struct nk_str *s, nk_size offset, nk_size len, int runes)
+{
+    /* drops checkpoints inside the deleted text and moves the rest */
+    const int begin = nk_str_checkpoint_after_offset(s, offset);
+    const int end = nk_str_checkpoint_after_offset(s, offset + len);
+    int i;
+    nk_memmove(s->checkpoints + begin, s->checkpoints + end,
+        (nk_size)(s->checkpoint_count - end) * sizeof(*s->checkpoints));
+    s->checkpoint_count -= end - begin;
+    for (i = begin; i < s->checkpoint_count; ++i) {
+        s->checkpoints[i].rune -= runes;
+        s->checkpoints[i].offset -= len;
+    }
+}
+NK_INTERN nk_size
+nk_str_seek_rune(const struct nk_str *s, int pos, struct nk_str *record)
+{
+    /* returns the text offset of rune `pos` by decoding forward from the
+     * closest checkpoint or the gap. If `record` is set a checkpoint is
+     * remembered every NK_STR_CHECKPOINT_STRIDE runes on the way, so const
+     * lookups pass null and never allocate. Runes never straddle the gap. */
+    const char *text = (const char*)s->buffer.memory.ptr;
+    nk_size offset = 0, end = s->buffer.allocated;
+    int index, i, last = 0;
+    nk_rune unicode;
+
+    index = nk_str_checkpoint_after_rune(s, pos);
+    if (index > 0) {
+        last = s->checkpoints[index-1].rune;
+        offset = s->checkpoints[index-1].offset;
+    }
+    if (s->gap_size && s->gap_rune <= pos && s->gap_rune >= last) {
+        last = s->gap_rune;
+        offset = s->gap_begin;
+    }
+    if (last == pos) return offset;
+
+    if (index < s->checkpoint_count)
+        end = nk_str_physical_end(s, s->checkpoints[index].offset);
+    if (s->gap_size && s->gap_rune > pos)
+        end = NK_MIN(end, s->gap_begin);
+    offset = nk_str_physical(s, offset);
+    for (i = last; i < pos && offset < end; ++i) {
+        int glyph_len = nk_utf_decode(text + offset, &unicode, (int)(end - offset));
+        if (!glyph_len) break;
+        offset += (nk_size)glyph_len;
+        if (record && i + 1 - last == NK_STR_CHECKPOINT_STRIDE && i + 1 < s->len) {
+            nk_str_add_checkpoint(record, index++, i + 1, nk_str_logical(s, offset));
+            last = i + 1;
+        }
+    }
+    return nk_str_logical(s, offset);
+}
+NK_INTERN nk_size
+nk_str_find_rune(struct nk_str *s, int pos)
+{
+    return nk_str_seek_rune(s, pos, s);
+}
+NK_INTERN int
+nk_str_rune_index(const struct nk_str *s, nk_size offset)
+{
+    /* rune index of a text offset, counted from the closest checkpoint or the gap */
+    const char *text = (const char*)s->buffer.memory.ptr;
+    const int index = nk_str_checkpoint_after_offset(s, offset);
+    nk_size begin = 0;
+    int rune = 0;
+
+    if (index > 0) {
+        rune = s->checkpoints[index-1].rune;
+        begin = s->checkpoints[index-1].offset;
+    }
+    if (s->gap_size && s->gap_begin <= offset && s->gap_begin >= begin) {
+        rune = s->gap_rune;
+        begin = s->gap_begin;
+    }
+    return rune + nk_utf_len(text + nk_str_physical(s, begin), (int)(offset - begin));
+}
+NK_INTERN int
+nk_str_open_gap(struct nk_str *s, nk_size pos, int rune, nk_size size)
+{
+    /* moves the gap to text offset `pos` and makes it at least `size` bytes */
+    char *text = (char*)s->buffer.memory.ptr;
+    if (!s->gap_size) {
+        s->gap_begin = pos;
+    } else if (pos < s->gap_begin) {
+        nk_memmove(text + pos + s->gap_size, text + pos, s->gap_begin - pos);
+    } else if (pos > s->gap_begin) {
+        nk_memmove(text + s->gap_begin, text + s->gap_begin + s->gap_size, pos - s->gap_begin);
+    }
+    s->gap_begin = pos;
+    s->gap_rune = rune;
+
+    if (s->gap_size < size) {
+        /* grow in proportion to the text so moving the tail stays amortized */
+        const nk_size tail = s->buffer.allocated - (s->gap_begin + s->gap_size);
+        nk_size grow = size - s->gap_size;
+        if (s->buffer.type != NK_BUFFER_FIXED)
+            grow += NK_MAX(NK_STR_GAP_SIZE, s->buffer.allocated / 16);
+        if (!nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, grow, 0))
+            return 0;
+        text = (char*)s->buffer.memory.ptr;
+        nk_memmove(text + s->gap_begin + s->gap_size + grow,
+            text + s->gap_begin + s->gap_size, tail);
+        s->gap_size += grow;
+    }
+    return 1;
+}
+NK_LIB void
+nk_str_close_gap(struct nk_str *s)
+{
+    char *text;
+    nk_size gap_end;
+    if (!s->gap_size) return;
+    text = (char*)s->buffer.memory.ptr;
+    gap_end = s->gap_begin + s->gap_size;
+    nk_memmove(text + s->gap_begin, text + gap_end, s->buffer.allocated - gap_end);
+    s->buffer.allocated -= s->gap_size;
+    s->gap_size = 0;
+}
+NK_INTERN int
+nk_str_insert_at(struct nk_str *s, nk_size pos, int rune, const char *str, int len)
+{
+    int runes;
+    if ((s->buffer.allocated - s->gap_size + (nk_size)len >= s->buffer.memory.size) &&
+        (s->buffer.type == NK_BUFFER_FIXED)) return 0;
+    if (!nk_str_open_gap(s, pos, rune, (nk_size)len))
+        return 0;
+
+    NK_MEMCPY(nk_ptr_add(char, s->buffer.memory.ptr, s->gap_begin), str, (nk_size)len);
+    runes = nk_utf_len(str, len);
+    s->gap_begin += (nk_size)len;
+    s->gap_size -= (nk_size)len;
+    s->gap_rune += runes;
+    s->len += runes;
+    nk_str_checkpoints_insert(s, pos, (nk_size)len, runes);
+    nk_str_changed(s, pos, 0, (nk_size)len);
+    return 1;
+}
+NK_INTERN void
+nk_str_delete_at(struct nk_str *s, nk_size pos, int rune, nk_size len, int runes)
+{
+    /* deleted bytes simply become part of the gap */
+    nk_str_open_gap(s, pos, rune, 0);
+    s->gap_size += len;
+    s->len -= runes;
+    nk_str_checkpoints_delete(s, pos, len, runes);
+    nk_str_changed(s, pos, len, 0);
 }
 NK_API int
 nk_str_append_text_char(struct nk_str *s, const char *str, int len)
@@ -42,6 +303,7 @@ nk_str_append_text_char(struct nk_str *s, const char *str, int len)
     if (!mem) return 0;
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len += nk_utf_len(str, len);
+    nk_str_changed(s, s->buffer.allocated - s->gap_size - (nk_size)len, 0, (nk_size)len);
     return len;
 }
 NK_API int
@@ -113,56 +375,33 @@ nk_str_append_str_runes(struct nk_str *str, const nk_rune *runes)
 NK_API int
 nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
 {
-    int i;
-    void *mem;
-    char *src;
-    char *dst;
-
-    int copylen;
+    int result;
     NK_ASSERT(s);
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
-    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated) return 0;
-    if ((s->buffer.allocated + (nk_size)len >= s->buffer.memory.size) &&
-        (s->buffer.type == NK_BUFFER_FIXED)) return 0;
-
-    copylen = (int)s->buffer.allocated - pos;
-    if (!copylen) {
-        nk_str_append_text_char(s, str, len);
-        return 1;
-    }
-    mem = nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
-    if (!mem) return 0;
-
-    /* memmove */
-    NK_ASSERT(((int)pos + (int)len + ((int)copylen - 1)) >= 0);
-    NK_ASSERT(((int)pos + ((int)copylen - 1)) >= 0);
-    dst = nk_ptr_add(char, s->buffer.memory.ptr, pos + len + (copylen - 1));
-    src = nk_ptr_add(char, s->buffer.memory.ptr, pos + (copylen-1));
-    for (i = 0; i < copylen; ++i) *dst-- = *src--;
-    mem = nk_ptr_add(void, s->buffer.memory.ptr, pos);
-    NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
-    s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
-    return 1;
+    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated - s->gap_size) return 0;
+    result = nk_str_insert_at(s, (nk_size)pos, nk_str_rune_index(s, (nk_size)pos), str, len);
+    nk_str_close_gap(s);
+    return result;
+}
+NK_INTERN int
+nk_str_edit_insert_at(struct nk_str *str, int pos, const char *cstr, int len)
+{
+    if (!str || !cstr || !len || pos < 0 || pos > str->len) return 0;
+    if (!str->len)
+        return nk_str_append_text_char(str, cstr, len);
+    return nk_str_insert_at(str, nk_str_find_rune(str, pos), pos, cstr, len);
 }
 NK_API int
 nk_str_insert_at_rune(struct nk_str *str, int pos, const char *cstr, int len)
 {
-    int glyph_len;
-    nk_rune unicode;
-    const char *begin;
-    const char *buffer;
-
+    int result;
     NK_ASSERT(str);
     NK_ASSERT(cstr);
     NK_ASSERT(len);
-    if (!str || !cstr || !len) return 0;
-    begin = nk_str_at_rune(str, pos, &unicode, &glyph_len);
-    if (!str->len)
-        return nk_str_append_text_char(str, cstr, len);
-    buffer = nk_str_get_const(str);
-    if (!begin) return 0;
-    return nk_str_insert_at_char(str, (int)(begin - buffer), cstr, len);
+    result = nk_str_edit_insert_at(str, pos, cstr, len);
+    if (str) nk_str_close_gap(str);
+    return result;
 }
 NK_API int
 nk_str_insert_text_char(struct nk_str *str, int pos, const char *text, int len)
@@ -174,19 +413,25 @@ nk_str_insert_str_char(struct nk_str *str, int pos, const char *text)
 {
     return nk_str_insert_text_utf8(str, pos, text, nk_strlen(text));
 }
-NK_API int
-nk_str_insert_text_utf8(struct nk_str *str, int pos, const char *text, int len)
+NK_LIB int
+nk_str_edit_insert_utf8(struct nk_str *str, int pos, const char *text, int len)
 {
     int i = 0;
     int byte_len = 0;
     nk_rune unicode;
-
-    NK_ASSERT(str);
-    NK_ASSERT(text);
     if (!str || !text || !len) return 0;
     for (i = 0; i < len; ++i)
         byte_len += nk_utf_decode(text+byte_len, &unicode, 4);
-    nk_str_insert_at_rune(str, pos, text, byte_len);
+    nk_str_edit_insert_at(str, pos, text, byte_len);
+    return len;
+}
+NK_API int
+nk_str_insert_text_utf8(struct nk_str *str, int pos, const char *text, int len)
+{
+    NK_ASSERT(str);
+    NK_ASSERT(text);
+    len = nk_str_edit_insert_utf8(str, pos, text, len);
+    if (str) nk_str_close_gap(str);
     return len;
 }
 NK_API int
@@ -207,23 +452,29 @@ nk_str_insert_str_utf8(struct nk_str *str, int pos, const char *text)
     nk_str_insert_at_rune(str, pos, text, byte_len);
     return num_runes;
 }
-NK_API int
-nk_str_insert_text_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
+NK_LIB int
+nk_str_edit_insert_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
 {
     int i = 0;
     int byte_len = 0;
     nk_glyph glyph;
-
-    NK_ASSERT(str);
     if (!str || !runes || !len) return 0;
     for (i = 0; i < len; ++i) {
         byte_len = nk_utf_encode(runes[i], glyph, NK_UTF_SIZE);
         if (!byte_len) break;
-        nk_str_insert_at_rune(str, pos+i, glyph, byte_len);
+        nk_str_edit_insert_at(str, pos+i, glyph, byte_len);
     }
     return len;
 }
 NK_API int
+nk_str_insert_text_runes(struct nk_str *str, int pos, const nk_rune *runes, int len)
+{
+    NK_ASSERT(str);
+    len = nk_str_edit_insert_runes(str, pos, runes, len);
+    if (str) nk_str_close_gap(str);
+    return len;
+}
+NK_API int
 nk_str_insert_str_runes(struct nk_str *str, int pos, const nk_rune *runes)
 {
     int i = 0;
@@ -243,10 +494,14 @@ nk_str_remove_chars(struct nk_str *s, int len)
 {
     NK_ASSERT(s);
     NK_ASSERT(len >= 0);
-    if (!s || len < 0 || (nk_size)len > s->buffer.allocated) return;
+    if (!s || len < 0) return;
+    nk_str_close_gap(s);
+    if ((nk_size)len > s->buffer.allocated) return;
     NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
     s->buffer.allocated -= (nk_size)len;
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_changed(s, s->buffer.allocated, (nk_size)len, 0);
+    s->checkpoint_count = nk_str_checkpoint_after_offset(s, s->buffer.allocated);
 }
 NK_API void
 nk_str_remove_runes(struct nk_str *str, int len)
@@ -272,59 +527,56 @@ nk_str_remove_runes(struct nk_str *str, int len)
 NK_API void
 nk_str_delete_chars(struct nk_str *s, int pos, int len)
 {
+    nk_size text_len;
+    int rune;
     NK_ASSERT(s);
-    if (!s || !len || (nk_size)pos > s->buffer.allocated ||
-        (nk_size)(pos + len) > s->buffer.allocated) return;
+    if (!s || !len) return;
+    text_len = s->buffer.allocated - s->gap_size;
+    if ((nk_size)pos > text_len || (nk_size)(pos + len) > text_len) return;
 
-    if ((nk_size)(pos + len) < s->buffer.allocated) {
-        /* memmove */
-        char *dst = nk_ptr_add(char, s->buffer.memory.ptr, pos);
-        char *src = nk_ptr_add(char, s->buffer.memory.ptr, pos + len);
-        NK_MEMCPY(dst, src, s->buffer.allocated - (nk_size)(pos + len));
-        NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
-        s->buffer.allocated -= (nk_size)len;
-    } else nk_str_remove_chars(s, len);
-    s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    rune = nk_str_rune_index(s, (nk_size)pos);
+    nk_str_delete_at(s, (nk_size)pos, rune, (nk_size)len,
+        nk_str_rune_index(s, (nk_size)(pos + len)) - rune);
+    nk_str_close_gap(s);
 }
-NK_API void
-nk_str_delete_runes(struct nk_str *s, int pos, int len)
+NK_LIB void
+nk_str_edit_delete_runes(struct nk_str *s, int pos, int len)
 {
-    char *temp;
-    nk_rune unicode;
-    char *begin;
-    char *end;
-    int unused;
+    nk_size begin;
+    nk_size end;
 
-    NK_ASSERT(s);
     NK_ASSERT(s->len >= pos + len);
     if (s->len < pos + len)
         len = NK_CLAMP(0, (s->len - pos), s->len);
-    if (!len) return;
+    if (!len || pos < 0) return;
 
-    temp = (char *)s->buffer.memory.ptr;
-    begin = nk_str_at_rune(s, pos, &unicode, &unused);
-    if (!begin) return;
-    s->buffer.memory.ptr = begin;
-    end = nk_str_at_rune(s, len, &unicode, &unused);
-    s->buffer.memory.ptr = temp;
-    if (!end) return;
-    nk_str_delete_chars(s, (int)(begin - temp), (int)(end - begin));
+    begin = nk_str_find_rune(s, pos);
+    end = nk_str_find_rune(s, pos + len);
+    nk_str_delete_at(s, begin, pos, end - begin, len);
+}
+NK_API void
+nk_str_delete_runes(struct nk_str *s, int pos, int len)
+{
+    NK_ASSERT(s);
+    if (!s) return;
+    nk_str_edit_delete_runes(s, pos, len);
+    nk_str_close_gap(s);
 }
 NK_API char*
 nk_str_at_char(struct nk_str *s, int pos)
 {
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
+    if (!s) return 0;
+    nk_str_close_gap(s);
+    if (pos > (int)s->buffer.allocated) return 0;
     return nk_ptr_add(char, s->buffer.memory.ptr, pos);
 }
 NK_API char*
 nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
+    nk_size offset;
+    int glyph_len;
     char *text;
-    int text_len;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -337,37 +589,29 @@ nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    nk_str_close_gap(str);
+    if (pos > str->len) return 0;
+    offset = nk_str_find_rune(str, pos);
+    text = (char*)str->buffer.memory.ptr + offset;
+    glyph_len = nk_utf_decode(text, unicode, (int)(str->buffer.allocated - offset));
+    if (glyph_len) *len = glyph_len;
+    return text;
 }
 NK_API const char*
 nk_str_at_char_const(const struct nk_str *s, int pos)
 {
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
-    return nk_ptr_add(char, s->buffer.memory.ptr, pos);
+    if (!s) return 0;
+    /* only the text editor sees an open gap and it never reads past it */
+    if (pos > (int)(s->buffer.allocated - s->gap_size)) return 0;
+    return nk_ptr_add_const(char, s->buffer.memory.ptr, nk_str_physical(s, (nk_size)pos));
 }
 NK_API const char*
 nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
+    nk_size offset;
+    int glyph_len;
     char *text;
-    int text_len;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -380,28 +624,24 @@ nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    if (pos > str->len) return 0;
+    offset = nk_str_physical(str, nk_str_seek_rune(str, pos, 0));
+    text = (char*)str->buffer.memory.ptr + offset;
+    glyph_len = nk_utf_decode(text, unicode, (int)(str->buffer.allocated - offset));
+    if (glyph_len) *len = glyph_len;
+    return text;
 }
 NK_API nk_rune
 nk_str_rune_at(const struct nk_str *str, int pos)
 {
-    int len;
+    /* reads around the gap the text editor keeps open during an edit */
+    nk_size offset;
     nk_rune unicode = 0;
-    nk_str_at_const(str, pos, &unicode, &len);
+    NK_ASSERT(str);
+    if (!str || pos < 0 || pos >= str->len) return 0;
+    offset = nk_str_physical(str, nk_str_seek_rune(str, pos, 0));
+    nk_utf_decode((const char*)str->buffer.memory.ptr + offset, &unicode,
+        (int)(str->buffer.allocated - offset));
     return unicode;
 }
 NK_API char*
@@ -409,6 +649,7 @@ nk_str_get(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    nk_str_close_gap(s);
     return (char*)s->buffer.memory.ptr;
 }
 NK_API const char*
@@ -416,6 +657,8 @@ nk_str_get_const(const struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    /* every editing call closes the gap before it returns */
+    NK_ASSERT(!s->gap_size);
     return (const char*)s->buffer.memory.ptr;
 }
 NK_API int
@@ -430,7 +673,7 @@ nk_str_len_char(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (int)s->buffer.allocated;
+    return (int)(s->buffer.allocated - s->gap_size);
 }
 NK_API void
 nk_str_clear(struct nk_str *str)
@@ -438,12 +681,23 @@ nk_str_clear(struct nk_str *str)
     NK_ASSERT(str);
     nk_buffer_clear(&str->buffer);
     str->len = 0;
+    str->gap_size = 0;
+    str->checkpoint_count = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 NK_API void
 nk_str_free(struct nk_str *str)
 {
     NK_ASSERT(str);
+    if (str->checkpoints && str->buffer.pool.free)
+        str->buffer.pool.free(str->buffer.pool.userdata, str->checkpoints);
     nk_buffer_free(&str->buffer);
     str->len = 0;
+    str->gap_size = 0;
+    str->checkpoints = 0;
+    str->checkpoint_count = str->checkpoint_capacity = 0;
+    str->changed_begin = 0;
+    str->changed_end = NK_SIZE_MAX;
 }
 
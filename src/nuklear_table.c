@@ -10,9 +10,8 @@ NK_LIB struct nk_table*
 nk_create_table(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_TABLE);
     if (!elem) return 0;
-    nk_zero_struct(*elem);
     return &elem->data.tbl;
 }
 NK_LIB void
@@ -20,7 +19,7 @@ nk_free_table(struct nk_context *ctx, struct nk_table *tbl)
 {
     union nk_page_data *pd = NK_CONTAINER_OF(tbl, union nk_page_data, tbl);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_TABLE);
 }
 NK_LIB void
 nk_push_table(struct nk_window *win, struct nk_table *tbl)
@@ -40,9 +39,136 @@ nk_push_table(struct nk_window *win, struct nk_table *tbl)
     win->tables = tbl;
     win->table_count++;
 }
+NK_INTERN struct nk_value_slot*
+nk_value_index_lookup(struct nk_value_slot *slots, unsigned int size, nk_hash key)
+{
+    unsigned int mask = size - 1;
+    unsigned int i = (key * 2654435761u) >> 8;
+    if (!slots) return 0;
+    for (i &= mask; slots[i].tbl || slots[i].index; i = (i + 1) & mask) {
+        if (slots[i].tbl && slots[i].key == key)
+            return &slots[i];
+    }
+    return 0;
+}
+NK_INTERN void
+nk_value_index_put(struct nk_value_index *vi, nk_hash key,
+    struct nk_table *tbl, unsigned int index)
+{
+    /* reuses the first deleted slot on the probe sequence */
+    unsigned int mask = vi->size - 1;
+    unsigned int i = ((key * 2654435761u) >> 8) & mask;
+    struct nk_value_slot *slot = 0;
+    for (; vi->slots[i].tbl || vi->slots[i].index; i = (i + 1) & mask) {
+        if (!vi->slots[i].tbl && !slot)
+            slot = &vi->slots[i];
+    }
+    if (!slot) {
+        slot = &vi->slots[i];
+        vi->used++;
+    }
+    slot->key = key;
+    slot->index = index;
+    slot->tbl = tbl;
+    vi->live++;
+}
+NK_INTERN void
+nk_value_index_forget(struct nk_value_index *vi, struct nk_table *tbl)
+{
+    unsigned int i;
+    for (i = 0; i < tbl->size; ++i) {
+        struct nk_value_slot *s;
+        s = nk_value_index_lookup(vi->slots, vi->size, tbl->keys[i]);
+        if (s && s->tbl == tbl && s->index == i) {
+            s->tbl = 0; s->index = 1;
+            vi->live--;
+        }
+        s = nk_value_index_lookup(vi->old, vi->old_size, tbl->keys[i]);
+        if (s && s->tbl == tbl && s->index == i) {
+            s->tbl = 0; s->index = 1;
+        }
+    }
+}
+NK_INTERN void
+nk_value_index_migrate(struct nk_context *ctx, struct nk_window *win, unsigned int count)
+{
+    struct nk_value_index *vi = &win->values;
+    if (!vi->old) return;
+    for (; count && vi->migrated < vi->old_size; --count, ++vi->migrated) {
+        const struct nk_value_slot *s = &vi->old[vi->migrated];
+        if (s->tbl) nk_value_index_put(vi, s->key, s->tbl, s->index);
+    }
+    if (vi->migrated < vi->old_size) return;
+    ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->old);
+    vi->old = 0;
+    vi->old_size = 0;
+    vi->migrated = 0;
+}
+NK_INTERN nk_bool
+nk_value_index_resize(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_value_index *vi = &win->values;
+    struct nk_value_slot *slots;
+    unsigned int size = 16;
+
+    nk_value_index_migrate(ctx, win, vi->old_size);
+    while (size < (vi->live + 1) * 2)
+        size *= 2;
+    slots = (struct nk_value_slot*)ctx->pool.alloc.alloc(ctx->pool.alloc.userdata,
+        0, size * sizeof(struct nk_value_slot));
+    if (!slots) return nk_false;
+    nk_zero(slots, size * sizeof(struct nk_value_slot));
+
+    if (!vi->slots) {
+        /* first index for this window is built from all table pages */
+        struct nk_table *iter;
+        vi->slots = slots;
+        vi->size = size;
+        for (iter = win->tables; iter; iter = iter->next) {
+            unsigned int i;
+            for (i = 0; i < iter->size; ++i) {
+                if (!nk_value_index_lookup(vi->slots, vi->size, iter->keys[i]))
+                    nk_value_index_put(vi, iter->keys[i], iter, i);
+            }
+        }
+        vi->prev = 0;
+        vi->next = ctx->value_index_owners;
+        if (vi->next) vi->next->values.prev = win;
+        ctx->value_index_owners = win;
+        return nk_true;
+    }
+    /* keep the current slots as `old` and move them over a few at a time */
+    vi->old = vi->slots;
+    vi->old_size = vi->size;
+    vi->migrated = 0;
+    vi->slots = slots;
+    vi->size = size;
+    vi->used = 0;
+    vi->live = 0;
+    return nk_true;
+}
+NK_LIB void
+nk_value_index_free(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_value_index *vi = &win->values;
+    if (!vi->slots) return;
+    if (vi->old) ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->old);
+    ctx->pool.alloc.free(ctx->pool.alloc.userdata, vi->slots);
+    if (vi->prev) vi->prev->values.next = vi->next;
+    else ctx->value_index_owners = vi->next;
+    if (vi->next) vi->next->values.prev = vi->prev;
+    nk_zero_struct(*vi);
+}
+NK_LIB void
+nk_value_index_step(struct nk_context *ctx, struct nk_window *win)
+{
+    nk_value_index_migrate(ctx, win, 64);
+}
 NK_LIB void
 nk_remove_table(struct nk_window *win, struct nk_table *tbl)
 {
+    if (win->values.slots)
+        nk_value_index_forget(&win->values, tbl);
     if (win->tables == tbl)
         win->tables = tbl->next;
     if (tbl->next)
@@ -68,21 +194,78 @@ nk_add_value(struct nk_context *ctx, struct nk_window *win,
     win->tables->seq = win->seq;
     win->tables->keys[win->tables->size] = name;
     win->tables->values[win->tables->size] = value;
+
+    /* contexts without an allocator keep scanning the table pages */
+    if (ctx->pool.alloc.alloc) {
+        struct nk_value_index *vi = &win->values;
+        if (!vi->slots) {
+            win->tables->size++;
+            nk_value_index_resize(ctx, win);
+            return &win->tables->values[win->tables->size-1];
+        }
+        if ((vi->used + 1) * 4 > vi->size * 3 && !nk_value_index_resize(ctx, win)
+            && vi->used + 1 >= vi->size) {
+            /* out of memory and out of slots so fall back to scanning */
+            nk_value_index_free(ctx, win);
+        }
+        if (vi->slots) {
+            nk_value_index_put(vi, name, win->tables, win->tables->size);
+            nk_value_index_migrate(ctx, win, 4);
+        }
+    }
     return &win->tables->values[win->tables->size++];
 }
+#ifdef NK_INCLUDE_STATISTICS
+NK_INTERN unsigned int
+nk_value_index_probes(const struct nk_value_slot *slots, unsigned int size, nk_hash key)
+{
+    /* walks the same probe sequence as `nk_value_index_lookup` */
+    unsigned int mask = size - 1;
+    unsigned int i = (key * 2654435761u) >> 8;
+    unsigned int probes = 0;
+    if (!slots) return 0;
+    for (i &= mask; slots[i].tbl || slots[i].index; i = (i + 1) & mask) {
+        probes++;
+        if (slots[i].tbl && slots[i].key == key)
+            break;
+    }
+    return probes;
+}
+#endif
 NK_LIB nk_uint*
 nk_find_value(struct nk_window *win, nk_hash name)
 {
     struct nk_table *iter = win->tables;
+#ifdef NK_INCLUDE_STATISTICS
+    win->value_lookups++;
+#endif
+    if (win->values.slots) {
+        struct nk_value_index *vi = &win->values;
+        struct nk_value_slot *s = nk_value_index_lookup(vi->slots, vi->size, name);
+#ifdef NK_INCLUDE_STATISTICS
+        win->value_probes += nk_value_index_probes(vi->slots, vi->size, name);
+        if (!s) win->value_probes += nk_value_index_probes(vi->old, vi->old_size, name);
+#endif
+        if (!s) s = nk_value_index_lookup(vi->old, vi->old_size, name);
+        if (!s) return 0;
+        s->tbl->seq = win->seq;
+        return &s->tbl->values[s->index];
+    }
     while (iter) {
         unsigned int i = 0;
         unsigned int size = iter->size;
         for (i = 0; i < size; ++i) {
             if (iter->keys[i] == name) {
+#ifdef NK_INCLUDE_STATISTICS
+                win->value_probes += i + 1;
+#endif
                 iter->seq = win->seq;
                 return &iter->values[i];
             }
         } size = NK_VALUE_PAGE_CAPACITY;
+#ifdef NK_INCLUDE_STATISTICS
+        win->value_probes += iter->size;
+#endif
         iter = iter->next;
     }
     return 0;
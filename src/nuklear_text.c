@@ -6,6 +6,61 @@
  *                              TEXT
  *
  * ===============================================================*/
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+NK_API void
+nk_text_width_cache_clear(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    nk_zero_struct(ctx->text_cache);
+}
+#endif
+NK_LIB float
+nk_text_width(struct nk_command_buffer *o, const struct nk_user_font *f,
+    const char *string, int len)
+{
+#ifdef NK_INCLUDE_TEXT_WIDTH_CACHE
+    struct nk_text_width_cache *cache;
+    struct nk_text_width_entry *set;
+    nk_hash hash;
+    int i, set_index;
+
+    NK_ASSERT(f);
+    cache = (o) ? o->text_cache : 0;
+    if (!cache || !string || len <= 0)
+        return f->width(f->userdata, f->height, string, len);
+
+    hash = nk_murmur_hash(string, len, 0);
+    set_index = (int)(hash & (NK_TEXT_WIDTH_CACHE_SIZE / NK_TEXT_WIDTH_CACHE_WAYS - 1));
+    set = &cache->entries[set_index * NK_TEXT_WIDTH_CACHE_WAYS];
+    for (i = 0; i < NK_TEXT_WIDTH_CACHE_WAYS; ++i) {
+        struct nk_text_width_entry *e = &set[i];
+        if (e->font == f && e->hash == hash && e->len == len && e->height == f->height) {
+            e->referenced = nk_true;
+            return e->width;
+        }
+    }
+    {/* miss: replace the first entry not referenced since the hand last passed it */
+    struct nk_text_width_entry *e;
+    int hand = cache->hand[set_index];
+    while (set[hand].referenced) {
+        set[hand].referenced = nk_false;
+        hand = (hand + 1) % NK_TEXT_WIDTH_CACHE_WAYS;
+    }
+    e = &set[hand];
+    cache->hand[set_index] = (nk_byte)((hand + 1) % NK_TEXT_WIDTH_CACHE_WAYS);
+    e->font = f;
+    e->hash = hash;
+    e->len = len;
+    e->height = f->height;
+    e->width = f->width(f->userdata, f->height, string, len);
+    e->referenced = nk_true;
+    return e->width;}
+#else
+    NK_UNUSED(o);
+    return f->width(f->userdata, f->height, string, len);
+#endif
+}
 NK_LIB void
 nk_widget_text(struct nk_command_buffer *o, struct nk_rect b,
     const char *string, int len, const struct nk_text *t,
@@ -23,7 +78,7 @@ nk_widget_text(struct nk_command_buffer *o, struct nk_rect b,
     label.y = b.y + t->padding.y;
     label.h = NK_MIN(f->height, b.h - 2 * t->padding.y);
 
-    text_width = f->width(f->userdata, f->height, (const char*)string, len);
+    text_width = nk_text_width(o, f, (const char*)string, len);
     text_width += (2.0f * t->padding.x);
 
     /* align in x-axis */
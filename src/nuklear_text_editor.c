@@ -28,6 +28,8 @@ struct nk_text_edit_row {
 NK_INTERN void nk_textedit_makeundo_delete(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_insert(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_replace(struct nk_text_edit*, int, int, int);
+NK_INTERN void nk_textedit_makeundo_type(struct nk_text_edit*, int, nk_rune);
+NK_INTERN void nk_textedit_flush_redo(struct nk_text_undo_state*);
 #define NK_TEXT_HAS_SELECTION(s)   ((s)->select_start != (s)->select_end)
 
 NK_INTERN float
@@ -273,17 +275,19 @@ nk_textedit_move_to_last(struct nk_text_edit *state)
     }
 }
 NK_INTERN int
-nk_is_word_boundary( struct nk_text_edit *state, int idx)
+nk_is_word_separator(nk_rune c)
 {
-    int len;
-    nk_rune c;
-    if (idx <= 0) return 1;
-    if (!nk_str_at_rune(&state->string, idx, &c, &len)) return 1;
     return (c == ' ' || c == '\t' ||c == 0x3000 || c == ',' || c == ';' ||
             c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' ||
             c == '|');
 }
 NK_INTERN int
+nk_is_word_boundary( struct nk_text_edit *state, int idx)
+{
+    if (idx <= 0 || idx > state->string.len) return 1;
+    return nk_is_word_separator(nk_str_rune_at(&state->string, idx));
+}
+NK_INTERN int
 nk_textedit_move_to_word_previous(struct nk_text_edit *state)
 {
    int c = state->cursor - 1;
@@ -350,8 +354,10 @@ nk_textedit_paste(struct nk_text_edit *state, char const *ctext, int len)
         return 1;
     }
     /* remove the undo since we didn't actually insert the characters */
-    if (state->undo.undo_point)
+    if (state->undo.undo_point > state->undo.record_begin) {
         --state->undo.undo_point;
+        nk_textedit_flush_redo(&state->undo);
+    }
     return 0;
 }
 NK_API void
@@ -376,13 +382,12 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
         if (state->filter && !state->filter(state, unicode)) goto next;
 
         if (!NK_TEXT_HAS_SELECTION(state) &&
-            state->cursor < state->string.len)
+            state->cursor < state->string.len &&
+            state->mode == NK_TEXT_EDIT_MODE_REPLACE)
         {
-            if (state->mode == NK_TEXT_EDIT_MODE_REPLACE) {
-                nk_textedit_makeundo_replace(state, state->cursor, 1, 1);
-                nk_str_delete_runes(&state->string, state->cursor, 1);
-            }
-            if (nk_str_insert_text_utf8(&state->string, state->cursor,
+            nk_textedit_makeundo_replace(state, state->cursor, 1, 1);
+            nk_str_edit_delete_runes(&state->string, state->cursor, 1);
+            if (nk_str_edit_insert_utf8(&state->string, state->cursor,
                                         text+text_len, 1))
             {
                 ++state->cursor;
@@ -390,10 +395,10 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
             }
         } else {
             nk_textedit_delete_selection(state); /* implicitly clamps */
-            if (nk_str_insert_text_utf8(&state->string, state->cursor,
+            if (nk_str_edit_insert_utf8(&state->string, state->cursor,
                                         text+text_len, 1))
             {
-                nk_textedit_makeundo_insert(state, state->cursor, 1);
+                nk_textedit_makeundo_type(state, state->cursor, unicode);
                 state->cursor = NK_MIN(state->cursor + 1, state->string.len);
                 state->has_preferred_x = 0;
             }
@@ -402,6 +407,8 @@ nk_textedit_text(struct nk_text_edit *state, const char *text, int total_len)
         text_len += glyph_len;
         glyph_len = nk_utf_decode(text + text_len, &unicode, total_len-text_len);
     }
+    /* all runes went into the same gap, move the text behind it only once */
+    nk_str_close_gap(&state->string);
 }
 NK_LIB void
 nk_textedit_key(struct nk_text_edit *state, enum nk_keys key, int shift_mod,
@@ -713,263 +720,299 @@ retry:
         }} break;
     }
 }
+NK_INTERN struct nk_text_undo_record*
+nk_textedit_undo_record(struct nk_text_undo_state *s, nk_size index)
+{
+    struct nk_text_undo_record *records = s->records ? s->records: s->undo_rec;
+    return &records[index % s->record_capacity];
+}
+NK_INTERN nk_rune*
+nk_textedit_undo_char(struct nk_text_undo_state *s, nk_size index)
+{
+    nk_rune *chars = s->chars ? s->chars: s->undo_char;
+    return &chars[index % s->char_capacity];
+}
 NK_INTERN void
-nk_textedit_flush_redo(struct nk_text_undo_state *state)
+nk_textedit_flush_redo(struct nk_text_undo_state *s)
 {
-    state->redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
-    state->redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+    /* drop the undone records and every rune stored after the last
+     * record that can still be undone */
+    s->record_end = s->undo_point;
+    if (s->undo_point > s->record_begin) {
+        const struct nk_text_undo_record *r = nk_textedit_undo_record(s, s->undo_point-1);
+        s->char_end = r->char_storage + (nk_size)r->delete_length;
+    } else s->char_end = s->char_begin;
 }
 NK_INTERN void
-nk_textedit_discard_undo(struct nk_text_undo_state *state)
+nk_textedit_discard_undo(struct nk_text_undo_state *s)
 {
     /* discard the oldest entry in the undo list */
-    if (state->undo_point > 0) {
-        /* if the 0th undo state has characters, clean those up */
-        if (state->undo_rec[0].char_storage >= 0) {
-            int n = state->undo_rec[0].insert_length, i;
-            /* delete n characters from all other records */
-            state->undo_char_point = (short)(state->undo_char_point - n);
-            NK_MEMCPY(state->undo_char, state->undo_char + n,
-                (nk_size)state->undo_char_point*sizeof(nk_rune));
-            for (i=0; i < state->undo_point; ++i) {
-                if (state->undo_rec[i].char_storage >= 0)
-                state->undo_rec[i].char_storage = (short)
-                    (state->undo_rec[i].char_storage - n);
-            }
+    NK_ASSERT(s->record_begin < s->undo_point);
+    s->record_begin++;
+    if (s->record_begin < s->record_end)
+        s->char_begin = nk_textedit_undo_record(s, s->record_begin)->char_storage;
+    else s->char_begin = s->char_end;
+}
+NK_INTERN int
+nk_textedit_undo_grow(struct nk_text_edit *state, nk_size records, nk_size chars)
+{
+    /* moves the history into allocator memory for at least `records`
+     * records and `chars` runes. Capacities double until `limit` */
+    struct nk_text_undo_state *s = &state->undo;
+    const struct nk_allocator *alloc = &state->string.buffer.pool;
+    const nk_size limit = s->limit ? s->limit: NK_TEXTEDIT_UNDO_LIMIT;
+    struct nk_text_undo_record *record_memory = 0;
+    nk_rune *char_memory = 0;
+    nk_size record_capacity = s->record_capacity;
+    nk_size char_capacity = s->char_capacity;
+    nk_size memory, i;
+
+    if (state->string.buffer.type != NK_BUFFER_DYNAMIC || !alloc->alloc || !alloc->free)
+        return 0;
+    if (records > record_capacity)
+        record_capacity = NK_MAX(record_capacity * 2, records);
+    if (chars > char_capacity)
+        char_capacity = NK_MAX(char_capacity * 2, chars);
+    memory = record_capacity * sizeof(struct nk_text_undo_record) +
+        char_capacity * sizeof(nk_rune);
+    if (memory > limit) {
+        /* only take what is left below the limit */
+        record_capacity = NK_MAX(records, s->record_capacity);
+        char_capacity = NK_MAX(chars, s->char_capacity);
+        memory = record_capacity * sizeof(struct nk_text_undo_record) +
+            char_capacity * sizeof(nk_rune);
+        if (memory > limit) return 0;
+        if (char_capacity != s->char_capacity)
+            char_capacity += (limit - memory) / sizeof(nk_rune);
+        else record_capacity += (limit - memory) / sizeof(struct nk_text_undo_record);
+    }
+
+    if (record_capacity != s->record_capacity) {
+        record_memory = (struct nk_text_undo_record*)alloc->alloc(alloc->userdata, 0,
+            record_capacity * sizeof(struct nk_text_undo_record));
+        if (!record_memory) return 0;
+    }
+    if (char_capacity != s->char_capacity) {
+        char_memory = (nk_rune*)alloc->alloc(alloc->userdata, 0,
+            char_capacity * sizeof(nk_rune));
+        if (!char_memory) {
+            if (record_memory) alloc->free(alloc->userdata, record_memory);
+            return 0;
         }
-        --state->undo_point;
-        NK_MEMCPY(state->undo_rec, state->undo_rec+1,
-            (nk_size)((nk_size)state->undo_point * sizeof(state->undo_rec[0])));
     }
+    if (record_memory) {
+        for (i = s->record_begin; i < s->record_end; ++i)
+            record_memory[i % record_capacity] = *nk_textedit_undo_record(s, i);
+        if (s->records) alloc->free(alloc->userdata, s->records);
+        s->records = record_memory;
+        s->record_capacity = record_capacity;
+    }
+    if (char_memory) {
+        for (i = s->char_begin; i < s->char_end; ++i)
+            char_memory[i % char_capacity] = *nk_textedit_undo_char(s, i);
+        if (s->chars) alloc->free(alloc->userdata, s->chars);
+        s->chars = char_memory;
+        s->char_capacity = char_capacity;
+    }
+    return 1;
 }
-NK_INTERN void
-nk_textedit_discard_redo(struct nk_text_undo_state *state)
+NK_INTERN int
+nk_textedit_undo_reserve(struct nk_text_edit *state, nk_size records,
+    nk_size chars, nk_size keep)
 {
-/*  discard the oldest entry in the redo list--it's bad if this
-    ever happens, but because undo & redo have to store the actual
-    characters in different cases, the redo character buffer can
-    fill up even though the undo buffer didn't */
-    nk_size num;
-    int k = NK_TEXTEDIT_UNDOSTATECOUNT-1;
-    if (state->redo_point <= k) {
-        /* if the k'th undo state has characters, clean those up */
-        if (state->undo_rec[k].char_storage >= 0) {
-            int n = state->undo_rec[k].insert_length, i;
-            /* delete n characters from all other records */
-            state->redo_char_point = (short)(state->redo_char_point + n);
-            num = (nk_size)(NK_TEXTEDIT_UNDOCHARCOUNT - state->redo_char_point);
-            NK_MEMCPY(state->undo_char + state->redo_char_point,
-                state->undo_char + state->redo_char_point-n, num * sizeof(char));
-            for (i = state->redo_point; i < k; ++i) {
-                if (state->undo_rec[i].char_storage >= 0) {
-                    state->undo_rec[i].char_storage = (short)
-                        (state->undo_rec[i].char_storage + n);
-                }
-            }
-        }
-        ++state->redo_point;
-        num = (nk_size)(NK_TEXTEDIT_UNDOSTATECOUNT - state->redo_point);
-        if (num) NK_MEMCPY(state->undo_rec + state->redo_point-1,
-            state->undo_rec + state->redo_point, num * sizeof(state->undo_rec[0]));
+    /* makes room for more records and runes by growing the history or
+     * else by dropping the oldest records before `keep` */
+    struct nk_text_undo_state *s = &state->undo;
+    while (s->record_end - s->record_begin + records > s->record_capacity ||
+        s->char_end - s->char_begin + chars > s->char_capacity)
+    {
+        if (nk_textedit_undo_grow(state, s->record_end - s->record_begin + records,
+            s->char_end - s->char_begin + chars)) continue;
+        if (s->record_begin >= keep) return 0;
+        nk_textedit_discard_undo(s);
     }
+    return 1;
 }
-NK_INTERN struct nk_text_undo_record*
-nk_textedit_create_undo_record(struct nk_text_undo_state *state, int numchars)
+NK_INTERN void
+nk_textedit_undo_save(struct nk_text_edit *state, nk_size index, int where, int len)
 {
-    /* any time we create a new undo record, we discard redo*/
-    nk_textedit_flush_redo(state);
-
-    /* if we have no free records, we have to make room,
-     * by sliding the existing records down */
-    if (state->undo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
-        nk_textedit_discard_undo(state);
+    /* copies `len` runes of the string into the char ring. Short runs are
+     * read around the gap, longer ones close it and are decoded in a single pass */
+    struct nk_text_undo_state *s = &state->undo;
+    const char *text, *end;
+    nk_rune unicode = 0;
+    int i, glyph_len = 0;
 
-    /* if the characters to store won't possibly fit in the buffer,
-     * we can't undo */
-    if (numchars > NK_TEXTEDIT_UNDOCHARCOUNT) {
-        state->undo_point = 0;
-        state->undo_char_point = 0;
-        return 0;
+    if (len <= 64) {
+        for (i = 0; i < len; ++i)
+            *nk_textedit_undo_char(s, index + (nk_size)i) =
+                nk_str_rune_at(&state->string, where + i);
+        return;
     }
-
-    /* if we don't have enough free characters in the buffer,
-     * we have to make room */
-    while (state->undo_char_point + numchars > NK_TEXTEDIT_UNDOCHARCOUNT)
-        nk_textedit_discard_undo(state);
-    return &state->undo_rec[state->undo_point++];
+    nk_str_close_gap(&state->string);
+    text = nk_str_at_const(&state->string, where, &unicode, &glyph_len);
+    end = nk_str_get_const(&state->string) + nk_str_len_char(&state->string);
+    if (!text) glyph_len = 0;
+    for (i = 0; i < len && glyph_len; ++i) {
+        *nk_textedit_undo_char(s, index + (nk_size)i) = unicode;
+        text += glyph_len;
+        glyph_len = nk_utf_decode(text, &unicode, (int)(end - text));
+    }
+    for (; i < len; ++i)
+        *nk_textedit_undo_char(s, index + (nk_size)i) = 0;
 }
-NK_INTERN nk_rune*
-nk_textedit_createundo(struct nk_text_undo_state *state, int pos,
+NK_INTERN void
+nk_textedit_undo_insert(struct nk_text_edit *state, int where, nk_size index, int len)
+{
+    /* inserts `len` runes from the char ring, which wrap around at most once */
+    struct nk_text_undo_state *s = &state->undo;
+    nk_size start;
+    int first;
+    if (len <= 0) return;
+    start = index % s->char_capacity;
+    first = (int)NK_MIN((nk_size)len, s->char_capacity - start);
+    if (first > 0)
+        nk_str_edit_insert_runes(&state->string, where, nk_textedit_undo_char(s, index), first);
+    if (len > first)
+        nk_str_edit_insert_runes(&state->string, where + first, nk_textedit_undo_char(s, 0), len - first);
+}
+NK_INTERN struct nk_text_undo_record*
+nk_textedit_create_undo_record(struct nk_text_edit *state, int where,
     int insert_len, int delete_len)
 {
-    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, insert_len);
-    if (r == 0)
-        return 0;
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_record *r;
 
-    r->where = pos;
-    r->insert_length = (short) insert_len;
-    r->delete_length = (short) delete_len;
+    /* any time we create a new undo record, we discard redo */
+    nk_textedit_flush_redo(s);
+    s->coalesce = 0;
 
-    if (insert_len == 0) {
-        r->char_storage = -1;
+    /* if the removed characters won't fit even into an empty history,
+     * we can't undo */
+    if (!nk_textedit_undo_reserve(state, 1, (nk_size)delete_len, s->undo_point))
         return 0;
-    } else {
-        r->char_storage = state->undo_char_point;
-        state->undo_char_point = (short)(state->undo_char_point +  insert_len);
-        return &state->undo_char[r->char_storage];
-    }
+
+    r = nk_textedit_undo_record(s, s->record_end);
+    r->where = where;
+    r->insert_length = insert_len;
+    r->delete_length = delete_len;
+    r->char_storage = s->char_end;
+    s->char_end += (nk_size)delete_len;
+    s->undo_point = ++s->record_end;
+    return r;
 }
 NK_API void
 nk_textedit_undo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
-    struct nk_text_undo_record u, *r;
-    if (s->undo_point == 0)
+    struct nk_text_undo_record *r;
+    int keep_redo;
+    if (s->undo_point == s->record_begin)
         return;
 
-    /* we need to do two things: apply the undo record, and create a redo record */
-    u = s->undo_rec[s->undo_point-1];
-    r = &s->undo_rec[s->redo_point-1];
-    r->char_storage = -1;
-
-    r->insert_length = u.delete_length;
-    r->delete_length = u.insert_length;
-    r->where = u.where;
-
-    if (u.delete_length)
-    {
-       /*   if the undo record says to delete characters, then the redo record will
-            need to re-insert the characters that get deleted, so we need to store
-            them.
-            there are three cases:
-                - there's enough room to store the characters
-                - characters stored for *redoing* don't leave room for redo
-                - characters stored for *undoing* don't leave room for redo
-            if the last is true, we have to bail */
-        if (s->undo_char_point + u.delete_length >= NK_TEXTEDIT_UNDOCHARCOUNT) {
-            /* the undo records take up too much character space; there's no space
-            * to store the redo characters */
-            r->insert_length = 0;
-        } else {
-            int i;
-            /* there's definitely room to store the characters eventually */
-            while (s->undo_char_point + u.delete_length > s->redo_char_point) {
-                /* there's currently not enough room, so discard a redo record */
-                nk_textedit_discard_redo(s);
-                /* should never happen: */
-                if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
-                    return;
-            }
-
-            r = &s->undo_rec[s->redo_point-1];
-            r->char_storage = (short)(s->redo_char_point - u.delete_length);
-            s->redo_char_point = (short)(s->redo_char_point -  u.delete_length);
-
-            /* now save the characters */
-            for (i=0; i < u.delete_length; ++i)
-                s->undo_char[r->char_storage + i] =
-                    nk_str_rune_at(&state->string, u.where + i);
-        }
-        /* now we can carry out the deletion */
-        nk_str_delete_runes(&state->string, u.where, u.delete_length);
+    /* the inserted characters go onto the redo stack. If there is no room
+     * even after dropping older records the edit can't be redone */
+    r = nk_textedit_undo_record(s, s->undo_point-1);
+    keep_redo = nk_textedit_undo_reserve(state, 0, (nk_size)r->insert_length, s->undo_point-1);
+    r = nk_textedit_undo_record(s, s->undo_point-1);
+    if (keep_redo) {
+        nk_textedit_undo_save(state, s->char_end, r->where, r->insert_length);
+        s->char_end += (nk_size)r->insert_length;
     }
 
-    /* check type of recorded action: */
-    if (u.insert_length) {
-        /* easy case: was a deletion, so we need to insert n characters */
-        nk_str_insert_text_runes(&state->string, u.where,
-            &s->undo_char[u.char_storage], u.insert_length);
-        s->undo_char_point = (short)(s->undo_char_point - u.insert_length);
-    }
-    state->cursor = (short)(u.where + u.insert_length);
+    nk_str_edit_delete_runes(&state->string, r->where, r->insert_length);
+    nk_textedit_undo_insert(state, r->where, r->char_storage, r->delete_length);
+    nk_str_close_gap(&state->string);
+    state->cursor = r->where + r->delete_length;
 
     s->undo_point--;
-    s->redo_point--;
+    s->coalesce = 0;
+    if (!keep_redo)
+        nk_textedit_flush_redo(s);
 }
 NK_API void
 nk_textedit_redo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
-    struct nk_text_undo_record *u, r;
-    if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
+    struct nk_text_undo_record *r;
+    if (s->undo_point == s->record_end)
         return;
 
-    /* we need to do two things: apply the redo record, and create an undo record */
-    u = &s->undo_rec[s->undo_point];
-    r = s->undo_rec[s->redo_point];
-
-    /* we KNOW there must be room for the undo record, because the redo record
-    was derived from an undo record */
-    u->delete_length = r.insert_length;
-    u->insert_length = r.delete_length;
-    u->where = r.where;
-    u->char_storage = -1;
-
-    if (r.delete_length) {
-        /* the redo record requires us to delete characters, so the undo record
-        needs to store the characters */
-        if (s->undo_char_point + u->insert_length > s->redo_char_point) {
-            u->insert_length = 0;
-            u->delete_length = 0;
-        } else {
-            int i;
-            u->char_storage = s->undo_char_point;
-            s->undo_char_point = (short)(s->undo_char_point + u->insert_length);
-
-            /* now save the characters */
-            for (i=0; i < u->insert_length; ++i) {
-                s->undo_char[u->char_storage + i] =
-                    nk_str_rune_at(&state->string, u->where + i);
-            }
-        }
-        nk_str_delete_runes(&state->string, r.where, r.delete_length);
-    }
-
-    if (r.insert_length) {
-        /* easy case: need to insert n characters */
-        nk_str_insert_text_runes(&state->string, r.where,
-            &s->undo_char[r.char_storage], r.insert_length);
-    }
-    state->cursor = r.where + r.insert_length;
+    /* the removed characters are still stored with the record, the
+     * inserted ones are on top of the redo stack */
+    r = nk_textedit_undo_record(s, s->undo_point);
+    nk_str_edit_delete_runes(&state->string, r->where, r->delete_length);
+    s->char_end -= (nk_size)r->insert_length;
+    nk_textedit_undo_insert(state, r->where, s->char_end, r->insert_length);
+    nk_str_close_gap(&state->string);
+    state->cursor = r->where + r->insert_length;
 
     s->undo_point++;
-    s->redo_point++;
+    s->coalesce = 0;
 }
 NK_INTERN void
 nk_textedit_makeundo_insert(struct nk_text_edit *state, int where, int length)
 {
-    nk_textedit_createundo(&state->undo, where, 0, length);
+    nk_textedit_create_undo_record(state, where, length, 0);
 }
 NK_INTERN void
-nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
+nk_textedit_makeundo_type(struct nk_text_edit *state, int where, nk_rune unicode)
 {
-    int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, length, 0);
-    if (p) {
-        for (i=0; i < length; ++i)
-            p[i] = nk_str_rune_at(&state->string, where+i);
+    /* typing extends the newest record until a new word starts */
+    struct nk_text_undo_state *s = &state->undo;
+    const nk_rune prev = s->coalesce;
+    if (prev && s->undo_point == s->record_end) {
+        struct nk_text_undo_record *r = nk_textedit_undo_record(s, s->undo_point-1);
+        if (r->where + r->insert_length == where && (nk_is_word_separator(unicode) ||
+            !(prev == '\n' || nk_is_word_separator(prev)))) {
+            r->insert_length++;
+            s->coalesce = unicode;
+            return;
+        }
     }
+    if (nk_textedit_create_undo_record(state, where, 1, 0))
+        s->coalesce = unicode;
+}
+NK_INTERN void
+nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
+{
+    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, where, 0, length);
+    if (r) nk_textedit_undo_save(state, r->char_storage, where, length);
 }
 NK_INTERN void
 nk_textedit_makeundo_replace(struct nk_text_edit *state, int where,
     int old_length, int new_length)
 {
-    int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
-    if (p) {
-        for (i=0; i < old_length; ++i)
-            p[i] = nk_str_rune_at(&state->string, where+i);
-    }
+    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, where,
+        new_length, old_length);
+    if (r) nk_textedit_undo_save(state, r->char_storage, where, old_length);
+}
+NK_INTERN void
+nk_textedit_clear_undo(struct nk_text_undo_state *s)
+{
+    /* empties the history but keeps its memory */
+#ifdef NK_LIGHTWEIGHT_CONTEXT
+    if (!s->records)
+        s->record_capacity = (s->undo_rec) ? NK_TEXTEDIT_UNDOSTATECOUNT: 0;
+    if (!s->chars)
+        s->char_capacity = (s->undo_char) ? NK_TEXTEDIT_UNDOCHARCOUNT: 0;
+#else
+    if (!s->records)
+        s->record_capacity = NK_TEXTEDIT_UNDOSTATECOUNT;
+    if (!s->chars)
+        s->char_capacity = NK_TEXTEDIT_UNDOCHARCOUNT;
+#endif
+    s->record_begin = s->record_end = 0;
+    s->undo_point = 0;
+    s->char_begin = s->char_end = 0;
+    s->coalesce = 0;
 }
 NK_LIB void
 nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type,
     nk_plugin_filter filter)
 {
     /* reset the state to default */
-   state->undo.undo_point = 0;
-   state->undo.undo_char_point = 0;
-   state->undo.redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
-   state->undo.redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+   nk_textedit_clear_undo(&state->undo);
    state->select_end = state->select_start = 0;
    state->cursor = 0;
    state->has_preferred_x = 0;
@@ -1024,6 +1067,18 @@ nk_textedit_free(struct nk_text_edit *state)
 {
     NK_ASSERT(state);
     if (!state) return;
+    if (state->lines.line && state->string.buffer.pool.free)
+        state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->lines.line);
+    nk_zero(&state->lines, sizeof(state->lines));
+    if (state->string.buffer.pool.free) {
+        if (state->undo.records)
+            state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->undo.records);
+        if (state->undo.chars)
+            state->string.buffer.pool.free(state->string.buffer.pool.userdata, state->undo.chars);
+    }
+    state->undo.records = 0;
+    state->undo.chars = 0;
+    nk_textedit_clear_undo(&state->undo);
     nk_str_free(&state->string);
 }
 
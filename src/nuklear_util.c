@@ -72,6 +72,30 @@ done:
     return (dst0);
 }
 #endif
+NK_LIB void
+nk_memmove(void *dst0, const void *src0, nk_size length)
+{
+    /* NK_MEMCPY may be a plain memcpy, so overlapping ranges are copied
+     * in pieces no larger than the distance between them */
+    char *dst = (char*)dst0;
+    const char *src = (const char*)src0;
+    nk_size dist, n;
+    if (!length || dst == src) return;
+    dist = (dst < src) ? (nk_size)(src - dst): (nk_size)(dst - src);
+    if (dist >= length) {
+        NK_MEMCPY(dst, src, length);
+    } else if (dst < src) {
+        for (; length; length -= n, dst += n, src += n) {
+            n = NK_MIN(dist, length);
+            NK_MEMCPY(dst, src, n);
+        }
+    } else {
+        for (; length; length -= n) {
+            n = NK_MIN(dist, length);
+            NK_MEMCPY(dst + length - n, src + length - n, n);
+        }
+    }
+}
 #ifndef NK_MEMSET
 #define NK_MEMSET nk_memset
 NK_LIB void
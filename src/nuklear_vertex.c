@@ -40,6 +40,7 @@ nk_draw_list_setup(struct nk_draw_list *canvas, const struct nk_convert_config *
     canvas->line_AA = line_aa;
     canvas->shape_AA = shape_aa;
     canvas->clip_rect = nk_null_rect;
+    canvas->vertex_writer = nk_draw_vertex_writer_select(canvas);
 
     canvas->cmd_offset = 0;
     canvas->element_count = 0;
@@ -47,6 +48,9 @@ nk_draw_list_setup(struct nk_draw_list *canvas, const struct nk_convert_config *
     canvas->cmd_offset = 0;
     canvas->cmd_count = 0;
     canvas->path_count = 0;
+    canvas->scratch_arena = 0;
+    canvas->scratch = 0;
+    canvas->scratch_size = 0;
 }
 NK_API const struct nk_draw_command*
 nk__draw_list_begin(const struct nk_draw_list *canvas, const struct nk_buffer *buffer)
@@ -392,9 +396,11 @@ nk_draw_vertex_element(void *dst, const float *values, int value_count,
     }
 }
 NK_INTERN void*
-nk_draw_vertex(void *dst, const struct nk_convert_config *config,
+nk_draw_vertex(void *dst, const struct nk_draw_list *list,
     struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
 {
+    /* generic writer interpreting the vertex layout for each vertex */
+    const struct nk_convert_config *config = &list->config;
     void *result = (void*)((char*)dst + config->vertex_size);
     const struct nk_draw_vertex_layout_element *elem_iter = config->vertex_layout;
     while (!nk_draw_vertex_layout_element_is_end_of_layout(elem_iter)) {
@@ -410,6 +416,147 @@ nk_draw_vertex(void *dst, const struct nk_convert_config *config,
     }
     return result;
 }
+NK_INTERN void*
+nk_draw_vertex_rgba8(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
+{
+    /* float position and texture coordinates with R8G8B8A8 color */
+    nk_byte *vtx = (nk_byte*)dst;
+    float *p = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_POSITION]);
+    float *t = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_TEXCOORD]);
+    nk_byte *c = vtx + list->vertex_offsets[NK_VERTEX_COLOR];
+    p[0] = pos.x; p[1] = pos.y;
+    t[0] = uv.x; t[1] = uv.y;
+    c[0] = (nk_byte)(NK_SATURATE(color.r) * 255.0f);
+    c[1] = (nk_byte)(NK_SATURATE(color.g) * 255.0f);
+    c[2] = (nk_byte)(NK_SATURATE(color.b) * 255.0f);
+    c[3] = (nk_byte)(NK_SATURATE(color.a) * 255.0f);
+    return vtx + list->config.vertex_size;
+}
+NK_INTERN void*
+nk_draw_vertex_bgra8(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
+{
+    /* float position and texture coordinates with B8G8R8A8 color */
+    nk_byte *vtx = (nk_byte*)dst;
+    float *p = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_POSITION]);
+    float *t = (float*)(void*)(vtx + list->vertex_offsets[NK_VERTEX_TEXCOORD]);
+    nk_byte *c = vtx + list->vertex_offsets[NK_VERTEX_COLOR];
+    p[0] = pos.x; p[1] = pos.y;
+    t[0] = uv.x; t[1] = uv.y;
+    c[0] = (nk_byte)(NK_SATURATE(color.b) * 255.0f);
+    c[1] = (nk_byte)(NK_SATURATE(color.g) * 255.0f);
+    c[2] = (nk_byte)(NK_SATURATE(color.r) * 255.0f);
+    c[3] = (nk_byte)(NK_SATURATE(color.a) * 255.0f);
+    return vtx + list->config.vertex_size;
+}
+NK_LIB nk_draw_vertex_writer
+nk_draw_vertex_writer_select(struct nk_draw_list *list)
+{
+    /* picks a straight-line writer for common vertex layouts */
+    NK_STORAGE const nk_size float_align = NK_ALIGNOF(float);
+    const struct nk_convert_config *config = &list->config;
+    const struct nk_draw_vertex_layout_element *elem;
+    enum nk_draw_vertex_layout_format color = NK_FORMAT_COUNT;
+    unsigned found = 0;
+
+    if (!config->vertex_layout || config->vertex_alignment % float_align ||
+        config->vertex_size % float_align)
+        return nk_draw_vertex;
+    for (elem = config->vertex_layout; !nk_draw_vertex_layout_element_is_end_of_layout(elem); ++elem) {
+        const unsigned bit = 1u << elem->attribute;
+        if (found & bit) return nk_draw_vertex;
+        found |= bit;
+        list->vertex_offsets[elem->attribute] = elem->offset;
+        switch (elem->attribute) {
+        case NK_VERTEX_POSITION:
+        case NK_VERTEX_TEXCOORD:
+            if (elem->format != NK_FORMAT_FLOAT || elem->offset % float_align)
+                return nk_draw_vertex;
+            break;
+        case NK_VERTEX_COLOR:
+            color = elem->format;
+            break;
+        default: return nk_draw_vertex;
+        }
+    }
+    if (found != (1u << NK_VERTEX_POSITION | 1u << NK_VERTEX_TEXCOORD | 1u << NK_VERTEX_COLOR))
+        return nk_draw_vertex;
+    switch (color) {
+    case NK_FORMAT_R8G8B8A8:
+    case NK_FORMAT_R8G8B8: return nk_draw_vertex_rgba8;
+    case NK_FORMAT_B8G8R8A8: return nk_draw_vertex_bgra8;
+    default: return nk_draw_vertex;
+    }
+}
+NK_INTERN void*
+nk_draw_list_alloc_temp(struct nk_draw_list *list, nk_size size, nk_size align)
+{
+    /* temporaries only live for a single stroke or fill, so the same frame
+     * arena block is handed out again and only replaced when too small */
+    void *memory;
+    nk_size capacity;
+    if (!list->scratch_arena) return 0;
+    if (list->scratch) {
+        memory = NK_ALIGN_PTR(list->scratch, align);
+        if ((nk_byte*)memory + size <= (nk_byte*)list->scratch + list->scratch_size)
+            return memory;
+    }
+    capacity = NK_MAX(size + align, list->scratch_size * 2);
+    memory = nk_frame_arena_alloc(list->scratch_arena, capacity, 0);
+    if (!memory) return 0;
+    list->scratch = memory;
+    list->scratch_size = capacity;
+    return NK_ALIGN_PTR(memory, align);
+}
+NK_INTERN struct nk_vec2
+nk_draw_list_miter(struct nk_vec2 n0, struct nk_vec2 n1)
+{
+    /* average of two normals scaled by the inverse squared length
+     * so the stroke keeps its width around corners */
+    const struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(n0, n1), 0.5f);
+    const float dmr2 = dm.x * dm.x + dm.y * dm.y;
+    const float scale = (dmr2 > 0.000001f) ? NK_MIN(100.0f, 1.0f/dmr2): 1.0f;
+    return nk_vec2_muls(dm, scale);
+}
+#ifdef NK_SIMD_SSE2
+NK_INTERN __m128
+nk_draw_list_inv_sqrt_sse2(__m128 n)
+{
+    /* same steps as nk_inv_sqrt, so the results are identical */
+    const __m128 x2 = _mm_mul_ps(n, _mm_set1_ps(0.5f));
+    const __m128 f = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(0x5f375A84),
+        _mm_srli_epi32(_mm_castps_si128(n), 1)));
+    return _mm_mul_ps(f, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(x2, f), f)));
+}
+NK_INTERN __m128
+nk_draw_list_normals_sse2(__m128 p0, __m128 p1)
+{
+    /* normals of the two segments from `p0` to `p1`, each register holds
+     * two points. Lengths are summed in both lanes of a point */
+    const __m128 d = _mm_sub_ps(p1, p0);
+    const __m128 sq = _mm_mul_ps(d, d);
+    const __m128 len = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+    const __m128 empty = _mm_cmpeq_ps(len, _mm_setzero_ps());
+    const __m128 scale = _mm_or_ps(_mm_and_ps(empty, _mm_set1_ps(1.0f)),
+        _mm_andnot_ps(empty, nk_draw_list_inv_sqrt_sse2(len)));
+    const __m128 n = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2,3,0,1)),
+        _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+    return _mm_mul_ps(n, scale);
+}
+NK_INTERN __m128
+nk_draw_list_miter_sse2(__m128 n0, __m128 n1)
+{
+    /* nk_draw_list_miter for two points at once */
+    const __m128 dm = _mm_mul_ps(_mm_add_ps(n0, n1), _mm_set1_ps(0.5f));
+    const __m128 sq = _mm_mul_ps(dm, dm);
+    const __m128 dmr2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+    const __m128 valid = _mm_cmpgt_ps(dmr2, _mm_set1_ps(0.000001f));
+    const __m128 scale = _mm_min_ps(_mm_set1_ps(100.0f), _mm_div_ps(_mm_set1_ps(1.0f), dmr2));
+    return _mm_mul_ps(dm, _mm_or_ps(_mm_and_ps(valid, scale),
+        _mm_andnot_ps(valid, _mm_set1_ps(1.0f))));
+}
+#endif
 NK_API void
 nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *points,
     const unsigned int points_count, struct nk_color color, enum nk_draw_list_stroke closed,
@@ -446,6 +593,7 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         nk_size i1 = 0;
         nk_size vertex_offset;
         nk_size index = list->vertex_count;
+        nk_bool in_vertices = nk_false;
 
         const nk_size idx_count = (thick_line) ?  (count * 18) : (count * 12);
         const nk_size vtx_count = (thick_line) ? (points_count * 4): (points_count *3);
@@ -458,68 +606,91 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         if (!vtx || !ids) return;
 
         /* temporary allocate normals + points */
-        vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
-        nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
         size = pnt_size * ((thick_line) ? 5 : 3) * points_count;
-        normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
-        if (!normals) return;
+        normals = (struct nk_vec2*)nk_draw_list_alloc_temp(list, size, pnt_align);
+        if (!normals) {
+            vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
+            nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
+            normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
+            if (!normals) return;
+            in_vertices = nk_true;
+
+            /* make sure vertex pointer is still correct */
+            vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        }
         temp = normals + points_count;
 
-        /* make sure vertex pointer is still correct */
-        vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
-
-        /* calculate normals */
-        for (i1 = 0; i1 < count; ++i1) {
-            const nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-            struct nk_vec2 diff = nk_vec2_sub(points[i2], points[i1]);
-            float len;
-
-            /* vec2 inverted length  */
-            len = nk_vec2_len_sqr(diff);
-            if (len != 0.0f)
-                len = NK_INV_SQRT(len);
-            else len = 1.0f;
-
-            diff = nk_vec2_muls(diff, len);
-            normals[i1].x = diff.y;
-            normals[i1].y = -diff.x;
+        /* calculate normals, the segment closing the path is done outside
+         * of the loop so it stays free of branches and can be vectorized */
+        i1 = 0;
+#ifdef NK_SIMD_SSE2
+        for (; i1 + 4 < points_count; i1 += 4) {
+            const float *p = &points[i1].x;
+            _mm_storeu_ps(&normals[i1].x, nk_draw_list_normals_sse2(
+                _mm_loadu_ps(p), _mm_loadu_ps(p + 2)));
+            _mm_storeu_ps(&normals[i1+2].x, nk_draw_list_normals_sse2(
+                _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 6)));
         }
-
-        if (!closed)
-            normals[points_count-1] = normals[points_count-2];
+#endif
+        for (; i1 + 1 < points_count; ++i1) {
+            const float dx = points[i1+1].x - points[i1].x;
+            const float dy = points[i1+1].y - points[i1].y;
+            const float len = dx * dx + dy * dy;
+            const float inv_len = NK_INV_SQRT(len);
+            const float scale = (len != 0.0f) ? inv_len: 1.0f;
+            normals[i1].x = dy * scale;
+            normals[i1].y = -dx * scale;
+        }
+        if (closed) {
+            const struct nk_vec2 diff = nk_vec2_sub(points[0], points[points_count-1]);
+            const float len = nk_vec2_len_sqr(diff);
+            const float scale = (len != 0.0f) ? NK_INV_SQRT(len): 1.0f;
+            normals[points_count-1].x = diff.y * scale;
+            normals[points_count-1].y = -diff.x * scale;
+        } else normals[points_count-1] = normals[points_count-2];
 
         if (!thick_line) {
-            nk_size idx1, i;
+            nk_size i;
+            const struct nk_vec2 uv = list->config.tex_null.uv;
+
+            /* fringe points from the averaged normals of both adjacent segments */
             if (!closed) {
-                struct nk_vec2 d;
-                temp[0] = nk_vec2_add(points[0], nk_vec2_muls(normals[0], AA_SIZE));
-                temp[1] = nk_vec2_sub(points[0], nk_vec2_muls(normals[0], AA_SIZE));
-                d = nk_vec2_muls(normals[points_count-1], AA_SIZE);
-                temp[(points_count-1) * 2 + 0] = nk_vec2_add(points[points_count-1], d);
-                temp[(points_count-1) * 2 + 1] = nk_vec2_sub(points[points_count-1], d);
+                const struct nk_vec2 d = nk_vec2_muls(normals[0], AA_SIZE);
+                temp[0] = nk_vec2_add(points[0], d);
+                temp[1] = nk_vec2_sub(points[0], d);
+            } else {
+                const struct nk_vec2 dm = nk_vec2_muls(nk_draw_list_miter(
+                    normals[points_count-1], normals[0]), AA_SIZE);
+                temp[0] = nk_vec2_add(points[0], dm);
+                temp[1] = nk_vec2_sub(points[0], dm);
             }
-
-            /* fill elements */
-            idx1 = index;
-            for (i1 = 0; i1 < count; i1++) {
-                struct nk_vec2 dm;
-                float dmr2;
-                nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 3);
-
-                /* average normals */
-                dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+            i = 1;
+#ifdef NK_SIMD_SSE2
+            for (; i + 3 < points_count; i += 4) {
+                nk_size j;
+                for (j = i; j < i + 4; j += 2) {
+                    const __m128 p = _mm_loadu_ps(&points[j].x);
+                    const __m128 dm = _mm_mul_ps(nk_draw_list_miter_sse2(
+                        _mm_loadu_ps(&normals[j-1].x), _mm_loadu_ps(&normals[j].x)),
+                        _mm_set1_ps(AA_SIZE));
+                    const __m128 a = _mm_add_ps(p, dm);
+                    const __m128 b = _mm_sub_ps(p, dm);
+                    _mm_storeu_ps(&temp[j*2].x, _mm_movelh_ps(a, b));
+                    _mm_storeu_ps(&temp[j*2+2].x, _mm_movehl_ps(b, a));
                 }
+            }
+#endif
+            for (; i < points_count; ++i) {
+                const struct nk_vec2 dm = nk_vec2_muls(nk_draw_list_miter(
+                    normals[i-1], normals[i]), AA_SIZE);
+                temp[i*2+0] = nk_vec2_add(points[i], dm);
+                temp[i*2+1] = nk_vec2_sub(points[i], dm);
+            }
 
-                dm = nk_vec2_muls(dm, AA_SIZE);
-                temp[i2*2+0] = nk_vec2_add(points[i2], dm);
-                temp[i2*2+1] = nk_vec2_sub(points[i2], dm);
-
+            /* fill elements, every segment connects three vertices per point */
+            for (i1 = 0; i1 < count; ++i1) {
+                const nk_size idx1 = index + i1 * 3;
+                const nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 3);
                 ids[0] = (nk_draw_index)(idx2 + 0); ids[1] = (nk_draw_index)(idx1+0);
                 ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
                 ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+0);
@@ -527,61 +698,72 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 ids[8] = (nk_draw_index)(idx1 + 0); ids[9] = (nk_draw_index)(idx1+0);
                 ids[10]= (nk_draw_index)(idx2 + 0); ids[11]= (nk_draw_index)(idx2+1);
                 ids += 12;
-                idx1 = idx2;
             }
 
             /* fill vertices */
             for (i = 0; i < points_count; ++i) {
-                const struct nk_vec2 uv = list->config.tex_null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, points[i], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+1], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, points[i], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*2+0], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*2+1], uv, col_trans);
             }
         } else {
-            nk_size idx1, i;
+            nk_size i;
+            const struct nk_vec2 uv = list->config.tex_null.uv;
             const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
-            if (!closed) {
-                struct nk_vec2 d1 = nk_vec2_muls(normals[0], half_inner_thickness + AA_SIZE);
-                struct nk_vec2 d2 = nk_vec2_muls(normals[0], half_inner_thickness);
+            const float half_outer_thickness = half_inner_thickness + AA_SIZE;
 
+            /* outer and inner fringe points from the averaged normals */
+            if (!closed) {
+                const struct nk_vec2 d1 = nk_vec2_muls(normals[0], half_outer_thickness);
+                const struct nk_vec2 d2 = nk_vec2_muls(normals[0], half_inner_thickness);
                 temp[0] = nk_vec2_add(points[0], d1);
                 temp[1] = nk_vec2_add(points[0], d2);
                 temp[2] = nk_vec2_sub(points[0], d2);
                 temp[3] = nk_vec2_sub(points[0], d1);
-
-                d1 = nk_vec2_muls(normals[points_count-1], half_inner_thickness + AA_SIZE);
-                d2 = nk_vec2_muls(normals[points_count-1], half_inner_thickness);
-
-                temp[(points_count-1)*4+0] = nk_vec2_add(points[points_count-1], d1);
-                temp[(points_count-1)*4+1] = nk_vec2_add(points[points_count-1], d2);
-                temp[(points_count-1)*4+2] = nk_vec2_sub(points[points_count-1], d2);
-                temp[(points_count-1)*4+3] = nk_vec2_sub(points[points_count-1], d1);
+            } else {
+                const struct nk_vec2 dm = nk_draw_list_miter(normals[points_count-1], normals[0]);
+                const struct nk_vec2 dm_out = nk_vec2_muls(dm, half_outer_thickness);
+                const struct nk_vec2 dm_in = nk_vec2_muls(dm, half_inner_thickness);
+                temp[0] = nk_vec2_add(points[0], dm_out);
+                temp[1] = nk_vec2_add(points[0], dm_in);
+                temp[2] = nk_vec2_sub(points[0], dm_in);
+                temp[3] = nk_vec2_sub(points[0], dm_out);
             }
-
-            /* add all elements */
-            idx1 = index;
-            for (i1 = 0; i1 < count; ++i1) {
-                struct nk_vec2 dm_out, dm_in;
-                const nk_size i2 = ((i1+1) == points_count) ? 0: (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 4);
-
-                /* average normals */
-                struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                float dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+            i = 1;
+#ifdef NK_SIMD_SSE2
+            for (; i + 3 < points_count; i += 4) {
+                nk_size j;
+                for (j = i; j < i + 4; j += 2) {
+                    const __m128 p = _mm_loadu_ps(&points[j].x);
+                    const __m128 dm = nk_draw_list_miter_sse2(
+                        _mm_loadu_ps(&normals[j-1].x), _mm_loadu_ps(&normals[j].x));
+                    const __m128 dm_out = _mm_mul_ps(dm, _mm_set1_ps(half_outer_thickness));
+                    const __m128 dm_in = _mm_mul_ps(dm, _mm_set1_ps(half_inner_thickness));
+                    const __m128 out0 = _mm_add_ps(p, dm_out);
+                    const __m128 in0 = _mm_add_ps(p, dm_in);
+                    const __m128 in1 = _mm_sub_ps(p, dm_in);
+                    const __m128 out1 = _mm_sub_ps(p, dm_out);
+                    _mm_storeu_ps(&temp[j*4].x, _mm_movelh_ps(out0, in0));
+                    _mm_storeu_ps(&temp[j*4+2].x, _mm_movelh_ps(in1, out1));
+                    _mm_storeu_ps(&temp[j*4+4].x, _mm_movehl_ps(in0, out0));
+                    _mm_storeu_ps(&temp[j*4+6].x, _mm_movehl_ps(out1, in1));
                 }
+            }
+#endif
+            for (; i < points_count; ++i) {
+                const struct nk_vec2 dm = nk_draw_list_miter(normals[i-1], normals[i]);
+                const struct nk_vec2 dm_out = nk_vec2_muls(dm, half_outer_thickness);
+                const struct nk_vec2 dm_in = nk_vec2_muls(dm, half_inner_thickness);
+                temp[i*4+0] = nk_vec2_add(points[i], dm_out);
+                temp[i*4+1] = nk_vec2_add(points[i], dm_in);
+                temp[i*4+2] = nk_vec2_sub(points[i], dm_in);
+                temp[i*4+3] = nk_vec2_sub(points[i], dm_out);
+            }
 
-                dm_out = nk_vec2_muls(dm, ((half_inner_thickness) + AA_SIZE));
-                dm_in = nk_vec2_muls(dm, half_inner_thickness);
-                temp[i2*4+0] = nk_vec2_add(points[i2], dm_out);
-                temp[i2*4+1] = nk_vec2_add(points[i2], dm_in);
-                temp[i2*4+2] = nk_vec2_sub(points[i2], dm_in);
-                temp[i2*4+3] = nk_vec2_sub(points[i2], dm_out);
-
-                /* add indexes */
+            /* add all elements, every segment connects four vertices per point */
+            for (i1 = 0; i1 < count; ++i1) {
+                const nk_size idx1 = index + i1 * 4;
+                const nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 4);
                 ids[0] = (nk_draw_index)(idx2 + 1); ids[1] = (nk_draw_index)(idx1+1);
                 ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
                 ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+1);
@@ -592,20 +774,19 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 ids[14]= (nk_draw_index)(idx1 + 3); ids[15] = (nk_draw_index)(idx1+3);
                 ids[16]= (nk_draw_index)(idx2 + 3); ids[17] = (nk_draw_index)(idx2+2);
                 ids += 18;
-                idx1 = idx2;
             }
 
             /* add vertices */
             for (i = 0; i < points_count; ++i) {
-                const struct nk_vec2 uv = list->config.tex_null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+1], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+2], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+3], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+0], uv, col_trans);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+1], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+2], uv, col);
+                vtx = list->vertex_writer(vtx, list, temp[i*4+3], uv, col_trans);
             }
         }
         /* free temporary normals + points */
-        nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
+        if (in_vertices)
+            nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
     } else {
         /* NON ANTI-ALIASED STROKE */
         nk_size i1 = 0;
@@ -636,10 +817,10 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
             dx = diff.x * (thickness * 0.5f);
             dy = diff.y * (thickness * 0.5f);
 
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
 
             ids[0] = (nk_draw_index)(idx+0); ids[1] = (nk_draw_index)(idx+1);
             ids[2] = (nk_draw_index)(idx+2); ids[3] = (nk_draw_index)(idx+0);
@@ -680,6 +861,7 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
         const float AA_SIZE = 1.0f;
         nk_size vertex_offset = 0;
         nk_size index = list->vertex_count;
+        nk_bool in_vertices = nk_false;
 
         const nk_size idx_count = (points_count-2)*3 + points_count*6;
         const nk_size vtx_count = (points_count*2);
@@ -694,12 +876,16 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
         if (!vtx || !ids) return;
 
         /* temporary allocate normals */
-        vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
-        nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
         size = pnt_size * points_count;
-        normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
-        if (!normals) return;
-        vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        normals = (struct nk_vec2*)nk_draw_list_alloc_temp(list, size, pnt_align);
+        if (!normals) {
+            vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
+            nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
+            normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
+            if (!normals) return;
+            in_vertices = nk_true;
+            vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
+        }
 
         /* add elements */
         for (i = 2; i < points_count; i++) {
@@ -741,8 +927,8 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
             dm = nk_vec2_muls(dm, AA_SIZE * 0.5f);
 
             /* add vertices */
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_sub(points[i1], dm), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_add(points[i1], dm), uv, col_trans);
+            vtx = list->vertex_writer(vtx, list, nk_vec2_sub(points[i1], dm), uv, col);
+            vtx = list->vertex_writer(vtx, list, nk_vec2_add(points[i1], dm), uv, col_trans);
 
             /* add indexes */
             ids[0] = (nk_draw_index)(vtx_inner_idx+(i1<<1));
@@ -754,7 +940,8 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
             ids += 6;
         }
         /* free temporary normals + points */
-        nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
+        if (in_vertices)
+            nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
     } else {
         nk_size i = 0;
         nk_size index = list->vertex_count;
@@ -765,7 +952,7 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
 
         if (!vtx || !ids) return;
         for (i = 0; i < vtx_count; ++i)
-            vtx = nk_draw_vertex(vtx, &list->config, points[i], list->config.tex_null.uv, col);
+            vtx = list->vertex_writer(vtx, list, points[i], list->config.tex_null.uv, col);
         for (i = 2; i < points_count; ++i) {
             ids[0] = (nk_draw_index)index;
             ids[1] = (nk_draw_index)(index+ i - 1);
@@ -1007,10 +1194,10 @@ nk_draw_list_fill_rect_multi_color(struct nk_draw_list *list, struct nk_rect rec
     idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
     idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
 
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y), list->config.tex_null.uv, col_left);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y), list->config.tex_null.uv, col_top);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.tex_null.uv, col_right);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y + rect.h), list->config.tex_null.uv, col_bottom);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x, rect.y), list->config.tex_null.uv, col_left);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x + rect.w, rect.y), list->config.tex_null.uv, col_top);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.tex_null.uv, col_right);
+    vtx = list->vertex_writer(vtx, list, nk_vec2(rect.x, rect.y + rect.h), list->config.tex_null.uv, col_bottom);
 }
 NK_API void
 nk_draw_list_fill_triangle(struct nk_draw_list *list, struct nk_vec2 a,
@@ -1067,17 +1254,32 @@ nk_draw_list_stroke_curve(struct nk_draw_list *list, struct nk_vec2 p0,
     nk_draw_list_path_curve_to(list, cp0, cp1, p1, segments);
     nk_draw_list_path_stroke(list, col, NK_STROKE_OPEN, thickness);
 }
+NK_INTERN void*
+nk_draw_list_write_rect_uv(const struct nk_draw_list *list, void *vtx,
+    nk_draw_index *idx, nk_draw_index index, struct nk_vec2 a, struct nk_vec2 c,
+    struct nk_vec2 uva, struct nk_vec2 uvc, struct nk_colorf col)
+{
+    /* writes one textured quad into already reserved vertex and element memory */
+    struct nk_vec2 uvb = nk_vec2(uvc.x, uva.y);
+    struct nk_vec2 uvd = nk_vec2(uva.x, uvc.y);
+    struct nk_vec2 b = nk_vec2(c.x, a.y);
+    struct nk_vec2 d = nk_vec2(a.x, c.y);
+
+    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
+    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
+    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
+
+    vtx = list->vertex_writer(vtx, list, a, uva, col);
+    vtx = list->vertex_writer(vtx, list, b, uvb, col);
+    vtx = list->vertex_writer(vtx, list, c, uvc, col);
+    return list->vertex_writer(vtx, list, d, uvd, col);
+}
 NK_INTERN void
 nk_draw_list_push_rect_uv(struct nk_draw_list *list, struct nk_vec2 a,
     struct nk_vec2 c, struct nk_vec2 uva, struct nk_vec2 uvc,
     struct nk_color color)
 {
     void *vtx;
-    struct nk_vec2 uvb;
-    struct nk_vec2 uvd;
-    struct nk_vec2 b;
-    struct nk_vec2 d;
-
     struct nk_colorf col;
     nk_draw_index *idx;
     nk_draw_index index;
@@ -1085,24 +1287,11 @@ nk_draw_list_push_rect_uv(struct nk_draw_list *list, struct nk_vec2 a,
     if (!list) return;
 
     nk_color_fv(&col.r, color);
-    uvb = nk_vec2(uvc.x, uva.y);
-    uvd = nk_vec2(uva.x, uvc.y);
-    b = nk_vec2(c.x, a.y);
-    d = nk_vec2(a.x, c.y);
-
     index = (nk_draw_index)list->vertex_count;
     vtx = nk_draw_list_alloc_vertices(list, 4);
     idx = nk_draw_list_alloc_elements(list, 6);
     if (!vtx || !idx) return;
-
-    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
-    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
-    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
-
-    vtx = nk_draw_vertex(vtx, &list->config, a, uva, col);
-    vtx = nk_draw_vertex(vtx, &list->config, b, uvb, col);
-    vtx = nk_draw_vertex(vtx, &list->config, c, uvc, col);
-    vtx = nk_draw_vertex(vtx, &list->config, d, uvd, col);
+    nk_draw_list_write_rect_uv(list, vtx, idx, index, a, c, uva, uvc, col);
 }
 NK_API void
 nk_draw_list_add_image(struct nk_draw_list *list, struct nk_image texture,
@@ -1131,12 +1320,21 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
     struct nk_color fg)
 {
     float x = 0;
+    int i = 0;
     int text_len = 0;
     nk_rune unicode = 0;
     nk_rune next = 0;
     int glyph_len = 0;
-    int next_glyph_len = 0;
+    int glyph_count = 0;
     struct nk_user_font_glyph g;
+    struct nk_colorf col;
+    nk_draw_index *idx;
+    nk_draw_index index;
+    void *vtx;
+#ifdef NK_INCLUDE_FONT_BAKING
+    struct nk_font *baked = 0;
+    float scale = 0;
+#endif
 
     NK_ASSERT(list);
     if (!list || !len || !text) return;
@@ -1144,43 +1342,242 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
         list->clip_rect.x, list->clip_rect.y, list->clip_rect.w, list->clip_rect.h)) return;
 
     nk_draw_list_push_image(list, font->texture);
-    x = rect.x;
-    glyph_len = nk_utf_decode(text, &unicode, len);
-    if (!glyph_len) return;
+
+    /* count glyphs up to the first invalid one to reserve all quads at once */
+    while (text_len < len) {
+        if ((unsigned char)text[text_len] < 0x7F) {
+            glyph_len = 1;
+        } else {
+            glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+            if (!glyph_len || unicode == NK_UTF_INVALID) break;
+        }
+        text_len += glyph_len;
+        glyph_count++;
+    }
+    if (!glyph_count) return;
+    index = (nk_draw_index)list->vertex_count;
+    vtx = nk_draw_list_alloc_vertices(list, 4 * (nk_size)glyph_count);
+    idx = nk_draw_list_alloc_elements(list, 6 * (nk_size)glyph_count);
+    if (!vtx || !idx) return;
 
     /* draw every glyph image */
     fg.a = (nk_byte)((float)fg.a * list->config.global_alpha);
-    while (text_len < len && glyph_len) {
-        float gx, gy, gh, gw;
-        float char_width = 0;
-        if (unicode == NK_UTF_INVALID) break;
-
-        /* query currently drawn glyph information */
-        next_glyph_len = nk_utf_decode(text + text_len + glyph_len, &next, (int)len - text_len);
-        font->query(font->userdata, font_height, &g, unicode,
-                    (next == NK_UTF_INVALID) ? '\0' : next);
-
-        /* calculate and draw glyph drawing rectangle and image */
-        gx = x + g.offset.x;
-        gy = rect.y + g.offset.y;
-        gw = g.width; gh = g.height;
-        char_width = g.xadvance;
-        nk_draw_list_push_rect_uv(list, nk_vec2(gx,gy), nk_vec2(gx + gw, gy+ gh),
-            g.uv[0], g.uv[1], fg);
-
+    nk_color_fv(&col.r, fg);
+#ifdef NK_INCLUDE_FONT_BAKING
+    if ((baked = nk_font_from_user_font(font)) != 0)
+        scale = font_height / baked->info.height;
+#endif
+    x = rect.x;
+    text_len = 0;
+    for (i = 0; i < glyph_count; ++i) {
+        float gx, gy;
+        if ((unsigned char)text[text_len] < 0x7F) {
+            unicode = (nk_rune)text[text_len];
+            glyph_len = 1;
+        } else glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+#ifdef NK_INCLUDE_FONT_BAKING
+        if (baked) {
+            /* same glyph metrics `nk_font_query_font_glyph` would return */
+            const struct nk_font_glyph *bg = nk_font_find_glyph(baked, unicode);
+            gx = x + bg->x0 * scale;
+            gy = rect.y + bg->y0 * scale;
+            vtx = nk_draw_list_write_rect_uv(list, vtx, idx, index, nk_vec2(gx, gy),
+                nk_vec2(gx + (bg->x1 - bg->x0) * scale, gy + (bg->y1 - bg->y0) * scale),
+                nk_vec2(bg->u0, bg->v0), nk_vec2(bg->u1, bg->v1), col);
+            x += bg->xadvance * scale;
+        } else
+#endif
+        {
+            /* query currently drawn glyph information */
+            next = 0;
+            if (text_len + glyph_len < len) {
+                nk_utf_decode(text + text_len + glyph_len, &next, len - text_len - glyph_len);
+                if (next == NK_UTF_INVALID) next = 0;
+            }
+            font->query(font->userdata, font_height, &g, unicode, next);
+            gx = x + g.offset.x;
+            gy = rect.y + g.offset.y;
+            vtx = nk_draw_list_write_rect_uv(list, vtx, idx, index, nk_vec2(gx, gy),
+                nk_vec2(gx + g.width, gy + g.height), g.uv[0], g.uv[1], col);
+            x += g.xadvance;
+        }
         /* offset next glyph */
         text_len += glyph_len;
-        x += char_width;
-        glyph_len = next_glyph_len;
-        unicode = next;
+        index = (nk_draw_index)(index + 4);
+        idx += 6;
+    }
+}
+NK_INTERN void
+nk_convert_command(struct nk_draw_list *list, const struct nk_command *cmd,
+    const struct nk_convert_config *config)
+{
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = cmd->userdata;
+#endif
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_SCISSOR");
+        nk_draw_list_add_clip(list, nk_rect(s->x, s->y, s->w, s->h));
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_LINE");
+        nk_draw_list_stroke_line(list, nk_vec2(l->begin.x, l->begin.y),
+            nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CURVE");
+        nk_draw_list_stroke_curve(list, nk_vec2(q->begin.x, q->begin.y),
+            nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
+            q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
+            config->curve_segment_count, q->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT");
+        nk_draw_list_stroke_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding, r->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT_FILLED");
+        nk_draw_list_fill_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_RECT_MULTI_COLOR");
+        nk_draw_list_fill_rect_multi_color(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->left, r->top, r->right, r->bottom);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CIRCLE");
+        nk_draw_list_stroke_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            config->circle_segment_count, c->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CIRCLE_FILLED");
+        nk_draw_list_fill_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            config->circle_segment_count);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_ARC");
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], config->arc_segment_count);
+        nk_draw_list_path_stroke(list, c->color, NK_STROKE_CLOSED, c->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_ARC_FILLED");
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], config->arc_segment_count);
+        nk_draw_list_path_fill(list, c->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TRIANGLE");
+        nk_draw_list_stroke_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
+            t->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TRIANGLE_FILLED");
+        nk_draw_list_fill_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYGON: {
+        int i;
+        const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYGON");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_CLOSED, p->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        int i;
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYGON_FILLED");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_fill(list, p->color);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        int i;
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_POLYLINE");
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_OPEN, p->line_thickness);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_TEXT");
+        nk_draw_list_add_text(list, t->font, nk_rect(t->x, t->y, t->w, t->h),
+            t->string, t->length, t->height, t->foreground);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_IMAGE");
+        nk_draw_list_add_image(list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
+        NK_PROFILE_END;
+    } break;
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        NK_PROFILE_BEGIN("NK_COMMAND_CUSTOM");
+        c->callback(list, c->x, c->y, c->w, c->h, c->callback_data);
+        NK_PROFILE_END;
+    } break;
+    default: break;
     }
 }
+NK_INTERN nk_flags
+nk_convert_result(const struct nk_buffer *cmds, const struct nk_buffer *vertices,
+    const struct nk_buffer *elements)
+{
+    nk_flags res = NK_CONVERT_SUCCESS;
+    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
+    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
+    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
+    return res;
+}
 NK_API nk_flags
 nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
     struct nk_buffer *vertices, struct nk_buffer *elements,
     const struct nk_convert_config *config)
 {
-    nk_flags res = NK_CONVERT_SUCCESS;
     const struct nk_command *cmd;
     NK_ASSERT(ctx);
     NK_ASSERT(cmds);
@@ -1191,131 +1588,525 @@ nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
     NK_ASSERT(config->vertex_size);
     if (!ctx || !cmds || !vertices || !elements || !config || !config->vertex_layout)
         return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert");
 
     nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
         config->line_AA, config->shape_AA);
+    ctx->draw_list.scratch_arena = &ctx->frame;
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_begin(ctx);
+    nk_foreach(cmd, ctx) {
+        nk_stats_convert_command(ctx, cmd);
+        nk_convert_command(&ctx->draw_list, cmd, config);
+    }
+    nk_stats_convert_end(ctx);
+#else
     nk_foreach(cmd, ctx)
-    {
+        nk_convert_command(&ctx->draw_list, cmd, config);
+#endif
+    NK_PROFILE_END;
+    return nk_convert_result(cmds, vertices, elements);
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_cache_init_default(struct nk_convert_cache *cache)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_cache_init(cache, &alloc);
+}
+#endif
+NK_API void
+nk_convert_cache_init(struct nk_convert_cache *cache, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(cache);
+    NK_ASSERT(alloc);
+    if (!cache || !alloc) return;
+
+    nk_zero(cache, sizeof(*cache));
+    nk_buffer_init(&cache->memory[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&cache->memory[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    /* window states start out zeroed so sequence zero never refers to valid data */
+    cache->seq = 1;
+}
+NK_API void
+nk_convert_cache_free(struct nk_convert_cache *cache)
+{
+    NK_ASSERT(cache);
+    if (!cache) return;
+    nk_buffer_free(&cache->memory[0]);
+    nk_buffer_free(&cache->memory[1]);
+    nk_zero(cache, sizeof(*cache));
+}
+NK_API void
+nk_convert_cache_invalidate(struct nk_convert_cache *cache)
+{
+    NK_ASSERT(cache);
+    if (!cache) return;
+    cache->invalid = nk_true;
+}
+NK_INTERN struct nk_draw_command*
+nk_draw_list_command_at(struct nk_draw_list *list, unsigned int index)
+{
+    /* draw commands are stored from the back of the buffer towards the front */
+    NK_ASSERT(index < list->cmd_count);
+    return nk_draw_list_command_last(list) + (list->cmd_count - 1 - index);
+}
+NK_INTERN nk_bool
+nk_draw_list_begin_segment(struct nk_draw_list *list)
+{
+    /* start a new draw command whose state does not depend on previous output */
+    struct nk_draw_command *cmd = 0;
+    if (list->cmd_count) {
+        cmd = nk_draw_list_command_last(list);
+        if (cmd->elem_count) cmd = 0;
+    }
+    if (!cmd) return nk_draw_list_push_command(list, list->clip_rect,
+        list->config.tex_null.texture) != 0;
+
+    cmd->clip_rect = list->clip_rect;
+    cmd->texture = list->config.tex_null.texture;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
-        ctx->draw_list.userdata = cmd->userdata;
+    cmd->userdata = list->userdata;
 #endif
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
-            nk_draw_list_add_clip(&ctx->draw_list, nk_rect(s->x, s->y, s->w, s->h));
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line*)cmd;
-            nk_draw_list_stroke_line(&ctx->draw_list, nk_vec2(l->begin.x, l->begin.y),
-                nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
-            nk_draw_list_stroke_curve(&ctx->draw_list, nk_vec2(q->begin.x, q->begin.y),
-                nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
-                q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
-                config->curve_segment_count, q->line_thickness);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
-            nk_draw_list_stroke_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding, r->line_thickness);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
-            nk_draw_list_fill_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR: {
-            const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
-            nk_draw_list_fill_rect_multi_color(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->left, r->top, r->right, r->bottom);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
-            nk_draw_list_stroke_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count, c->line_thickness);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_draw_list_fill_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count);
-        } break;
-        case NK_COMMAND_ARC: {
-            const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_stroke(&ctx->draw_list, c->color, NK_STROKE_CLOSED, c->line_thickness);
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_fill(&ctx->draw_list, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
-            nk_draw_list_stroke_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
-                t->line_thickness);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
-            nk_draw_list_fill_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            int i;
-            const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_CLOSED, p->line_thickness);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            int i;
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_fill(&ctx->draw_list, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            int i;
-            const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
+    return nk_true;
+}
+NK_INTERN nk_bool
+nk_convert_config_equal(const struct nk_convert_config *a,
+    const struct nk_convert_config *b)
+{
+    return a->global_alpha == b->global_alpha &&
+        a->line_AA == b->line_AA && a->shape_AA == b->shape_AA &&
+        a->circle_segment_count == b->circle_segment_count &&
+        a->arc_segment_count == b->arc_segment_count &&
+        a->curve_segment_count == b->curve_segment_count &&
+        a->tex_null.texture.id == b->tex_null.texture.id &&
+        a->tex_null.uv.x == b->tex_null.uv.x &&
+        a->tex_null.uv.y == b->tex_null.uv.y &&
+        a->vertex_layout == b->vertex_layout &&
+        a->vertex_size == b->vertex_size &&
+        a->vertex_alignment == b->vertex_alignment;
+}
+NK_INTERN void
+nk_convert_cache_replay(struct nk_draw_list *list, const struct nk_buffer *cache,
+    const struct nk_convert_cache_state *state)
+{
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    const nk_byte *memory = (const nk_byte*)cache->memory.ptr;
+    const struct nk_draw_command *cmds;
+    struct nk_draw_command *cmd;
+    unsigned int base = list->vertex_count;
+    unsigned int i;
+
+    /* first draw command was already started by `nk_draw_list_begin_segment` */
+    cmds = nk_ptr_add_const(struct nk_draw_command, memory, state->cmd_offset);
+    cmd = nk_draw_list_command_last(list);
+    *cmd = cmds[0];
+    for (i = 1; i < state->cmd_count; ++i) {
+        cmd = nk_draw_list_push_command(list, cmds[i].clip_rect, cmds[i].texture);
+        if (!cmd) return;
+        *cmd = cmds[i];
+    }
+    list->clip_rect = state->clip;
+
+    if (state->vertex_count) {
+        void *vtx = nk_draw_list_alloc_vertices(list, state->vertex_count);
+        if (!vtx) return;
+        NK_MEMCPY(vtx, memory + state->vertex_offset,
+            list->config.vertex_size * state->vertex_count);
+    }
+    if (state->element_count) {
+        const nk_draw_index *src;
+        nk_draw_index *ids = (nk_draw_index*)nk_buffer_alloc(list->elements,
+            NK_BUFFER_FRONT, elem_size * state->element_count, elem_align);
+        if (!ids) return;
+        src = nk_ptr_add_const(nk_draw_index, memory, state->element_offset);
+        for (i = 0; i < state->element_count; ++i)
+            ids[i] = (nk_draw_index)(src[i] + base);
+        list->element_count += state->element_count;
+    }
+}
+NK_INTERN nk_bool
+nk_convert_cache_store(struct nk_draw_list *list, struct nk_buffer *cache,
+    struct nk_convert_cache_state *state, unsigned int cmd_begin,
+    unsigned int vertex_begin, unsigned int element_begin)
+{
+    NK_STORAGE const nk_size cmd_align = NK_ALIGNOF(struct nk_draw_command);
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    void *dst;
+    unsigned int i;
+
+    /* partially converted output can not be cached */
+    if (nk_convert_result(list->buffer, list->vertices, list->elements) != NK_CONVERT_SUCCESS)
+        return nk_false;
+
+    state->cmd_count = list->cmd_count - cmd_begin;
+    state->vertex_count = list->vertex_count - vertex_begin;
+    state->element_count = list->element_count - element_begin;
+
+    dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT,
+        sizeof(struct nk_draw_command) * state->cmd_count, cmd_align);
+    if (!dst) return nk_false;
+    state->cmd_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+    for (i = 0; i < state->cmd_count; ++i)
+        ((struct nk_draw_command*)dst)[i] = *nk_draw_list_command_at(list, cmd_begin + i);
+
+    if (state->vertex_count) {
+        const nk_size size = list->config.vertex_size * state->vertex_count;
+        const void *src = nk_ptr_add_const(void, list->vertices->memory.ptr,
+            list->vertices->allocated - size);
+        dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT, size, list->config.vertex_alignment);
+        if (!dst) return nk_false;
+        state->vertex_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+        NK_MEMCPY(dst, src, size);
+    }
+    if (state->element_count) {
+        /* indices are stored relative to the first vertex of the window */
+        const nk_size size = elem_size * state->element_count;
+        const nk_draw_index *src = nk_ptr_add_const(nk_draw_index,
+            list->elements->memory.ptr, list->elements->allocated - size);
+        dst = nk_buffer_alloc(cache, NK_BUFFER_FRONT, size, elem_align);
+        if (!dst) return nk_false;
+        state->element_offset = (nk_size)((nk_byte*)dst - (nk_byte*)cache->memory.ptr);
+        for (i = 0; i < state->element_count; ++i)
+            ((nk_draw_index*)dst)[i] = (nk_draw_index)(src[i] - vertex_begin);
+    }
+    state->clip = list->clip_rect;
+    return nk_true;
+}
+NK_INTERN struct nk_window*
+nk_convert_cache_next_window(const struct nk_context *ctx, struct nk_window *win)
+{
+    /* same visibility rules `nk_build` uses to link window command buffers */
+    while (win && (win->buffer.last == win->buffer.begin ||
+        (win->flags & NK_WINDOW_HIDDEN) || win->seq != ctx->seq))
+        win = win->next;
+    return win;
+}
+NK_INTERN const struct nk_command*
+nk_convert_cache_window(struct nk_context *ctx, struct nk_convert_cache *cache,
+    struct nk_window *win, const struct nk_command *begin, nk_bool valid)
+{
+    struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_convert_cache_state *state = &win->convert_cache;
+    struct nk_buffer *cur = &cache->memory[cache->seq & 1];
+    const struct nk_buffer *prev = &cache->memory[(cache->seq-1) & 1];
+    const struct nk_command *last;
+    const struct nk_command *end;
+    const struct nk_command *cmd;
+    unsigned int cmd_begin, vertex_begin, element_begin;
+    nk_bool cacheable = nk_true;
+    nk_hash hash[2];
+
+    /* hash every command of the window together with the incoming clip rect.
+     * A single 32-bit hash collides too easily to silently reuse stale
+     * vertices on, so two differently seeded lanes form a 64-bit key */
+    last = nk_ptr_add_const(struct nk_command, ctx->memory.memory.ptr, win->buffer.last);
+    hash[0] = nk_murmur_hash(&list->clip_rect, (int)sizeof(list->clip_rect), 0);
+    hash[1] = nk_murmur_hash(&list->clip_rect, (int)sizeof(list->clip_rect), 0x9E3779B9u);
+    for (cmd = begin; cmd; cmd = nk__next(ctx, cmd)) {
+        hash[0] = nk_command_hash(cmd, hash[0]);
+        hash[1] = nk_command_hash(cmd, hash[1]);
+        if (cmd->type == NK_COMMAND_CUSTOM)
+            cacheable = nk_false;
+        if (cmd == last) {
+            cmd = nk__next(ctx, cmd);
+            break;
+        }
+    }
+    end = cmd;
+
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = begin->userdata;
+#endif
+    if (!nk_draw_list_begin_segment(list))
+        cacheable = nk_false;
+    cmd_begin = list->cmd_count ? list->cmd_count - 1: 0;
+    vertex_begin = list->vertex_count;
+    element_begin = list->element_count;
+
+    if (valid && cacheable && state->seq && state->seq == cache->seq-1 &&
+        state->hash[0] == hash[0] && state->hash[1] == hash[1]) {
+        nk_convert_cache_replay(list, prev, state);
+        cache->reused++;
+    } else {
+        for (cmd = begin; cmd != end; cmd = nk__next(ctx, cmd))
+            nk_convert_command(list, cmd, &list->config);
+        cache->converted++;
+    }
+    if (cacheable && nk_convert_cache_store(list, cur, state, cmd_begin, vertex_begin, element_begin)) {
+        state->seq = cache->seq;
+        state->hash[0] = hash[0];
+        state->hash[1] = hash[1];
+    } else state->seq = 0;
+    return end;
+}
+NK_API nk_flags
+nk_convert_cached(struct nk_context *ctx, struct nk_convert_cache *cache,
+    struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    const struct nk_command *cmd;
+    struct nk_window *win;
+    nk_bool valid;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(cache);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cache || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert_cached");
+
+    /* a different configuration produces different vertices */
+    valid = !cache->invalid && nk_convert_config_equal(&cache->config, config);
+    cache->invalid = nk_false;
+    cache->config = *config;
+    cache->seq++;
+    cache->reused = 0;
+    cache->converted = 0;
+    nk_buffer_clear(&cache->memory[cache->seq & 1]);
+
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    ctx->draw_list.scratch_arena = &ctx->frame;
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_begin(ctx);
+#endif
+    cmd = nk__begin(ctx);
+    win = nk_convert_cache_next_window(ctx, ctx->begin);
+    while (cmd) {
+        const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+#ifdef NK_INCLUDE_STATISTICS
+        nk_stats_convert_command(ctx, cmd);
+#endif
+        if (win && offset == win->buffer.begin) {
+            /* window commands: either copied from cache or converted and stored */
+            cmd = nk_convert_cache_window(ctx, cache, win, cmd, valid);
+            win = nk_convert_cache_next_window(ctx, win->next);
+        } else {
+            /* popups and overlay are always converted */
+            nk_convert_command(&ctx->draw_list, cmd, config);
+            cmd = nk__next(ctx, cmd);
+        }
+    }
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_end(ctx);
+#endif
+    NK_PROFILE_END;
+    return nk_convert_result(cmds, vertices, elements);
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_pool_init_default(struct nk_convert_pool *pool,
+    nk_convert_dispatch dispatch, nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_pool_init(pool, &alloc, dispatch, userdata);
+}
+#endif
+NK_API void
+nk_convert_pool_init(struct nk_convert_pool *pool, const struct nk_allocator *alloc,
+    nk_convert_dispatch dispatch, nk_handle userdata)
+{
+    NK_ASSERT(pool);
+    NK_ASSERT(alloc);
+    if (!pool || !alloc) return;
+
+    nk_zero(pool, sizeof(*pool));
+    pool->alloc = *alloc;
+    pool->dispatch = dispatch;
+    pool->userdata = userdata;
+}
+NK_API void
+nk_convert_pool_free(struct nk_convert_pool *pool)
+{
+    int i;
+    NK_ASSERT(pool);
+    if (!pool) return;
+    for (i = 0; i < pool->capacity; ++i) {
+        nk_buffer_free(&pool->jobs[i].cmds);
+        nk_buffer_free(&pool->jobs[i].vertices);
+        nk_buffer_free(&pool->jobs[i].elements);
+    }
+    if (pool->jobs)
+        pool->alloc.free(pool->alloc.userdata, pool->jobs);
+    nk_zero(pool, sizeof(*pool));
+}
+NK_INTERN struct nk_convert_job*
+nk_convert_pool_push(struct nk_convert_pool *pool)
+{
+    struct nk_convert_job *job;
+    if (pool->count == pool->capacity) {
+        /* grow job array while keeping the buffers of existing jobs */
+        int i, capacity = NK_MAX(pool->capacity * 2, 8);
+        struct nk_convert_job *jobs = (struct nk_convert_job*)
+            pool->alloc.alloc(pool->alloc.userdata, pool->jobs,
+                sizeof(struct nk_convert_job) * (nk_size)capacity);
+        if (!jobs) return 0;
+        if (pool->jobs) {
+            NK_MEMCPY(jobs, pool->jobs, sizeof(struct nk_convert_job) * (nk_size)pool->capacity);
+            pool->alloc.free(pool->alloc.userdata, pool->jobs);
+        }
+        for (i = pool->capacity; i < capacity; ++i) {
+            nk_draw_list_init(&jobs[i].list);
+            nk_buffer_init(&jobs[i].cmds, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+            nk_buffer_init(&jobs[i].vertices, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+            nk_buffer_init(&jobs[i].elements, &pool->alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+        }
+        pool->jobs = jobs;
+        pool->capacity = capacity;
+    }
+    job = &pool->jobs[pool->count++];
+    nk_buffer_clear(&job->cmds);
+    nk_buffer_clear(&job->vertices);
+    nk_buffer_clear(&job->elements);
+    job->result = NK_CONVERT_SUCCESS;
+    return job;
+}
+NK_API void
+nk_convert_job_run(struct nk_convert_job *job)
+{
+    const struct nk_command *cmd;
+    NK_ASSERT(job);
+    if (!job) return;
+
+    /* first draw command carries the clip rect left by previous jobs */
+    if (!nk_draw_list_begin_segment(&job->list)) {
+        job->result = nk_convert_result(&job->cmds, &job->vertices, &job->elements);
+        return;
+    }
+    for (cmd = job->begin; cmd != job->end; cmd = nk__next(job->ctx, cmd))
+        nk_convert_command(&job->list, cmd, &job->list.config);
+    job->result = nk_convert_result(&job->cmds, &job->vertices, &job->elements);
+}
+NK_INTERN void
+nk_convert_job_append(struct nk_draw_list *list, struct nk_convert_job *job)
+{
+    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    struct nk_draw_list *src = &job->list;
+    const unsigned int base = list->vertex_count;
+    unsigned int i;
+
+    for (i = 0; i < src->cmd_count; ++i) {
+        const struct nk_draw_command *from = nk_draw_list_command_at(src, i);
+        struct nk_draw_command *cmd = nk_draw_list_push_command(list, from->clip_rect, from->texture);
+        if (!cmd) return;
+        *cmd = *from;
+    }
+    if (src->vertex_count) {
+        const nk_size size = list->config.vertex_size * src->vertex_count;
+        void *vtx = nk_draw_list_alloc_vertices(list, src->vertex_count);
+        if (!vtx) return;
+        NK_MEMCPY(vtx, nk_ptr_add_const(void, job->vertices.memory.ptr,
+            job->vertices.allocated - size), size);
+    }
+    if (src->element_count) {
+        /* job indices start at the first vertex of the job */
+        const nk_size size = elem_size * src->element_count;
+        const nk_draw_index *from = nk_ptr_add_const(nk_draw_index,
+            job->elements.memory.ptr, job->elements.allocated - size);
+        nk_draw_index *ids = (nk_draw_index*)nk_buffer_alloc(list->elements,
+            NK_BUFFER_FRONT, size, elem_align);
+        if (!ids) return;
+        for (i = 0; i < src->element_count; ++i)
+            ids[i] = (nk_draw_index)(from[i] + base);
+        list->element_count += src->element_count;
+    }
+}
+NK_API nk_flags
+nk_convert_parallel(struct nk_context *ctx, struct nk_convert_pool *pool,
+    struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    const struct nk_command *cmd;
+    struct nk_convert_job *job = 0;
+    struct nk_window *win;
+    struct nk_rect clip = nk_null_rect;
+    nk_flags res;
+    int i;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(pool);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !pool || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
+    NK_PROFILE_BEGIN("nk_convert_parallel");
+
+    /* split draw commands on window boundaries into jobs */
+    pool->count = 0;
+    win = nk_convert_cache_next_window(ctx, ctx->begin);
+    for (cmd = nk__begin(ctx); cmd; cmd = nk__next(ctx, cmd)) {
+        const nk_size offset = (nk_size)((const nk_byte*)cmd - (const nk_byte*)ctx->memory.memory.ptr);
+        if (!job || (win && offset == win->buffer.begin)) {
+            if (job) job->end = cmd;
+            job = nk_convert_pool_push(pool);
+            if (!job) {
+                NK_PROFILE_END;
+                return nk_convert(ctx, cmds, vertices, elements, config);
             }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_OPEN, p->line_thickness);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_draw_list_add_text(&ctx->draw_list, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *i = (const struct nk_command_image*)cmd;
-            nk_draw_list_add_image(&ctx->draw_list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
-        } break;
-        case NK_COMMAND_CUSTOM: {
-            const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
-            c->callback(&ctx->draw_list, c->x, c->y, c->w, c->h, c->callback_data);
-        } break;
-        default: break;
+            job->ctx = ctx;
+            job->begin = cmd;
+            job->end = 0;
+            job->clip = clip;
+            if (win && offset == win->buffer.begin)
+                win = nk_convert_cache_next_window(ctx, win->next);
+        }
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+            clip = nk_rect(s->x, s->y, s->w, s->h);
         }
     }
-    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
-    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
-    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
-    return res;
+
+    /* tessellate all jobs and append their output in order */
+    for (i = 0; i < pool->count; ++i) {
+        job = &pool->jobs[i];
+        nk_draw_list_setup(&job->list, config, &job->cmds, &job->vertices,
+            &job->elements, config->line_AA, config->shape_AA);
+        job->list.clip_rect = job->clip;
+    }
+    if (pool->dispatch && pool->count > 1)
+        pool->dispatch(pool->userdata, pool->jobs, pool->count);
+    else for (i = 0; i < pool->count; ++i)
+        nk_convert_job_run(&pool->jobs[i]);
+
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    res = NK_CONVERT_SUCCESS;
+#ifdef NK_INCLUDE_STATISTICS
+    /* jobs start on window boundaries, so popups and overlay count
+     * towards the last window */
+    nk_stats_convert_begin(ctx);
+#endif
+    for (i = 0; i < pool->count; ++i) {
+#ifdef NK_INCLUDE_STATISTICS
+        nk_stats_convert_command(ctx, pool->jobs[i].begin);
+#endif
+        nk_convert_job_append(&ctx->draw_list, &pool->jobs[i]);
+        res |= pool->jobs[i].result;
+    }
+#ifdef NK_INCLUDE_STATISTICS
+    nk_stats_convert_end(ctx);
+#endif
+    NK_PROFILE_END;
+    return res | nk_convert_result(cmds, vertices, elements);
 }
 NK_API const struct nk_draw_command*
 nk__draw_begin(const struct nk_context *ctx,
@@ -10,20 +10,37 @@ NK_LIB void*
 nk_create_window(struct nk_context *ctx)
 {
     struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_WINDOW);
     if (!elem) return 0;
     elem->data.win.seq = ctx->seq;
     return &elem->data.win;
 }
+NK_LIB struct nk_window_state*
+nk_window_acquire_state(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_page_element *elem;
+    if (win->state) return win->state;
+    elem = nk_create_page_element(ctx, NK_PAGE_ELEMENT_WINDOW_STATE);
+    if (!elem) return 0;
+    win->state = &elem->data.state;
+    return win->state;
+}
 NK_LIB void
 nk_free_window(struct nk_context *ctx, struct nk_window *win)
 {
     /* unlink windows from list */
     struct nk_table *it = win->tables;
+    nk_value_index_free(ctx, win);
     if (win->popup.win) {
         nk_free_window(ctx, win->popup.win);
         win->popup.win = 0;
     }
+    if (win->state) {
+        union nk_page_data *pd = NK_CONTAINER_OF(win->state, union nk_page_data, state);
+        struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
+        nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_WINDOW_STATE);
+        win->state = 0;
+    }
     win->next = 0;
     win->prev = 0;
 
@@ -40,12 +57,104 @@ nk_free_window(struct nk_context *ctx, struct nk_window *win)
     /* link windows into freelist */
     {union nk_page_data *pd = NK_CONTAINER_OF(win, union nk_page_data, win);
     struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);}
+    nk_free_page_element(ctx, pe, NK_PAGE_ELEMENT_WINDOW);}
+}
+NK_LIB void
+nk_window_index_clear(struct nk_context *ctx)
+{
+    if (!ctx->window_index) return;
+    nk_zero(ctx->window_index, ctx->window_index_size * sizeof(struct nk_window*));
+    ctx->window_index_count = 0;
+}
+NK_LIB void
+nk_window_index_free(struct nk_context *ctx)
+{
+    if (ctx->window_index && ctx->pool.alloc.free)
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, ctx->window_index);
+    ctx->window_index = 0;
+    ctx->window_index_size = 0;
+    ctx->window_index_count = 0;
+}
+NK_INTERN void
+nk_window_index_add(struct nk_context *ctx, struct nk_window *win)
+{
+    unsigned int mask = ctx->window_index_size - 1;
+    unsigned int i = win->name & mask;
+    while (ctx->window_index[i])
+        i = (i + 1) & mask;
+    ctx->window_index[i] = win;
+    ctx->window_index_count++;
+}
+NK_INTERN void
+nk_window_index_insert(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_window *iter;
+    unsigned int size;
+
+    /* contexts without an allocator keep searching the window list */
+    if (!ctx->pool.alloc.alloc) return;
+    if (ctx->window_index && (ctx->window_index_count + 1) * 2 <= ctx->window_index_size) {
+        nk_window_index_add(ctx, win);
+        return;
+    }
+    /* grow and rebuild from the window list which already contains `win` */
+    size = (ctx->window_index_size) ? ctx->window_index_size * 2 : 16;
+    nk_window_index_free(ctx);
+    ctx->window_index = (struct nk_window**)ctx->pool.alloc.alloc(
+        ctx->pool.alloc.userdata, 0, size * sizeof(struct nk_window*));
+    if (!ctx->window_index) return;
+    ctx->window_index_size = size;
+    nk_window_index_clear(ctx);
+    for (iter = ctx->begin; iter; iter = iter->next)
+        nk_window_index_add(ctx, iter);
+}
+NK_INTERN void
+nk_window_index_remove(struct nk_context *ctx, struct nk_window *win)
+{
+    unsigned int mask, i, j;
+    if (!ctx->window_index) return;
+    mask = ctx->window_index_size - 1;
+    i = win->name & mask;
+    while (ctx->window_index[i] && ctx->window_index[i] != win)
+        i = (i + 1) & mask;
+    if (!ctx->window_index[i]) return;
+
+    /* backward shift deletion keeps probe sequences intact without tombstones */
+    ctx->window_index[i] = 0;
+    ctx->window_index_count--;
+    for (j = (i + 1) & mask; ctx->window_index[j]; j = (j + 1) & mask) {
+        unsigned int k = ctx->window_index[j]->name & mask;
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+            ctx->window_index[i] = ctx->window_index[j];
+            ctx->window_index[j] = 0;
+            i = j;
+        }
+    }
+}
+NK_INTERN void
+nk_window_index_drop(struct nk_context *ctx, struct nk_window *iter)
+{
+    /* windows behind the list end become unreachable once it is relinked */
+    for (; iter; iter = iter->next)
+        nk_window_index_remove(ctx, iter);
 }
 NK_LIB struct nk_window*
 nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name)
 {
     struct nk_window *iter;
+    if (ctx->window_index) {
+        unsigned int mask = ctx->window_index_size - 1;
+        unsigned int i = hash & mask;
+        while ((iter = ctx->window_index[i]) != 0) {
+            if (iter->name == hash) {
+                int max_len = nk_strlen(iter->name_string);
+                if (!nk_stricmpn(iter->name_string, name, max_len))
+                    return iter;
+            }
+            i = (i + 1) & mask;
+        }
+        return 0;
+    }
     iter = ctx->begin;
     while (iter) {
         NK_ASSERT(iter != iter->next);
@@ -81,12 +190,14 @@ nk_insert_window(struct nk_context *ctx, struct nk_window *win,
         ctx->begin = win;
         ctx->end = win;
         ctx->count = 1;
+        nk_window_index_insert(ctx, win);
         return;
     }
     if (loc == NK_INSERT_BACK) {
         struct nk_window *end;
         end = ctx->end;
         end->flags |= NK_WINDOW_ROM;
+        nk_window_index_drop(ctx, end->next);
         end->next = win;
         win->prev = ctx->end;
         win->next = 0;
@@ -102,6 +213,7 @@ nk_insert_window(struct nk_context *ctx, struct nk_window *win,
         ctx->begin->flags &= ~(nk_flags)NK_WINDOW_ROM;
     }
     ctx->count++;
+    nk_window_index_insert(ctx, win);
 }
 NK_LIB void
 nk_remove_window(struct nk_context *ctx, struct nk_window *win)
@@ -114,8 +226,10 @@ nk_remove_window(struct nk_context *ctx, struct nk_window *win)
         }
         if (win == ctx->end) {
             ctx->end = win->prev;
-            if (win->prev)
+            if (win->prev) {
+                nk_window_index_drop(ctx, win->next);
                 win->prev->next = 0;
+            }
         }
     } else {
         if (win->next)
@@ -131,6 +245,7 @@ nk_remove_window(struct nk_context *ctx, struct nk_window *win)
     win->next = 0;
     win->prev = 0;
     ctx->count--;
+    nk_window_index_remove(ctx, win);
 }
 NK_API nk_bool
 nk_begin(struct nk_context *ctx, const char *title,
@@ -155,6 +270,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
     if (!ctx || ctx->current || !title || !name)
         return 0;
+    NK_PROFILE_BEGIN("nk_begin");
 
     /* find or create window */
     style = &ctx->style;
@@ -166,8 +282,16 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
         nk_size name_length = (nk_size)name_len;
         win = (struct nk_window*)nk_create_window(ctx);
         NK_ASSERT(win);
-        if (!win) return 0;
+        if (!win) {
+            NK_PROFILE_END;
+            return 0;
+        }
 
+        /* name has to be set before insertion since it keys the window index */
+        win->name = name_hash;
+        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
+        NK_MEMCPY(win->name_string, name, name_length);
+        win->name_string[name_length] = 0;
         if (flags & NK_WINDOW_BACKGROUND)
             nk_insert_window(ctx, win, NK_INSERT_FRONT);
         else nk_insert_window(ctx, win, NK_INSERT_BACK);
@@ -175,10 +299,6 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
 
         win->flags = flags;
         win->bounds = bounds;
-        win->name = name_hash;
-        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
-        NK_MEMCPY(win->name_string, name, name_length);
-        win->name_string[name_length] = 0;
         win->popup.win = 0;
         win->widgets_disabled = nk_false;
         if (!ctx->active)
@@ -206,6 +326,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     if (win->flags & NK_WINDOW_HIDDEN) {
         ctx->current = win;
         win->layout = 0;
+        NK_PROFILE_END;
         return 0;
     } else nk_start(ctx, win);
 
@@ -291,6 +412,7 @@ nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
     ret = nk_panel_begin(ctx, title, NK_PANEL_WINDOW);
     win->layout->offset_x = &win->scrollbar.x;
     win->layout->offset_y = &win->scrollbar.y;
+    NK_PROFILE_END;
     return ret;
 }
 NK_API void
@@ -307,9 +429,11 @@ nk_end(struct nk_context *ctx)
         ctx->current = 0;
         return;
     }
+    NK_PROFILE_BEGIN("nk_end");
     nk_panel_end(ctx);
     nk_free_panel(ctx, ctx->current->layout);
     ctx->current = 0;
+    NK_PROFILE_END;
 }
 NK_API struct nk_rect
 nk_window_get_bounds(const struct nk_context *ctx)